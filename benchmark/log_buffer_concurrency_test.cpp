@@ -0,0 +1,110 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "common/log/log.h"
+#include "storage/clog/log_buffer.h"
+#include "storage/clog/log_file.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试多个线程同时向日志缓冲区追加日志的性能
+ * @details 后台有一个线程一直把日志写入文件，不做sync，只关心追加日志本身的开销
+ */
+class LogBufferBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    LoggerFactory::init_default("log_buffer_benchmark.log", LOG_LEVEL_INFO);
+
+    filesystem::remove(filename_);
+    writer_ = make_unique<LogFileWriter>();
+    if (OB_FAIL(buffer_.init(0)) || OB_FAIL(writer_->open(filename_, numeric_limits<int>::max()))) {
+      throw runtime_error("failed to init log buffer");
+    }
+
+    running_.store(true);
+    flusher_ = thread([this]() {
+      while (running_.load() || buffer_.entry_number() > 0) {
+        int count = 0;
+        if (OB_FAIL(buffer_.flush(*writer_, count))) {
+          throw runtime_error("failed to flush log buffer");
+        }
+        if (count == 0) {
+          buffer_.wait_entries(chrono::milliseconds(10));
+        }
+      }
+    });
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    running_.store(false);
+    flusher_.join();
+    writer_.reset();
+    filesystem::remove(filename_);
+  }
+
+protected:
+  const char               *filename_ = "log_buffer_benchmark.clog";
+  LogEntryBuffer            buffer_;
+  unique_ptr<LogFileWriter> writer_;
+  thread                    flusher_;
+  atomic<bool>              running_{false};
+};
+
+BENCHMARK_DEFINE_F(LogBufferBenchmark, Append)(State &state)
+{
+  const int log_size = static_cast<int>(state.range(0));
+  int64_t   count    = 0;
+  for (auto _ : state) {
+    LSN          lsn = 0;
+    vector<char> data(log_size);
+    if (OB_FAIL(buffer_.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)))) {
+      throw runtime_error("failed to append log");
+    }
+    count++;
+  }
+
+  state.counters.insert({{"appends", Counter(static_cast<double>(count), Counter::kIsRate)}});
+}
+
+BENCHMARK_REGISTER_F(LogBufferBenchmark, Append)
+    ->Arg(64)
+    ->Arg(512)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->Threads(32)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "common/log/log.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/log_replayer.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+class EmptyLogReplayer : public LogReplayer
+{
+public:
+  RC replay(const LogEntry &) override { return RC::SUCCESS; }
+};
+
+/**
+ * @brief 测试日志组提交的性能
+ * @details 每个线程模拟事务提交：追加一条日志，然后等待这条日志刷盘。
+ * 输出每秒提交的次数和提交延迟的p99。
+ */
+class GroupCommitBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    string log_name = "group_commit_benchmark.log";
+    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_INFO);
+
+    filesystem::remove_all(directory_);
+    handler_ = make_unique<DiskLogHandler>();
+
+    EmptyLogReplayer replayer;
+    if (OB_FAIL(handler_->init(directory_)) || OB_FAIL(handler_->replay(replayer, 0)) ||
+        OB_FAIL(handler_->start())) {
+      throw runtime_error("failed to start log handler");
+    }
+    LOG_INFO("test group commit setup done. threads=%d", state.threads());
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    handler_->stop();
+    handler_->await_termination();
+    handler_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  void Commit(vector<double> &latencies)
+  {
+    auto         begin = chrono::steady_clock::now();
+    LSN          lsn   = 0;
+    vector<char> data(log_size_);
+    if (OB_FAIL(handler_->append(lsn, LogModule::Id::TRANSACTION, std::move(data)))) {
+      throw runtime_error("failed to append log");
+    }
+    if (OB_FAIL(handler_->wait_lsn(lsn))) {
+      throw runtime_error("failed to wait lsn");
+    }
+    auto end = chrono::steady_clock::now();
+    latencies.push_back(chrono::duration<double, micro>(end - begin).count());
+  }
+
+protected:
+  const char                *directory_ = "group_commit_benchmark_clog";
+  const int                  log_size_  = 128;
+  unique_ptr<DiskLogHandler> handler_;
+};
+
+BENCHMARK_DEFINE_F(GroupCommitBenchmark, Commit)(State &state)
+{
+  vector<double> latencies;
+  for (auto _ : state) {
+    Commit(latencies);
+  }
+
+  double p99 = 0;
+  if (!latencies.empty()) {
+    auto p99_iter = latencies.begin() + (latencies.size() - 1) * 99 / 100;
+    nth_element(latencies.begin(), p99_iter, latencies.end());
+    p99 = *p99_iter;
+  }
+
+  state.counters.insert({{"commits", Counter(static_cast<double>(latencies.size()), Counter::kIsRate)},
+      {"p99_latency_us", Counter(p99, Counter::kAvgThreads)}});
+}
+
+BENCHMARK_REGISTER_F(GroupCommitBenchmark, Commit)->Threads(1)->Threads(4)->Threads(16)->Threads(32)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
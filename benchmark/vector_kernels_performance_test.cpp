@@ -0,0 +1,127 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "sql/expr/chunk.h"
+#include "sql/expr/vector_kernels.h"
+#include "sql/parser/value.h"
+
+using namespace std;
+
+static void make_ints(int count, vector<int32_t> &left, vector<int32_t> &right)
+{
+  left.resize(count);
+  right.resize(count);
+  for (int i = 0; i < count; i++) {
+    left[i]  = (i * 7919) % 1000;
+    right[i] = 500;
+  }
+}
+
+/**
+ * @brief 逐行执行时的做法：每个值包装成Value，再调用Value::compare，作为向量化比较的对照
+ * @details 参数是数组长度
+ */
+static void BM_CompareIntValue(benchmark::State &state)
+{
+  vector<int32_t> left;
+  vector<int32_t> right;
+  make_ints(state.range(0), left, right);
+
+  vector<Value> left_values(left.begin(), left.end());
+  vector<Value> right_values(right.begin(), right.end());
+  vector<uint8_t> result(left.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < left_values.size(); i++) {
+      result[i] = left_values[i].compare(right_values[i]) < 0 ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * left.size()));
+}
+
+static void compare_int_kernel(benchmark::State &state, SimdLevel level)
+{
+  vector<int32_t> left;
+  vector<int32_t> right;
+  make_ints(state.range(0), left, right);
+
+  VectorKernels::set_level(level);
+  state.SetLabel(simd_level_name(VectorKernels::level()));
+  vector<uint8_t> result(left.size());
+  for (auto _ : state) {
+    VectorKernels::compare_int32(LESS_THAN, left.data(), right.data(), static_cast<int>(left.size()), result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * left.size()));
+  VectorKernels::set_level(VectorKernels::detect());
+}
+
+static void compare_float_kernel(benchmark::State &state, SimdLevel level)
+{
+  const int     count = state.range(0);
+  vector<float> left(count);
+  vector<float> right(count, 0.5f);
+  for (int i = 0; i < count; i++) {
+    left[i] = static_cast<float>((i * 7919) % 1000) / 1000;
+  }
+
+  VectorKernels::set_level(level);
+  state.SetLabel(simd_level_name(VectorKernels::level()));
+  vector<uint8_t> result(count);
+  for (auto _ : state) {
+    VectorKernels::compare_float(LESS_THAN, left.data(), right.data(), count, result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+  VectorKernels::set_level(VectorKernels::detect());
+}
+
+static void select_kernel(benchmark::State &state, SimdLevel level)
+{
+  const int       count = state.range(0);
+  vector<uint8_t> values(count);
+  for (int i = 0; i < count; i++) {
+    values[i] = (i * 7919) % 100 < 10 ? 1 : 0;
+  }
+
+  VectorKernels::set_level(level);
+  state.SetLabel(simd_level_name(VectorKernels::level()));
+  vector<int> selection(count);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(VectorKernels::select(values.data(), nullptr, count, selection.data()));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+  VectorKernels::set_level(VectorKernels::detect());
+}
+
+static void BM_CompareIntScalar(benchmark::State &state) { compare_int_kernel(state, SimdLevel::SCALAR); }
+static void BM_CompareIntSSE42(benchmark::State &state) { compare_int_kernel(state, SimdLevel::SSE42); }
+static void BM_CompareIntAVX2(benchmark::State &state) { compare_int_kernel(state, SimdLevel::AVX2); }
+static void BM_CompareFloatScalar(benchmark::State &state) { compare_float_kernel(state, SimdLevel::SCALAR); }
+static void BM_CompareFloatSSE42(benchmark::State &state) { compare_float_kernel(state, SimdLevel::SSE42); }
+static void BM_CompareFloatAVX2(benchmark::State &state) { compare_float_kernel(state, SimdLevel::AVX2); }
+static void BM_SelectScalar(benchmark::State &state) { select_kernel(state, SimdLevel::SCALAR); }
+static void BM_SelectAVX2(benchmark::State &state) { select_kernel(state, SimdLevel::AVX2); }
+
+BENCHMARK(BM_CompareIntValue)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareIntScalar)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareIntSSE42)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareIntAVX2)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareFloatScalar)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareFloatSSE42)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_CompareFloatAVX2)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_SelectScalar)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+BENCHMARK(BM_SelectAVX2)->Arg(Chunk::MAX_ROWS)->Arg(64 << 10);
+
+BENCHMARK_MAIN();
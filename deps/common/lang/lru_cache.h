@@ -116,6 +116,20 @@ public:
     return true;
   }
 
+  /**
+   * @brief 查找但是不调整LRU的顺序
+   */
+  bool peek(const Key &key, Value &value) const
+  {
+    auto iter = searcher_.find((ListNode *)&key);
+    if (iter == searcher_.end()) {
+      return false;
+    }
+
+    value = (*iter)->value_;
+    return true;
+  }
+
   void put(const Key &key, const Value &value)
   {
     auto iter = searcher_.find((ListNode *)&key);
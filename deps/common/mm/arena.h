@@ -0,0 +1,101 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 按块分配的连续内存区域
+ * @details 只分配不单独释放，所有内存在clear或者析构时一起回收。
+ * 适合算子中大量生命周期相同的小对象，比如hash join缓存的行数据，避免每行一次堆分配。
+ */
+class Arena
+{
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  Arena(const Arena &)            = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief 分配size字节的内存，返回的地址按8字节对齐
+   */
+  char *alloc(size_t size)
+  {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > remain_) {
+      new_block(size);
+    }
+
+    char *ptr = current_;
+    current_ += size;
+    remain_ -= size;
+    used_ += size;
+    return ptr;
+  }
+
+  /**
+   * @brief 释放所有内存块
+   */
+  void clear()
+  {
+    blocks_.clear();
+    current_   = nullptr;
+    remain_    = 0;
+    used_      = 0;
+    allocated_ = 0;
+  }
+
+  void swap(Arena &other)
+  {
+    std::swap(blocks_, other.blocks_);
+    std::swap(block_size_, other.block_size_);
+    std::swap(current_, other.current_);
+    std::swap(remain_, other.remain_);
+    std::swap(used_, other.used_);
+    std::swap(allocated_, other.allocated_);
+  }
+
+  /// 已经分配给调用者的字节数
+  size_t used_size() const { return used_; }
+  /// 从系统申请的字节数
+  size_t memory_size() const { return allocated_; }
+
+private:
+  void new_block(size_t min_size)
+  {
+    // 超过块大小的对象单独分配一个块，剩余空间仍然留在当前块中会被浪费，但这种情况很少
+    size_t size = min_size > block_size_ ? min_size : block_size_;
+    blocks_.emplace_back(new char[size]);
+    current_ = blocks_.back().get();
+    remain_  = size;
+    allocated_ += size;
+  }
+
+private:
+  static constexpr size_t ALIGNMENT = 8;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  size_t                               block_size_;
+  char                                *current_   = nullptr;
+  size_t                               remain_    = 0;
+  size_t                               used_      = 0;
+  size_t                               allocated_ = 0;
+};
+
+}  // namespace common
@@ -24,4 +24,12 @@ See the Mulan PSL v2 for more details. */
 
 #define SOCKET_BUFFER_SIZE 8192
 
+#define STORAGE "STORAGE"
+#define IO_ENGINE "IO_ENGINE"
+#define IO_ENGINE_DEFAULT "pread"
+#define REPLACEMENT_POLICY "REPLACEMENT_POLICY"
+#define REPLACEMENT_POLICY_DEFAULT "lru"
+#define FRAME_SHARD_NUM "FRAME_SHARD_NUM"
+#define FRAME_SHARD_NUM_DEFAULT 16
+
 #define SESSION_STAGE_NAME "SessionStage"
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/init.h"
 
 #include "common/conf/ini.h"
+#include "common/ini_setting.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/path.h"
@@ -143,8 +144,22 @@ int init_global_objects(ProcessParam *process_param, Ini &properties)
 
   int ret = 0;
 
-  RC rc =
-      GCTX.handler_->init("miniob", process_param->trx_kit_name().c_str(), process_param->durability_mode().c_str());
+  const string io_engine_name     = properties.get(IO_ENGINE, IO_ENGINE_DEFAULT, STORAGE);
+  const string replacement_policy = properties.get(REPLACEMENT_POLICY, REPLACEMENT_POLICY_DEFAULT, STORAGE);
+  const string frame_shard_str    = properties.get(FRAME_SHARD_NUM, "", STORAGE);
+
+  int frame_shard_num = FRAME_SHARD_NUM_DEFAULT;
+  if (!frame_shard_str.empty() && (!str_to_val(frame_shard_str, frame_shard_num) || frame_shard_num <= 0)) {
+    LOG_ERROR("invalid frame shard num: %s", frame_shard_str.c_str());
+    return -1;
+  }
+
+  RC rc = GCTX.handler_->init("miniob",
+      process_param->trx_kit_name().c_str(),
+      process_param->durability_mode().c_str(),
+      io_engine_name.c_str(),
+      replacement_policy.c_str(),
+      frame_shard_num);
   if (OB_FAIL(rc)) {
     LOG_ERROR("failed to init handler. rc=%s", strrc(rc));
     return -1;
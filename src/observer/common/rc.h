@@ -69,6 +69,7 @@ See the Mulan PSL v2 for more details. */
   DEFINE_RC(IOERR_SYNC)                  \
   DEFINE_RC(INCORRECT_DATE_VALUE)        \
   DEFINE_RC(INCORRECT_DATE_FORMAT)       \
+  DEFINE_RC(NUMERIC_OVERFLOW)            \
   DEFINE_RC(INVALID_ARGUMENT)            \
   DEFINE_RC(INVALID_AGGREGATE)           \
   DEFINE_RC(INVALID_GROUPING)            \
@@ -76,6 +77,8 @@ See the Mulan PSL v2 for more details. */
   DEFINE_RC(LOCKED_UNLOCK)               \
   DEFINE_RC(LOCKED_NEED_WAIT)            \
   DEFINE_RC(LOCKED_CONCURRENCY_CONFLICT) \
+  DEFINE_RC(LOCKED_DEADLOCK)             \
+  DEFINE_RC(LOCKED_WAIT_TIMEOUT)         \
   DEFINE_RC(FILE_EXIST)                  \
   DEFINE_RC(FILE_NOT_EXIST)              \
   DEFINE_RC(FILE_NAME)                   \
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "session_event.h"
 #include "net/communicator.h"
+#include "sql/parser/parse_defs.h"
 
 SessionEvent::SessionEvent(Communicator *comm) : communicator_(comm), sql_result_(communicator_->session()) {}
 
@@ -22,3 +23,5 @@ SessionEvent::~SessionEvent() {}
 Communicator *SessionEvent::get_communicator() const { return communicator_; }
 
 Session *SessionEvent::session() const { return communicator_->session(); }
+
+void SessionEvent::set_sql_node(std::unique_ptr<ParsedSqlNode> sql_node) { sql_node_ = std::move(sql_node); }
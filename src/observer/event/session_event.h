@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "event/sql_debug.h"
@@ -21,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 
 class Session;
 class Communicator;
+class ParsedSqlNode;
 
 /**
  * @brief 表示一个SQL请求
@@ -37,13 +39,27 @@ public:
 
   void set_query(const std::string &query) { query_ = query; }
 
+  /**
+   * @brief 设置已经完成语法解析的SQL，比如执行预处理语句时，就不需要再解析query
+   */
+  void                            set_sql_node(std::unique_ptr<ParsedSqlNode> sql_node);
+  std::unique_ptr<ParsedSqlNode> &sql_node() { return sql_node_; }
+
+  /**
+   * @brief 是否按照二进制协议返回结果，执行预处理语句时使用
+   */
+  void set_binary_protocol(bool binary_protocol) { binary_protocol_ = binary_protocol; }
+  bool binary_protocol() const { return binary_protocol_; }
+
   const std::string &query() const { return query_; }
   SqlResult         *sql_result() { return &sql_result_; }
   SqlDebug          &sql_debug() { return sql_debug_; }
 
 private:
-  Communicator *communicator_ = nullptr;  ///< 与客户端通讯的对象
-  SqlResult     sql_result_;              ///< SQL执行结果
-  SqlDebug      sql_debug_;               ///< SQL调试信息
-  std::string   query_;                   ///< SQL语句
+  Communicator                  *communicator_ = nullptr;   ///< 与客户端通讯的对象
+  SqlResult                      sql_result_;               ///< SQL执行结果
+  SqlDebug                       sql_debug_;                ///< SQL调试信息
+  std::string                    query_;                    ///< SQL语句
+  std::unique_ptr<ParsedSqlNode> sql_node_;                 ///< 语法解析后的SQL语句，可能为空
+  bool                           binary_protocol_ = false;  ///< 是否使用二进制协议返回结果
 };
@@ -25,7 +25,7 @@ SQLStageEvent::~SQLStageEvent() noexcept
     session_event_ = nullptr;
   }
 
-  if (stmt_ != nullptr) {
+  if (stmt_ != nullptr && owned_stmt_) {
     delete stmt_;
     stmt_ = nullptr;
   }
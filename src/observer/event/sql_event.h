@@ -42,6 +42,24 @@ public:
   void set_sql(const char *sql) { sql_ = sql; }
   void set_sql_node(std::unique_ptr<ParsedSqlNode> sql_node) { sql_node_ = std::move(sql_node); }
   void set_stmt(Stmt *stmt) { stmt_ = stmt; }
+
+  /**
+   * @brief 设置一个不由当前对象释放的stmt，比如缓存的执行计划中的stmt
+   */
+  void set_borrowed_stmt(Stmt *stmt)
+  {
+    stmt_       = stmt;
+    owned_stmt_ = false;
+  }
+
+  /**
+   * @brief 交出stmt的所有权，之后由调用者负责释放
+   */
+  Stmt *release_stmt()
+  {
+    owned_stmt_ = false;
+    return stmt_;
+  }
   void set_operator(std::unique_ptr<PhysicalOperator> oper) { operator_ = std::move(oper); }
 
 private:
@@ -49,5 +67,6 @@ private:
   std::string                       sql_;             ///< 处理的SQL语句
   std::unique_ptr<ParsedSqlNode>    sql_node_;        ///< 语法解析后的SQL命令
   Stmt                             *stmt_ = nullptr;  ///< Resolver之后生成的数据结构
+  bool                              owned_stmt_ = true;  ///< stmt_是否由当前对象释放
   std::unique_ptr<PhysicalOperator> operator_;        ///< 生成的执行计划，也可能没有
 };
@@ -22,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "net/buffered_writer.h"
 #include "net/mysql_communicator.h"
 #include "sql/operator/string_list_physical_operator.h"
+#include "sql/prepared_stmt/prepared_stmt.h"
 
 using namespace std;
 
@@ -42,6 +43,15 @@ const uint32_t CLIENT_OPTIONAL_RESULTSET_METADATA =
 // Support optional extension for query parameters into the COM_QUERY and COM_STMT_EXECUTE packets.
 // const uint32_t CLIENT_QUERY_ATTRIBUTES = (1UL << 27);
 
+// https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_command_phase.html
+// Text Protocol and Prepared Statements commands
+const int8_t COM_QUERY               = 0x03;
+const int8_t COM_STMT_PREPARE        = 0x16;
+const int8_t COM_STMT_EXECUTE        = 0x17;
+const int8_t COM_STMT_SEND_LONG_DATA = 0x18;
+const int8_t COM_STMT_CLOSE          = 0x19;
+const int8_t COM_STMT_RESET          = 0x1a;
+
 // https://dev.mysql.com/doc/dev/mysql-server/latest/group__group__cs__column__definition__flags.html
 // Column Definition Flags
 // const uint32_t NOT_NULL_FLAG  = 1;
@@ -50,6 +60,10 @@ const uint32_t CLIENT_OPTIONAL_RESULTSET_METADATA =
 // const uint32_t MULTIPLE_KEY_FLAG = 8;
 // const uint32_t NUM_FLAG          = 32768; // Field is num (for clients)
 // const uint32_t PART_KEY_FLAG     = 16384; // Intern; Part of some key.
+const uint32_t BINARY_FLAG = 128;  // Field is binary
+
+// COM_STMT_EXECUTE中参数类型的第二个字节，表示整数是无符号的
+const uint16_t PARAM_UNSIGNED_FLAG = 0x8000;
 
 /**
  * @brief Resultset metadata
@@ -281,6 +295,68 @@ int store_lenenc_string(char *buf, const char *s)
   return pos + len;
 }
 
+/**
+ * @brief 写入一个列定义，不包括包头
+ * @details 结果集的列描述和预处理语句的参数描述都使用这个格式
+ * [Column Definition](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_query_response_text_resultset_column_definition.html)
+ * @param buf   数据缓存，需要能够容纳表名和列名
+ * @param table 表名
+ * @param name  列名
+ * @param type  列的类型 @ref enum_field_types
+ * @return int 写入的字节数
+ * @ingroup MySQLProtocolStore
+ */
+int store_column_definition(char *buf, const char *table, const char *name, int type)
+{
+  const char *catalog          = "def";  // The catalog used. Currently always "def"
+  const char *schema           = "sys";  // schema name
+  int         fixed_len_fields = 0x0c;
+  int         character_set    = 33;
+  int         column_length    = 16384;
+  int16_t     flags            = 0;
+  int8_t      decimals         = 0x1f;
+
+  // 二进制协议中的结果列使用实际的类型，文本协议都是字符串
+  switch (type) {
+    case MYSQL_TYPE_TINY: {
+      column_length = 1;
+      decimals      = 0;
+    } break;
+    case MYSQL_TYPE_LONG: {
+      column_length = 11;
+      decimals      = 0;
+    } break;
+    case MYSQL_TYPE_FLOAT: {
+      column_length = 12;
+    } break;
+    case MYSQL_TYPE_DATE: {
+      column_length = 10;
+      decimals      = 0;
+    } break;
+    default: break;
+  }
+  if (type != MYSQL_TYPE_VAR_STRING) {
+    character_set = 63;  // binary
+    flags |= BINARY_FLAG;
+  }
+
+  int pos = 0;
+  pos += store_lenenc_string(buf + pos, catalog);
+  pos += store_lenenc_string(buf + pos, schema);
+  pos += store_lenenc_string(buf + pos, table);
+  pos += store_lenenc_string(buf + pos, table);  // org_table
+  pos += store_lenenc_string(buf + pos, name);
+  pos += store_lenenc_string(buf + pos, name);  // org_name
+  pos += store_lenenc_int(buf + pos, fixed_len_fields);
+  pos += store_int2(buf + pos, character_set);
+  pos += store_int4(buf + pos, column_length);
+  pos += store_int1(buf + pos, type);
+  pos += store_int2(buf + pos, flags);
+  pos += store_int1(buf + pos, decimals);
+  pos += store_int2(buf + pos, 0);  // 按照mariadb的文档描述，最后还有一个unused字段int<2>，不过mysql的文档没有给出这样的描述
+  return pos;
+}
+
 /**
  * @brief 每个包都有一个包头
  * @details [MySQL Basic Packet](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_basic_packets.html)
@@ -540,6 +616,318 @@ RC decode_query_packet(std::vector<char> &net_packet, QueryPacket &query_packet)
   return RC::SUCCESS;
 }
 
+/**
+ * @brief 按照MySQL协议从数据包中读取数据
+ * @ingroup MySQLProtocol
+ * @details 与store_xxx函数对应，数据包中剩余的数据不够时返回false
+ */
+class PacketDecoder
+{
+public:
+  PacketDecoder(const char *data, size_t size) : data_(data), size_(size) {}
+
+  size_t remain() const { return size_ - pos_; }
+
+  bool fetch_int(int bytes, uint64_t &value)
+  {
+    if (remain() < static_cast<size_t>(bytes)) {
+      return false;
+    }
+    value = 0;
+    memcpy(&value, data_ + pos_, bytes);  // 与store_xxx一样，仅考虑小端
+    pos_ += bytes;
+    return true;
+  }
+
+  bool fetch_lenenc_int(uint64_t &value)
+  {
+    uint64_t first = 0;
+    if (!fetch_int(1, first)) {
+      return false;
+    }
+    switch (first) {
+      case 0xFC: return fetch_int(2, value);
+      case 0xFD: return fetch_int(3, value);
+      case 0xFE: return fetch_int(8, value);
+      default: {
+        value = first;
+        return first < 0xFB;
+      }
+    }
+  }
+
+  bool fetch_string(size_t length, std::string &str)
+  {
+    if (remain() < length) {
+      return false;
+    }
+    str.assign(data_ + pos_, length);
+    pos_ += length;
+    return true;
+  }
+
+  bool fetch_lenenc_string(std::string &str)
+  {
+    uint64_t length = 0;
+    return fetch_lenenc_int(length) && fetch_string(length, str);
+  }
+
+  bool skip(size_t length)
+  {
+    if (remain() < length) {
+      return false;
+    }
+    pos_ += length;
+    return true;
+  }
+
+private:
+  const char *data_ = nullptr;
+  size_t      size_ = 0;
+  size_t      pos_  = 0;
+};
+
+/**
+ * @brief COM_STMT_PREPARE成功时的响应包
+ * @ingroup MySQLProtocol
+ * @details 后面跟着每个参数的描述，结果列的描述在执行时返回。
+ * [COM_STMT_PREPARE Response](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_prepare.html)
+ */
+struct StmtPrepareOkPacket : public BasePacket
+{
+  int8_t   status        = 0;
+  uint32_t statement_id  = 0;
+  uint16_t num_columns   = 0;
+  uint16_t num_params    = 0;
+  int16_t  warning_count = 0;
+
+  StmtPrepareOkPacket(int8_t sequence = 0) : BasePacket(sequence) {}
+  virtual ~StmtPrepareOkPacket() = default;
+
+  RC encode(uint32_t capabilities, std::vector<char> &net_packet) const override
+  {
+    net_packet.resize(32);
+    char *buf = net_packet.data();
+    int   pos = 0;
+
+    pos += 3;  // skip packet length
+    pos += store_int1(buf + pos, packet_header.sequence_id);
+    pos += store_int1(buf + pos, status);
+    pos += store_int4(buf + pos, statement_id);
+    pos += store_int2(buf + pos, num_columns);
+    pos += store_int2(buf + pos, num_params);
+    pos += store_int1(buf + pos, 0);  // reserved
+    pos += store_int2(buf + pos, warning_count);
+    if (capabilities & CLIENT_OPTIONAL_RESULTSET_METADATA) {
+      pos += store_int1(buf + pos, static_cast<int>(ResultSetMetaData::RESULTSET_METADATA_FULL));
+    }
+
+    int payload_length = pos - 4;
+    store_int3(buf, payload_length);
+    net_packet.resize(pos);
+    return RC::SUCCESS;
+  }
+};
+
+/**
+ * @brief 按照客户端指定的类型解析COM_STMT_EXECUTE中的一个参数
+ * @details [Binary Protocol Value](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html)
+ * MiniOB的整数只有4个字节，超出范围的整数返回错误。日期时间类型只保留日期部分。
+ * @ingroup MySQLProtocol
+ */
+RC decode_binary_param(PacketDecoder &decoder, int param_type, Value &value)
+{
+  const bool is_unsigned = (param_type & PARAM_UNSIGNED_FLAG) != 0;
+  const int  type        = param_type & 0xFF;
+
+  uint64_t uint_value = 0;
+  int64_t  int_value  = 0;
+  switch (type) {
+    case MYSQL_TYPE_NULL: {
+      value.set_null();
+      return RC::SUCCESS;
+    }
+
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONGLONG: {
+      int bytes = 8;
+      if (type == MYSQL_TYPE_TINY) {
+        bytes = 1;
+      } else if (type == MYSQL_TYPE_SHORT || type == MYSQL_TYPE_YEAR) {
+        bytes = 2;
+      } else if (type == MYSQL_TYPE_LONG || type == MYSQL_TYPE_INT24) {
+        bytes = 4;
+      }
+      if (!decoder.fetch_int(bytes, uint_value)) {
+        return RC::INVALID_ARGUMENT;
+      }
+
+      if (is_unsigned || bytes == 8) {
+        int_value = static_cast<int64_t>(uint_value);
+      } else {
+        // 有符号数做符号扩展
+        const int shift = 64 - bytes * 8;
+        int_value       = static_cast<int64_t>(uint_value << shift) >> shift;
+      }
+      if ((is_unsigned && bytes == 8 && uint_value > INT32_MAX) || int_value > INT32_MAX || int_value < INT32_MIN) {
+        LOG_WARN("integer param is out of range. value=%ld", int_value);
+        return RC::INVALID_ARGUMENT;
+      }
+      value.set_int(static_cast<int>(int_value));
+    } break;
+
+    case MYSQL_TYPE_FLOAT: {
+      float float_value = 0;
+      if (!decoder.fetch_int(4, uint_value)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(&float_value, &uint_value, sizeof(float_value));
+      value.set_float(float_value);
+    } break;
+
+    case MYSQL_TYPE_DOUBLE: {
+      double double_value = 0;
+      if (!decoder.fetch_int(8, uint_value)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(&double_value, &uint_value, sizeof(double_value));
+      value.set_float(static_cast<float>(double_value));
+    } break;
+
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP: {
+      uint64_t length = 0, year = 0, month = 0, day = 0;
+      if (!decoder.fetch_int(1, length)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      if (length >= 4) {
+        if (!decoder.fetch_int(2, year) || !decoder.fetch_int(1, month) || !decoder.fetch_int(1, day) ||
+            !decoder.skip(length - 4)) {
+          return RC::INVALID_ARGUMENT;
+        }
+      } else if (!decoder.skip(length)) {
+        return RC::INVALID_ARGUMENT;
+      }
+
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%04d-%02d-%02d", (int)year, (int)month, (int)day);
+      value.set_date(buf);
+    } break;
+
+    case MYSQL_TYPE_TIME: {
+      LOG_WARN("time param is not supported");
+      return RC::UNIMPLENMENT;
+    }
+
+    default: {
+      // 字符串、DECIMAL等类型都按照字符串发送
+      std::string str;
+      if (!decoder.fetch_lenenc_string(str)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value.set_string(str.c_str(), static_cast<int>(str.length()));
+    } break;
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 解析COM_STMT_EXECUTE请求中的参数
+ * @details [COM_STMT_EXECUTE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_execute.html)
+ * 没有通告CLIENT_QUERY_ATTRIBUTES，所以参数没有名字。
+ * @param decoder 已经读过了statement_id、flags和iteration_count
+ * @ingroup MySQLProtocol
+ */
+RC decode_stmt_execute_params(PacketDecoder &decoder, PreparedStmt &stmt, std::vector<Value> &params)
+{
+  const int param_count = stmt.param_count();
+  params.clear();
+  if (param_count == 0) {
+    return RC::SUCCESS;
+  }
+
+  std::string null_bitmap;
+  uint64_t    new_params_bound = 0;
+  if (!decoder.fetch_string((param_count + 7) / 8, null_bitmap) || !decoder.fetch_int(1, new_params_bound)) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (new_params_bound) {
+    std::vector<int> param_types(param_count);
+    for (int i = 0; i < param_count; i++) {
+      uint64_t param_type = 0;
+      if (!decoder.fetch_int(2, param_type)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      param_types[i] = static_cast<int>(param_type);
+    }
+    stmt.set_param_types(std::move(param_types));
+  } else if (static_cast<int>(stmt.param_types().size()) != param_count) {
+    LOG_WARN("params are not bound. stmt id=%u", stmt.id());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  params.resize(param_count);
+  for (int i = 0; i < param_count; i++) {
+    Value &value = params[i];
+    if (null_bitmap[i / 8] & (1 << (i % 8))) {
+      value.set_null();
+      continue;
+    }
+
+    // 通过COM_STMT_SEND_LONG_DATA发送过数据的参数，这里不再有值
+    const std::string *long_data = stmt.long_data(i);
+    if (long_data != nullptr) {
+      value.set_string(long_data->c_str(), static_cast<int>(long_data->length()));
+      continue;
+    }
+
+    RC rc = decode_binary_param(decoder, stmt.param_types()[i], value);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to decode param. index=%d, type=%d, rc=%s", i, stmt.param_types()[i], strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 二进制协议中结果列的类型
+ * @ingroup MySQLProtocol
+ * @details 类型不确定的列按照字符串返回
+ */
+int binary_column_type(AttrType attr_type)
+{
+  switch (attr_type) {
+    case AttrType::INTS: return MYSQL_TYPE_LONG;
+    case AttrType::FLOATS: return MYSQL_TYPE_FLOAT;
+    case AttrType::BOOLEANS: return MYSQL_TYPE_TINY;
+    case AttrType::DATES: return MYSQL_TYPE_DATE;
+    default: return MYSQL_TYPE_VAR_STRING;
+  }
+}
+
+/**
+ * @brief 值能否按照二进制协议中列的类型发送
+ * @ingroup MySQLProtocol
+ * @details 只接受不会丢失信息的转换，其它的类型都可以转换成字符串
+ */
+bool binary_column_accepts(int column_type, AttrType attr_type)
+{
+  switch (column_type) {
+    case MYSQL_TYPE_TINY: return attr_type == AttrType::BOOLEANS;
+    case MYSQL_TYPE_LONG: return attr_type == AttrType::INTS;
+    case MYSQL_TYPE_FLOAT: return attr_type == AttrType::FLOATS || attr_type == AttrType::INTS;
+    case MYSQL_TYPE_DATE: return attr_type == AttrType::DATES;
+    default: return true;
+  }
+}
+
 /**
  * @brief MySQL客户端连接时会发起一个"select @@version_comment"的查询，这里对这个查询进行特殊处理
  * @param[out] sql_result 生成的结果
@@ -667,7 +1055,7 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
   LOG_TRACE("recv command from client =%d", command_type);
 
   /// 已经做过握手，接收普通的消息包
-  if (command_type == 0x03) {  // COM_QUERY，这是一个普通的文本请求
+  if (command_type == COM_QUERY) {  // 这是一个普通的文本请求
     QueryPacket query_packet;
     rc = decode_query_packet(buf, query_packet);
     if (rc != RC::SUCCESS) {
@@ -683,6 +1071,13 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
 
     event = new SessionEvent(this);
     event->set_query(query_packet.query);
+  } else if (command_type == COM_STMT_PREPARE) {
+    rc = handle_stmt_prepare(buf);
+  } else if (command_type == COM_STMT_EXECUTE) {
+    rc = handle_stmt_execute(buf, event);
+  } else if (command_type == COM_STMT_SEND_LONG_DATA || command_type == COM_STMT_CLOSE ||
+             command_type == COM_STMT_RESET) {
+    rc = handle_stmt_command(command_type, buf);
   } else {
     /// 其它的非文本请求，暂时不支持
     OkPacket ok_packet(sequence_id_);
@@ -696,6 +1091,156 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
   return rc;
 }
 
+RC MysqlCommunicator::handle_stmt_prepare(std::vector<char> &net_packet)
+{
+  QueryPacket query_packet;
+  RC          rc = decode_query_packet(net_packet, query_packet);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to decode prepare packet. packet length=%ld, addr=%s, rc=%s", net_packet.size(), addr(), strrc(rc));
+    return rc;
+  }
+
+  PreparedStmt *stmt = nullptr;
+  rc                 = session_->add_prepared_stmt(query_packet.query, stmt);
+  if (OB_FAIL(rc)) {
+    return send_error(rc, "failed to prepare statement");
+  }
+
+  LOG_TRACE("prepare statement. id=%u, params=%d, sql=%s", stmt->id(), stmt->param_count(), stmt->sql().c_str());
+
+  // 结果列的描述在执行时返回，这里只返回参数的描述
+  StmtPrepareOkPacket prepare_ok_packet(sequence_id_++);
+  prepare_ok_packet.statement_id = stmt->id();
+  prepare_ok_packet.num_params   = static_cast<uint16_t>(stmt->param_count());
+  rc                             = send_packet(prepare_ok_packet);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to send prepare ok packet. addr=%s, rc=%s", addr(), strrc(rc));
+    return rc;
+  }
+
+  if (stmt->param_count() > 0) {
+    std::vector<char> param_packet(128);
+    for (int i = 0; i < stmt->param_count(); i++) {
+      char *buf = param_packet.data();
+      int   pos = 3;
+      pos += store_int1(buf + pos, sequence_id_++);
+      pos += store_column_definition(buf + pos, "", "?", MYSQL_TYPE_VAR_STRING);
+      store_int3(buf, pos - 4);
+
+      rc = writer_->writen(buf, pos);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to send param definition. addr=%s, rc=%s", addr(), strrc(rc));
+        return rc;
+      }
+    }
+
+    if (!(client_capabilities_flag_ & CLIENT_DEPRECATE_EOF)) {
+      EofPacket eof_packet(sequence_id_++);
+      rc = send_packet(eof_packet);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to send eof packet. addr=%s, rc=%s", addr(), strrc(rc));
+        return rc;
+      }
+    }
+  }
+
+  writer_->flush();
+  return rc;
+}
+
+RC MysqlCommunicator::handle_stmt_execute(std::vector<char> &net_packet, SessionEvent *&event)
+{
+  PacketDecoder decoder(net_packet.data() + 1, net_packet.size() - 1);
+
+  uint64_t stmt_id = 0, flags = 0, iteration_count = 0;
+  if (!decoder.fetch_int(4, stmt_id) || !decoder.fetch_int(1, flags) || !decoder.fetch_int(4, iteration_count)) {
+    return send_error(RC::INVALID_ARGUMENT, "malformed execute packet");
+  }
+
+  PreparedStmt *stmt = session_->find_prepared_stmt(static_cast<uint32_t>(stmt_id));
+  if (nullptr == stmt) {
+    LOG_WARN("no such prepared statement. id=%lu", stmt_id);
+    return send_error(RC::NOTFOUND, "unknown prepared statement handler");
+  }
+
+  // 不支持游标，flags中的游标类型忽略，结果都直接返回
+  std::vector<Value> params;
+  RC                 rc = decode_stmt_execute_params(decoder, *stmt, params);
+  stmt->clear_long_data();
+  if (OB_FAIL(rc)) {
+    return send_error(rc, "malformed execute params");
+  }
+
+  std::string               sql;
+  unique_ptr<ParsedSqlNode> sql_node;
+  rc = stmt->bind(params, sql, sql_node);
+  if (OB_FAIL(rc)) {
+    return send_error(rc, "failed to bind params");
+  }
+
+  LOG_TRACE("execute prepared statement. id=%u, sql=%s", stmt->id(), sql.c_str());
+  event = new SessionEvent(this);
+  event->set_query(sql);
+  event->set_sql_node(std::move(sql_node));
+  event->set_binary_protocol(true);
+  return RC::SUCCESS;
+}
+
+RC MysqlCommunicator::handle_stmt_command(int8_t command_type, std::vector<char> &net_packet)
+{
+  PacketDecoder decoder(net_packet.data() + 1, net_packet.size() - 1);
+
+  uint64_t stmt_id = 0;
+  if (!decoder.fetch_int(4, stmt_id)) {
+    LOG_WARN("malformed statement command. command=%d", command_type);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  PreparedStmt *stmt = session_->find_prepared_stmt(static_cast<uint32_t>(stmt_id));
+
+  // COM_STMT_SEND_LONG_DATA和COM_STMT_CLOSE没有响应
+  if (command_type == COM_STMT_CLOSE) {
+    session_->remove_prepared_stmt(static_cast<uint32_t>(stmt_id));
+    return RC::SUCCESS;
+  }
+
+  if (command_type == COM_STMT_SEND_LONG_DATA) {
+    uint64_t param_id = 0;
+    if (nullptr == stmt || !decoder.fetch_int(2, param_id) || static_cast<int>(param_id) >= stmt->param_count()) {
+      LOG_WARN("invalid long data. stmt id=%lu", stmt_id);
+      return RC::SUCCESS;
+    }
+    stmt->append_long_data(static_cast<int>(param_id), net_packet.data() + 7, static_cast<int>(decoder.remain()));
+    return RC::SUCCESS;
+  }
+
+  // COM_STMT_RESET
+  if (nullptr == stmt) {
+    return send_error(RC::NOTFOUND, "unknown prepared statement handler");
+  }
+  stmt->clear_long_data();
+
+  OkPacket ok_packet(sequence_id_++);
+  RC       rc = send_packet(ok_packet);
+  writer_->flush();
+  return rc;
+}
+
+RC MysqlCommunicator::send_error(RC rc, const char *message)
+{
+  ErrPacket err_packet(sequence_id_++);
+  err_packet.error_code    = static_cast<int>(rc);
+  err_packet.error_message = std::string(strrc(rc)) + " > " + message;
+
+  RC send_rc = send_packet(err_packet);
+  if (OB_FAIL(send_rc)) {
+    LOG_WARN("failed to send err packet. addr=%s, rc=%s", addr(), strrc(send_rc));
+    return send_rc;
+  }
+  writer_->flush();
+  return RC::SUCCESS;
+}
+
 RC MysqlCommunicator::write_state(SessionEvent *event, bool &need_disconnect)
 {
   SqlResult *sql_result = event->sql_result();
@@ -772,10 +1317,16 @@ RC MysqlCommunicator::write_result(SessionEvent *event, bool &need_disconnect)
     const int          cell_num     = tuple_schema.cell_num();
     if (cell_num == 0) {
       // maybe a dml that send nothing to client
+    } else if (event->binary_protocol()) {
+      // 预处理语句的结果使用二进制协议，列描述使用投影表达式的类型
+      rc = send_binary_result_set(sql_result, need_disconnect);
+      RC close_rc = sql_result->close();
+      writer_->flush();
+      return OB_SUCC(rc) ? close_rc : rc;
     } else {
 
       // send metadata : Column Definition
-      rc = send_column_definition(sql_result, need_disconnect);
+      rc = send_column_definition(sql_result, nullptr, need_disconnect);
       if (rc != RC::SUCCESS) {
         sql_result->close();
         return rc;
@@ -821,7 +1372,8 @@ RC MysqlCommunicator::send_packet(const BasePacket &packet)
  * 先发送当前有多少个列
  * 然后发送N个包，告诉客户端每个列的信息
  */
-RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_disconnect)
+RC MysqlCommunicator::send_column_definition(
+    SqlResult *sql_result, const std::vector<int> *column_types, bool &need_disconnect)
 {
   RC rc = RC::SUCCESS;
 
@@ -871,40 +1423,9 @@ RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_d
     store_int1(buf + pos, sequence_id_++);
     pos += 1;
 
-    const TupleCellSpec &spec      = tuple_schema.cell_at(i);
-    const char          *catalog   = "def";  // The catalog used. Currently always "def"
-    const char          *schema    = "sys";  // schema name
-    const char          *table     = spec.table_name();
-    const char          *org_table = spec.table_name();
-    const char          *name      = spec.alias();
-    // const char *org_name = spec.field_name();
-    const char *org_name         = spec.alias();
-    int         fixed_len_fields = 0x0c;
-    int         character_set    = 33;
-    int         column_length    = 16384;
-    int         type             = MYSQL_TYPE_VAR_STRING;
-    int16_t     flags            = 0;
-    int8_t      decimals         = 0x1f;
-
-    pos += store_lenenc_string(buf + pos, catalog);
-    pos += store_lenenc_string(buf + pos, schema);
-    pos += store_lenenc_string(buf + pos, table);
-    pos += store_lenenc_string(buf + pos, org_table);
-    pos += store_lenenc_string(buf + pos, name);
-    pos += store_lenenc_string(buf + pos, org_name);
-    pos += store_lenenc_int(buf + pos, fixed_len_fields);
-    store_int2(buf + pos, character_set);
-    pos += 2;
-    store_int4(buf + pos, column_length);
-    pos += 4;
-    store_int1(buf + pos, type);
-    pos += 1;
-    store_int2(buf + pos, flags);
-    pos += 2;
-    store_int1(buf + pos, decimals);
-    pos += 1;
-    store_int2(buf + pos, 0);  // 按照mariadb的文档描述，最后还有一个unused字段int<2>，不过mysql的文档没有给出这样的描述
-    pos += 2;
+    const TupleCellSpec &spec = tuple_schema.cell_at(i);
+    const int            type = column_types != nullptr ? (*column_types)[i] : MYSQL_TYPE_VAR_STRING;
+    pos += store_column_definition(buf + pos, spec.table_name(), spec.alias(), type);
 
     payload_length = pos - 4;
     store_int3(buf, payload_length);
@@ -991,21 +1512,167 @@ RC MysqlCommunicator::send_result_rows(SqlResult *sql_result, bool no_column_def
     }
   }
 
+  rc = send_result_end(no_column_def, affected_rows);
+  LOG_TRACE("send rows to client done");
+  need_disconnect = false;
+  return rc;
+}
+
+RC MysqlCommunicator::send_result_end(bool no_column_def, int affected_rows)
+{
   // 所有行发送完成后，发送一个EOF或OK包
   if ((client_capabilities_flag_ & CLIENT_DEPRECATE_EOF) || no_column_def) {
     LOG_TRACE("client has CLIENT_DEPRECATE_EOF or has empty column, send ok packet");
     OkPacket ok_packet;
     ok_packet.packet_header.sequence_id = sequence_id_++;
     ok_packet.affected_rows             = affected_rows;
-    rc                                  = send_packet(ok_packet);
-  } else {
-    LOG_TRACE("send eof packet to client");
-    EofPacket eof_packet;
-    eof_packet.packet_header.sequence_id = sequence_id_++;
-    rc                                   = send_packet(eof_packet);
+    return send_packet(ok_packet);
+  }
+
+  LOG_TRACE("send eof packet to client");
+  EofPacket eof_packet;
+  eof_packet.packet_header.sequence_id = sequence_id_++;
+  return send_packet(eof_packet);
+}
+
+/**
+ * 按照二进制协议发送结果集
+ *  https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html
+ *
+ * 列描述与文本协议相同，只是每列使用投影表达式的类型，类型不确定的列按照字符串返回。
+ * 某个值不能按照列的类型发送时，不截断数据，而是发送错误包结束这个结果集。
+ */
+RC MysqlCommunicator::send_binary_result_set(SqlResult *sql_result, bool &need_disconnect)
+{
+  const TupleSchema &tuple_schema = sql_result->tuple_schema();
+  const int          cell_num     = tuple_schema.cell_num();
+
+  std::vector<int> column_types(cell_num);
+  for (int i = 0; i < cell_num; i++) {
+    column_types[i] = binary_column_type(tuple_schema.cell_type(i));
+  }
+
+  RC rc = send_column_definition(sql_result, &column_types, need_disconnect);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  std::vector<Value> row(cell_num);
+  Tuple             *tuple         = nullptr;
+  int                affected_rows = 0;
+  while (OB_SUCC(rc = sql_result->next_tuple(tuple))) {
+    for (int i = 0; i < cell_num && OB_SUCC(rc); i++) {
+      rc = tuple->cell_at(i, row[i]);
+    }
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    bool io_error = false;
+    rc            = send_binary_row(row, column_types, io_error);
+    if (io_error) {
+      LOG_WARN("failed to send row packet to client. addr=%s, error=%s", addr(), strerror(errno));
+      need_disconnect = true;
+      return rc;
+    }
+    if (OB_FAIL(rc)) {
+      break;
+    }
+    affected_rows++;
   }
 
-  LOG_TRACE("send rows to client done");
   need_disconnect = false;
+  if (rc != RC::RECORD_EOF) {
+    sql_result->set_return_code(rc);
+    RC send_rc = send_error(rc, "failed to send binary result set");
+    if (OB_FAIL(send_rc)) {
+      need_disconnect = true;
+      return send_rc;
+    }
+    return rc;
+  }
+
+  return send_result_end(false, affected_rows);
+}
+
+/**
+ * 发送一行二进制协议的数据
+ *  https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html#sect_protocol_binary_resultset_row
+ *
+ * 包头之后是0x00，然后是NULL位图，位图的前两位保留不用，最后是所有非NULL的值。
+ * 值的类型与列的类型不匹配时返回SCHEMA_FIELD_TYPE_MISMATCH，这时什么都没有发送。
+ */
+RC MysqlCommunicator::send_binary_row(
+    const std::vector<Value> &row, const std::vector<int> &column_types, bool &io_error)
+{
+  const int cell_num      = static_cast<int>(row.size());
+  const int bitmap_offset = 5;
+  const int bitmap_size   = (cell_num + 7 + 2) / 8;
+
+  io_error = false;
+  for (int i = 0; i < cell_num; i++) {
+    const AttrType attr_type = row[i].attr_type();
+    if (attr_type != AttrType::NULLS && !binary_column_accepts(column_types[i], attr_type)) {
+      LOG_WARN("value type mismatch with binary column type. column=%d, column type=%d, value type=%s",
+               i, column_types[i], attr_type_to_string(attr_type));
+      return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+    }
+  }
+
+  std::vector<char> &packet = row_packet_;
+  packet.assign(bitmap_offset + bitmap_size, 0);
+  int pos = 4;
+  pos += store_int1(packet.data() + pos, 0);
+  pos += bitmap_size;
+
+  std::string str;
+  for (int i = 0; i < cell_num; i++) {
+    const Value &value = row[i];
+    if (value.attr_type() == AttrType::NULLS) {
+      packet[bitmap_offset + (i + 2) / 8] |= static_cast<char>(1 << ((i + 2) % 8));
+      continue;
+    }
+
+    switch (column_types[i]) {
+      case MYSQL_TYPE_TINY: {
+        packet.resize(pos + 1);
+        pos += store_int1(packet.data() + pos, value.get_boolean() ? 1 : 0);
+      } break;
+
+      case MYSQL_TYPE_LONG: {
+        packet.resize(pos + 4);
+        pos += store_int4(packet.data() + pos, value.get_int());
+      } break;
+
+      case MYSQL_TYPE_FLOAT: {
+        const float float_value = value.get_float();
+        packet.resize(pos + sizeof(float_value));
+        memcpy(packet.data() + pos, &float_value, sizeof(float_value));
+        pos += sizeof(float_value);
+      } break;
+
+      case MYSQL_TYPE_DATE: {
+        packet.resize(pos + 5);
+        int date = 0;
+        memcpy(&date, value.data(), sizeof(date));
+        pos += store_int1(packet.data() + pos, 4);
+        pos += store_int2(packet.data() + pos, date / 10000);
+        pos += store_int1(packet.data() + pos, (date % 10000) / 100);
+        pos += store_int1(packet.data() + pos, date % 100);
+      } break;
+
+      default: {
+        str = value.to_string();
+        packet.resize(pos + 9 + str.length());
+        pos += store_lenenc_int(packet.data() + pos, str.length());
+        pos += store_fix_length_string(packet.data() + pos, str.data(), static_cast<int>(str.length()));
+      } break;
+    }
+  }
+
+  store_int3(packet.data(), pos - 4);
+  store_int1(packet.data() + 3, sequence_id_++);
+  RC rc = writer_->writen(packet.data(), pos);
+  io_error = OB_FAIL(rc);
   return rc;
 }
@@ -14,10 +14,13 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <vector>
+
 #include "net/communicator.h"
 
 class SqlResult;
 class BasePacket;
+class Value;
 
 /**
  * @brief 与客户端通讯
@@ -70,8 +73,9 @@ private:
    * @brief 返回客户端列描述信息
    * @details 根据MySQL text protocol 描述，普通的结果分为列信息描述和行数据。
    * 这里就分为两个函数
+   * @param column_types 每一列的类型，为空时都是字符串
    */
-  RC send_column_definition(SqlResult *sql_result, bool &need_disconnect);
+  RC send_column_definition(SqlResult *sql_result, const std::vector<int> *column_types, bool &need_disconnect);
 
   /**
    * @brief 返回客户端行数据
@@ -83,6 +87,44 @@ private:
    */
   RC send_result_rows(SqlResult *sql_result, bool no_column_def, bool &need_disconnect);
 
+  /**
+   * @brief 所有行发送完成后，发送一个EOF或OK包
+   */
+  RC send_result_end(bool no_column_def, int affected_rows);
+
+  /**
+   * @brief 按照二进制协议返回结果集，用于预处理语句
+   */
+  RC send_binary_result_set(SqlResult *sql_result, bool &need_disconnect);
+
+  /**
+   * @param[out] io_error 是否是发送数据失败，值与列的类型不匹配时不会发送任何数据
+   */
+  RC send_binary_row(const std::vector<Value> &row, const std::vector<int> &column_types, bool &io_error);
+
+  /**
+   * @brief 创建预处理语句，返回语句ID和参数描述
+   * @details [COM_STMT_PREPARE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_prepare.html)
+   */
+  RC handle_stmt_prepare(std::vector<char> &net_packet);
+
+  /**
+   * @brief 执行预处理语句，绑定参数之后生成一个普通的请求
+   * @details [COM_STMT_EXECUTE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_execute.html)
+   * @param[out] event 参数正确时生成的请求
+   */
+  RC handle_stmt_execute(std::vector<char> &net_packet, SessionEvent *&event);
+
+  /**
+   * @brief 处理COM_STMT_SEND_LONG_DATA、COM_STMT_CLOSE和COM_STMT_RESET
+   */
+  RC handle_stmt_command(int8_t command_type, std::vector<char> &net_packet);
+
+  /**
+   * @brief 在请求进入SQL处理流程之前出错时，直接返回一个ERR包
+   */
+  RC send_error(RC rc, const char *message);
+
   /**
    * @brief 根据实际测试，客户端在连接上来时，会发起一个 version_comment的查询
    * @details 这里就针对这个查询返回一个结果
@@ -99,4 +141,7 @@ private:
   //! 在一次通讯过程中(一个任务的请求与处理)，每个包(packet)都有一个sequence id
   //! 这个sequence id是递增的
   int8_t sequence_id_ = 0;
+
+  //! 发送二进制协议的行数据时复用的缓存
+  std::vector<char> row_packet_;
 };
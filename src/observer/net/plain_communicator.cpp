@@ -309,6 +309,12 @@ RC PlainCommunicator::write_result_internal(SessionEvent *event, bool &need_disc
 
   if (rc == RC::RECORD_EOF) {
     rc = RC::SUCCESS;
+  } else if (OB_FAIL(rc) && cell_num != 0) {
+    LOG_WARN("failed to get next tuple. rc=%s", strrc(rc));
+    event->sql_result()->set_return_code(rc);
+    write_state(event, need_disconnect);
+    sql_result->close();
+    return rc;
   }
 
   if (cell_num == 0) {
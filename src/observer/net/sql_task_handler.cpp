@@ -33,6 +33,7 @@ RC SqlTaskHandler::handle_event(Communicator *communicator)
   session_stage_.handle_request2(event);
 
   SQLStageEvent sql_event(event, event->query());
+  sql_event.set_sql_node(std::move(event->sql_node()));
 
   (void)handle_sql(&sql_event);
 
@@ -60,21 +61,50 @@ RC SqlTaskHandler::handle_sql(SQLStageEvent *sql_event)
     return rc;
   }
 
-  rc = parse_stage_.handle_request(sql_event);
-  if (OB_FAIL(rc)) {
-    LOG_TRACE("failed to do parse. rc=%s", strrc(rc));
+  // 命中查询结果缓存时，直接输出缓存的结果
+  if (sql_event->session_event()->sql_result()->has_operator()) {
     return rc;
   }
 
-  rc = resolve_stage_.handle_request(sql_event);
+  rc = plan_cache_stage_.handle_request(sql_event);
   if (OB_FAIL(rc)) {
-    LOG_TRACE("failed to do resolve. rc=%s", strrc(rc));
+    LOG_TRACE("failed to do plan cache. rc=%s", strrc(rc));
     return rc;
   }
 
-  rc = optimize_stage_.handle_request(sql_event);
-  if (rc != RC::UNIMPLENMENT && rc != RC::SUCCESS) {
-    LOG_TRACE("failed to do optimize. rc=%s", strrc(rc));
+  // 命中执行计划缓存时，直接执行缓存的计划
+  if (!sql_event->physical_operator()) {
+    // 执行预处理语句时已经有语法树了
+    if (!sql_event->sql_node()) {
+      rc = parse_stage_.handle_request(sql_event);
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("failed to do parse. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+
+    rc = resolve_stage_.handle_request(sql_event);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to do resolve. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = optimize_stage_.handle_request(sql_event);
+    if (rc != RC::UNIMPLENMENT && rc != RC::SUCCESS) {
+      LOG_TRACE("failed to do optimize. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = plan_cache_stage_.cache_plan(sql_event);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to cache plan. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = query_cache_stage_.cache_result(sql_event);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to cache query result. rc=%s", strrc(rc));
     return rc;
   }
 
@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "session/session.h"
 #include "common/global_context.h"
+#include "common/log/log.h"
+#include "sql/prepared_stmt/prepared_stmt.h"
 #include "storage/db/db.h"
 #include "storage/default/default_handler.h"
 #include "storage/trx/trx.h"
@@ -24,6 +26,8 @@ Session &Session::default_session()
   return session;
 }
 
+Session::Session() = default;
+
 Session::Session(const Session &other) : db_(other.db_) {}
 
 Session::~Session()
@@ -85,3 +89,26 @@ Session *Session::current_session() { return thread_session; }
 void Session::set_current_request(SessionEvent *request) { current_request_ = request; }
 
 SessionEvent *Session::current_request() const { return current_request_; }
+
+RC Session::add_prepared_stmt(const std::string &sql, PreparedStmt *&stmt)
+{
+  auto prepared_stmt = std::make_unique<PreparedStmt>(next_prepared_stmt_id_, sql);
+  RC   rc            = prepared_stmt->init();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init prepared statement. sql=%s, rc=%s", sql.c_str(), strrc(rc));
+    return rc;
+  }
+
+  next_prepared_stmt_id_++;
+  stmt = prepared_stmt.get();
+  prepared_stmts_.emplace(stmt->id(), std::move(prepared_stmt));
+  return RC::SUCCESS;
+}
+
+PreparedStmt *Session::find_prepared_stmt(uint32_t stmt_id) const
+{
+  auto iter = prepared_stmts_.find(stmt_id);
+  return iter == prepared_stmts_.end() ? nullptr : iter->second.get();
+}
+
+void Session::remove_prepared_stmt(uint32_t stmt_id) { prepared_stmts_.erase(stmt_id); }
@@ -14,11 +14,17 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+
+#include "common/rc.h"
 
 class Trx;
 class Db;
 class SessionEvent;
+class PreparedStmt;
 
 /**
  * @brief 表示会话
@@ -34,7 +40,7 @@ public:
   static Session &default_session();
 
 public:
-  Session() = default;
+  Session();
   ~Session();
 
   Session(const Session &other);
@@ -79,6 +85,34 @@ public:
   void set_sql_debug(bool sql_debug) { sql_debug_ = sql_debug; }
   bool sql_debug_on() const { return sql_debug_; }
 
+  void   set_hash_join_memory_limit(size_t limit) { hash_join_memory_limit_ = limit; }
+  size_t hash_join_memory_limit() const { return hash_join_memory_limit_; }
+
+  void   set_sort_memory_limit(size_t limit) { sort_memory_limit_ = limit; }
+  size_t sort_memory_limit() const { return sort_memory_limit_; }
+
+  void set_vectorized_execution(bool enable) { vectorized_execution_ = enable; }
+  bool vectorized_execution() const { return vectorized_execution_; }
+
+  void set_plan_cache(bool enable) { plan_cache_ = enable; }
+  bool plan_cache() const { return plan_cache_; }
+
+  void set_query_cache(bool enable) { query_cache_ = enable; }
+  bool query_cache() const { return query_cache_; }
+
+  /**
+   * @brief 创建一个预处理语句，语句ID在当前会话中唯一
+   */
+  RC add_prepared_stmt(const std::string &sql, PreparedStmt *&stmt);
+
+  /**
+   * @brief 查找预处理语句
+   * @return 没有找到时返回nullptr
+   */
+  PreparedStmt *find_prepared_stmt(uint32_t stmt_id) const;
+
+  void remove_prepared_stmt(uint32_t stmt_id);
+
   /**
    * @brief 将指定会话设置到线程变量中
    *
@@ -99,4 +133,14 @@ private:
   bool trx_multi_operation_mode_ = false;  ///< 当前事务的模式，是否多语句模式. 单语句模式自动提交
 
   bool sql_debug_ = false;  ///< 是否输出SQL调试信息
+
+  size_t hash_join_memory_limit_ = 64 * 1024 * 1024;  ///< 单个hash join算子可以使用的内存，超过后落盘
+  size_t sort_memory_limit_      = 64 * 1024 * 1024;  ///< 单个排序算子可以使用的内存，超过后落盘
+
+  bool vectorized_execution_ = true;   ///< 是否按chunk批量执行扫描、过滤、投影和聚合
+  bool plan_cache_           = true;   ///< SELECT语句是否使用执行计划缓存
+  bool query_cache_          = false;  ///< 自动提交的SELECT语句是否使用查询结果缓存
+
+  std::unordered_map<uint32_t, std::unique_ptr<PreparedStmt>> prepared_stmts_;  ///< 当前会话的预处理语句
+  uint32_t next_prepared_stmt_id_ = 1;
 };
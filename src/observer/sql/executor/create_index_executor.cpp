@@ -17,7 +17,9 @@ See the Mulan PSL v2 for more details. */
 #include "event/session_event.h"
 #include "event/sql_event.h"
 #include "session/session.h"
+#include "sql/plan_cache/plan_cache.h"
 #include "sql/stmt/create_index_stmt.h"
+#include "storage/db/db.h"
 #include "storage/table/table.h"
 
 RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
@@ -32,5 +34,10 @@ RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 
   Trx   *trx   = session->current_trx();
   Table *table = create_index_stmt->table();
-  return table->create_index(trx, create_index_stmt->field_meta(), create_index_stmt->index_name().c_str(), false);
+  RC     rc    = table->create_index(trx, create_index_stmt->field_meta(), create_index_stmt->index_name().c_str(), false);
+  if (OB_SUCC(rc)) {
+    // 有了新的索引，缓存的执行计划可能不再是最优的
+    table->db()->plan_cache().invalidate();
+  }
+  return rc;
 }
\ No newline at end of file
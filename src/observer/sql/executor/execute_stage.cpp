@@ -66,15 +66,19 @@ RC ExecuteStage::handle_request_with_physical_operator(SQLStageEvent *sql_event)
   switch (stmt->type()) {
     case StmtType::SELECT: {
       SelectStmt *select_stmt = static_cast<SelectStmt *>(stmt);
-      for (const auto &tuple_cell : select_stmt->tuple_schema()) {
+      const vector<AttrType> &value_types = select_stmt->tuple_value_types();
+      for (size_t i = 0; i < select_stmt->tuple_schema().size(); i++) {
+        const TupleCellSpec &tuple_cell = select_stmt->tuple_schema()[i];
 
+        // 投影列的类型，二进制协议按照它声明列的类型
+        const AttrType type = i < value_types.size() ? value_types[i] : AttrType::UNDEFINED;
         if (strlen(tuple_cell.alias()) != 0) {
-          schema.append_cell(tuple_cell.alias());
+          schema.append_cell(tuple_cell.alias(), type);
         } else if (select_stmt->table_descs().size() <= 1) {
-          schema.append_cell(tuple_cell.field_name());
+          schema.append_cell(tuple_cell.field_name(), type);
         } else {
           string str = std::string(tuple_cell.table_name()) + "." + tuple_cell.field_name();
-          schema.append_cell(str.c_str());
+          schema.append_cell(str.c_str(), type);
         }
       }
     } break;
@@ -48,14 +48,69 @@ public:
 
       session->set_sql_debug(bool_value);
       LOG_TRACE("set sql_debug to %d", bool_value);
+    } else if (strcasecmp(var_name, "hash_join_memory_limit") == 0) {
+      int64_t int_value = 0;
+      rc                = var_value_to_positive_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_hash_join_memory_limit(static_cast<size_t>(int_value));
+      LOG_TRACE("set hash_join_memory_limit to %ld", int_value);
+    } else if (strcasecmp(var_name, "sort_memory_limit") == 0) {
+      int64_t int_value = 0;
+      rc                = var_value_to_positive_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_sort_memory_limit(static_cast<size_t>(int_value));
+      LOG_TRACE("set sort_memory_limit to %ld", int_value);
+    } else if (strcasecmp(var_name, "vectorized_execution") == 0) {
+      bool bool_value = false;
+      rc              = var_value_to_boolean(var_value, bool_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_vectorized_execution(bool_value);
+      LOG_TRACE("set vectorized_execution to %d", bool_value);
+    } else if (strcasecmp(var_name, "plan_cache") == 0) {
+      bool bool_value = false;
+      rc              = var_value_to_boolean(var_value, bool_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_plan_cache(bool_value);
+      LOG_TRACE("set plan_cache to %d", bool_value);
+    } else if (strcasecmp(var_name, "query_cache") == 0) {
+      bool bool_value = false;
+      rc              = var_value_to_boolean(var_value, bool_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_query_cache(bool_value);
+      LOG_TRACE("set query_cache to %d", bool_value);
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
 
-    return RC::SUCCESS;
+    return rc;
   }
 
 private:
+  RC var_value_to_positive_int(const Value &var_value, int64_t &int_value) const
+  {
+    if (var_value.attr_type() != AttrType::INTS || var_value.get_int() <= 0) {
+      return RC::VARIABLE_NOT_VALID;
+    }
+
+    int_value = var_value.get_int();
+    return RC::SUCCESS;
+  }
+
   RC var_value_to_boolean(const Value &var_value, bool &bool_value) const
   {
     RC rc = RC::SUCCESS;
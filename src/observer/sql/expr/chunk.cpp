@@ -0,0 +1,250 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/chunk.h"
+#include "sql/expr/vector_kernels.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+void Column::reset(AttrType type, int width)
+{
+  assert(width > 0);
+  type_     = type;
+  width_    = width;
+  count_    = 0;
+  constant_ = false;
+  data_.clear();
+  nulls_.clear();
+  values_.clear();
+}
+
+void Column::reset_values()
+{
+  type_     = AttrType::UNDEFINED;
+  width_    = 0;
+  count_    = 0;
+  constant_ = false;
+  data_.clear();
+  nulls_.clear();
+  values_.clear();
+}
+
+void Column::reset_constant(const Value &value)
+{
+  switch (value.attr_type()) {
+    case INTS:
+    case FLOATS:
+    case DATES: {
+      reset(value.attr_type(), sizeof(int32_t));
+    } break;
+    case BOOLEANS: {
+      reset(value.attr_type(), 1);
+    } break;
+    default: {
+      reset_values();
+    } break;
+  }
+  append_value(value);
+  constant_ = true;
+}
+
+void Column::resize(int count)
+{
+  assert(is_fixed());
+  data_.resize(static_cast<size_t>(count) * width_, 0);
+  nulls_.resize(count, 0);
+  count_ = count;
+}
+
+void Column::append_fixed(const char *data, bool is_null)
+{
+  assert(is_fixed());
+  data_.insert(data_.end(), data, data + width_);
+  nulls_.push_back(is_null ? 1 : 0);
+  count_++;
+}
+
+void Column::append_value(const Value &value)
+{
+  const bool is_null = value.attr_type() == AttrType::NULLS;
+  if (!is_fixed()) {
+    values_.push_back(value);
+    nulls_.push_back(is_null ? 1 : 0);
+    count_++;
+    return;
+  }
+
+  const size_t offset = data_.size();
+  data_.resize(offset + width_, 0);
+  nulls_.push_back(is_null ? 1 : 0);
+  count_++;
+  if (is_null) {
+    return;
+  }
+
+  assert(value.attr_type() == type_);
+  char *dst = data_.data() + offset;
+  switch (type_) {
+    case BOOLEANS: {
+      dst[0] = value.get_boolean() ? 1 : 0;
+    } break;
+    case CHARS: {
+      memcpy(dst, value.data(), min(value.length(), width_));
+    } break;
+    default: {
+      memcpy(dst, value.data(), width_);
+    } break;
+  }
+}
+
+void Column::get_value(int row, Value &value) const
+{
+  const int i = index(row);
+  if (nulls_[i]) {
+    value.set_null();
+    return;
+  }
+
+  if (!is_fixed()) {
+    value = values_[i];
+    return;
+  }
+
+  const char *src = data_.data() + static_cast<size_t>(i) * width_;
+  switch (type_) {
+    case BOOLEANS: {
+      value.set_boolean(src[0] != 0);
+    } break;
+    case CHARS: {
+      value.set_string(src, width_);
+    } break;
+    default: {
+      value.set_type(type_);
+      value.set_data(const_cast<char *>(src), width_);
+    } break;
+  }
+}
+
+void Column::select(const vector<int> &selection)
+{
+  if (constant_) {
+    return;
+  }
+
+  const int new_count = static_cast<int>(selection.size());
+  for (int i = 0; i < new_count; i++) {
+    const int from = selection[i];
+    if (from == i) {
+      continue;
+    }
+    nulls_[i] = nulls_[from];
+    if (is_fixed()) {
+      memcpy(data_.data() + static_cast<size_t>(i) * width_, data_.data() + static_cast<size_t>(from) * width_, width_);
+    } else {
+      values_[i] = std::move(values_[from]);
+    }
+  }
+
+  nulls_.resize(new_count);
+  if (is_fixed()) {
+    data_.resize(static_cast<size_t>(new_count) * width_);
+  } else {
+    values_.resize(new_count);
+  }
+  count_ = new_count;
+}
+
+void Column::collect_true(int rows, vector<int> &selection) const
+{
+  selection.clear();
+  if (is_fixed() && type_ == BOOLEANS) {
+    if (constant_) {
+      if (data_[0] != 0 && nulls_[0] == 0) {
+        for (int row = 0; row < rows; row++) {
+          selection.push_back(row);
+        }
+      }
+      return;
+    }
+
+    selection.resize(rows);
+    const int selected =
+        VectorKernels::select(reinterpret_cast<const uint8_t *>(data_.data()), nulls_.data(), rows, selection.data());
+    selection.resize(selected);
+    return;
+  }
+
+  Value value;
+  for (int row = 0; row < rows; row++) {
+    get_value(row, value);
+    try {
+      if (value.get_boolean()) {
+        selection.push_back(row);
+      }
+    } catch (null_cast_exception) {
+      // null as false
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Chunk::reset()
+{
+  specs_.clear();
+  columns_.clear();
+  rows_ = 0;
+}
+
+void Chunk::add_column(const TupleCellSpec &spec, shared_ptr<Column> column)
+{
+  specs_.push_back(spec);
+  columns_.push_back(std::move(column));
+}
+
+int Chunk::find_column(const TupleCellSpec &spec) const
+{
+  if (spec.alias()[0] != '\0') {
+    for (size_t i = 0; i < specs_.size(); i++) {
+      if (0 == strcmp(spec.alias(), specs_[i].alias())) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+
+  if (spec.field_name()[0] != '\0') {
+    for (size_t i = 0; i < specs_.size(); i++) {
+      if (0 == strcmp(spec.table_name(), specs_[i].table_name()) &&
+          0 == strcmp(spec.field_name(), specs_[i].field_name())) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+  return -1;
+}
+
+void Chunk::select(const vector<int> &selection)
+{
+  if (static_cast<int>(selection.size()) == rows_) {
+    return;
+  }
+
+  for (size_t i = 0; i < columns_.size(); i++) {
+    // 同一个列可能在chunk中出现多次，只能处理一次
+    auto iter = find(columns_.begin(), columns_.begin() + i, columns_[i]);
+    if (iter == columns_.begin() + i) {
+      columns_[i]->select(selection);
+    }
+  }
+  rows_ = static_cast<int>(selection.size());
+}
@@ -0,0 +1,157 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sql/expr/tuple_cell.h"
+#include "sql/parser/value.h"
+
+/**
+ * @brief 列存格式的一列数据，向量化执行时使用
+ * @ingroup Tuple
+ * @details 有两种存储方式：
+ * 定长的列(INTS/FLOATS/DATES/BOOLEANS/CHARS)把所有值连续存放在一块内存中，每个值占width字节，
+ * 计算时可以直接按照数组访问；其它情况(TEXTS、类型不确定的表达式结果)每个值保存为一个Value。
+ * 不管哪种方式，NULL都单独记录在nulls中，每行一个字节。
+ *
+ * 常量列只保存一个值，表示每一行都是这个值，用于ValueExpr等不依赖行的表达式。
+ */
+class Column
+{
+public:
+  Column() = default;
+  Column(AttrType type, int width) { reset(type, width); }
+
+  /**
+   * @brief 清空数据，变成定长的列
+   * @details BOOLEANS每个值占1个字节，其它类型的width与字段长度一致
+   */
+  void reset(AttrType type, int width);
+
+  /**
+   * @brief 清空数据，变成每个值是一个Value的列
+   */
+  void reset_values();
+
+  /**
+   * @brief 清空数据，变成常量列
+   */
+  void reset_constant(const Value &value);
+
+  bool     is_fixed() const { return width_ > 0; }
+  bool     is_constant() const { return constant_; }
+  AttrType type() const { return type_; }
+  int      width() const { return width_; }
+  int      count() const { return count_; }
+
+  /**
+   * @brief 常量列的任何一行都对应第0个值
+   */
+  int index(int row) const { return constant_ ? 0 : row; }
+
+  /**
+   * @brief 调整定长列的行数，新的行不是NULL，数据是0
+   */
+  void resize(int count);
+
+  template <typename T>
+  T *data()
+  {
+    return reinterpret_cast<T *>(data_.data());
+  }
+  template <typename T>
+  const T *data() const
+  {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  uint8_t       *nulls() { return nulls_.data(); }
+  const uint8_t *nulls() const { return nulls_.data(); }
+  bool           is_null(int row) const { return nulls_[index(row)] != 0; }
+
+  /**
+   * @brief 在最后追加一个值
+   * @details 定长的列只能追加NULL或者类型相同的值
+   */
+  void append_value(const Value &value);
+
+  /**
+   * @brief 追加一个定长的值，data指向width字节
+   */
+  void append_fixed(const char *data, bool is_null);
+
+  void get_value(int row, Value &value) const;
+
+  /**
+   * @brief 把值为true的行号放到selection中，NULL当作false
+   * @details 用于过滤条件的计算结果
+   */
+  void collect_true(int rows, std::vector<int> &selection) const;
+
+  /**
+   * @brief 只保留selection中的行，selection是递增的行号
+   */
+  void select(const std::vector<int> &selection);
+
+private:
+  AttrType             type_     = AttrType::UNDEFINED;
+  int                  width_    = 0;  ///< 0 表示每个值是一个Value
+  int                  count_    = 0;
+  bool                 constant_ = false;
+  std::vector<char>    data_;
+  std::vector<uint8_t> nulls_;
+  std::vector<Value>   values_;
+};
+
+/**
+ * @brief 一批行的列存数据，向量化执行时算子之间传递的单位
+ * @ingroup Tuple
+ * @details 每一列带有一个TupleCellSpec，与Tuple::find_cell的规则一样，可以按照别名或者表名+字段名查找。
+ * 列使用shared_ptr保存，字段表达式可以直接引用chunk中的列，不需要复制数据。
+ */
+class Chunk
+{
+public:
+  /// 每个chunk最多的行数
+  static constexpr int MAX_ROWS = 1024;
+
+  Chunk() = default;
+
+  void reset();
+
+  void add_column(const TupleCellSpec &spec, std::shared_ptr<Column> column);
+
+  int  column_num() const { return static_cast<int>(columns_.size()); }
+  int  rows() const { return rows_; }
+  void set_rows(int rows) { rows_ = rows; }
+
+  const std::shared_ptr<Column> &column(int index) const { return columns_[index]; }
+  const TupleCellSpec           &spec(int index) const { return specs_[index]; }
+
+  /**
+   * @brief 查找列的位置
+   * @return 找不到时返回-1
+   */
+  int find_column(const TupleCellSpec &spec) const;
+
+  /**
+   * @brief 只保留selection中的行
+   */
+  void select(const std::vector<int> &selection);
+
+private:
+  std::vector<TupleCellSpec>           specs_;
+  std::vector<std::shared_ptr<Column>> columns_;
+  int                                  rows_ = 0;
+};
@@ -16,28 +16,165 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "common/rc.h"
 #include "sql/expr/tuple.h"
+#include "sql/expr/vector_kernels.h"
 #include "sql/parser/defs/comp_op.h"
 #include "sql/parser/value.h"
 #include <cassert>
 #include <regex>
 #include <sstream>
 #include <set>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
+/**
+ * @brief 获取保存计算结果的列，column没有被其它地方引用时复用它
+ */
+static Column &prepare_column(shared_ptr<Column> &column)
+{
+  if (!column || column.use_count() > 1) {
+    column = make_shared<Column>();
+  }
+  return *column;
+}
+
+static bool is_number_column(const Column &column)
+{
+  return column.is_fixed() && (column.type() == INTS || column.type() == FLOATS || column.type() == DATES);
+}
+
+static int column_step(const Column &column) { return column.is_constant() ? 0 : 1; }
+
+/**
+ * @brief 获取数值列中rows个T类型的值
+ * @details 列的类型与T一致并且不是常量列时直接返回列中的数据，否则转换到buffer中，常量会展开成rows个值，
+ * 这样计算时只需要处理两个数组逐个元素运算的情况
+ */
+template <typename T>
+static const T *column_numbers(const Column &column, int rows, vector<T> &buffer)
+{
+  const bool is_float = column.type() == FLOATS;
+  if (!column.is_constant() && is_float == is_same_v<T, float> && (is_same_v<T, float> || is_same_v<T, int32_t>)) {
+    return column.data<T>();
+  }
+
+  buffer.resize(rows);
+  const int step = column_step(column);
+  if (is_float) {
+    const float *data = column.data<float>();
+    for (int i = 0; i < rows; i++) {
+      buffer[i] = static_cast<T>(data[i * step]);
+    }
+  } else {
+    const int32_t *data = column.data<int32_t>();
+    for (int i = 0; i < rows; i++) {
+      buffer[i] = static_cast<T>(data[i * step]);
+    }
+  }
+  return buffer.data();
+}
+
+/**
+ * @brief 两个列中只要有一个是NULL，结果就是NULL
+ */
+static void merge_nulls(const Column &left, const Column *right, int rows, uint8_t *nulls)
+{
+  const uint8_t *left_nulls = left.nulls();
+  const int      left_step  = column_step(left);
+  if (right == nullptr) {
+    for (int i = 0; i < rows; i++) {
+      nulls[i] = left_nulls[i * left_step];
+    }
+    return;
+  }
+
+  const uint8_t *right_nulls = right->nulls();
+  const int      right_step  = column_step(*right);
+  for (int i = 0; i < rows; i++) {
+    nulls[i] = left_nulls[i * left_step] | right_nulls[i * right_step];
+  }
+}
+
+void collect_plan_params(Expression &expr, vector<PlanParam> &params)
+{
+  switch (expr.type()) {
+    case ExprType::VALUE: {
+      auto &value_expr = static_cast<ValueExpr &>(expr);
+      if (value_expr.position() >= 0) {
+        params.push_back(PlanParam{value_expr.position(), &value_expr.value()});
+      }
+    } break;
+    case ExprType::COMPARISON: {
+      auto &comparison_expr = static_cast<ComparisonExpr &>(expr);
+      collect_plan_params(*comparison_expr.left(), params);
+      collect_plan_params(*comparison_expr.right(), params);
+    } break;
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        collect_plan_params(*child, params);
+      }
+    } break;
+    case ExprType::ARITHMETIC: {
+      auto &arithmetic_expr = static_cast<ArithmeticExpr &>(expr);
+      collect_plan_params(*arithmetic_expr.left(), params);
+      if (arithmetic_expr.right()) {
+        collect_plan_params(*arithmetic_expr.right(), params);
+      }
+    } break;
+    default: break;
+  }
+}
+
+RC Expression::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  Column &result = prepare_column(column);
+  result.reset_values();
+
+  ChunkTuple tuple;
+  tuple.set_chunk(&chunk);
+  Value value;
+  for (int row = 0; row < chunk.rows(); row++) {
+    tuple.set_row(row);
+    RC rc = get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    result.append_value(value);
+  }
+  return RC::SUCCESS;
+}
+
 RC FieldExpr::get_value(const Tuple &tuple, Value &value) const
 {
   return tuple.find_cell(TupleCellSpec(table_name(), field_name()), value);
 }
 
+RC FieldExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  const int index = chunk.find_column(TupleCellSpec(table_name(), field_name()));
+  if (index < 0) {
+    LOG_WARN("failed to find column in chunk. field=%s.%s", table_name(), field_name());
+    return RC::NOTFOUND;
+  }
+
+  column = chunk.column(index);
+  return RC::SUCCESS;
+}
+
 RC ValueExpr::get_value(const Tuple &tuple, Value &value) const
 {
   value = value_;
   return RC::SUCCESS;
 }
 
+RC ValueExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  prepare_column(column).reset_constant(value_);
+  return RC::SUCCESS;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 CastExpr::CastExpr(unique_ptr<Expression> child, AttrType cast_type) : child_(std::move(child)), cast_type_(cast_type)
 {}
@@ -219,6 +356,82 @@ RC ComparisonExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ComparisonExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  shared_ptr<Column> left;
+  shared_ptr<Column> right;
+
+  RC rc = left_->get_column(chunk, left);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get column of left expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  rc = right_->get_column(chunk, right);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get column of right expression. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const int rows   = chunk.rows();
+  Column   &result = prepare_column(column);
+  result.reset(BOOLEANS, 1);
+  result.resize(rows);
+  uint8_t *values = result.data<uint8_t>();
+  uint8_t *nulls  = result.nulls();
+
+  if (is_number_column(*left) && is_number_column(*right)) {
+    bool supported = false;
+    if (left->type() != FLOATS && right->type() != FLOATS) {
+      vector<int32_t> left_buffer;
+      vector<int32_t> right_buffer;
+      supported = VectorKernels::compare_int32(comp_,
+          column_numbers(*left, rows, left_buffer),
+          column_numbers(*right, rows, right_buffer),
+          rows, values);
+    } else if (left->type() == FLOATS && right->type() == FLOATS) {
+      vector<float> left_buffer;
+      vector<float> right_buffer;
+      supported = VectorKernels::compare_float(comp_,
+          column_numbers(*left, rows, left_buffer),
+          column_numbers(*right, rows, right_buffer),
+          rows, values);
+    } else {
+      vector<double> left_buffer;
+      vector<double> right_buffer;
+      supported = VectorKernels::compare_double(comp_,
+          column_numbers(*left, rows, left_buffer),
+          column_numbers(*right, rows, right_buffer),
+          rows, values);
+    }
+
+    if (!supported) {
+      LOG_WARN("unsupported comparison. %d", comp_);
+      return RC::INTERNAL;
+    }
+    merge_nulls(*left, right.get(), rows, nulls);
+    return RC::SUCCESS;
+  }
+
+  // 字符串等其它类型逐行比较
+  Value left_value;
+  Value right_value;
+  for (int row = 0; row < rows; row++) {
+    left->get_value(row, left_value);
+    right->get_value(row, right_value);
+
+    bool bool_value = false;
+    rc              = compare_value(left_value, right_value, bool_value);
+    if (rc == RC::NULL_VALUE) {
+      nulls[row] = 1;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    } else {
+      values[row] = bool_value ? 1 : 0;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ConjunctionExpr::ConjunctionExpr(ConjunctionType type, vector<unique_ptr<Expression>> &children)
     : conjunction_type_(type), children_(std::move(children))
@@ -264,6 +477,61 @@ RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ConjunctionExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  const int rows   = chunk.rows();
+  Column   &result = prepare_column(column);
+  if (children_.empty()) {
+    result.reset_constant(Value(true));
+    return RC::SUCCESS;
+  }
+
+  // AND中出现false或者OR中出现true的行，结果已经确定，与NULL无关
+  const bool      is_and = conjunction_type_ == ConjunctionType::AND;
+  vector<uint8_t> decided(rows, 0);
+  vector<uint8_t> contain_null(rows, 0);
+
+  shared_ptr<Column> child_column;
+  Value              value;
+  for (const unique_ptr<Expression> &expr : children_) {
+    RC rc = expr->get_column(chunk, child_column);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get column by child expression. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (child_column->is_fixed() && child_column->type() == BOOLEANS) {
+      const uint8_t *values = child_column->data<uint8_t>();
+      const uint8_t *nulls  = child_column->nulls();
+      const int      step   = column_step(*child_column);
+      for (int i = 0; i < rows; i++) {
+        contain_null[i] |= nulls[i * step];
+        decided[i] |= (nulls[i * step] == 0) & ((values[i * step] != 0) != is_and);
+      }
+      continue;
+    }
+
+    for (int row = 0; row < rows; row++) {
+      child_column->get_value(row, value);
+      if (value.attr_type() == NULLS) {
+        contain_null[row] = 1;
+      } else if (value.get_boolean() != is_and) {
+        decided[row] = 1;
+      }
+    }
+  }
+
+  result.reset(BOOLEANS, 1);
+  result.resize(rows);
+  uint8_t *values = result.data<uint8_t>();
+  uint8_t *nulls  = result.nulls();
+  for (int i = 0; i < rows; i++) {
+    values[i] = decided[i] ? !is_and : is_and;
+    nulls[i]  = !decided[i] && contain_null[i];
+  }
+  return RC::SUCCESS;
+}
+
 RC ConjunctionExpr::try_get_value(Value &value) const
 {
   RC rc = RC::SUCCESS;
@@ -417,6 +685,115 @@ RC ArithmeticExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ArithmeticExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  shared_ptr<Column> left;
+  shared_ptr<Column> right;
+
+  RC rc = left_->get_column(chunk, left);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get column of left expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  if (right_) {
+    rc = right_->get_column(chunk, right);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get column of right expression. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  const int      rows        = chunk.rows();
+  const AttrType target_type = value_type();
+  Column        &result      = prepare_column(column);
+
+  auto is_type = [](const Column *column, AttrType type) { return column->is_fixed() && column->type() == type; };
+  auto is_int_or_float = [&](const Column *column) { return is_type(column, INTS) || is_type(column, FLOATS); };
+
+  const bool int_kernel   = target_type == INTS && is_type(left.get(), INTS) && (!right || is_type(right.get(), INTS));
+  const bool float_kernel = target_type == FLOATS && is_int_or_float(left.get()) && (!right || is_int_or_float(right.get()));
+
+  if (int_kernel) {
+    result.reset(INTS, sizeof(int32_t));
+    result.resize(rows);
+    merge_nulls(*left, right.get(), rows, result.nulls());
+
+    // 按照无符号数计算，溢出时回绕，与逐行计算的结果一致
+    int32_t        *values = result.data<int32_t>();
+    vector<int32_t> left_buffer;
+    const int32_t  *left_data = column_numbers(*left, rows, left_buffer);
+    if (arithmetic_type_ == ArithmeticType::NEGATIVE) {
+      for (int i = 0; i < rows; i++) {
+        values[i] = static_cast<int32_t>(0U - static_cast<uint32_t>(left_data[i]));
+      }
+      return RC::SUCCESS;
+    }
+
+    vector<int32_t> right_buffer;
+    const int32_t  *right_data = column_numbers(*right, rows, right_buffer);
+    if (!VectorKernels::arithmetic_int32(arithmetic_type_, left_data, right_data, rows, values)) {
+      LOG_WARN("unsupported arithmetic type. %d", arithmetic_type_);
+      return RC::INTERNAL;
+    }
+    return RC::SUCCESS;
+  }
+
+  if (float_kernel) {
+    result.reset(FLOATS, sizeof(float));
+    result.resize(rows);
+    uint8_t *nulls = result.nulls();
+    merge_nulls(*left, right.get(), rows, nulls);
+
+    float        *values = result.data<float>();
+    vector<float> left_buffer;
+    const float  *left_data = column_numbers(*left, rows, left_buffer);
+    if (arithmetic_type_ == ArithmeticType::NEGATIVE) {
+      for (int i = 0; i < rows; i++) {
+        values[i] = -left_data[i];
+      }
+      return RC::SUCCESS;
+    }
+
+    vector<float> right_buffer;
+    const float  *right_data = column_numbers(*right, rows, right_buffer);
+    if (!VectorKernels::arithmetic_float(arithmetic_type_, left_data, right_data, rows, values)) {
+      LOG_WARN("unsupported arithmetic type. %d", arithmetic_type_);
+      return RC::INTERNAL;
+    }
+    if (arithmetic_type_ == ArithmeticType::DIV) {
+      for (int i = 0; i < rows; i++) {
+        if (right_data[i] > -EPSILON && right_data[i] < EPSILON) {
+          nulls[i] = 1;
+        }
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  // 其它类型逐行计算
+  result.reset_values();
+  Value left_value;
+  Value right_value;
+  Value value;
+  for (int row = 0; row < rows; row++) {
+    left->get_value(row, left_value);
+    if (right) {
+      right->get_value(row, right_value);
+    }
+    try {
+      rc = calc_value(left_value, right_value, value);
+    } catch (null_cast_exception) {
+      value.set_null();
+      rc = RC::SUCCESS;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    result.append_value(value);
+  }
+  return RC::SUCCESS;
+}
+
 RC ArithmeticExpr::try_get_value(Value &value) const
 {
   RC rc = RC::SUCCESS;
@@ -578,6 +955,18 @@ RC NotExpr::try_get_value(Value &value) const
 
 RC TupleCellExpr::get_value(const Tuple &tuple, Value &value) const { return tuple.find_cell(cell_spec_, value); }
 
+RC TupleCellExpr::get_column(const Chunk &chunk, shared_ptr<Column> &column) const
+{
+  const int index = chunk.find_column(cell_spec_);
+  if (index < 0) {
+    LOG_WARN("failed to find column in chunk. alias=%s", cell_spec_.alias());
+    return RC::NOTFOUND;
+  }
+
+  column = chunk.column(index);
+  return RC::SUCCESS;
+}
+
 RC InExpr::get_value(const Tuple &tuple, Value &value) const
 {
   Value      left;
@@ -22,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include <utility>
 #include <vector>
 
+#include "sql/expr/chunk.h"
 #include "sql/expr/tuple_cell.h"
 #include "sql/parser/defs/comp_op.h"
 #include "sql/parser/value.h"
@@ -65,6 +66,14 @@ public:
    */
   virtual RC try_get_value(Value &value) const { return RC::UNIMPLENMENT; }
 
+  /**
+   * @brief 对chunk中的所有行计算表达式的值，向量化执行时使用
+   * @details 默认的实现通过ChunkTuple逐行调用get_value。
+   * column可以是上一次调用的结果，没有被其它地方引用时会复用它的内存。
+   * @param[out] column 计算结果，行数与chunk一致(常量列只有一个值)
+   */
+  virtual RC get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const;
+
   /**
    * @brief 表达式的类型
    * 可以根据表达式类型来转换为具体的子类
@@ -88,13 +97,31 @@ private:
 };
 
 /**
- * @brief 用于排序的表达式
- * 
+ * @brief 执行计划中来自SQL常量的一个值
+ * @details 执行计划缓存复用计划时，把这些值替换成新的SQL中相同位置的常量
+ */
+struct PlanParam
+{
+  int    position;  ///< 常量在SQL中的位置
+  Value *value;
+};
+
+/**
+ * @brief 收集表达式中可以替换的常量
+ * @details 只处理比较、逻辑运算和算术运算中直接出现的常量，这些常量的值不影响执行计划的结构。
+ * 其它表达式中的常量不收集，比如类型转换在生成表达式时就检查了常量的值，执行计划缓存会把这些常量当作计划的一部分。
+ */
+void collect_plan_params(Expression &expr, std::vector<PlanParam> &params);
+
+/**
+ * @brief 排序字段
+ * @details 排序的表达式作为投影的一部分计算，这里只记录它在投影结果中的位置
  */
-struct ExprWithOrder
+struct OrderByDesc
 {
-  std::unique_ptr<Expression> expr;
-  bool                        is_asc;
+  int         cell_index;
+  bool        is_asc;
+  std::string name;  ///< 用于explain
 };
 
 /**
@@ -121,6 +148,7 @@ public:
   const char *field_name() const { return field_.field_name(); }
 
   RC get_value(const Tuple &tuple, Value &value) const override;
+  RC get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
 
 private:
   Field field_;
@@ -144,15 +172,25 @@ public:
     value = value_;
     return RC::SUCCESS;
   }
+  RC get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
 
   ExprType type() const override { return ExprType::VALUE; }
   AttrType value_type() const override { return value_.attr_type(); }
 
   void         get_value(Value &value) const { value = value_; }
   const Value &get_value() const { return value_; }
+  Value       &value() { return value_; }
+
+  /**
+   * @brief 常量在SQL中的位置，执行计划缓存根据位置替换常量的值
+   * @details 不是SQL中直接出现的常量(比如优化时计算出来的值)为-1
+   */
+  int  position() const { return position_; }
+  void set_position(int position) { position_ = position; }
 
 private:
   Value value_;
+  int   position_ = -1;
 };
 
 /**
@@ -194,6 +232,7 @@ public:
 
   ExprType type() const override { return ExprType::COMPARISON; }
   RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
   AttrType value_type() const override { return BOOLEANS; }
   CompOp   comp() const { return comp_; }
 
@@ -234,6 +273,7 @@ public:
   AttrType value_type() const override { return BOOLEANS; }
   RC       get_value(const Tuple &tuple, Value &value) const override;
   RC       try_get_value(Value &value) const override;
+  RC       get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
 
   ConjunctionType conjunction_type() const { return conjunction_type_; }
 
@@ -260,6 +300,7 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
   RC try_get_value(Value &value) const override;
+  RC get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
 
   ArithmeticType arithmetic_type() const { return arithmetic_type_; }
 
@@ -319,6 +360,7 @@ public:
       : cell_spec_(cell_spec), cell_value_type_(cell_value_type)
   {}
   RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       get_column(const Chunk &chunk, std::shared_ptr<Column> &column) const override;
   ExprType type() const override { return ExprType::CELL_REF; }
   AttrType value_type() const override { return cell_value_type_; }
 
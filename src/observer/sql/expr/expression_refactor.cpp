@@ -183,13 +183,15 @@ RC ExpressionStructRefactor::refactor(ExpressionSqlNode *&sql_node, const std::v
 
 RC ExpressionStructRefactor::refactor_internal(ExpressionSqlNode *&sql_node)
 {
+  // 聚合函数参数中的字段不需要替换成group by字段，比如 select sum(id) from t group by id
   for (auto group_by_expr : groupby_) {
-    if (*group_by_expr == *sql_node) {
+    if (!in_aggregate_ && *group_by_expr == *sql_node) {
       AggregateExpressionSqlNode *aggregate_node = new AggregateExpressionSqlNode();
       aggregate_node->name                       = group_by_expr->name;
       aggregate_node->aggregate_type             = AggregateType::GROUP;
       aggregate_node->child                      = sql_node;
       sql_node                                   = aggregate_node;
+      break;
     }
   }
 
@@ -271,14 +273,19 @@ RC ExpressionStructRefactor::refactor_internal(ExpressionSqlNode *&sql_node)
         }
       }
 
-      SubqueryType old_subquery_type = current_subquery_type_;
-      current_subquery_type_         = SubqueryType::SINGLE_CELL;
-      RC rc                          = refactor_internal(child);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("Failed to refactor expression struct, rc=%d:%s", rc, strrc(rc));
-        return rc;
+      // group by的表达式本身就是group by中的一项，不能再重构，否则会被无限地包装成GROUP
+      if (aggregate_node->aggregate_type != AggregateType::GROUP) {
+        SubqueryType old_subquery_type = current_subquery_type_;
+        current_subquery_type_         = SubqueryType::SINGLE_CELL;
+        in_aggregate_                  = true;
+        RC rc                          = refactor_internal(child);
+        in_aggregate_                  = false;
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("Failed to refactor expression struct, rc=%d:%s", rc, strrc(rc));
+          return rc;
+        }
+        current_subquery_type_ = old_subquery_type;
       }
-      current_subquery_type_ = old_subquery_type;
 
       aggregate_types_.push_back(aggregate_node->aggregate_type);
       aggregate_childs_.emplace_back(std::move(child));
@@ -377,5 +384,6 @@ RC ExpressionStructRefactor::init()
   subquery_types_.clear();
   groupby_.clear();
   current_subquery_type_ = SubqueryType::SINGLE_CELL;
+  in_aggregate_          = false;
   return RC::SUCCESS;
 }
@@ -97,6 +97,7 @@ private:
   std::vector<TupleCellSpec>                              subquery_cells_;
 
   SubqueryType current_subquery_type_ = SubqueryType::SINGLE_CELL;
+  bool         in_aggregate_          = false;  ///< 是否正在重构聚合函数的参数
 
   ExpressionStructValidator validator_;
 };
\ No newline at end of file
@@ -81,7 +81,9 @@ RC ExpressionGenerator::generate_expression(const ExpressionSqlNode *sql_node, s
 
 RC ExpressionGenerator::generate_expression(const ValueExpressionSqlNode *sql_node, std::unique_ptr<Expression> &expr)
 {
-  expr.reset(new ValueExpr(sql_node->value));
+  auto value_expr = new ValueExpr(sql_node->value);
+  value_expr->set_position(sql_node->position);
+  expr.reset(value_expr);
   expr->set_name(sql_node->name);
   return RC::SUCCESS;
 }
@@ -534,7 +536,12 @@ RC ProjectExpressionResovler::resolve_projection_list(
       // 普通的表达式
       unique_ptr<Expression>   expr;
       ExpressionStructRefactor refactor;
-      refactor.refactor(sql_node->expr);
+      rc = refactor.refactor(sql_node->expr, group_exprs_);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("refactor expression failed rc = %d:%s", rc, strrc(rc));
+        return rc;
+      }
+
       rc = generator_.generate_expression(sql_node->expr, expr);
       if (rc != RC::SUCCESS) {
         LOG_WARN("generate expression failed");
@@ -556,6 +563,7 @@ RC ProjectExpressionResovler::resolve_projection_list(
           std::make_move_iterator(refactor.subqueries().end()));
 
       // 生成tuple_schema
+      resovled_attr_types_.push_back(query_exprs.back()->value_type());
       FieldExpressionSqlNode *field = dynamic_cast<FieldExpressionSqlNode *>(sql_node->expr);
       if (field) {
         resovled_attr_tuple_specs_.emplace_back(
@@ -605,6 +613,7 @@ RC ProjectExpressionResovler::wildcard_fields(
         query_exprs.push_back(std::move(expr));
         delete temp_node;
 
+        resovled_attr_types_.push_back(query_exprs.back()->value_type());
         resovled_attr_tuple_specs_.push_back(
             TupleCellSpec(table_desc.table_name().c_str(), field.field_name().c_str()));
       }
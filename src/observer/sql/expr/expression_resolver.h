@@ -170,6 +170,7 @@ public:
   std::vector<TupleCellSpec>                         &subquery_cell_desc() { return subquery_cell_desc_; }
   std::vector<unique_ptr<AggregateDesc>>             &aggregate_desc() { return aggregate_desc_; }
   std::vector<TupleCellSpec>                         &attr_tuple() { return resovled_attr_tuple_specs_; }
+  std::vector<AttrType>                              &attr_types() { return resovled_attr_types_; }
 
 private:
   RC wildcard_fields(FieldExpressionSqlNode *wildcard_expression, vector<unique_ptr<Expression>> &query_exprs);
@@ -183,6 +184,7 @@ private:
   std::vector<unique_ptr<AggregateDesc>> aggregate_desc_;
 
   std::vector<TupleCellSpec> resovled_attr_tuple_specs_;
+  std::vector<AttrType>      resovled_attr_types_;  ///< 与resovled_attr_tuple_specs_一一对应，每一列的值的类型
 
 private:
   ExpressionGenerator generator_;
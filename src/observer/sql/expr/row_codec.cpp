@@ -0,0 +1,159 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/row_codec.h"
+#include "common/log/log.h"
+#include "sql/expr/tuple.h"
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+static int payload_size(const Value &value)
+{
+  switch (value.attr_type()) {
+    case INTS:
+    case DATES:
+    case FLOATS:
+    case BOOLEANS: return 4;
+    case CHARS:
+    case TEXTS: return value.length();
+    default: return 0;
+  }
+}
+
+int RowCodec::encoded_size(const vector<Value> &cells)
+{
+  int size = sizeof(int32_t) * (cells.size() + 2);
+  for (const Value &cell : cells) {
+    size += 1 + payload_size(cell);
+  }
+  return size;
+}
+
+void RowCodec::encode(const vector<Value> &cells, char *buf)
+{
+  const int32_t num     = static_cast<int32_t>(cells.size());
+  int32_t      *offsets = reinterpret_cast<int32_t *>(buf + sizeof(int32_t));
+  int32_t       offset  = sizeof(int32_t) * (num + 2);
+
+  memcpy(buf, &num, sizeof(num));
+  for (int32_t i = 0; i < num; i++) {
+    const Value &cell = cells[i];
+    char        *pos  = buf + offset;
+
+    int32_t cell_offset = offset;
+    memcpy(offsets + i, &cell_offset, sizeof(cell_offset));
+
+    *pos = static_cast<char>(cell.attr_type());
+    pos++;
+    switch (cell.attr_type()) {
+      case INTS:
+      case DATES: {
+        int32_t v = cell.get_int();
+        memcpy(pos, &v, sizeof(v));
+      } break;
+      case FLOATS: {
+        float v = cell.get_float();
+        memcpy(pos, &v, sizeof(v));
+      } break;
+      case BOOLEANS: {
+        int32_t v = cell.get_boolean() ? 1 : 0;
+        memcpy(pos, &v, sizeof(v));
+      } break;
+      case CHARS:
+      case TEXTS: {
+        memcpy(pos, cell.data(), cell.length());
+      } break;
+      default: break;
+    }
+    offset += 1 + payload_size(cell);
+  }
+  memcpy(offsets + num, &offset, sizeof(offset));
+}
+
+RC RowCodec::read_cells(const Tuple &tuple, vector<Value> &cells)
+{
+  const int num = tuple.cell_num();
+  cells.resize(num);
+  for (int i = 0; i < num; i++) {
+    RC rc = tuple.cell_at(i, cells[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get cell. index=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+int RowCodec::cell_num(const char *row)
+{
+  int32_t num;
+  memcpy(&num, row, sizeof(num));
+  return num;
+}
+
+int RowCodec::row_size(const char *row)
+{
+  int32_t size;
+  memcpy(&size, row + sizeof(int32_t) * (cell_num(row) + 1), sizeof(size));
+  return size;
+}
+
+RC RowCodec::decode_cell(const char *row, int index, Value &cell)
+{
+  const int num = cell_num(row);
+  if (index < 0 || index >= num) {
+    return RC::NOTFOUND;
+  }
+
+  int32_t begin;
+  int32_t end;
+  memcpy(&begin, row + sizeof(int32_t) * (index + 1), sizeof(begin));
+  memcpy(&end, row + sizeof(int32_t) * (index + 2), sizeof(end));
+
+  const AttrType type = static_cast<AttrType>(row[begin]);
+  const char    *data = row + begin + 1;
+  const int      len  = end - begin - 1;
+  switch (type) {
+    case INTS:
+    case DATES:
+    case FLOATS: {
+      // payload没有对齐，先拷贝出来
+      char buf[4];
+      memcpy(buf, data, sizeof(buf));
+      cell.set_type(type);
+      cell.set_data(buf, sizeof(buf));
+    } break;
+    case BOOLEANS: {
+      int32_t v;
+      memcpy(&v, data, sizeof(v));
+      cell.set_boolean(v != 0);
+    } break;
+    case CHARS: {
+      if (len == 0) {
+        cell.set_string("");
+      } else {
+        cell.set_string(data, len);
+      }
+    } break;
+    case TEXTS: {
+      string str(data, len);
+      cell.set_text(str.c_str());
+    } break;
+    case NULLS: {
+      cell.set_null();
+    } break;
+    default: {
+      cell = Value();
+    } break;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,53 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/rc.h"
+#include "sql/parser/value.h"
+
+class Tuple;
+
+/**
+ * @brief 把一行数据(多个Value)编码到一段连续内存中
+ * @ingroup Tuple
+ * @details 编码格式:
+ * @code
+ * | cell_num(4B) | offsets[cell_num + 1](4B each) | cell 0 | cell 1 | ... |
+ * @endcode
+ * 每个cell是 | type(1B) | payload |，NULL只有type。offset是相对于行起始位置的偏移，
+ * offsets[cell_num]就是整行的长度，这样可以O(1)地访问任意一个cell。
+ * 编码后的数据不包含指针，可以直接写到磁盘上。
+ */
+class RowCodec
+{
+public:
+  /**
+   * @brief 计算编码cells需要的字节数
+   */
+  static int encoded_size(const std::vector<Value> &cells);
+
+  /**
+   * @brief 将cells编码到buf中，buf的大小至少是encoded_size(cells)
+   */
+  static void encode(const std::vector<Value> &cells, char *buf);
+
+  /**
+   * @brief 读取tuple的所有cell
+   */
+  static RC read_cells(const Tuple &tuple, std::vector<Value> &cells);
+
+  static int cell_num(const char *row);
+  static int row_size(const char *row);
+  static RC  decode_cell(const char *row, int index, Value &cell);
+};
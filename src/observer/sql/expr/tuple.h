@@ -28,8 +28,10 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/bitmap.h"
 #include "common/log/log.h"
 #include "mock/in_memory_text_storage.h"
+#include "sql/expr/chunk.h"
 #include "sql/expr/expr_type.h"
 #include "sql/expr/expression.h"
+#include "sql/expr/row_codec.h"
 #include "sql/expr/tuple_cell.h"
 #include "sql/parser/value.h"
 #include "sql/stmt/table_ref_desc.h"
@@ -62,15 +64,24 @@ class Table;
 class TupleSchema
 {
 public:
-  void append_cell(const TupleCellSpec &cell) { cells_.push_back(cell); }
+  /**
+   * @param type 这一列的值的类型，不确定时是UNDEFINED
+   */
+  void append_cell(const TupleCellSpec &cell, AttrType type = AttrType::UNDEFINED)
+  {
+    cells_.push_back(cell);
+    cell_types_.push_back(type);
+  }
   void append_cell(const char *table, const char *field) { append_cell(TupleCellSpec(table, field)); }
-  void append_cell(const char *alias) { append_cell(TupleCellSpec(alias)); }
+  void append_cell(const char *alias, AttrType type = AttrType::UNDEFINED) { append_cell(TupleCellSpec(alias), type); }
   int  cell_num() const { return static_cast<int>(cells_.size()); }
 
   const TupleCellSpec &cell_at(int i) const { return cells_[i]; }
+  AttrType             cell_type(int i) const { return cell_types_[i]; }
 
 private:
   std::vector<TupleCellSpec> cells_;
+  std::vector<AttrType>      cell_types_;
 };
 
 /**
@@ -247,6 +258,9 @@ public:
 
   void set_tuple_schema(std::vector<TupleCellSpec> tuple_schema) { tuple_schema_ = std::move(tuple_schema); }
 
+  const std::vector<std::unique_ptr<Expression>> &project_exprs() const { return project_exprs_; }
+  const std::vector<TupleCellSpec>               &tuple_schema() const { return tuple_schema_; }
+
   int cell_num() const override { return project_exprs_.size(); }
 
   RC cell_at(int index, Value &cell) const override
@@ -398,19 +412,23 @@ private:
   Tuple *right_ = nullptr;
 };
 
-class AggregateTupleManager;
-
 /**
  * @brief 聚合操作所需的Tuple
+ * @details 聚合的结果由聚合算子计算好之后放进来，按照聚合函数的别名查找
  */
 class AggregateTuple : public Tuple
 {
 public:
+  AggregateTuple(const std::vector<TupleCellSpec> &aggr_specs) : aggr_specs_(aggr_specs) {}
+  virtual ~AggregateTuple() = default;
+
+  std::vector<Value> &cells() { return cells_; }
+
   /**
    * @brief 获取元组中的Cell的个数
    * @details 个数应该与tuple_schema一致
    */
-  int cell_num() const override { return aggr_exprs_.size(); }
+  int cell_num() const override { return static_cast<int>(aggr_specs_.size()); }
 
   /**
    * @brief 获取指定位置的Cell
@@ -420,21 +438,11 @@ public:
    */
   RC cell_at(int index, Value &cell) const override
   {
-    if (index < 0 || index >= static_cast<int>(aggr_values_.size())) {
+    if (index < 0 || index >= static_cast<int>(cells_.size())) {
       return RC::NOTFOUND;
     }
 
-    const Value &value = aggr_values_[index];
-
-    if (aggr_types_[index] == AggregateType::AVG && value.attr_type() != NULLS) {
-      int   count;
-      float sum;
-      sscanf(value.get_string().c_str(), "count: %d, sum: %f", &count, &sum);
-      cell.set_float(sum / count);
-    } else {
-      cell = value;
-    }
-
+    cell = cells_[index];
     return RC::SUCCESS;
   }
 
@@ -462,175 +470,9 @@ public:
     return RC::NOTFOUND;
   }
 
-  RC aggregate_tuple(Tuple &tuple)
-  {
-    for (size_t i = 0; i < aggr_exprs_.size(); ++i) {
-      Value         value;
-      Value        &aggregated_value = aggr_values_[i];
-      AggregateType aggregated_type  = aggr_types_[i];
-      Expression   *expr             = aggr_exprs_[i].get();
-
-      RC rc = expr->get_value(tuple, value);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("get value failed. rc=%d", rc);
-        return rc;
-      }
-      if (value.attr_type() == AttrType::NULLS) {
-        continue;
-      }
-
-      switch (aggregated_type) {
-        case AggregateType::SUM: {
-          if (aggregated_value.attr_type() == AttrType::NULLS) {
-            aggregated_value.set_float(value.get_double());
-          } else {
-            aggregated_value.set_float(aggregated_value.get_float() + value.get_float());
-          }
-        } break;
-        case AggregateType::COUNT: {
-          aggregated_value.set_int(aggregated_value.get_int() + 1);
-        } break;
-        case AggregateType::AVG:
-          // 使用字符串简单粗暴地记录count和sum
-          {
-            const char *fmt = "count: %d, sum: %f";
-            if (aggregated_value.attr_type() == AttrType::NULLS) {
-              char info[100];
-              sprintf(info, fmt, 1, value.get_float());
-              aggregated_value.set_string(info);
-            } else {
-              int         count;
-              float       sum;
-              std::string info = aggregated_value.get_string();
-              char        res[100];
-              sscanf(info.c_str(), fmt, &count, &sum);
-
-              sprintf(res, fmt, count + 1, sum + value.get_float());
-              aggregated_value.set_string(res);
-            }
-          }
-          break;
-        case AggregateType::MAX: {
-          if (aggregated_value.attr_type() == AttrType::NULLS) {
-            aggregated_value.set_value(value);
-          } else {
-            int cmp_res = value.compare(aggregated_value);
-            if (cmp_res > 0) {
-              aggregated_value.set_value(value);
-            }
-          }
-        } break;
-        case AggregateType::MIN:
-          if (aggregated_value.attr_type() == AttrType::NULLS) {
-            aggregated_value.set_value(value);
-          } else {
-            int cmp_res = value.compare(aggregated_value);
-            if (cmp_res < 0) {
-              aggregated_value.set_value(value);
-            }
-          }
-          break;
-        case AggregateType::GROUP:
-          if (aggregated_value != value) {
-            return RC::INTERNAL;
-          }
-          break;
-        default: {
-          LOG_WARN("Invalid aggregate type. type=%d", static_cast<int>(aggr_types_[i]));
-          return RC::INTERNAL;
-        };
-      }
-    }
-    return RC::SUCCESS;
-  }
-
-private:
-  friend class AggregateTupleManager;
-
-  AggregateTuple(const std::vector<std::unique_ptr<Expression>> &aggr_exprs,
-      const std::vector<AggregateType> &aggr_types, const std::vector<TupleCellSpec> &aggr_specs)
-      : aggr_exprs_(aggr_exprs), aggr_types_(aggr_types), aggr_specs_(aggr_specs)
-  {
-    assert(aggr_exprs.size() == aggr_types_.size() && aggr_types_.size() == aggr_specs_.size());
-  }
-
 private:
-  // 资源引用向AggregateTupleFactory的成员
-  const std::vector<std::unique_ptr<Expression>> &aggr_exprs_;
-  const std::vector<AggregateType>               &aggr_types_;
-  const std::vector<TupleCellSpec>               &aggr_specs_;
-  std::vector<Value>                              aggr_values_;
-};
-
-class AggregateTupleManager
-{
-public:
-  AggregateTupleManager(std::vector<std::unique_ptr<AggregateDesc>> aggr_descs)
-  {
-    for (const auto &desc : aggr_descs) {
-      aggr_exprs_.push_back(std::move(desc->child()));
-      aggr_types_.push_back(desc->type());
-      aggr_specs_.push_back(desc->child_spec());
-    }
-  }
-
-  AggregateTuple generateTuple(const std::vector<Value> group_by)
-  {
-    AggregateTuple tuple(aggr_exprs_, aggr_types_, aggr_specs_);
-    auto           group_by_it = group_by.begin();
-
-    for (int i = 0; i < aggr_exprs_.size(); i++) {
-      Value initial_value;
-      switch (aggr_types_[i]) {
-        case AggregateType::COUNT: {
-          initial_value.set_int(0);
-        } break;
-        case AggregateType::SUM: {
-          initial_value.set_null();
-        } break;
-        case AggregateType::AVG: {
-          initial_value.set_null();
-        } break;
-        case AggregateType::MAX: {
-          initial_value.set_null();
-        } break;
-        case AggregateType::MIN: {
-          initial_value.set_null();
-        } break;
-        case AggregateType::GROUP: {
-          if (group_by_it == group_by.end()) {
-            throw std::runtime_error("Group by value not enough");
-          }
-          initial_value = *group_by_it;
-          group_by_it++;
-        } break;
-        default: {
-          throw std::runtime_error("Invalid aggregate type");
-        }
-      }
-      tuple.aggr_values_.push_back(initial_value);
-    }
-
-    if (group_by_it != group_by.end()) {
-      throw std::runtime_error("Group by value too much");
-    }
-
-    return tuple;
-  }
-
-  std::vector<Expression *> group_exprs()
-  {
-    std::vector<Expression *> exprs;
-    for (const auto &expr : aggr_exprs_) {
-      exprs.push_back(expr.get());
-    }
-    return exprs;
-  }
-
-private:
-  std::vector<std::unique_ptr<Expression>> aggr_exprs_;
-  std::vector<AggregateType>               aggr_types_;
-  std::vector<TupleCellSpec>               aggr_specs_;
+  const std::vector<TupleCellSpec> &aggr_specs_;
+  std::vector<Value>                cells_;
 };
 
 /**
@@ -712,3 +554,104 @@ public:
 private:
   const std::vector<TupleCellSpec> cell_specs_;
 };
+
+/**
+ * @brief 以RowCodec格式编码在连续内存中的元组
+ * @ingroup Tuple
+ * @details 不持有数据，只是引用一段编码后的行数据，访问cell时才解码。
+ * 用于hash join等需要缓存大量行的算子，行数据可以统一放在Arena中。
+ */
+class EncodedTuple : public Tuple
+{
+public:
+  EncodedTuple(const std::vector<TupleCellSpec> &cell_specs) : cell_specs_(cell_specs) {}
+  virtual ~EncodedTuple() = default;
+
+  void        set_data(const char *data) { data_ = data; }
+  const char *data() const { return data_; }
+
+  int cell_num() const override { return static_cast<int>(cell_specs_.size()); }
+
+  RC cell_at(int index, Value &cell) const override
+  {
+    if (data_ == nullptr) {
+      return RC::INTERNAL;
+    }
+    return RowCodec::decode_cell(data_, index, cell);
+  }
+
+  RC find_cell(const TupleCellSpec &spec, Value &cell) const override
+  {
+    const char *alias = spec.alias();
+    const char *table = spec.table_name();
+    const char *field = spec.field_name();
+
+    if (alias[0] != '\0') {
+      for (size_t i = 0; i < cell_specs_.size(); ++i) {
+        if (0 == strcmp(alias, cell_specs_[i].alias())) {
+          return cell_at(i, cell);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < cell_specs_.size(); ++i) {
+      if (0 == strcmp(table, cell_specs_[i].table_name()) && 0 == strcmp(field, cell_specs_[i].field_name())) {
+        return cell_at(i, cell);
+      }
+    }
+
+    return RC::NOTFOUND;
+  }
+
+private:
+  const std::vector<TupleCellSpec> &cell_specs_;
+  const char                       *data_ = nullptr;
+};
+
+/**
+ * @brief chunk中的一行
+ * @ingroup Tuple
+ * @details 向量化执行的算子通过它把chunk中的数据按行提供给上层算子，
+ * 不支持向量化的表达式也通过它逐行计算。
+ * 在chunk中找不到的列，会继续到parent中查找，比如投影结果中找不到时再到投影的输入中查找。
+ */
+class ChunkTuple : public Tuple
+{
+public:
+  ChunkTuple()          = default;
+  virtual ~ChunkTuple() = default;
+
+  void set_chunk(const Chunk *chunk) { chunk_ = chunk; }
+  void set_row(int row) { row_ = row; }
+  void set_parent(const Tuple *parent) { parent_ = parent; }
+
+  int row() const { return row_; }
+
+  int cell_num() const override { return chunk_->column_num(); }
+
+  RC cell_at(int index, Value &cell) const override
+  {
+    if (index < 0 || index >= chunk_->column_num() || row_ < 0 || row_ >= chunk_->rows()) {
+      return RC::INVALID_ARGUMENT;
+    }
+    chunk_->column(index)->get_value(row_, cell);
+    return RC::SUCCESS;
+  }
+
+  RC find_cell(const TupleCellSpec &spec, Value &cell) const override
+  {
+    const int index = chunk_->find_column(spec);
+    if (index >= 0) {
+      return cell_at(index, cell);
+    }
+    if (parent_ != nullptr) {
+      return parent_->find_cell(spec, cell);
+    }
+    return RC::NOTFOUND;
+  }
+
+private:
+  const Chunk *chunk_  = nullptr;
+  int          row_    = 0;
+  const Tuple *parent_ = nullptr;
+};
@@ -0,0 +1,550 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/vector_kernels.h"
+#include "common/defs.h"
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_KERNELS_X86 1
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief 第i个元素是把i的低8个bit展开成8个字节(0或1)，用于把比较结果的掩码写成字节
+ */
+constexpr array<uint64_t, 256> make_bit_bytes()
+{
+  array<uint64_t, 256> table{};
+  for (int i = 0; i < 256; i++) {
+    uint64_t bytes = 0;
+    for (int bit = 0; bit < 8; bit++) {
+      if (i & (1 << bit)) {
+        bytes |= static_cast<uint64_t>(1) << (bit * 8);
+      }
+    }
+    table[i] = bytes;
+  }
+  return table;
+}
+
+constexpr array<uint64_t, 256> BIT_BYTES = make_bit_bytes();
+
+/**
+ * @brief 把bits的低n位写成n个字节，n不超过8。按小端序存放
+ */
+inline void store_bits(uint32_t bits, int n, uint8_t *result)
+{
+  const uint64_t bytes = BIT_BYTES[bits & 0xFF];
+  memcpy(result, &bytes, n);
+}
+
+bool is_supported(CompOp comp)
+{
+  switch (comp) {
+    case EQUAL_TO:
+    case LESS_EQUAL:
+    case NOT_EQUAL:
+    case LESS_THAN:
+    case GREAT_EQUAL:
+    case GREAT_THAN: return true;
+    default: return false;
+  }
+}
+
+/**
+ * @brief 根据"大于"和"小于"的掩码计算比较结果的掩码
+ * @details 数值比较只需要知道left > right 和 left < right，其它比较运算都可以由这两个结果组合得到
+ */
+inline uint32_t combine(CompOp comp, uint32_t gt, uint32_t lt, uint32_t full)
+{
+  switch (comp) {
+    case EQUAL_TO: return full & ~(gt | lt);
+    case LESS_EQUAL: return full & ~gt;
+    case NOT_EQUAL: return gt | lt;
+    case LESS_THAN: return lt;
+    case GREAT_EQUAL: return full & ~lt;
+    case GREAT_THAN: return gt;
+    default: return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 标量实现，也用来处理SIMD实现剩下的不足一个向量的部分
+
+inline int compare_number(int32_t left, int32_t right) { return (left > right) - (left < right); }
+
+inline int compare_number(double left, double right)
+{
+  const double diff = left - right;
+  return diff > EPSILON ? 1 : (diff < -EPSILON ? -1 : 0);
+}
+
+template <typename T>
+void compare_scalar(CompOp comp, const T *left, const T *right, int from, int count, uint8_t *result)
+{
+  using C = conditional_t<is_same_v<T, int32_t>, int32_t, double>;
+  for (int i = from; i < count; i++) {
+    const int cmp = compare_number(static_cast<C>(left[i]), static_cast<C>(right[i]));
+    result[i]     = static_cast<uint8_t>(combine(comp, cmp > 0, cmp < 0, 1));
+  }
+}
+
+void arithmetic_int32_scalar(
+    ArithmeticType type, const int32_t *left, const int32_t *right, int from, int count, int32_t *result)
+{
+  const uint32_t *l = reinterpret_cast<const uint32_t *>(left);
+  const uint32_t *r = reinterpret_cast<const uint32_t *>(right);
+  switch (type) {
+    case ArithmeticType::ADD: {
+      for (int i = from; i < count; i++) {
+        result[i] = static_cast<int32_t>(l[i] + r[i]);
+      }
+    } break;
+    case ArithmeticType::SUB: {
+      for (int i = from; i < count; i++) {
+        result[i] = static_cast<int32_t>(l[i] - r[i]);
+      }
+    } break;
+    case ArithmeticType::MUL: {
+      for (int i = from; i < count; i++) {
+        result[i] = static_cast<int32_t>(l[i] * r[i]);
+      }
+    } break;
+    default: break;
+  }
+}
+
+void arithmetic_float_scalar(
+    ArithmeticType type, const float *left, const float *right, int from, int count, float *result)
+{
+  switch (type) {
+    case ArithmeticType::ADD: {
+      for (int i = from; i < count; i++) {
+        result[i] = left[i] + right[i];
+      }
+    } break;
+    case ArithmeticType::SUB: {
+      for (int i = from; i < count; i++) {
+        result[i] = left[i] - right[i];
+      }
+    } break;
+    case ArithmeticType::MUL: {
+      for (int i = from; i < count; i++) {
+        result[i] = left[i] * right[i];
+      }
+    } break;
+    case ArithmeticType::DIV: {
+      for (int i = from; i < count; i++) {
+        result[i] = left[i] / right[i];
+      }
+    } break;
+    default: break;
+  }
+}
+
+int select_scalar(const uint8_t *values, const uint8_t *nulls, int from, int count, int *selection, int selected)
+{
+  for (int i = from; i < count; i++) {
+    if (values[i] != 0 && (nulls == nullptr || nulls[i] == 0)) {
+      selection[selected++] = i;
+    }
+  }
+  return selected;
+}
+
+#ifdef VECTOR_KERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2，每次处理256位。函数返回已经处理的个数
+
+TARGET_AVX2 int compare_int32_avx2(CompOp comp, const int32_t *left, const int32_t *right, int count, uint8_t *result)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i  a  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + i));
+    const __m256i  b  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i));
+    const uint32_t gt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+    const uint32_t lt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)));
+    store_bits(combine(comp, gt, lt, 0xFF), 8, result + i);
+  }
+  return i;
+}
+
+TARGET_AVX2 inline void compare_diff_avx2(
+    CompOp comp, __m256d a, __m256d b, __m256d epsilon, __m256d neg_epsilon, uint8_t *result)
+{
+  const __m256d  diff = _mm256_sub_pd(a, b);
+  const uint32_t gt   = _mm256_movemask_pd(_mm256_cmp_pd(diff, epsilon, _CMP_GT_OQ));
+  const uint32_t lt   = _mm256_movemask_pd(_mm256_cmp_pd(diff, neg_epsilon, _CMP_LT_OQ));
+  store_bits(combine(comp, gt, lt, 0xF), 4, result);
+}
+
+TARGET_AVX2 int compare_float_avx2(CompOp comp, const float *left, const float *right, int count, uint8_t *result)
+{
+  const __m256d epsilon     = _mm256_set1_pd(EPSILON);
+  const __m256d neg_epsilon = _mm256_set1_pd(-EPSILON);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d a = _mm256_cvtps_pd(_mm_loadu_ps(left + i));
+    const __m256d b = _mm256_cvtps_pd(_mm_loadu_ps(right + i));
+    compare_diff_avx2(comp, a, b, epsilon, neg_epsilon, result + i);
+  }
+  return i;
+}
+
+TARGET_AVX2 int compare_double_avx2(CompOp comp, const double *left, const double *right, int count, uint8_t *result)
+{
+  const __m256d epsilon     = _mm256_set1_pd(EPSILON);
+  const __m256d neg_epsilon = _mm256_set1_pd(-EPSILON);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d a = _mm256_loadu_pd(left + i);
+    const __m256d b = _mm256_loadu_pd(right + i);
+    compare_diff_avx2(comp, a, b, epsilon, neg_epsilon, result + i);
+  }
+  return i;
+}
+
+TARGET_AVX2 int arithmetic_int32_avx2(
+    ArithmeticType type, const int32_t *left, const int32_t *right, int count, int32_t *result)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i));
+    __m256i       c;
+    switch (type) {
+      case ArithmeticType::ADD: c = _mm256_add_epi32(a, b); break;
+      case ArithmeticType::SUB: c = _mm256_sub_epi32(a, b); break;
+      case ArithmeticType::MUL: c = _mm256_mullo_epi32(a, b); break;
+      default: return i;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + i), c);
+  }
+  return i;
+}
+
+TARGET_AVX2 int arithmetic_float_avx2(
+    ArithmeticType type, const float *left, const float *right, int count, float *result)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 a = _mm256_loadu_ps(left + i);
+    const __m256 b = _mm256_loadu_ps(right + i);
+    __m256       c;
+    switch (type) {
+      case ArithmeticType::ADD: c = _mm256_add_ps(a, b); break;
+      case ArithmeticType::SUB: c = _mm256_sub_ps(a, b); break;
+      case ArithmeticType::MUL: c = _mm256_mul_ps(a, b); break;
+      case ArithmeticType::DIV: c = _mm256_div_ps(a, b); break;
+      default: return i;
+    }
+    _mm256_storeu_ps(result + i, c);
+  }
+  return i;
+}
+
+TARGET_AVX2 int select_avx2(const uint8_t *values, const uint8_t *nulls, int count, int *selection, int &selected)
+{
+  const __m256i zero = _mm256_setzero_si256();
+
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m256i v    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    uint32_t      bits = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+    if (nulls != nullptr) {
+      const __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(nulls + i));
+      bits &= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(n, zero)));
+    }
+    while (bits != 0) {
+      selection[selected++] = i + __builtin_ctz(bits);
+      bits &= bits - 1;
+    }
+  }
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE4.2，每次处理128位
+
+TARGET_SSE42 int compare_int32_sse42(CompOp comp, const int32_t *left, const int32_t *right, int count, uint8_t *result)
+{
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i  a  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + i));
+    const __m128i  b  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i));
+    const uint32_t gt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)));
+    const uint32_t lt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, b)));
+    store_bits(combine(comp, gt, lt, 0xF), 4, result + i);
+  }
+  return i;
+}
+
+/**
+ * @brief 比较两组各2个double，返回"大于"和"小于"的掩码
+ */
+TARGET_SSE42 inline void compare_diff_sse42(
+    __m128d a, __m128d b, __m128d epsilon, __m128d neg_epsilon, uint32_t &gt, uint32_t &lt)
+{
+  const __m128d diff = _mm_sub_pd(a, b);
+  gt                 = _mm_movemask_pd(_mm_cmpgt_pd(diff, epsilon));
+  lt                 = _mm_movemask_pd(_mm_cmplt_pd(diff, neg_epsilon));
+}
+
+TARGET_SSE42 int compare_float_sse42(CompOp comp, const float *left, const float *right, int count, uint8_t *result)
+{
+  const __m128d epsilon     = _mm_set1_pd(EPSILON);
+  const __m128d neg_epsilon = _mm_set1_pd(-EPSILON);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 a = _mm_loadu_ps(left + i);
+    const __m128 b = _mm_loadu_ps(right + i);
+
+    uint32_t gt_low, lt_low, gt_high, lt_high;
+    compare_diff_sse42(_mm_cvtps_pd(a), _mm_cvtps_pd(b), epsilon, neg_epsilon, gt_low, lt_low);
+    compare_diff_sse42(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b)), epsilon, neg_epsilon,
+        gt_high, lt_high);
+    store_bits(combine(comp, gt_low | (gt_high << 2), lt_low | (lt_high << 2), 0xF), 4, result + i);
+  }
+  return i;
+}
+
+TARGET_SSE42 int compare_double_sse42(CompOp comp, const double *left, const double *right, int count, uint8_t *result)
+{
+  const __m128d epsilon     = _mm_set1_pd(EPSILON);
+  const __m128d neg_epsilon = _mm_set1_pd(-EPSILON);
+
+  int i = 0;
+  for (; i + 2 <= count; i += 2) {
+    uint32_t gt, lt;
+    compare_diff_sse42(_mm_loadu_pd(left + i), _mm_loadu_pd(right + i), epsilon, neg_epsilon, gt, lt);
+    store_bits(combine(comp, gt, lt, 0x3), 2, result + i);
+  }
+  return i;
+}
+
+TARGET_SSE42 int arithmetic_int32_sse42(
+    ArithmeticType type, const int32_t *left, const int32_t *right, int count, int32_t *result)
+{
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i));
+    __m128i       c;
+    switch (type) {
+      case ArithmeticType::ADD: c = _mm_add_epi32(a, b); break;
+      case ArithmeticType::SUB: c = _mm_sub_epi32(a, b); break;
+      case ArithmeticType::MUL: c = _mm_mullo_epi32(a, b); break;
+      default: return i;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i), c);
+  }
+  return i;
+}
+
+TARGET_SSE42 int arithmetic_float_sse42(
+    ArithmeticType type, const float *left, const float *right, int count, float *result)
+{
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 a = _mm_loadu_ps(left + i);
+    const __m128 b = _mm_loadu_ps(right + i);
+    __m128       c;
+    switch (type) {
+      case ArithmeticType::ADD: c = _mm_add_ps(a, b); break;
+      case ArithmeticType::SUB: c = _mm_sub_ps(a, b); break;
+      case ArithmeticType::MUL: c = _mm_mul_ps(a, b); break;
+      case ArithmeticType::DIV: c = _mm_div_ps(a, b); break;
+      default: return i;
+    }
+    _mm_storeu_ps(result + i, c);
+  }
+  return i;
+}
+
+TARGET_SSE42 int select_sse42(const uint8_t *values, const uint8_t *nulls, int count, int *selection, int &selected)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i v    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+    uint32_t      bits = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero))) & 0xFFFF;
+    if (nulls != nullptr) {
+      const __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i *>(nulls + i));
+      bits &= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(n, zero)));
+    }
+    while (bits != 0) {
+      selection[selected++] = i + __builtin_ctz(bits);
+      bits &= bits - 1;
+    }
+  }
+  return i;
+}
+
+#endif  // VECTOR_KERNELS_X86
+
+atomic<SimdLevel> &current_level()
+{
+  static atomic<SimdLevel> level(VectorKernels::detect());
+  return level;
+}
+
+}  // namespace
+
+const char *simd_level_name(SimdLevel level)
+{
+  switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE42: return "sse4.2";
+    default: return "scalar";
+  }
+}
+
+SimdLevel VectorKernels::detect()
+{
+#ifdef VECTOR_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::SSE42;
+  }
+#endif
+  return SimdLevel::SCALAR;
+}
+
+SimdLevel VectorKernels::level() { return current_level().load(memory_order_relaxed); }
+
+void VectorKernels::set_level(SimdLevel level)
+{
+  const SimdLevel supported = detect();
+  current_level().store(static_cast<int>(level) > static_cast<int>(supported) ? supported : level);
+}
+
+bool VectorKernels::compare_int32(CompOp comp, const int32_t *left, const int32_t *right, int count, uint8_t *result)
+{
+  if (!is_supported(comp)) {
+    return false;
+  }
+
+  int done = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = compare_int32_avx2(comp, left, right, count, result); break;
+    case SimdLevel::SSE42: done = compare_int32_sse42(comp, left, right, count, result); break;
+    default: break;
+  }
+#endif
+  compare_scalar(comp, left, right, done, count, result);
+  return true;
+}
+
+bool VectorKernels::compare_float(CompOp comp, const float *left, const float *right, int count, uint8_t *result)
+{
+  if (!is_supported(comp)) {
+    return false;
+  }
+
+  int done = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = compare_float_avx2(comp, left, right, count, result); break;
+    case SimdLevel::SSE42: done = compare_float_sse42(comp, left, right, count, result); break;
+    default: break;
+  }
+#endif
+  compare_scalar(comp, left, right, done, count, result);
+  return true;
+}
+
+bool VectorKernels::compare_double(CompOp comp, const double *left, const double *right, int count, uint8_t *result)
+{
+  if (!is_supported(comp)) {
+    return false;
+  }
+
+  int done = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = compare_double_avx2(comp, left, right, count, result); break;
+    case SimdLevel::SSE42: done = compare_double_sse42(comp, left, right, count, result); break;
+    default: break;
+  }
+#endif
+  compare_scalar(comp, left, right, done, count, result);
+  return true;
+}
+
+bool VectorKernels::arithmetic_int32(
+    ArithmeticType type, const int32_t *left, const int32_t *right, int count, int32_t *result)
+{
+  if (type != ArithmeticType::ADD && type != ArithmeticType::SUB && type != ArithmeticType::MUL) {
+    return false;
+  }
+
+  int done = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = arithmetic_int32_avx2(type, left, right, count, result); break;
+    case SimdLevel::SSE42: done = arithmetic_int32_sse42(type, left, right, count, result); break;
+    default: break;
+  }
+#endif
+  arithmetic_int32_scalar(type, left, right, done, count, result);
+  return true;
+}
+
+bool VectorKernels::arithmetic_float(
+    ArithmeticType type, const float *left, const float *right, int count, float *result)
+{
+  if (type != ArithmeticType::ADD && type != ArithmeticType::SUB && type != ArithmeticType::MUL &&
+      type != ArithmeticType::DIV) {
+    return false;
+  }
+
+  int done = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = arithmetic_float_avx2(type, left, right, count, result); break;
+    case SimdLevel::SSE42: done = arithmetic_float_sse42(type, left, right, count, result); break;
+    default: break;
+  }
+#endif
+  arithmetic_float_scalar(type, left, right, done, count, result);
+  return true;
+}
+
+int VectorKernels::select(const uint8_t *values, const uint8_t *nulls, int count, int *selection)
+{
+  int selected = 0;
+  int done     = 0;
+#ifdef VECTOR_KERNELS_X86
+  switch (level()) {
+    case SimdLevel::AVX2: done = select_avx2(values, nulls, count, selection, selected); break;
+    case SimdLevel::SSE42: done = select_sse42(values, nulls, count, selection, selected); break;
+    default: break;
+  }
+#endif
+  return select_scalar(values, nulls, done, count, selection, selected);
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "sql/expr/expr_type.h"
+#include "sql/parser/defs/comp_op.h"
+
+/**
+ * @brief 使用的SIMD指令集
+ */
+enum class SimdLevel
+{
+  SCALAR,
+  SSE42,
+  AVX2,
+};
+
+const char *simd_level_name(SimdLevel level);
+
+/**
+ * @brief 定长数组上的比较、算术和选择运算，向量化执行时使用
+ * @ingroup Expression
+ * @details 每个函数都有AVX2、SSE4.2和标量三种实现，第一次使用时根据CPU支持的指令集选择。
+ * 比较的结果是每行一个字节(0或1)，与BOOLEANS类型的Column格式一致，可以再用select转换成选择向量。
+ * 比较的语义与Value::compare一致：浮点数转换成double后相减，差值在EPSILON以内认为相等。
+ * 输入输出数组都不需要对齐，输出数组不能与输入数组重叠。
+ */
+class VectorKernels
+{
+public:
+  /**
+   * @brief CPU支持的最高级别
+   */
+  static SimdLevel detect();
+
+  static SimdLevel level();
+
+  /**
+   * @brief 指定使用的实现，超过CPU支持的级别时使用CPU支持的最高级别
+   * @details 用于测试和性能对比
+   */
+  static void set_level(SimdLevel level);
+
+  /**
+   * @brief result[i] = left[i] comp right[i]
+   * @return 不支持的比较运算返回false
+   */
+  static bool compare_int32(CompOp comp, const int32_t *left, const int32_t *right, int count, uint8_t *result);
+  static bool compare_float(CompOp comp, const float *left, const float *right, int count, uint8_t *result);
+  static bool compare_double(CompOp comp, const double *left, const double *right, int count, uint8_t *result);
+
+  /**
+   * @brief result[i] = left[i] op right[i]，支持加减乘，溢出时回绕
+   * @return 不支持的运算返回false
+   */
+  static bool arithmetic_int32(
+      ArithmeticType type, const int32_t *left, const int32_t *right, int count, int32_t *result);
+
+  /**
+   * @brief result[i] = left[i] op right[i]，支持加减乘除，除数是否为0由调用者处理
+   * @return 不支持的运算返回false
+   */
+  static bool arithmetic_float(ArithmeticType type, const float *left, const float *right, int count, float *result);
+
+  /**
+   * @brief 把values不为0并且nulls为0的行号依次写到selection中
+   * @param nulls 可以是nullptr，表示没有NULL
+   * @return 选中的行数
+   */
+  static int select(const uint8_t *values, const uint8_t *nulls, int count, int *selection);
+};
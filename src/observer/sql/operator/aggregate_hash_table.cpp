@@ -0,0 +1,157 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/aggregate_hash_table.h"
+#include "common/log/log.h"
+#include "sql/expr/chunk.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+RC GroupKeyEncoder::encode(const vector<unique_ptr<Expression>> &exprs, const Tuple &tuple, string &key)
+{
+  key.clear();
+
+  Value value;
+  for (const unique_ptr<Expression> &expr : exprs) {
+    RC rc = expr->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get value of group by expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    append(value, key);
+  }
+  return RC::SUCCESS;
+}
+
+void GroupKeyEncoder::append(const Value &value, string &key)
+{
+  const AttrType type = value.attr_type();
+  key.push_back(static_cast<char>(type));
+
+  switch (type) {
+    case INTS:
+    case DATES: {
+      int32_t v = value.get_int();
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } break;
+
+    case FLOATS: {
+      float v = value.get_float();
+      if (v == 0) {
+        v = 0;  // -0.0 与 0.0 属于同一组
+      }
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } break;
+
+    case BOOLEANS: {
+      key.push_back(value.get_boolean() ? 1 : 0);
+    } break;
+
+    case CHARS:
+    case TEXTS: {
+      const int32_t len = value.length();
+      key.append(reinterpret_cast<const char *>(&len), sizeof(len));
+      key.append(value.data(), len);
+    } break;
+
+    default: break;
+  }
+}
+
+void GroupKeyEncoder::append(const Column &column, int row, string &key)
+{
+  const AttrType type = column.type();
+  if (column.is_fixed() && !column.is_null(row) && (type == INTS || type == DATES || type == FLOATS)) {
+    const char *data = column.data<char>() + static_cast<size_t>(column.index(row)) * column.width();
+    key.push_back(static_cast<char>(type));
+    if (type == FLOATS) {
+      float v;
+      memcpy(&v, data, sizeof(v));
+      if (v == 0) {
+        v = 0;
+      }
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } else {
+      key.append(data, sizeof(int32_t));
+    }
+    return;
+  }
+
+  Value value;
+  column.get_value(row, value);
+  append(value, key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int AggregateHashTable::find_or_insert(string_view key, bool &inserted)
+{
+  // 负载因子保持在1/2以下
+  if (static_cast<size_t>(size_ + 1) * 2 > slots_.size()) {
+    grow();
+  }
+
+  const size_t h   = hash(key);
+  size_t       pos = h & mask_;
+  while (true) {
+    Slot &slot = slots_[pos];
+    if (slot.group < 0) {
+      char *buf = arena_.alloc(key.size());
+      memcpy(buf, key.data(), key.size());
+
+      slot.hash    = h;
+      slot.key     = buf;
+      slot.key_len = static_cast<int>(key.size());
+      slot.group   = size_++;
+      inserted     = true;
+      return slot.group;
+    }
+
+    if (slot.hash == h && slot.key_len == static_cast<int>(key.size()) && 0 == memcmp(slot.key, key.data(), key.size())) {
+      inserted = false;
+      return slot.group;
+    }
+    pos = (pos + 1) & mask_;
+  }
+}
+
+void AggregateHashTable::grow()
+{
+  const size_t capacity = slots_.empty() ? INITIAL_CAPACITY : slots_.size() * 2;
+
+  vector<Slot> old_slots(capacity);
+  old_slots.swap(slots_);
+  mask_ = capacity - 1;
+
+  for (const Slot &slot : old_slots) {
+    if (slot.group < 0) {
+      continue;
+    }
+
+    size_t pos = slot.hash & mask_;
+    while (slots_[pos].group >= 0) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+void AggregateHashTable::clear()
+{
+  arena_.clear();
+  slots_.clear();
+  slots_.shrink_to_fit();
+  mask_ = 0;
+  size_ = 0;
+}
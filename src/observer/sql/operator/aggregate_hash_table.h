@@ -0,0 +1,92 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/mm/arena.h"
+#include "common/rc.h"
+#include "sql/parser/value.h"
+
+class Column;
+class Expression;
+class Tuple;
+
+/**
+ * @brief 将多列分组键编码为一段字节
+ * @details 每个值编码为 | type(1B) | payload |，字符串的payload带有长度。
+ * 与连接键不同，分组时所有的NULL属于同一组，所以NULL也会编码进去。
+ */
+class GroupKeyEncoder
+{
+public:
+  /**
+   * @brief 计算tuple在exprs上的分组键
+   */
+  static RC encode(const std::vector<std::unique_ptr<Expression>> &exprs, const Tuple &tuple, std::string &key);
+
+  static void append(const Value &value, std::string &key);
+
+  /**
+   * @brief 追加列中第row行的值，编码结果与append(Value)相同
+   */
+  static void append(const Column &column, int row, std::string &key);
+};
+
+/**
+ * @brief hash聚合使用的hash表，把分组键映射到连续的分组编号
+ * @ingroup PhysicalOperator
+ * @details 使用开放寻址、线性探测。分组键保存在Arena中，槽位中保存hash值，冲突时先比较hash值再比较键。
+ * 每一行只需要一次find_or_insert，查找和插入共用同一次探测。
+ * 聚合的状态由调用者按照分组编号保存在数组中，hash表本身不关心。
+ */
+class AggregateHashTable
+{
+public:
+  AggregateHashTable() = default;
+
+  /**
+   * @brief 查找分组，不存在时插入一个新的分组
+   * @param[out] inserted 是否是新插入的分组
+   * @return 分组编号，从0开始连续分配
+   */
+  int find_or_insert(std::string_view key, bool &inserted);
+
+  int size() const { return size_; }
+
+  size_t memory_size() const { return arena_.memory_size() + slots_.capacity() * sizeof(Slot); }
+
+  void clear();
+
+  static size_t hash(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+private:
+  void grow();
+
+private:
+  struct Slot
+  {
+    size_t      hash    = 0;
+    const char *key     = nullptr;
+    int         key_len = 0;
+    int         group   = -1;  ///< -1 表示空槽位
+  };
+
+  static constexpr int INITIAL_CAPACITY = 64;
+
+  common::Arena     arena_;
+  std::vector<Slot> slots_;
+  size_t            mask_ = 0;
+  int               size_ = 0;
+};
@@ -23,8 +23,13 @@ See the Mulan PSL v2 for more details. */
 class ExplainLogicalOperator : public LogicalOperator
 {
 public:
-  ExplainLogicalOperator()          = default;
+  ExplainLogicalOperator(bool analyze) : analyze_(analyze) {}
   virtual ~ExplainLogicalOperator() = default;
 
   LogicalOperatorType type() const override { return LogicalOperatorType::EXPLAIN; }
+
+  bool analyze() const { return analyze_; }
+
+private:
+  bool analyze_ = false;
 };
@@ -18,9 +18,10 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
-RC ExplainPhysicalOperator::open(Trx *)
+RC ExplainPhysicalOperator::open(Trx *trx)
 {
   ASSERT(children_.size() == 1, "explain must has 1 child");
+  trx_ = trx;
   return RC::SUCCESS;
 }
 
@@ -32,6 +33,13 @@ RC ExplainPhysicalOperator::next()
     return RC::RECORD_EOF;
   }
 
+  if (analyze_) {
+    RC rc = execute_child();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
   stringstream ss;
   ss << "OPERATOR(NAME)\n";
 
@@ -58,6 +66,27 @@ RC ExplainPhysicalOperator::next()
 
 Tuple *ExplainPhysicalOperator::current_tuple() { return &tuple_; }
 
+RC ExplainPhysicalOperator::execute_child()
+{
+  PhysicalOperator *child = children_[0].get();
+
+  RC rc = child->open(trx_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while ((rc = child->next()) == RC::SUCCESS) {
+  }
+
+  RC close_rc = child->close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to execute child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+  return close_rc;
+}
+
 /**
  * 递归打印某个算子
  * @param os 结果输出到这里
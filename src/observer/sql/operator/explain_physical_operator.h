@@ -19,11 +19,12 @@ See the Mulan PSL v2 for more details. */
 /**
  * @brief Explain物理算子
  * @ingroup PhysicalOperator
+ * @details explain analyze 会先把子算子执行完，再输出执行计划，这样算子可以在param中带上运行时的统计信息
  */
 class ExplainPhysicalOperator : public PhysicalOperator
 {
 public:
-  ExplainPhysicalOperator()          = default;
+  ExplainPhysicalOperator(bool analyze) : analyze_(analyze) {}
   virtual ~ExplainPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::EXPLAIN; }
@@ -35,8 +36,11 @@ public:
 
 private:
   void to_string(std::ostream &os, PhysicalOperator *oper, int level, bool last_child, std::vector<bool> &ends);
+  RC   execute_child();
 
 private:
+  bool           analyze_ = false;
+  Trx           *trx_     = nullptr;
   std::string    physical_plan_;
   ValueListTuple tuple_;
 };
@@ -9,12 +9,17 @@
 class GroupLogicalOperator : public LogicalOperator
 {
 public:
-  GroupLogicalOperator( std::vector<std::unique_ptr<AggregateDesc>> descs) : aggr_descs_(std::move(descs)) {}
+  GroupLogicalOperator(
+      std::vector<std::unique_ptr<AggregateDesc>> descs, std::vector<std::unique_ptr<Expression>> group_exprs)
+      : aggr_descs_(std::move(descs)), group_exprs_(std::move(group_exprs))
+  {}
 
   virtual LogicalOperatorType type() const override { return LogicalOperatorType::GROUP; }
 
-   std::vector<std::unique_ptr<AggregateDesc>> &aggr_descs()  { return aggr_descs_; }
+  std::vector<std::unique_ptr<AggregateDesc>> &aggr_descs() { return aggr_descs_; }
+  std::vector<std::unique_ptr<Expression>>    &group_exprs() { return group_exprs_; }
 
 private:
   std::vector<std::unique_ptr<AggregateDesc>> aggr_descs_;
+  std::vector<std::unique_ptr<Expression>>    group_exprs_;  ///< group by的表达式，为空表示整个输入是一个分组
 };
\ No newline at end of file
@@ -4,19 +4,42 @@
 #include "sql/operator/physical_operator.h"
 #include "sql/parser/value.h"
 #include <cassert>
+#include <climits>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
+GroupPhysicalOperator::GroupPhysicalOperator(
+    vector<unique_ptr<AggregateDesc>> descs, vector<unique_ptr<Expression>> group_exprs)
+    : group_exprs_(std::move(group_exprs)), tuple_(aggr_specs_)
+{
+  for (const auto &desc : descs) {
+    aggr_exprs_.push_back(std::move(desc->child()));
+    aggr_types_.push_back(desc->type());
+    aggr_specs_.push_back(desc->child_spec());
+
+    const AttrType child_type = aggr_exprs_.back()->value_type();
+    int_sums_.push_back(child_type == AttrType::INTS || child_type == AttrType::BOOLEANS);
+
+    switch (desc->type()) {
+      case AggregateType::COUNT:
+      case AggregateType::SUM:
+      case AggregateType::AVG: {
+        state_index_.push_back(accumulator_num_++);
+      } break;
+      default: {
+        state_index_.push_back(value_num_++);
+      } break;
+    }
+  }
+}
+
 RC GroupPhysicalOperator::open(Trx *trx)
 {
   assert(children_.size() == 1);
-  map<vector<Value>, AggregateTuple> grouped_tuples;
-  vector<Value>                      current_group_by_values;
-  Tuple                             *tuple = nullptr;
-  PhysicalOperator                  *child = children_[0].get();
-  RC                                 rc;
+  PhysicalOperator *child = children_[0].get();
+  RC                rc;
 
   rc = child->open(trx);
   if (rc != RC::SUCCESS) {
@@ -24,32 +47,38 @@ RC GroupPhysicalOperator::open(Trx *trx)
     return rc;
   }
 
-  while ((rc = child->next()) == RC::SUCCESS) {
-    tuple = child->current_tuple();
-    Value tmp;
-    for (auto &expr : group_exprs) {
-      rc = expr->get_value(*tuple, tmp);
+  group_num_     = 0;
+  current_group_ = -1;
+  if (vectorized_execution_enabled() && child->support_chunk()) {
+    while ((rc = child->next_chunk(chunk_)) == RC::SUCCESS) {
+      rc = aggregate_chunk(chunk_);
       if (rc != RC::SUCCESS) {
-        LOG_WARN("Failed to get value from expression rc=%d:%s", rc, strrc(rc));
+        LOG_WARN("Failed to aggregate chunk rc=%d:%s", rc, strrc(rc));
         return rc;
       }
-
-      current_group_by_values.push_back(tmp);
     }
+  } else {
+    while ((rc = child->next()) == RC::SUCCESS) {
+      Tuple *tuple = child->current_tuple();
 
-    auto it = grouped_tuples.find(current_group_by_values);
-    if (it == grouped_tuples.end()) {
-      grouped_tuples.insert(
-          {std::move(current_group_by_values), tuple_factory_.generateTuple(current_group_by_values)});
-      it = grouped_tuples.find(current_group_by_values);
-      assert(it != grouped_tuples.end());
-    }
+      rc = GroupKeyEncoder::encode(group_exprs_, *tuple, group_key_);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("Failed to get group by key rc=%d:%s", rc, strrc(rc));
+        return rc;
+      }
 
-    rc = it->second.aggregate_tuple(*tuple);
-    if (rc != RC::SUCCESS) {
-      string str = tuple->to_string();
-      LOG_WARN("Failed to aggregate tuple rc=%d:%s, tuple=%s", rc, strrc(rc), str.c_str());
-      return rc;
+      bool      inserted = false;
+      const int group    = hash_table_.find_or_insert(group_key_, inserted);
+      if (inserted) {
+        init_group();
+      }
+
+      rc = aggregate(*tuple, group, inserted);
+      if (rc != RC::SUCCESS) {
+        string str = tuple->to_string();
+        LOG_WARN("Failed to aggregate tuple rc=%d:%s, tuple=%s", rc, strrc(rc), str.c_str());
+        return rc;
+      }
     }
   }
 
@@ -58,13 +87,13 @@ RC GroupPhysicalOperator::open(Trx *trx)
     return rc;
   }
 
-  for (auto &it : grouped_tuples) {
-    tuples_.push_back(std::move(it.second));
-  }
-  if (tuples_.empty() && group_exprs.empty()) {
-    tuples_.push_back(tuple_factory_.generateTuple({}));
+  // 没有group by时，即使没有数据也要输出一行
+  if (group_num_ == 0 && group_exprs_.empty()) {
+    init_group();
   }
 
+  LOG_TRACE("aggregation finished. groups=%d, memory=%ld", group_num_, hash_table_.memory_size());
+
   rc = child->close();
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to close child operator rc=%d:%s", rc, strrc(rc));
@@ -74,29 +103,251 @@ RC GroupPhysicalOperator::open(Trx *trx)
   return RC::SUCCESS;
 }
 
-RC GroupPhysicalOperator::next()
+void GroupPhysicalOperator::init_group()
+{
+  accumulators_.resize(accumulators_.size() + accumulator_num_);
+  values_.resize(values_.size() + value_num_);
+  for (int i = 0; i < value_num_; i++) {
+    values_[values_.size() - value_num_ + i].set_null();
+  }
+  group_num_++;
+}
+
+RC GroupPhysicalOperator::aggregate(const Tuple &tuple, int group, bool new_group)
+{
+  Value value;
+  for (size_t i = 0; i < aggr_exprs_.size(); ++i) {
+    const AggregateType type = aggr_types_[i];
+
+    // 分组字段在同一个分组中都是一样的，只需要在分组第一次出现时计算
+    if (type == AggregateType::GROUP && !new_group) {
+      continue;
+    }
+
+    RC rc = aggr_exprs_[i]->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("get value failed. rc=%d", rc);
+      return rc;
+    }
+
+    if (type == AggregateType::GROUP) {
+      values_[group * value_num_ + state_index_[i]] = value;
+      continue;
+    }
+
+    rc = update(group, i, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC GroupPhysicalOperator::update(int group, size_t index, const Value &value)
 {
-  if (current_tuple_index_ + 1 < (int)tuples_.size()) {
-    current_tuple_index_ += 1;
+  if (value.attr_type() == AttrType::NULLS) {
     return RC::SUCCESS;
-  } else {
+  }
+
+  const AggregateType type = aggr_types_[index];
+  switch (type) {
+    case AggregateType::COUNT:
+    case AggregateType::SUM:
+    case AggregateType::AVG: {
+      Accumulator &accumulator = accumulators_[group * accumulator_num_ + state_index_[index]];
+      accumulator.count++;
+      if (type == AggregateType::COUNT) {
+        break;
+      }
+
+      if (value.attr_type() == AttrType::INTS || value.attr_type() == AttrType::BOOLEANS) {
+        accumulator.int_sum += value.get_int();
+      } else {
+        accumulator.double_sum += value.get_double();
+        accumulator.has_double = true;
+      }
+    } break;
+
+    case AggregateType::MAX:
+    case AggregateType::MIN: {
+      Value &aggregated_value = values_[group * value_num_ + state_index_[index]];
+      if (aggregated_value.attr_type() == AttrType::NULLS) {
+        aggregated_value = value;
+      } else {
+        const int cmp_res = value.compare(aggregated_value);
+        if ((type == AggregateType::MAX && cmp_res > 0) || (type == AggregateType::MIN && cmp_res < 0)) {
+          aggregated_value = value;
+        }
+      }
+    } break;
+
+    default: {
+      LOG_WARN("Invalid aggregate type. type=%d", static_cast<int>(type));
+      return RC::INTERNAL;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC GroupPhysicalOperator::aggregate_chunk(const Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+
+  group_columns_.resize(group_exprs_.size());
+  for (size_t i = 0; i < group_exprs_.size(); i++) {
+    rc = group_exprs_[i]->get_column(chunk, group_columns_[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to get column of group by expression rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  aggr_columns_.resize(aggr_exprs_.size());
+  for (size_t i = 0; i < aggr_exprs_.size(); i++) {
+    rc = aggr_exprs_[i]->get_column(chunk, aggr_columns_[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to get column of aggregate expression rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  // 先确定每一行所属的分组，再按列更新聚合状态
+  const int rows = chunk.rows();
+  groups_.resize(rows);
+  for (int row = 0; row < rows; row++) {
+    group_key_.clear();
+    for (const shared_ptr<Column> &column : group_columns_) {
+      GroupKeyEncoder::append(*column, row, group_key_);
+    }
+
+    bool      inserted = false;
+    const int group    = hash_table_.find_or_insert(group_key_, inserted);
+    if (inserted) {
+      init_group();
+      for (size_t i = 0; i < aggr_exprs_.size(); i++) {
+        if (aggr_types_[i] == AggregateType::GROUP) {
+          aggr_columns_[i]->get_value(row, values_[group * value_num_ + state_index_[i]]);
+        }
+      }
+    }
+    groups_[row] = group;
+  }
+
+  Value value;
+  for (size_t i = 0; i < aggr_exprs_.size(); i++) {
+    const AggregateType type   = aggr_types_[i];
+    const Column       &column = *aggr_columns_[i];
+    if (type == AggregateType::GROUP) {
+      continue;
+    }
+
+    const bool native = (type == AggregateType::COUNT || type == AggregateType::SUM || type == AggregateType::AVG) &&
+                        column.is_fixed() && (column.type() == INTS || column.type() == FLOATS);
+    if (!native) {
+      for (int row = 0; row < rows; row++) {
+        column.get_value(row, value);
+        rc = update(groups_[row], i, value);
+        if (rc != RC::SUCCESS) {
+          return rc;
+        }
+      }
+      continue;
+    }
+
+    const uint8_t *nulls = column.nulls();
+    const int      step  = column.is_constant() ? 0 : 1;
+    const int      index = state_index_[i];
+    for (int row = 0; row < rows; row++) {
+      if (nulls[row * step]) {
+        continue;
+      }
+
+      Accumulator &accumulator = accumulators_[groups_[row] * accumulator_num_ + index];
+      accumulator.count++;
+      if (type == AggregateType::COUNT) {
+        continue;
+      }
+      if (column.type() == INTS) {
+        accumulator.int_sum += column.data<int32_t>()[row * step];
+      } else {
+        accumulator.double_sum += column.data<float>()[row * step];
+        accumulator.has_double = true;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC GroupPhysicalOperator::get_result(int group, int index, Value &value) const
+{
+  const AggregateType type = aggr_types_[index];
+  if (type != AggregateType::COUNT && type != AggregateType::SUM && type != AggregateType::AVG) {
+    value = values_[group * value_num_ + state_index_[index]];
+    return RC::SUCCESS;
+  }
+
+  const Accumulator &accumulator = accumulators_[group * accumulator_num_ + state_index_[index]];
+  if (type == AggregateType::COUNT) {
+    value.set_int(static_cast<int>(accumulator.count));
+    return RC::SUCCESS;
+  }
+
+  if (accumulator.count == 0) {
+    value.set_null();
+    return RC::SUCCESS;
+  }
+
+  if (type == AggregateType::AVG || !int_sums_[index]) {
+    double sum = accumulator.int_sum + accumulator.double_sum;
+    value.set_float(static_cast<float>(type == AggregateType::AVG ? sum / accumulator.count : sum));
+    return RC::SUCCESS;
+  }
+
+  // 整数的和一直按照整数返回，不能因为某个分组溢出就换成浮点数
+  if (accumulator.int_sum > INT_MAX || accumulator.int_sum < INT_MIN) {
+    LOG_WARN("sum of integers overflow. sum=%ld", accumulator.int_sum);
+    return RC::NUMERIC_OVERFLOW;
+  }
+  value.set_int(static_cast<int>(accumulator.int_sum));
+  return RC::SUCCESS;
+}
+
+RC GroupPhysicalOperator::next()
+{
+  if (current_group_ + 1 >= group_num_) {
     return RC::RECORD_EOF;
   }
+
+  current_group_ += 1;
+  vector<Value> &cells = tuple_.cells();
+  cells.resize(aggr_exprs_.size());
+  for (size_t i = 0; i < aggr_exprs_.size(); i++) {
+    RC rc = get_result(current_group_, static_cast<int>(i), cells[i]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
 }
 
 RC GroupPhysicalOperator::close()
 {
-  tuples_.clear();
-  current_tuple_index_ = -1;
+  chunk_.reset();
+  group_columns_.clear();
+  aggr_columns_.clear();
+  hash_table_.clear();
+  accumulators_.clear();
+  values_.clear();
+  group_num_     = 0;
+  current_group_ = -1;
   return RC::SUCCESS;
 }
 
 Tuple *GroupPhysicalOperator::current_tuple()
 {
-
-  if (current_tuple_index_ < 0 || current_tuple_index_ >= tuples_.size()) {
+  if (current_group_ < 0 || current_group_ >= group_num_) {
     return nullptr;
   }
 
-  return &tuples_[current_tuple_index_];
+  return &tuple_;
 }
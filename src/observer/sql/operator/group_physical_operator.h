@@ -2,16 +2,32 @@
 
 #include "sql/expr/expression.h"
 #include "sql/expr/tuple.h"
+#include "sql/operator/aggregate_hash_table.h"
 #include "sql/operator/physical_operator.h"
 #include "sql/stmt/table_ref_desc.h"
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
+/**
+ * @brief 聚合算子
+ * @ingroup PhysicalOperator
+ * @details 使用hash表做分组。分组键编码成一段字节，每一行只做一次hash查找得到分组编号，
+ * 然后更新这个分组的聚合状态。聚合状态按照分组编号存放在数组中：
+ * COUNT/SUM/AVG 使用原生的计数和求和(整数使用int64，其它使用double)，
+ * MIN/MAX和分组字段本身才需要保存Value。
+ * SUM结果的类型只由参数表达式的类型决定，与数据无关：整数的和是整数，超出int范围时返回NUMERIC_OVERFLOW，
+ * 其它类型的和是浮点数。
+ *
+ * 子算子支持向量化执行时，按chunk计算分组和聚合表达式，先求出每一行的分组编号，
+ * 再对每个聚合函数按列更新，整数和浮点数的COUNT/SUM/AVG直接读取列中的数组。
+ */
 class GroupPhysicalOperator : public PhysicalOperator
 {
 public:
-  GroupPhysicalOperator(std::vector<std::unique_ptr<AggregateDesc>> descs) : tuple_factory_(std::move(descs))
-  {}
+  GroupPhysicalOperator(
+      std::vector<std::unique_ptr<AggregateDesc>> descs, std::vector<std::unique_ptr<Expression>> group_exprs);
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::GROUP; };
 
@@ -22,8 +38,47 @@ public:
   Tuple *current_tuple() override;
 
 private:
-  AggregateTupleManager       tuple_factory_;
-  std::vector<AggregateTuple> tuples_;
-  int                         current_tuple_index_ = -1;
-  std::vector<Expression *>   group_exprs;
-};
\ No newline at end of file
+  /**
+   * @brief COUNT/SUM/AVG的聚合状态
+   */
+  struct Accumulator
+  {
+    int64_t count      = 0;  ///< 非NULL值的个数
+    int64_t int_sum    = 0;  ///< 整数值的和
+    double  double_sum = 0;  ///< 非整数值的和
+    bool    has_double = false;
+  };
+
+  RC   aggregate(const Tuple &tuple, int group, bool new_group);
+  RC   aggregate_chunk(const Chunk &chunk);
+  RC   update(int group, size_t index, const Value &value);
+  void init_group();
+  RC   get_result(int group, int index, Value &value) const;
+
+private:
+  std::vector<std::unique_ptr<Expression>> aggr_exprs_;
+  std::vector<AggregateType>               aggr_types_;
+  std::vector<TupleCellSpec>               aggr_specs_;
+  std::vector<bool>                        int_sums_;  ///< 每个SUM的结果是不是整数
+  std::vector<std::unique_ptr<Expression>> group_exprs_;
+
+  /// 每个聚合函数在accumulators_或者values_中的位置
+  std::vector<int> state_index_;
+  int              accumulator_num_ = 0;  ///< 每个分组的Accumulator个数
+  int              value_num_       = 0;  ///< 每个分组需要保存的Value个数
+
+  AggregateHashTable       hash_table_;
+  std::vector<Accumulator> accumulators_;
+  std::vector<Value>       values_;
+  std::string              group_key_;
+
+  /// 向量化执行时使用，子算子支持next_chunk时按chunk计算表达式并聚合
+  Chunk                                chunk_;
+  std::vector<std::shared_ptr<Column>> group_columns_;
+  std::vector<std::shared_ptr<Column>> aggr_columns_;
+  std::vector<int>                     groups_;  ///< chunk中每一行所属的分组
+
+  int            group_num_     = 0;
+  int            current_group_ = -1;
+  AggregateTuple tuple_;
+};
@@ -1,153 +1,517 @@
 #include "hash_join_physical_operator.h"
 #include "common/log/log.h"
+#include "session/session.h"
+#include "sql/expr/row_codec.h"
 #include "sql/expr/tuple.h"
 #include "sql/parser/value.h"
+#include "storage/db/db.h"
 #include <cassert>
 #include <memory>
 #include <utility>
 
 using namespace std;
 
-RC RbTreeEqJoinPhysicalOperator::open(Trx *trx)
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(vector<unique_ptr<Expression>> left_exprs,
+    vector<unique_ptr<Expression>> right_exprs, vector<TupleCellSpec> left_spec, vector<TupleCellSpec> right_spec)
+    : left_exprs_(std::move(left_exprs)),
+      right_exprs_(std::move(right_exprs)),
+      left_spec_(std::move(left_spec)),
+      right_spec_(std::move(right_spec)),
+      left_tuple_(left_spec_),
+      right_tuple_(right_spec_)
 {
-  assert(children_.size() == 2);
+  assert(left_exprs_.size() == right_exprs_.size());
 
-  RC rc;
-  eq_range_it_ = {left_hash_table_.end(), left_hash_table_.end()};
-  trx_         = trx;
-  left_table_  = children_[0].get();
-  right_table_ = children_[1].get();
+  vector<JoinKeyType> key_types;
+  for (size_t i = 0; i < left_exprs_.size(); i++) {
+    key_types.push_back(join_key_type(left_exprs_[i]->value_type(), right_exprs_[i]->value_type()));
+  }
+  left_key_encoder_.set_key_types(key_types);
+  right_key_encoder_.set_key_types(std::move(key_types));
+}
 
-  if ((rc = right_table_->open(trx)) != RC::SUCCESS) {
-    LOG_WARN("open right table failed");
-    return rc;
+static string join_key_name(const Expression *expr)
+{
+  if (expr->type() == ExprType::FIELD) {
+    const FieldExpr *field_expr = static_cast<const FieldExpr *>(expr);
+    return string(field_expr->table_name()) + "." + field_expr->field_name();
   }
+  return expr->name();
+}
 
-  if ((rc = generate_hash_table()) != RC::SUCCESS) {
-    LOG_WARN("generate hash table failed");
-    return rc;
+string HashJoinPhysicalOperator::param() const
+{
+  string param;
+  for (size_t i = 0; i < left_exprs_.size(); i++) {
+    if (i > 0) {
+      param += " AND ";
+    }
+    param += join_key_name(left_exprs_[i].get()) + "=" + join_key_name(right_exprs_[i].get());
   }
 
-  return RC::SUCCESS;
+  // 执行过之后(explain analyze)才有落盘的统计信息
+  if (executed_) {
+    param += ", memory_limit=" + to_string(memory_limit_);
+    param += ", spill_partitions=" + to_string(spill_partitions_);
+    param += ", spill_build_rows=" + to_string(spill_build_rows_);
+    param += ", spill_probe_rows=" + to_string(spill_probe_rows_);
+    if (spill_partitions_ > 0) {
+      param += ", spill_bytes=" + to_string(spill_bytes_);
+      param += ", spill_levels=" + to_string(max_spill_level_ + 1);
+    }
+  }
+  return param;
 }
 
-RC RbTreeEqJoinPhysicalOperator::next()
+RC HashJoinPhysicalOperator::open(Trx *trx)
 {
+  assert(children_.size() == 2);
+
   RC rc;
+  left_             = children_[0].get();
+  right_            = children_[1].get();
+  probe_entry_      = -1;
+  probe_child_done_ = false;
+  memory_partition_ = true;
+  executed_         = true;
+  spill_partitions_ = 0;
+  max_spill_level_  = 0;
+  spill_build_rows_ = 0;
+  spill_probe_rows_ = 0;
+  spill_bytes_      = 0;
 
-  if ((rc = fetch_next_tuple_in_range()) == RC::SUCCESS) {
-    return rc;
+  memory_limit_ = DEFAULT_MEMORY_LIMIT;
+  spill_dir_    = ".";
+  Session *session = Session::current_session();
+  if (session != nullptr) {
+    memory_limit_ = session->hash_join_memory_limit();
+    if (session->get_current_db() != nullptr) {
+      spill_dir_ = session->get_current_db()->path();
+    }
   }
-  if (rc != RC::RECORD_EOF) {
-    LOG_WARN("get next tuple in range failed");
+
+  rc = left_->open(trx);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("open left table failed. rc=%s", strrc(rc));
     return rc;
   }
 
-  if ((rc = fetch_next_tuple_in_table()) == RC::SUCCESS) {
+  rc = build_hash_table();
+  left_->close();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("build hash table failed. rc=%s", strrc(rc));
     return rc;
   }
-  if (rc != RC::RECORD_EOF) {
-    LOG_WARN("get next tuple in table failed");
+
+  rc = right_->open(trx);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("open right table failed. rc=%s", strrc(rc));
     return rc;
   }
 
-  return RC::RECORD_EOF;
+  return RC::SUCCESS;
 }
 
-RC RbTreeEqJoinPhysicalOperator::close()
+RC HashJoinPhysicalOperator::next()
 {
-  RC rc;
+  // 先看当前右表的行是否还有其它匹配的左表行
+  if (probe_entry_ >= 0) {
+    probe_entry_ = hash_table_.find_next(probe_entry_, probe_key_, probe_hash_);
+  }
 
-  if ((rc = right_table_->close()) != RC::SUCCESS) {
-    LOG_WARN("close right table failed");
-    return rc;
+  while (probe_entry_ < 0) {
+    RC rc = RC::SUCCESS;
+    if (!probe_child_done_) {
+      rc = fetch_next_probe_tuple();
+      if (rc == RC::SUCCESS) {
+        break;
+      }
+      if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+
+      // 右表读完了，开始处理落盘的分区
+      probe_child_done_ = true;
+      for (int i = 0; i < static_cast<int>(partitions_.size()); i++) {
+        Partition &partition = partitions_[i];
+        if ((i == 0 && memory_partition_) || partition.build->record_count() == 0 ||
+            partition.probe->record_count() == 0) {
+          continue;
+        }
+
+        rc = partition.probe->finish();
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to finish probe spill file. rc=%s", strrc(rc));
+          return rc;
+        }
+        spill_bytes_ += partition.probe->file_size();
+        pending_partitions_.push_back(std::move(partition));
+      }
+      partitions_.clear();
+      continue;
+    }
+
+    rc = fetch_next_spilled_tuple();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
   }
 
-  left_hash_table_.clear();
+  left_tuple_.set_data(hash_table_.row(probe_entry_));
+  joined_tuple_.set_left(&left_tuple_);
+  if (probe_child_done_) {
+    right_tuple_.set_data(probe_row_.data());
+    joined_tuple_.set_right(&right_tuple_);
+  } else {
+    joined_tuple_.set_right(right_->current_tuple());
+  }
   return RC::SUCCESS;
 }
 
-Tuple *RbTreeEqJoinPhysicalOperator::current_tuple() { return &current_tuple_; }
+RC HashJoinPhysicalOperator::close()
+{
+  RC rc = right_->close();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("close right table failed. rc=%s", strrc(rc));
+  }
+
+  hash_table_.clear();
+  partitions_.clear();
+  pending_partitions_.clear();
+  current_probe_file_.reset();
+  probe_entry_ = -1;
+  return rc;
+}
+
+Tuple *HashJoinPhysicalOperator::current_tuple() { return &joined_tuple_; }
 
-RC RbTreeEqJoinPhysicalOperator::generate_hash_table()
+int HashJoinPhysicalOperator::partition_of(size_t hash, int level)
 {
-  Value             value;
-  unique_ptr<Tuple> cache;
-  RC                rc;
+  // hash表的桶使用hash值的低位，分区使用高位，每拆分一层多使用PARTITION_BITS位
+  const int shift = static_cast<int>(sizeof(size_t) * 8) - PARTITION_BITS * (level + 1);
+  return static_cast<int>((hash >> shift) & (PARTITION_NUM - 1));
+}
 
-  rc = left_table_->open(trx_);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("open left table failed");
-    return rc;
+RC HashJoinPhysicalOperator::create_partitions(int level, vector<Partition> &partitions)
+{
+  partitions.resize(PARTITION_NUM);
+  for (Partition &partition : partitions) {
+    partition.level = level;
+    partition.build = make_unique<SpillFile>();
+    partition.probe = make_unique<SpillFile>();
+    RC rc = partition.build->open(spill_dir_.c_str());
+    if (rc == RC::SUCCESS) {
+      rc = partition.probe->open(spill_dir_.c_str());
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create spill file. dir=%s, rc=%s", spill_dir_.c_str(), strrc(rc));
+      return rc;
+    }
   }
 
-  while ((rc = left_table_->next()) == RC::SUCCESS) {
-    rc = cache_manager_.cloneTuple(*left_table_->current_tuple(), cache);
+  max_spill_level_ = max(max_spill_level_, level);
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::build_hash_table()
+{
+  RC   rc;
+  bool valid = false;
+
+  while ((rc = left_->next()) == RC::SUCCESS) {
+    Tuple *tuple = left_->current_tuple();
+
+    rc = left_key_encoder_.encode(left_exprs_, *tuple, spill_key_, valid);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("clone tuple failed, due to %s", strrc(rc));
-      break;
+      LOG_WARN("failed to encode join key. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // 连接键中有NULL的行不会与任何行匹配，内连接中可以直接丢弃
+    if (!valid) {
+      continue;
     }
 
-    rc = left_expr_->get_value(*cache, value);
+    rc = RowCodec::read_cells(*tuple, cells_);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("get value failed");
-      break;
+      LOG_WARN("failed to read cells of left tuple. rc=%s", strrc(rc));
+      return rc;
     }
 
-    left_hash_table_.insert({value, std::move(cache)});
+    spill_row_.resize(RowCodec::encoded_size(cells_));
+    RowCodec::encode(cells_, spill_row_.data());
+    rc = add_build_row(spill_key_, JoinHashTable::hash(spill_key_), spill_row_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
   }
 
   if (rc != RC::RECORD_EOF) {
-    LOG_WARN("next left table failed");
+    LOG_WARN("next left table failed. rc=%s", strrc(rc));
     return rc;
   }
 
+  for (Partition &partition : partitions_) {
+    rc = partition.build->finish();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to finish build spill file. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (partition.build->record_count() > 0) {
+      spill_partitions_++;
+      spill_bytes_ += partition.build->file_size();
+    }
+  }
+
+  hash_table_.build();
+  LOG_TRACE("hash join build finished. rows=%ld, memory=%ld, spill partitions=%d, spill rows=%ld",
+            hash_table_.size(), hash_table_.memory_size(), spill_partitions_, spill_build_rows_);
   return RC::SUCCESS;
 }
 
-RC RbTreeEqJoinPhysicalOperator::fetch_next_tuple_in_table()
+RC HashJoinPhysicalOperator::add_build_row(string_view key, size_t hash, string_view row)
 {
-  RC    rc;
-  Value value;
+  if (!partitions_.empty()) {
+    const int index = partition_of(hash, 0);
+    if (index != 0 || !memory_partition_) {
+      spill_build_rows_++;
+      return partitions_[index].build->append(key, row);
+    }
+  }
 
-  while (true) {
-    if ((rc = right_table_->next()) != RC::SUCCESS) {
+  hash_table_.insert(key, row);
+  if (hash_table_.memory_size() > memory_limit_) {
+    return spill_build_rows();
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::spill_build_rows()
+{
+  RC rc = RC::SUCCESS;
+  if (partitions_.empty()) {
+    LOG_INFO("hash join exceeds memory limit, start to spill. memory=%ld, limit=%ld",
+             hash_table_.memory_size(), memory_limit_);
+    rc = create_partitions(0, partitions_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    // 只保留0号分区在内存中
+    JoinHashTable memory_table;
+    for (int i = 0; i < static_cast<int>(hash_table_.size()) && rc == RC::SUCCESS; i++) {
+      string_view key   = hash_table_.key(i);
+      string_view row   = string_view(hash_table_.row(i), RowCodec::row_size(hash_table_.row(i)));
+      const int   index = partition_of(hash_table_.entry_hash(i), 0);
+      if (index == 0) {
+        memory_table.insert(key, row);
+      } else {
+        spill_build_rows_++;
+        rc = partitions_[index].build->append(key, row);
+      }
+    }
+    hash_table_.swap(memory_table);
+    if (rc != RC::SUCCESS || hash_table_.memory_size() <= memory_limit_) {
       return rc;
     }
+  }
 
-    rc = right_expr_->get_value(*right_table_->current_tuple(), value);
+  // 0号分区自己也放不下，全部落盘
+  LOG_INFO("hash join memory partition exceeds memory limit, spill it. rows=%ld", hash_table_.size());
+  memory_partition_ = false;
+  for (int i = 0; i < static_cast<int>(hash_table_.size()) && rc == RC::SUCCESS; i++) {
+    spill_build_rows_++;
+    rc = partitions_[0].build->append(hash_table_.key(i), string_view(hash_table_.row(i), RowCodec::row_size(hash_table_.row(i))));
+  }
+  hash_table_.clear();
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::fetch_next_probe_tuple()
+{
+  RC   rc;
+  bool valid = false;
+
+  while ((rc = right_->next()) == RC::SUCCESS) {
+    Tuple *tuple = right_->current_tuple();
+
+    rc = right_key_encoder_.encode(right_exprs_, *tuple, probe_key_, valid);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("get value failed");
+      LOG_WARN("failed to encode join key. rc=%s", strrc(rc));
       return rc;
     }
 
-    eq_range_it_ = left_hash_table_.equal_range(value);
-    if (eq_range_it_.first != eq_range_it_.second) {
-      break;
+    if (!valid) {
+      continue;
+    }
+
+    probe_hash_ = JoinHashTable::hash(probe_key_);
+    if (!partitions_.empty()) {
+      const int index = partition_of(probe_hash_, 0);
+      if (index != 0 || !memory_partition_) {
+        Partition &partition = partitions_[index];
+        // 左表这个分区没有数据，右表的行不可能匹配
+        if (partition.build->record_count() == 0) {
+          continue;
+        }
+
+        rc = RowCodec::read_cells(*tuple, cells_);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to read cells of right tuple. rc=%s", strrc(rc));
+          return rc;
+        }
+
+        spill_row_.resize(RowCodec::encoded_size(cells_));
+        RowCodec::encode(cells_, spill_row_.data());
+        rc = partition.probe->append(probe_key_, spill_row_);
+        if (rc != RC::SUCCESS) {
+          return rc;
+        }
+        spill_probe_rows_++;
+        continue;
+      }
+    }
+
+    probe_entry_ = hash_table_.find_first(probe_key_, probe_hash_);
+    if (probe_entry_ >= 0) {
+      return RC::SUCCESS;
     }
   }
-  
-  current_tuple_.set_left(eq_range_it_.first->second.get());
-  current_tuple_.set_right(right_table_->current_tuple());
 
-  return RC::SUCCESS;
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::fetch_next_spilled_tuple()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (current_probe_file_) {
+      while ((rc = current_probe_file_->read(probe_key_, probe_row_)) == RC::SUCCESS) {
+        probe_hash_  = JoinHashTable::hash(probe_key_);
+        probe_entry_ = hash_table_.find_first(probe_key_, probe_hash_);
+        if (probe_entry_ >= 0) {
+          return RC::SUCCESS;
+        }
+      }
+
+      if (rc != RC::RECORD_EOF) {
+        LOG_WARN("failed to read probe spill file. rc=%s", strrc(rc));
+        return rc;
+      }
+      current_probe_file_.reset();
+    }
+
+    if (pending_partitions_.empty()) {
+      hash_table_.clear();
+      return RC::RECORD_EOF;
+    }
+
+    Partition partition = std::move(pending_partitions_.back());
+    pending_partitions_.pop_back();
+
+    bool loaded = false;
+    rc          = load_partition(partition, loaded);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (loaded) {
+      current_probe_file_ = std::move(partition.probe);
+    }
+  }
 }
 
-RC RbTreeEqJoinPhysicalOperator::fetch_next_tuple_in_range()
+RC HashJoinPhysicalOperator::load_partition(Partition &partition, bool &loaded)
 {
-  // 有可能eq_range_it_已经到达end
-  if (eq_range_it_.first == eq_range_it_.second) {
-    return RC::RECORD_EOF;
+  RC rc = RC::SUCCESS;
+  loaded = false;
+  hash_table_.clear();
+
+  vector<Partition> sub_partitions;
+  while ((rc = partition.build->read(spill_key_, spill_row_)) == RC::SUCCESS) {
+    if (!sub_partitions.empty()) {
+      spill_build_rows_++;
+      rc = sub_partitions[partition_of(JoinHashTable::hash(spill_key_), partition.level + 1)].build->append(
+          spill_key_, spill_row_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      continue;
+    }
+
+    hash_table_.insert(spill_key_, spill_row_);
+    if (hash_table_.memory_size() <= memory_limit_ || partition.level >= MAX_SPILL_LEVEL) {
+      continue;
+    }
+
+    // 分区仍然放不下，使用hash值的下一段继续拆分
+    rc = create_partitions(partition.level + 1, sub_partitions);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    for (int i = 0; i < static_cast<int>(hash_table_.size()) && rc == RC::SUCCESS; i++) {
+      spill_build_rows_++;
+      rc = sub_partitions[partition_of(hash_table_.entry_hash(i), partition.level + 1)].build->append(
+          hash_table_.key(i), string_view(hash_table_.row(i), RowCodec::row_size(hash_table_.row(i))));
+    }
+    hash_table_.clear();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
   }
 
-  eq_range_it_.first++;
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read build spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+  partition.build.reset();
 
-  if (eq_range_it_.first == eq_range_it_.second) {
-    return RC::RECORD_EOF;
+  if (sub_partitions.empty()) {
+    if (partition.level >= MAX_SPILL_LEVEL && hash_table_.memory_size() > memory_limit_) {
+      LOG_WARN("hash join partition still exceeds memory limit after %d levels. memory=%ld, limit=%ld",
+               partition.level, hash_table_.memory_size(), memory_limit_);
+    }
+    hash_table_.build();
+    loaded = true;
+    return RC::SUCCESS;
   }
 
-  current_tuple_.set_left(eq_range_it_.first->second.get());
-  current_tuple_.set_right(right_table_->current_tuple());
+  for (Partition &sub_partition : sub_partitions) {
+    rc = sub_partition.build->finish();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  while ((rc = partition.probe->read(spill_key_, spill_row_)) == RC::SUCCESS) {
+    Partition &sub_partition = sub_partitions[partition_of(JoinHashTable::hash(spill_key_), partition.level + 1)];
+    if (sub_partition.build->record_count() == 0) {
+      continue;
+    }
+
+    spill_probe_rows_++;
+    rc = sub_partition.probe->append(spill_key_, spill_row_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read probe spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (Partition &sub_partition : sub_partitions) {
+    if (sub_partition.build->record_count() == 0 || sub_partition.probe->record_count() == 0) {
+      continue;
+    }
 
+    rc = sub_partition.probe->finish();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    spill_partitions_++;
+    spill_bytes_ += sub_partition.build->file_size() + sub_partition.probe->file_size();
+    pending_partitions_.push_back(std::move(sub_partition));
+  }
   return RC::SUCCESS;
 }
@@ -1,4 +1,3 @@
-
 /**
  * @brief
  *
@@ -9,49 +8,114 @@
 #include "sql/expr/expression.h"
 #include "sql/expr/tuple.h"
 #include "sql/expr/tuple_cell.h"
+#include "sql/operator/join_hash_table.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/spill_file.h"
 #include "sql/parser/value.h"
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 /**
- * @brief RbTreeJoin算子
+ * @brief HashJoin算子
  * @ingroup PhysicalOperator
- * @details 当前将左表的内容全部缓存在内存，当数据量较大时会出问题.
- *          当前只有在expr(left_field) = expr(right_field)时才能使用RbTreeJoin
+ * @details 使用左表建立hash表，然后遍历右表去hash表中查找。
+ *          连接条件可以是多个 expr(left_field) = expr(right_field) 的AND，
+ *          其它的条件由上层的PredicateOperator处理。
+ *
+ *          hash表超过内存限制(会话变量hash_join_memory_limit)时，使用hybrid hash join：
+ *          按照连接键的hash值把两边的数据分成多个分区，0号分区仍然留在内存中，其它分区写到数据库目录下的临时文件。
+ *          右表中属于内存分区的行直接探测，其它的行写到对应分区的文件中。
+ *          右表读完后，再逐个把分区读回内存做连接。如果某个分区读回来时仍然超过内存限制，就使用hash值的
+ *          下一段比特继续拆分，直到达到最大的拆分层数。
  */
-
-class RbTreeEqJoinPhysicalOperator : public PhysicalOperator
+class HashJoinPhysicalOperator : public PhysicalOperator
 {
 public:
-  RbTreeEqJoinPhysicalOperator(std::unique_ptr<Expression> left_expr, std::unique_ptr<Expression> right_expr,
-      std::vector<TupleCellSpec> left_spec)
-      : left_expr_(std::move(left_expr)), right_expr_(std::move(right_expr)), cache_manager_(std::move(left_spec))
-  {}
-  virtual PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; };
+  HashJoinPhysicalOperator(std::vector<std::unique_ptr<Expression>> left_exprs,
+      std::vector<std::unique_ptr<Expression>> right_exprs, std::vector<TupleCellSpec> left_spec,
+      std::vector<TupleCellSpec> right_spec);
+
+  virtual ~HashJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; };
 
-  virtual RC open(Trx *trx) override;
-  virtual RC next() override;
-  virtual RC close() override;
+  std::string param() const override;
 
-  virtual Tuple *current_tuple() override;
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  /// 没有设置会话变量时的内存限制
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
 
 private:
-  RC generate_hash_table();
-  RC fetch_next_tuple_in_table();
-  RC fetch_next_tuple_in_range();
+  /**
+   * @brief 一个落盘的分区
+   */
+  struct Partition
+  {
+    std::unique_ptr<SpillFile> build;  ///< 左表的行
+    std::unique_ptr<SpillFile> probe;  ///< 右表的行
+    int                        level = 0;
+  };
+
+  RC build_hash_table();
+  RC add_build_row(std::string_view key, size_t hash, std::string_view row);
+  RC spill_build_rows();
+  RC create_partitions(int level, std::vector<Partition> &partitions);
+
+  RC fetch_next_probe_tuple();
+  RC fetch_next_spilled_tuple();
+  RC load_partition(Partition &partition, bool &loaded);
+
+  static int partition_of(size_t hash, int level);
 
 private:
-  std::unique_ptr<Expression> left_expr_;
-  std::unique_ptr<Expression> right_expr_;
-
-  PhysicalOperator                               *left_table_;
-  PhysicalOperator                               *right_table_;
-  std::multimap<Value, std::unique_ptr<Tuple>>    left_hash_table_;
-  decltype(left_hash_table_.equal_range(Value())) eq_range_it_;
-
-  CacheTupleManager cache_manager_;
-  Trx              *trx_;
-  JoinedTuple       current_tuple_;
-};
\ No newline at end of file
+  static constexpr int PARTITION_BITS  = 4;
+  static constexpr int PARTITION_NUM   = 1 << PARTITION_BITS;
+  static constexpr int MAX_SPILL_LEVEL = 3;
+
+  std::vector<std::unique_ptr<Expression>> left_exprs_;   ///< 左表(build)的连接键
+  std::vector<std::unique_ptr<Expression>> right_exprs_;  ///< 右表(probe)的连接键
+  std::vector<TupleCellSpec>               left_spec_;
+  std::vector<TupleCellSpec>               right_spec_;
+
+  JoinKeyEncoder left_key_encoder_;
+  JoinKeyEncoder right_key_encoder_;
+  JoinHashTable  hash_table_;
+
+  PhysicalOperator *left_  = nullptr;
+  PhysicalOperator *right_ = nullptr;
+
+  size_t      memory_limit_ = DEFAULT_MEMORY_LIMIT;
+  std::string spill_dir_;
+
+  std::vector<Partition> partitions_;              ///< 第一次拆分出的分区，为空表示没有落盘
+  bool                   memory_partition_ = true;  ///< 0号分区是否仍然在内存中
+  std::vector<Partition> pending_partitions_;      ///< 右表读完后，等待处理的分区
+  std::unique_ptr<SpillFile> current_probe_file_;  ///< 正在处理的分区的右表数据
+  bool                       probe_child_done_ = false;
+
+  std::string probe_key_;          ///< 右表当前行的连接键
+  std::string probe_row_;          ///< 从分区文件中读出来的右表行
+  std::string spill_key_;
+  std::string spill_row_;
+  size_t      probe_hash_  = 0;    ///< probe_key_的hash值
+  int         probe_entry_ = -1;   ///< 当前匹配到的hash表中的entry
+  std::vector<Value> cells_;
+
+  bool    executed_           = false;
+  int     spill_partitions_   = 0;  ///< 落盘的分区数，包括再次拆分的分区
+  int     max_spill_level_    = 0;
+  int64_t spill_build_rows_   = 0;
+  int64_t spill_probe_rows_   = 0;
+  int64_t spill_bytes_        = 0;
+
+  EncodedTuple left_tuple_;
+  EncodedTuple right_tuple_;
+  JoinedTuple  joined_tuple_;
+};
@@ -73,6 +73,11 @@ RC IndexScanPhysicalOperator::next()
   bool filter_result = false;
   while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
     rc = record_handler_->get_record(rid, current_record_);
+    if (rc == RC::RECORD_NOT_EXIST) {
+      // 拿到索引项之后，记录被回滚或者回收了，对当前事务不可见
+      LOG_TRACE("record has been removed. rid=%s", rid.to_string().c_str());
+      continue;
+    }
     if (OB_FAIL(rc)) {
       LOG_TRACE("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
       return rc;
@@ -128,6 +133,17 @@ void IndexScanPhysicalOperator::set_predicates(std::vector<std::unique_ptr<Expre
   predicates_ = std::move(exprs);
 }
 
+void IndexScanPhysicalOperator::collect_plan_params(std::vector<PlanParam> &params)
+{
+  if (value_position_ >= 0) {
+    params.push_back(PlanParam{value_position_, &left_value_});
+    params.push_back(PlanParam{value_position_, &right_value_});
+  }
+  for (std::unique_ptr<Expression> &predicate : predicates_) {
+    ::collect_plan_params(*predicate, params);
+  }
+}
+
 RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 {
   RC    rc = RC::SUCCESS;
@@ -42,6 +42,13 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 索引查找的值在SQL中的位置，执行计划缓存替换常量时同时替换索引查找的值
+   */
+  void set_value_position(int position) { value_position_ = position; }
+
+  void collect_plan_params(std::vector<PlanParam> &params) override;
+
 private:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
@@ -62,6 +69,7 @@ private:
   Value right_value_;
   bool  left_inclusive_  = false;
   bool  right_inclusive_ = false;
+  int   value_position_  = -1;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
 };
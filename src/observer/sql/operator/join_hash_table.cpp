@@ -0,0 +1,220 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/join_hash_table.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/row_codec.h"
+#include "sql/expr/tuple.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+static bool is_integer_type(AttrType type) { return type == INTS || type == DATES || type == BOOLEANS; }
+static bool is_string_type(AttrType type) { return type == CHARS || type == TEXTS; }
+
+JoinKeyType join_key_type(AttrType left, AttrType right)
+{
+  if (is_integer_type(left) && is_integer_type(right)) {
+    return JoinKeyType::INTEGER;
+  }
+  if (is_string_type(left) && is_string_type(right)) {
+    return JoinKeyType::STRING;
+  }
+  if ((left == DATES && right == CHARS) || (left == CHARS && right == DATES)) {
+    return JoinKeyType::DATE;
+  }
+  return JoinKeyType::DOUBLE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC JoinKeyEncoder::encode(
+    const vector<unique_ptr<Expression>> &exprs, const Tuple &tuple, string &key, bool &valid) const
+{
+  key.clear();
+  valid = true;
+
+  Value value;
+  for (size_t i = 0; i < exprs.size(); i++) {
+    RC rc = exprs[i]->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get value of join key. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (!append(value, key_types_[i], key)) {
+      valid = false;
+      return RC::SUCCESS;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+bool JoinKeyEncoder::encode_values(const vector<Value> &values, string &key) const
+{
+  key.clear();
+  for (size_t i = 0; i < values.size(); i++) {
+    if (!append(values[i], key_types_[i], key)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool JoinKeyEncoder::append(const Value &value, JoinKeyType key_type, string &key) const
+{
+  if (value.attr_type() == NULLS || value.attr_type() == UNDEFINED) {
+    return false;
+  }
+
+  switch (key_type) {
+    case JoinKeyType::INTEGER: {
+      int64_t v = value.get_int();
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } break;
+
+    case JoinKeyType::DOUBLE: {
+      double v = value.get_double();
+      if (v == 0) {
+        v = 0;  // -0.0 与 0.0 相等，但是字节不同
+      }
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } break;
+
+    case JoinKeyType::STRING: {
+      const char   *data = value.data();
+      const int32_t len  = value.length();
+      key.append(reinterpret_cast<const char *>(&len), sizeof(len));
+      key.append(data, len);
+    } break;
+
+    case JoinKeyType::DATE: {
+      int64_t v = 0;
+      if (value.attr_type() == DATES) {
+        v = value.get_int();
+      } else {
+        Value       date;
+        std::string str = value.get_string();
+        date.set_date(str.c_str());
+        if (date.attr_type() == NULLS) {
+          return false;  // 非法的日期不会与任何日期相等
+        }
+        v = date.get_int();
+      }
+      key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } break;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void JoinHashTable::insert(string_view key, const vector<Value> &cells)
+{
+  char *row = alloc_entry(key, RowCodec::encoded_size(cells));
+  RowCodec::encode(cells, row);
+}
+
+void JoinHashTable::insert(string_view key, string_view row)
+{
+  char *buf = alloc_entry(key, static_cast<int>(row.size()));
+  memcpy(buf, row.data(), row.size());
+}
+
+char *JoinHashTable::alloc_entry(string_view key, int row_size)
+{
+  ASSERT(buckets_.empty(), "cannot insert after hash table built");
+
+  char *buf = arena_.alloc(key.size() + row_size);
+  memcpy(buf, key.data(), key.size());
+  // 键和行数据紧挨着放，RowCodec读取时使用memcpy，不要求对齐
+  char *row = buf + key.size();
+
+  Entry entry;
+  entry.hash    = hash(key);
+  entry.key     = buf;
+  entry.key_len = static_cast<int>(key.size());
+  entry.next    = -1;
+  entry.row     = row;
+  entries_.push_back(entry);
+  return row;
+}
+
+void JoinHashTable::build()
+{
+  size_t bucket_num = 16;
+  while (bucket_num < entries_.size()) {
+    bucket_num <<= 1;
+  }
+
+  buckets_.assign(bucket_num, -1);
+  bucket_mask_ = bucket_num - 1;
+
+  // 倒序插入链表头，这样同一个桶中的entry保持插入的顺序
+  for (int i = static_cast<int>(entries_.size()) - 1; i >= 0; i--) {
+    Entry &entry = entries_[i];
+    int   &head  = buckets_[entry.hash & bucket_mask_];
+    entry.next   = head;
+    head         = i;
+  }
+}
+
+int JoinHashTable::find_first(string_view key, size_t hash) const
+{
+  if (buckets_.empty()) {
+    return -1;
+  }
+  return match(buckets_[hash & bucket_mask_], key, hash);
+}
+
+int JoinHashTable::find_next(int entry, string_view key, size_t hash) const
+{
+  if (entry < 0) {
+    return -1;
+  }
+  return match(entries_[entry].next, key, hash);
+}
+
+int JoinHashTable::match(int entry, string_view key, size_t hash) const
+{
+  while (entry >= 0) {
+    const Entry &e = entries_[entry];
+    if (e.hash == hash && e.key_len == static_cast<int>(key.size()) && 0 == memcmp(e.key, key.data(), key.size())) {
+      return entry;
+    }
+    entry = e.next;
+  }
+  return -1;
+}
+
+size_t JoinHashTable::memory_size() const
+{
+  return arena_.memory_size() + entries_.capacity() * sizeof(Entry) + buckets_.capacity() * sizeof(int);
+}
+
+void JoinHashTable::clear()
+{
+  arena_.clear();
+  entries_.clear();
+  entries_.shrink_to_fit();
+  buckets_.clear();
+  buckets_.shrink_to_fit();
+  bucket_mask_ = 0;
+}
+
+void JoinHashTable::swap(JoinHashTable &other)
+{
+  arena_.swap(other.arena_);
+  entries_.swap(other.entries_);
+  buckets_.swap(other.buckets_);
+  std::swap(bucket_mask_, other.bucket_mask_);
+}
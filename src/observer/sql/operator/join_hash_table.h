@@ -0,0 +1,151 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/mm/arena.h"
+#include "common/rc.h"
+#include "sql/parser/value.h"
+
+class Expression;
+class Tuple;
+
+/**
+ * @brief 连接键的编码方式
+ * @details 等值连接两边的类型可能不同，比如int和float、date和char。
+ * 为了能够直接比较字节，需要先把两边的值转换成同一种表示。
+ * 这里与Value::compare的语义保持一致，只是浮点数按照精确值比较。
+ */
+enum class JoinKeyType
+{
+  INTEGER,  ///< int/date/boolean之间比较，按照int64编码
+  DOUBLE,   ///< 涉及浮点数或者字符串与数字之间的比较，按照double编码
+  STRING,   ///< 字符串之间比较，编码为长度+内容
+  DATE,     ///< date与字符串比较，字符串需要按照日期解析
+};
+
+/**
+ * @brief 根据等值条件两边的值类型，确定连接键的编码方式
+ */
+JoinKeyType join_key_type(AttrType left, AttrType right);
+
+/**
+ * @brief 将多列连接键编码为一段字节
+ * @details 编码后的字节相等，当且仅当每一列的值都相等。包含NULL的键不会与任何键相等。
+ */
+class JoinKeyEncoder
+{
+public:
+  JoinKeyEncoder() = default;
+  JoinKeyEncoder(std::vector<JoinKeyType> key_types) : key_types_(std::move(key_types)) {}
+
+  void set_key_types(std::vector<JoinKeyType> key_types) { key_types_ = std::move(key_types); }
+
+  /**
+   * @brief 计算tuple在exprs上的连接键
+   * @param[out] key 编码后的键
+   * @param[out] valid 键中是否没有NULL，只有valid的键才需要参与连接
+   */
+  RC encode(const std::vector<std::unique_ptr<Expression>> &exprs, const Tuple &tuple, std::string &key,
+      bool &valid) const;
+
+  /**
+   * @brief 对已经取出来的值做编码
+   */
+  bool encode_values(const std::vector<Value> &values, std::string &key) const;
+
+private:
+  bool append(const Value &value, JoinKeyType key_type, std::string &key) const;
+
+private:
+  std::vector<JoinKeyType> key_types_;
+};
+
+/**
+ * @brief hash join 使用的hash表
+ * @ingroup PhysicalOperator
+ * @details 使用拉链法。所有的键和行数据都放在Arena中，Entry存放在一个vector中，
+ * 不会因为每插入一行就做一次堆内存分配。插入完成后调用build建立桶，之后就不能再插入了。
+ * 相同键的多行在同一条链上，查找时依次比较hash值和键的内容。
+ */
+class JoinHashTable
+{
+public:
+  JoinHashTable() = default;
+
+  /**
+   * @brief 插入一行
+   * @param key 编码后的连接键
+   * @param cells 行数据，会使用RowCodec编码后保存
+   */
+  void insert(std::string_view key, const std::vector<Value> &cells);
+
+  /**
+   * @brief 插入一行已经使用RowCodec编码过的数据
+   */
+  void insert(std::string_view key, std::string_view row);
+
+  /**
+   * @brief 所有数据插入完成后，建立hash桶
+   */
+  void build();
+
+  /**
+   * @brief 查找与key相等的第一行
+   * @return entry的编号，-1表示没有找到
+   */
+  int find_first(std::string_view key, size_t hash) const;
+
+  /**
+   * @brief 在同一条链上查找下一个与key相等的行
+   */
+  int find_next(int entry, std::string_view key, size_t hash) const;
+
+  const char      *row(int entry) const { return entries_[entry].row; }
+  std::string_view key(int entry) const { return std::string_view(entries_[entry].key, entries_[entry].key_len); }
+  size_t           entry_hash(int entry) const { return entries_[entry].hash; }
+
+  size_t size() const { return entries_.size(); }
+  bool   empty() const { return entries_.empty(); }
+
+  /**
+   * @brief 当前hash表大概占用的内存
+   */
+  size_t memory_size() const;
+
+  void clear();
+  void swap(JoinHashTable &other);
+
+  static size_t hash(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+private:
+  char *alloc_entry(std::string_view key, int row_size);
+  int   match(int entry, std::string_view key, size_t hash) const;
+
+private:
+  struct Entry
+  {
+    size_t      hash;
+    const char *key;
+    int         key_len;
+    int         next;  ///< 同一个桶中的下一个entry
+    const char *row;
+  };
+
+  common::Arena      arena_;
+  std::vector<Entry> entries_;
+  std::vector<int>   buckets_;
+  size_t             bucket_mask_ = 0;
+};
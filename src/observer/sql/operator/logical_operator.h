@@ -41,6 +41,7 @@ enum class LogicalOperatorType
   UPDATE,      ///< 更新
   EXPLAIN,     ///< 查看执行计划
   GROUP,       ///< 分组
+  SORT,        ///< 排序
 };
 
 /**
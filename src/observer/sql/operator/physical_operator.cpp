@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/physical_operator.h"
+#include "session/session.h"
+#include "sql/expr/expression.h"
 
 std::string physical_operator_type_name(PhysicalOperatorType type)
 {
@@ -28,6 +30,7 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::STRING_LIST: return "STRING_LIST";
     case PhysicalOperatorType::GROUP: return "GROUP";
     case PhysicalOperatorType::HASH_JOIN: return "HASH_JOIN";
+    case PhysicalOperatorType::SORT: return "SORT";
     default: return "UNKNOWN";
   }
 }
@@ -37,3 +40,16 @@ PhysicalOperator::~PhysicalOperator() {}
 std::string PhysicalOperator::name() const { return physical_operator_type_name(type()); }
 
 std::string PhysicalOperator::param() const { return ""; }
+
+void PhysicalOperator::collect_plan_params(std::vector<PlanParam> &params)
+{
+  for (std::unique_ptr<PhysicalOperator> &child : children_) {
+    child->collect_plan_params(params);
+  }
+}
+
+bool PhysicalOperator::vectorized_execution_enabled()
+{
+  Session *session = Session::current_session();
+  return session == nullptr || session->vectorized_execution();
+}
@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 class Record;
 class TupleCellSpec;
 class Trx;
+struct PlanParam;
 
 /**
  * @brief 物理算子
@@ -49,6 +50,7 @@ enum class PhysicalOperatorType
   INSERT,
   UPDATE,
   GROUP,
+  SORT,
 };
 
 /**
@@ -76,10 +78,34 @@ public:
 
   virtual Tuple *current_tuple() = 0;
 
+  /**
+   * @brief 是否可以通过next_chunk一次输出一批数据
+   * @details 向量化执行时，上层算子在open之后根据这个结果决定使用next还是next_chunk，两者不能混用
+   */
+  virtual bool support_chunk() const { return false; }
+
+  /**
+   * @brief 输出下一批数据，每批最多Chunk::MAX_ROWS行
+   * @details 输出的chunk至少有一行，没有数据时返回RC::RECORD_EOF
+   */
+  virtual RC next_chunk(Chunk &chunk) { return RC::UNIMPLENMENT; }
+
+  /**
+   * @brief 收集执行计划中可以替换的常量，执行计划缓存复用计划时使用
+   * @details 默认只收集子算子的。算子中其它的常量(比如投影、排序中的)不收集，会作为执行计划的一部分
+   */
+  virtual void collect_plan_params(std::vector<PlanParam> &params);
+
   void add_child(std::unique_ptr<PhysicalOperator> oper) { children_.emplace_back(std::move(oper)); }
 
   std::vector<std::unique_ptr<PhysicalOperator>> &children() { return children_; }
 
+protected:
+  /**
+   * @brief 当前会话是否开启了向量化执行(会话变量vectorized_execution)
+   */
+  static bool vectorized_execution_enabled();
+
 protected:
   std::vector<std::unique_ptr<PhysicalOperator>> children_;
 };
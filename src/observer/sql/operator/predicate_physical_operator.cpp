@@ -58,6 +58,26 @@ RC PredicatePhysicalOperator::next()
   return rc;
 }
 
+RC PredicatePhysicalOperator::next_chunk(Chunk &chunk)
+{
+  RC                rc   = RC::SUCCESS;
+  PhysicalOperator *oper = children_.front().get();
+
+  while (RC::SUCCESS == (rc = oper->next_chunk(chunk))) {
+    rc = expression_->get_column(chunk, filter_column_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    filter_column_->collect_true(chunk.rows(), selection_);
+    chunk.select(selection_);
+    if (chunk.rows() > 0) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
 RC PredicatePhysicalOperator::close()
 {
   children_[0]->close();
@@ -65,3 +85,9 @@ RC PredicatePhysicalOperator::close()
 }
 
 Tuple *PredicatePhysicalOperator::current_tuple() { return children_[0]->current_tuple(); }
+
+void PredicatePhysicalOperator::collect_plan_params(std::vector<PlanParam> &params)
+{
+  ::collect_plan_params(*expression_, params);
+  PhysicalOperator::collect_plan_params(params);
+}
@@ -38,6 +38,13 @@ public:
 
   Tuple *current_tuple() override;
 
+  bool support_chunk() const override { return children_.size() == 1 && children_[0]->support_chunk(); }
+  RC   next_chunk(Chunk &chunk) override;
+
+  void collect_plan_params(std::vector<PlanParam> &params) override;
+
 private:
   std::unique_ptr<Expression> expression_;
+  std::shared_ptr<Column>     filter_column_;
+  std::vector<int>            selection_;
 };
@@ -35,6 +35,13 @@ RC ProjectPhysicalOperator::open(Trx *trx)
     return rc;
   }
 
+  chunk_mode_ = vectorized_execution_enabled() && child->support_chunk();
+  row_        = -1;
+  input_.reset();
+  output_.reset();
+  chunk_tuple_.set_chunk(&output_);
+  chunk_tuple_.set_parent(&input_tuple_);
+  input_tuple_.set_chunk(&input_);
   return RC::SUCCESS;
 }
 
@@ -47,11 +54,45 @@ RC ProjectPhysicalOperator::next()
     } else {
       return RC::RECORD_EOF;
     }
+  } else if (chunk_mode_) {
+    if (++row_ < output_.rows()) {
+      return RC::SUCCESS;
+    }
+
+    RC rc = fetch_chunk();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    row_ = 0;
+    return RC::SUCCESS;
   } else {
     return children_[0]->next();
   }
 }
 
+RC ProjectPhysicalOperator::fetch_chunk()
+{
+  output_.reset();
+  RC rc = children_[0]->next_chunk(input_);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const vector<unique_ptr<Expression>> &exprs  = tuple_.project_exprs();
+  const vector<TupleCellSpec>          &schema = tuple_.tuple_schema();
+  output_columns_.resize(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    rc = exprs[i]->get_column(input_, output_columns_[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get column of project expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    output_.add_column(i < schema.size() ? schema[i] : TupleCellSpec(exprs[i]->name().c_str()), output_columns_[i]);
+  }
+  output_.set_rows(input_.rows());
+  return RC::SUCCESS;
+}
+
 RC ProjectPhysicalOperator::close()
 {
   RC rc;
@@ -71,6 +112,10 @@ Tuple *ProjectPhysicalOperator::current_tuple()
 {
   if (children_.empty()) {
     tuple_.set_tuple(fake_tuple);
+  } else if (chunk_mode_) {
+    chunk_tuple_.set_row(row_);
+    input_tuple_.set_row(row_);
+    return &chunk_tuple_;
   } else {
     tuple_.set_tuple(children_[0]->current_tuple());
   }
@@ -23,6 +23,12 @@ See the Mulan PSL v2 for more details. */
  * @brief 选择/投影物理算子
  * @ingroup PhysicalOperator
  */
+/**
+ * @brief 投影物理算子
+ * @ingroup PhysicalOperator
+ * @details 子算子支持向量化执行时，每次从子算子获取一个chunk，按列计算投影表达式，
+ * 再从计算结果中逐行输出，上层算子看到的仍然是按行的接口。
+ */
 class ProjectPhysicalOperator : public PhysicalOperator
 {
 public:
@@ -45,7 +51,22 @@ public:
 
   Tuple *current_tuple() override;
 
+private:
+  /**
+   * @brief 从子算子获取下一个chunk，按列计算所有投影表达式
+   */
+  RC fetch_chunk();
+
 private:
   ProjectTuple tuple_;
   bool const_eof_ = false; //是否已经输出常量, 当不是常量时，此字段无效
+
+  /// 子算子支持时按chunk执行，投影结果按行输出
+  bool                                 chunk_mode_ = false;
+  Chunk                                input_;
+  Chunk                                output_;
+  std::vector<std::shared_ptr<Column>> output_columns_;
+  int                                  row_ = -1;  ///< 当前输出的行在output_中的位置
+  ChunkTuple                           chunk_tuple_;
+  ChunkTuple                           input_tuple_;
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple_cell.h"
+#include "sql/operator/logical_operator.h"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 排序逻辑算子
+ * @ingroup LogicalOperator
+ * @details 放在投影算子之上，排序字段是投影结果中的列。
+ * 投影结果的前面几列是select的字段(tuple_schema)，之后的列是只用于排序的order by表达式，排序后不再输出。
+ */
+class SortLogicalOperator : public LogicalOperator
+{
+public:
+  SortLogicalOperator(std::vector<OrderByDesc> order_by, std::vector<TupleCellSpec> tuple_schema, int limit)
+      : order_by_(std::move(order_by)), tuple_schema_(std::move(tuple_schema)), limit_(limit)
+  {}
+
+  virtual LogicalOperatorType type() const override { return LogicalOperatorType::SORT; }
+
+  std::vector<OrderByDesc>         &order_by() { return order_by_; }
+  const std::vector<TupleCellSpec> &tuple_schema() const { return tuple_schema_; }
+  int                               limit() const { return limit_; }
+
+private:
+  std::vector<OrderByDesc>   order_by_;
+  std::vector<TupleCellSpec> tuple_schema_;  ///< 输出的列
+  int                        limit_ = -1;    ///< 最多输出的行数，-1 表示没有限制
+};
@@ -0,0 +1,518 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/sort_physical_operator.h"
+#include "common/log/log.h"
+#include "session/session.h"
+#include "sql/expr/row_codec.h"
+#include "storage/db/db.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+enum SortKeyClass : char
+{
+  NULL_CLASS    = 0,
+  NUMBER_CLASS  = 1,
+  DATE_CLASS    = 2,
+  STRING_CLASS  = 3,
+};
+
+void append_uint64(uint64_t v, string &key)
+{
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((v >> shift) & 0xFF));
+  }
+}
+
+void append_uint32(uint32_t v, string &key)
+{
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((v >> shift) & 0xFF));
+  }
+}
+
+bool top_n_less(const pair<string, string> &a, const pair<string, string> &b) { return a.first < b.first; }
+
+}  // namespace
+
+void SortKeyEncoder::append(const Value &value, bool is_asc, string &key)
+{
+  const size_t start = key.size();
+  switch (value.attr_type()) {
+    case INTS:
+    case FLOATS:
+    case BOOLEANS: {
+      // 整数和浮点数可能出现在同一列中(比如表达式的结果)，统一按照double比较，int32转换成double不会丢失精度
+      key.push_back(NUMBER_CLASS);
+      double v = value.get_double();
+      if (v == 0) {
+        v = 0;  // -0.0 与 0.0 相等
+      }
+      uint64_t bits = 0;
+      memcpy(&bits, &v, sizeof(bits));
+      // 负数所有的位取反，正数只把符号位置1，这样按照无符号整数比较的结果与浮点数一致
+      bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+      append_uint64(bits, key);
+    } break;
+
+    case DATES: {
+      key.push_back(DATE_CLASS);
+      append_uint32(static_cast<uint32_t>(value.get_int()) ^ (1U << 31), key);
+    } break;
+
+    case CHARS:
+    case TEXTS: {
+      key.push_back(STRING_CLASS);
+      const char *data = value.data();
+      for (int i = 0; i < value.length(); i++) {
+        key.push_back(data[i]);
+        if (data[i] == 0) {
+          key.push_back(static_cast<char>(0xFF));
+        }
+      }
+      key.push_back(0);
+      key.push_back(0);
+    } break;
+
+    default: {
+      key.push_back(NULL_CLASS);
+    } break;
+  }
+
+  if (!is_asc) {
+    for (size_t i = start; i < key.size(); i++) {
+      key[i] = static_cast<char>(~key[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SortPhysicalOperator::SortPhysicalOperator(vector<OrderByDesc> order_by, vector<TupleCellSpec> tuple_schema, int limit)
+    : order_by_(std::move(order_by)), tuple_schema_(std::move(tuple_schema)), limit_(limit), tuple_(tuple_schema_)
+{}
+
+string SortPhysicalOperator::param() const
+{
+  string param;
+  for (size_t i = 0; i < order_by_.size(); i++) {
+    if (i > 0) {
+      param += ", ";
+    }
+    param += order_by_[i].name + (order_by_[i].is_asc ? " ASC" : " DESC");
+  }
+  if (limit_ >= 0) {
+    param += ", limit=" + to_string(limit_);
+  }
+
+  // 执行过之后(explain analyze)才有落盘的统计信息
+  if (executed_) {
+    param += ", memory_limit=" + to_string(memory_limit_);
+    param += string(", top_n=") + (top_n_ ? "true" : "false");
+    param += ", runs=" + to_string(run_count_);
+    if (run_count_ > 0) {
+      param += ", merge_passes=" + to_string(merge_passes_);
+      param += ", spill_rows=" + to_string(spill_rows_);
+      param += ", spill_bytes=" + to_string(spill_bytes_);
+    }
+  }
+  return param;
+}
+
+RC SortPhysicalOperator::open(Trx *trx)
+{
+  assert(children_.size() == 1);
+
+  executed_     = true;
+  run_count_    = 0;
+  merge_passes_ = 0;
+  spill_rows_   = 0;
+  spill_bytes_  = 0;
+  row_seq_      = 0;
+  position_     = -1;
+  output_count_ = 0;
+  top_n_        = limit_ >= 0;
+
+  memory_limit_ = DEFAULT_MEMORY_LIMIT;
+  spill_dir_    = ".";
+  Session *session = Session::current_session();
+  if (session != nullptr) {
+    memory_limit_ = session->sort_memory_limit();
+    if (session->get_current_db() != nullptr) {
+      spill_dir_ = session->get_current_db()->path();
+    }
+  }
+
+  PhysicalOperator *child = children_[0].get();
+  RC                rc    = child->open(trx);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while ((rc = child->next()) == RC::SUCCESS) {
+    rc = encode_tuple(*child->current_tuple());
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+
+    if (top_n_) {
+      rc = add_to_top_n();
+    } else {
+      rc = add_to_buffer(key_, row_);
+    }
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read and sort child tuples. rc=%s", strrc(rc));
+    child->close();
+    return rc;
+  }
+
+  rc = child->close();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to close child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (top_n_) {
+    // 堆顶是最大的行，sort_heap之后就是升序的
+    sort_heap(top_n_heap_.begin(), top_n_heap_.end(), top_n_less);
+    LOG_TRACE("top-n sort finished. rows=%ld, memory=%ld", top_n_heap_.size(), top_n_memory_);
+    return RC::SUCCESS;
+  }
+
+  if (runs_.empty()) {
+    sort(entries_.begin(), entries_.end(), [](const SortEntry &a, const SortEntry &b) {
+      return a.key_view() < b.key_view();
+    });
+    LOG_TRACE("in-memory sort finished. rows=%ld, memory=%ld", entries_.size(), buffer_memory_size());
+    return RC::SUCCESS;
+  }
+
+  return prepare_merge();
+}
+
+RC SortPhysicalOperator::encode_tuple(Tuple &tuple)
+{
+  key_.clear();
+  for (const OrderByDesc &order_by : order_by_) {
+    Value value;
+    RC    rc = tuple.cell_at(order_by.cell_index, value);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get order by value. index=%d, rc=%s", order_by.cell_index, strrc(rc));
+      return rc;
+    }
+    SortKeyEncoder::append(value, order_by.is_asc, key_);
+  }
+
+  // 最后加上行的序号，相同的排序字段按照输入的顺序输出，归并时也不需要额外处理
+  append_uint64(static_cast<uint64_t>(row_seq_++), key_);
+
+  cells_.resize(tuple_schema_.size());
+  for (size_t i = 0; i < tuple_schema_.size(); i++) {
+    RC rc = tuple.cell_at(static_cast<int>(i), cells_[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get cell. index=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+  }
+
+  row_.resize(RowCodec::encoded_size(cells_));
+  RowCodec::encode(cells_, row_.data());
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::add_to_top_n()
+{
+  if (static_cast<int>(top_n_heap_.size()) < limit_) {
+    top_n_memory_ += key_.size() + row_.size();
+    top_n_heap_.emplace_back(key_, row_);
+    push_heap(top_n_heap_.begin(), top_n_heap_.end(), top_n_less);
+  } else if (!top_n_heap_.empty() && key_ < top_n_heap_.front().first) {
+    // 比堆中最大的行小，替换掉它
+    pop_heap(top_n_heap_.begin(), top_n_heap_.end(), top_n_less);
+    pair<string, string> &last = top_n_heap_.back();
+    top_n_memory_ += key_.size() + row_.size() - last.first.size() - last.second.size();
+    last.first.swap(key_);
+    last.second.swap(row_);
+    push_heap(top_n_heap_.begin(), top_n_heap_.end(), top_n_less);
+  }
+
+  if (top_n_memory_ <= memory_limit_) {
+    return RC::SUCCESS;
+  }
+
+  // limit很大时，堆也可能超过内存限制，转换成普通的外部排序，输出时再按照limit截断
+  LOG_INFO("top-n heap exceeds memory limit, switch to external sort. rows=%ld, memory=%ld, limit=%ld",
+           top_n_heap_.size(), top_n_memory_, memory_limit_);
+  top_n_ = false;
+  RC rc  = RC::SUCCESS;
+  for (const pair<string, string> &entry : top_n_heap_) {
+    if (rc == RC::SUCCESS) {
+      rc = add_to_buffer(entry.first, entry.second);
+    }
+  }
+  top_n_heap_.clear();
+  top_n_heap_.shrink_to_fit();
+  top_n_memory_ = 0;
+  return rc;
+}
+
+size_t SortPhysicalOperator::buffer_memory_size() const
+{
+  return arena_.memory_size() + entries_.capacity() * sizeof(SortEntry);
+}
+
+RC SortPhysicalOperator::add_to_buffer(string_view key, string_view row)
+{
+  char *buf = arena_.alloc(key.size() + row.size());
+  memcpy(buf, key.data(), key.size());
+  memcpy(buf + key.size(), row.data(), row.size());
+  entries_.push_back(
+      {buf, static_cast<int>(key.size()), buf + key.size(), static_cast<int>(row.size())});
+
+  if (buffer_memory_size() > memory_limit_) {
+    return spill_run();
+  }
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::spill_run()
+{
+  if (entries_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  sort(entries_.begin(), entries_.end(), [](const SortEntry &a, const SortEntry &b) {
+    return a.key_view() < b.key_view();
+  });
+
+  unique_ptr<SpillFile> run = make_unique<SpillFile>();
+  RC                    rc  = run->open(spill_dir_.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create spill file. dir=%s, rc=%s", spill_dir_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  for (const SortEntry &entry : entries_) {
+    rc = run->append(entry.key_view(), string_view(entry.row, entry.row_len));
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to write spill file. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = run->finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to finish spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_TRACE("sort spill a run. rows=%ld, bytes=%ld", run->record_count(), run->file_size());
+  run_count_++;
+  spill_rows_ += run->record_count();
+  spill_bytes_ += run->file_size();
+  runs_.push_back(std::move(run));
+
+  arena_.clear();
+  entries_.clear();
+  entries_.shrink_to_fit();
+
+  // 每个run占用一个文件描述符，run太多时提前归并一部分
+  return compact_runs(MAX_RUNS);
+}
+
+RC SortPhysicalOperator::compact_runs(size_t max_runs)
+{
+  while (runs_.size() > max_runs) {
+    // 优先归并小的run，减少重复读写的数据量
+    stable_sort(runs_.begin(), runs_.end(), [](const unique_ptr<SpillFile> &a, const unique_ptr<SpillFile> &b) {
+      return a->file_size() < b->file_size();
+    });
+
+    vector<unique_ptr<SpillFile>> inputs(
+        make_move_iterator(runs_.begin()), make_move_iterator(runs_.begin() + MERGE_FAN_IN));
+    runs_.erase(runs_.begin(), runs_.begin() + MERGE_FAN_IN);
+
+    unique_ptr<SpillFile> output;
+    RC                    rc = merge_runs(std::move(inputs), output);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to merge runs. rc=%s", strrc(rc));
+      return rc;
+    }
+    runs_.push_back(std::move(output));
+    merge_passes_++;
+  }
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::merge_init(vector<MergeSource> &sources, vector<int> &heap)
+{
+  heap.clear();
+  for (int i = 0; i < static_cast<int>(sources.size()); i++) {
+    RC rc = sources[i].run->read(sources[i].key, sources[i].row);
+    if (rc == RC::SUCCESS) {
+      heap.push_back(i);
+    } else if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to read spill file. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  make_heap(heap.begin(), heap.end(), MergeGreater{sources});
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::merge_next(vector<MergeSource> &sources, vector<int> &heap, string &key, string &row)
+{
+  if (heap.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  pop_heap(heap.begin(), heap.end(), MergeGreater{sources});
+  MergeSource &source = sources[heap.back()];
+  key.swap(source.key);
+  row.swap(source.row);
+
+  RC rc = source.run->read(source.key, source.row);
+  if (rc == RC::SUCCESS) {
+    push_heap(heap.begin(), heap.end(), MergeGreater{sources});
+  } else if (rc == RC::RECORD_EOF) {
+    source.run.reset();
+    heap.pop_back();
+  } else {
+    LOG_WARN("failed to read spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::merge_runs(vector<unique_ptr<SpillFile>> runs, unique_ptr<SpillFile> &output)
+{
+  vector<MergeSource> sources(runs.size());
+  for (size_t i = 0; i < runs.size(); i++) {
+    sources[i].run = std::move(runs[i]);
+  }
+
+  vector<int> heap;
+  RC          rc = merge_init(sources, heap);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  output = make_unique<SpillFile>();
+  rc     = output->open(spill_dir_.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create spill file. dir=%s, rc=%s", spill_dir_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  while ((rc = merge_next(sources, heap, key_, row_)) == RC::SUCCESS) {
+    rc = output->append(key_, row_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to write spill file. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    return rc;
+  }
+
+  rc = output->finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to finish spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  run_count_++;
+  spill_bytes_ += output->file_size();
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::prepare_merge()
+{
+  // 内存中剩余的数据也作为一个run，所有的数据都从文件中归并
+  RC rc = spill_run();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  rc = compact_runs(MERGE_FAN_IN);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  merge_sources_.resize(runs_.size());
+  for (size_t i = 0; i < runs_.size(); i++) {
+    merge_sources_[i].run = std::move(runs_[i]);
+  }
+  runs_.clear();
+  merge_passes_++;
+
+  LOG_TRACE("sort start to merge runs. runs=%d, merge passes=%d", merge_sources_.size(), merge_passes_);
+  return merge_init(merge_sources_, merge_heap_);
+}
+
+RC SortPhysicalOperator::next()
+{
+  if (limit_ >= 0 && output_count_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+
+  if (top_n_) {
+    if (position_ + 1 >= static_cast<int64_t>(top_n_heap_.size())) {
+      return RC::RECORD_EOF;
+    }
+    position_++;
+    tuple_.set_data(top_n_heap_[position_].second.data());
+  } else if (!merge_sources_.empty()) {
+    RC rc = merge_next(merge_sources_, merge_heap_, key_, current_row_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    tuple_.set_data(current_row_.data());
+  } else {
+    if (position_ + 1 >= static_cast<int64_t>(entries_.size())) {
+      return RC::RECORD_EOF;
+    }
+    position_++;
+    tuple_.set_data(entries_[position_].row);
+  }
+
+  output_count_++;
+  return RC::SUCCESS;
+}
+
+RC SortPhysicalOperator::close()
+{
+  top_n_heap_.clear();
+  top_n_heap_.shrink_to_fit();
+  top_n_memory_ = 0;
+  arena_.clear();
+  entries_.clear();
+  entries_.shrink_to_fit();
+  runs_.clear();
+  merge_sources_.clear();
+  merge_heap_.clear();
+  position_ = -1;
+  return RC::SUCCESS;
+}
+
+Tuple *SortPhysicalOperator::current_tuple() { return &tuple_; }
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "common/mm/arena.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "sql/expr/tuple_cell.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/operator/spill_file.h"
+#include "sql/parser/value.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 把排序字段编码成可以直接用memcmp比较的字节串
+ * @details 每个值编码为 | class(1B) | payload |，NULL最小。
+ * 数值统一转换成double并处理符号位，字符串中的0x00转义成0x00 0xFF，并以0x00 0x00结尾，
+ * 这样多个字段拼接后仍然可以逐字节比较。降序的字段把编码后的每个字节取反。
+ */
+class SortKeyEncoder
+{
+public:
+  static void append(const Value &value, bool is_asc, std::string &key);
+};
+
+/**
+ * @brief 排序算子
+ * @ingroup PhysicalOperator
+ * @details 子算子是投影算子，排序字段由OrderByDesc指定在投影结果中的位置，只输出前面tuple_schema中的列。
+ * 每一行编码成 排序键 + 行数据(RowCodec)，排序键的最后是行的序号，所以排序是稳定的。
+ *
+ * 有limit时使用大小为limit的堆，只保留最小的limit行(top-N)。
+ * 否则把数据放到内存中排序，超过内存限制(会话变量sort_memory_limit)时，把已经排好序的数据写到临时文件中(run)，
+ * 最后对所有的run做多路归并。run太多时先把较小的run归并成一个，避免同时打开太多文件。
+ */
+class SortPhysicalOperator : public PhysicalOperator
+{
+public:
+  SortPhysicalOperator(std::vector<OrderByDesc> order_by, std::vector<TupleCellSpec> tuple_schema, int limit);
+
+  virtual ~SortPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::SORT; }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  /// 没有设置会话变量时的内存限制
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+private:
+  /**
+   * @brief 内存中的一行，key和row都保存在arena_中
+   */
+  struct SortEntry
+  {
+    const char *key;
+    int         key_len;
+    const char *row;
+    int         row_len;
+
+    std::string_view key_view() const { return std::string_view(key, key_len); }
+  };
+
+  /**
+   * @brief 归并时的一个输入
+   */
+  struct MergeSource
+  {
+    std::unique_ptr<SpillFile> run;
+    std::string                key;
+    std::string                row;
+  };
+
+  /**
+   * @brief 归并堆的比较函数，key小的在堆顶
+   */
+  struct MergeGreater
+  {
+    const std::vector<MergeSource> &sources;
+
+    bool operator()(int a, int b) const { return sources[a].key > sources[b].key; }
+  };
+
+  RC     encode_tuple(Tuple &tuple);
+  RC     add_to_top_n();
+  RC     add_to_buffer(std::string_view key, std::string_view row);
+  size_t buffer_memory_size() const;
+  RC     spill_run();
+  RC     compact_runs(size_t max_runs);
+  RC     merge_runs(std::vector<std::unique_ptr<SpillFile>> runs, std::unique_ptr<SpillFile> &output);
+  RC     prepare_merge();
+
+  /**
+   * @brief 读取每个输入的第一行，建立归并堆
+   */
+  static RC merge_init(std::vector<MergeSource> &sources, std::vector<int> &heap);
+
+  /**
+   * @brief 取出所有输入中最小的一行
+   * @return RC::RECORD_EOF 表示所有输入都已经读完
+   */
+  static RC merge_next(std::vector<MergeSource> &sources, std::vector<int> &heap, std::string &key, std::string &row);
+
+private:
+  static constexpr size_t MERGE_FAN_IN = 64;                ///< 一次最多归并的run数
+  static constexpr size_t MAX_RUNS     = MERGE_FAN_IN * 2;  ///< 同时存在的run数上限
+
+  std::vector<OrderByDesc>   order_by_;
+  std::vector<TupleCellSpec> tuple_schema_;
+  int                        limit_ = -1;
+
+  size_t      memory_limit_ = DEFAULT_MEMORY_LIMIT;
+  std::string spill_dir_;
+  bool        top_n_ = false;  ///< 是否在使用top-N堆
+
+  std::string        key_;  ///< 当前行的排序键
+  std::string        row_;  ///< 当前行编码后的数据
+  std::vector<Value> cells_;
+  int64_t            row_seq_ = 0;
+
+  /// top-N堆，按照key的大顶堆
+  std::vector<std::pair<std::string, std::string>> top_n_heap_;
+  size_t                                           top_n_memory_ = 0;
+
+  common::Arena          arena_;
+  std::vector<SortEntry> entries_;
+
+  std::vector<std::unique_ptr<SpillFile>> runs_;          ///< 已经写到文件中的run
+  std::vector<MergeSource>                merge_sources_;  ///< 最后一次归并的输入
+  std::vector<int>                        merge_heap_;     ///< merge_sources_的下标，按照key的小顶堆
+
+  int64_t     position_     = -1;  ///< 内存中排序时，当前输出的行
+  int64_t     output_count_ = 0;
+  std::string current_row_;
+  EncodedTuple tuple_;
+
+  bool    executed_     = false;
+  int     run_count_    = 0;  ///< 生成的run数，包括中间归并生成的
+  int     merge_passes_ = 0;
+  int64_t spill_rows_   = 0;
+  int64_t spill_bytes_  = 0;
+};
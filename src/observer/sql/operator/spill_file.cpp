@@ -0,0 +1,152 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/spill_file.h"
+#include "common/io/io.h"
+#include "common/log/log.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+SpillFile::~SpillFile() { close(); }
+
+RC SpillFile::open(const char *dir)
+{
+  string path = string(dir) + "/miniob_spill_XXXXXX";
+  fd_         = mkstemp(path.data());
+  if (fd_ < 0) {
+    LOG_WARN("failed to create spill file. path=%s, errno=%d:%s", path.c_str(), errno, strerror(errno));
+    return RC::FILE_CREATE;
+  }
+
+  if (unlink(path.c_str()) != 0) {
+    LOG_WARN("failed to unlink spill file. path=%s, errno=%d:%s", path.c_str(), errno, strerror(errno));
+  }
+
+  buffer_.clear();
+  buffer_.reserve(BUFFER_SIZE);
+  buffer_pos_   = 0;
+  record_count_ = 0;
+  file_size_    = 0;
+  LOG_TRACE("create spill file. fd=%d", fd_);
+  return RC::SUCCESS;
+}
+
+void SpillFile::close()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+}
+
+RC SpillFile::append(string_view key, string_view row)
+{
+  const int32_t key_len = static_cast<int32_t>(key.size());
+  const int32_t row_len = static_cast<int32_t>(row.size());
+  buffer_.append(reinterpret_cast<const char *>(&key_len), sizeof(key_len));
+  buffer_.append(reinterpret_cast<const char *>(&row_len), sizeof(row_len));
+  buffer_.append(key);
+  buffer_.append(row);
+
+  record_count_++;
+  file_size_ += sizeof(key_len) + sizeof(row_len) + key_len + row_len;
+  if (static_cast<int>(buffer_.size()) >= BUFFER_SIZE) {
+    return flush();
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::flush()
+{
+  if (buffer_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  int ret = common::writen(fd_, buffer_.data(), static_cast<int>(buffer_.size()));
+  if (ret != 0) {
+    LOG_WARN("failed to write spill file. fd=%d, size=%d, error=%d:%s",
+             fd_, static_cast<int>(buffer_.size()), ret, strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+  buffer_.clear();
+  return RC::SUCCESS;
+}
+
+RC SpillFile::finish()
+{
+  RC rc = flush();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  if (lseek(fd_, 0, SEEK_SET) != 0) {
+    LOG_WARN("failed to seek spill file. fd=%d, errno=%d:%s", fd_, errno, strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  buffer_pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::read_bytes(char *data, int size)
+{
+  while (size > 0) {
+    if (buffer_pos_ >= static_cast<int>(buffer_.size())) {
+      buffer_.resize(BUFFER_SIZE);
+      ssize_t ret = ::read(fd_, buffer_.data(), BUFFER_SIZE);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        LOG_WARN("failed to read spill file. fd=%d, errno=%d:%s", fd_, errno, strerror(errno));
+        buffer_.clear();
+        return RC::IOERR_READ;
+      }
+      buffer_.resize(ret);
+      buffer_pos_ = 0;
+      if (ret == 0) {
+        return RC::RECORD_EOF;
+      }
+    }
+
+    const int len = min(size, static_cast<int>(buffer_.size()) - buffer_pos_);
+    memcpy(data, buffer_.data() + buffer_pos_, len);
+    buffer_pos_ += len;
+    data += len;
+    size -= len;
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::read(string &key, string &row)
+{
+  int32_t lens[2];
+  RC      rc = read_bytes(reinterpret_cast<char *>(lens), sizeof(lens));
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  key.resize(lens[0]);
+  row.resize(lens[1]);
+  rc = read_bytes(key.data(), lens[0]);
+  if (rc == RC::SUCCESS) {
+    rc = read_bytes(row.data(), lens[1]);
+  }
+  if (rc == RC::RECORD_EOF) {
+    LOG_WARN("spill file is truncated. fd=%d", fd_);
+    return RC::IOERR_READ;
+  }
+  return rc;
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "common/rc.h"
+
+/**
+ * @brief 算子使用的临时文件
+ * @ingroup PhysicalOperator
+ * @details 内存不够时，算子把中间结果写到临时文件中，之后再按顺序读回来。
+ * 文件中的每条记录是 | key_len(4B) | row_len(4B) | key | row |，key和row的含义由使用者决定。
+ * 使用流程是 open -> append... -> finish -> read...，写入和读取都带有缓存。
+ * 文件创建后会立即从目录中删除，关闭文件描述符时空间自动回收，进程异常退出也不会留下垃圾文件。
+ */
+class SpillFile
+{
+public:
+  SpillFile() = default;
+  ~SpillFile();
+
+  SpillFile(const SpillFile &)            = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  /**
+   * @brief 在dir目录下创建一个临时文件
+   */
+  RC open(const char *dir);
+
+  /**
+   * @brief 追加一条记录
+   */
+  RC append(std::string_view key, std::string_view row);
+
+  /**
+   * @brief 写入结束，刷新缓存并回到文件开头准备读取
+   */
+  RC finish();
+
+  /**
+   * @brief 读取下一条记录
+   * @return RC::RECORD_EOF 表示已经读完
+   */
+  RC read(std::string &key, std::string &row);
+
+  void close();
+
+  int64_t record_count() const { return record_count_; }
+  int64_t file_size() const { return file_size_; }
+
+private:
+  RC flush();
+  RC read_bytes(char *data, int size);
+
+private:
+  static constexpr int BUFFER_SIZE = 64 * 1024;
+
+  int         fd_ = -1;
+  std::string buffer_;
+  int         buffer_pos_   = 0;  ///< 读取时，buffer_中下一个未读的位置
+  int64_t     record_count_ = 0;
+  int64_t     file_size_    = 0;
+};
@@ -26,7 +26,8 @@ RC TableScanPhysicalOperator::open(Trx *trx)
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_->table_meta().field_metas());
   }
-  trx_ = trx;
+  trx_      = trx;
+  scan_eof_ = false;
   return rc;
 }
 
@@ -62,6 +63,97 @@ RC TableScanPhysicalOperator::next()
   return rc;
 }
 
+RC TableScanPhysicalOperator::next_chunk(Chunk &chunk)
+{
+  const vector<FieldMeta> &field_metas = *table_->table_meta().field_metas();
+  if (columns_.size() != field_metas.size()) {
+    columns_.clear();
+    for (size_t i = 0; i < field_metas.size(); i++) {
+      columns_.push_back(make_shared<Column>());
+    }
+  }
+
+  RC rc = RC::SUCCESS;
+  while (!scan_eof_) {
+    chunk.reset();
+    for (size_t i = 0; i < field_metas.size(); i++) {
+      const FieldMeta &field_meta = field_metas[i];
+      Column          &column     = *columns_[i];
+      if (field_meta.type() == TEXTS) {
+        column.reset_values();
+      } else {
+        column.reset(field_meta.type(), field_meta.len());
+        column.resize(Chunk::MAX_ROWS);
+      }
+      chunk.add_column(TupleCellSpec(table_->name(), field_meta.name()), columns_[i]);
+    }
+
+    int rows = 0;
+    while (rows < Chunk::MAX_ROWS && OB_SUCC(rc = record_scanner_.next(current_record_))) {
+      rc = trx_->visit_record(table_, current_record_, mode_);
+      if (rc == RC::RECORD_INVISIBLE) {
+        continue;
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to visit record. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      append_record(rows);
+      rows++;
+    }
+
+    if (rc == RC::RECORD_EOF) {
+      scan_eof_ = true;
+    } else if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to scan records. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    for (shared_ptr<Column> &column : columns_) {
+      if (column->is_fixed()) {
+        column->resize(rows);
+      }
+    }
+    chunk.set_rows(rows);
+
+    rc = filter(chunk);
+    if (rc != RC::SUCCESS) {
+      LOG_TRACE("chunk filtered failed=%s", strrc(rc));
+      return rc;
+    }
+
+    if (chunk.rows() > 0) {
+      return RC::SUCCESS;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
+void TableScanPhysicalOperator::append_record(int row)
+{
+  const TableMeta         &table_meta  = table_->table_meta();
+  const vector<FieldMeta> &field_metas = *table_meta.field_metas();
+  const FieldMeta         *null_field  = table_meta.null_bitmap_field();
+
+  char          *data = current_record_.data();
+  common::Bitmap null_bitmap(data + null_field->offset(), null_field->len() * 8);
+  for (size_t i = 0; i < field_metas.size(); i++) {
+    Column &column = *columns_[i];
+    if (!column.is_fixed()) {
+      Value value;
+      tuple_.set_record(&current_record_);
+      tuple_.cell_at(static_cast<int>(i), value);
+      column.append_value(value);
+      continue;
+    }
+
+    const int width = column.width();
+    memcpy(column.data<char>() + static_cast<size_t>(row) * width, data + field_metas[i].offset(), width);
+    column.nulls()[row] = null_bitmap.get_bit(static_cast<int>(i)) ? 1 : 0;
+  }
+}
+
 RC TableScanPhysicalOperator::close() { return record_scanner_.close_scan(); }
 
 Tuple *TableScanPhysicalOperator::current_tuple()
@@ -77,6 +169,13 @@ void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&
   predicates_ = std::move(exprs);
 }
 
+void TableScanPhysicalOperator::collect_plan_params(vector<PlanParam> &params)
+{
+  for (unique_ptr<Expression> &predicate : predicates_) {
+    ::collect_plan_params(*predicate, params);
+  }
+}
+
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 {
   RC    rc = RC::SUCCESS;
@@ -103,3 +202,20 @@ RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
   result = true;
   return rc;
 }
+
+RC TableScanPhysicalOperator::filter(Chunk &chunk)
+{
+  for (unique_ptr<Expression> &expr : predicates_) {
+    if (chunk.rows() == 0) {
+      break;
+    }
+
+    RC rc = expr->get_column(chunk, filter_column_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    filter_column_->collect_true(chunk.rows(), selection_);
+    chunk.select(selection_);
+  }
+  return RC::SUCCESS;
+}
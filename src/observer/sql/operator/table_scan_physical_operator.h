@@ -42,10 +42,22 @@ public:
 
   Tuple *current_tuple() override;
 
+  bool support_chunk() const override { return true; }
+
+  /**
+   * @brief 一次读取多条记录，按列存放到chunk中，并使用下推的谓词过滤
+   * @details chunk中的列由算子持有，下一次调用时会被覆盖
+   */
+  RC next_chunk(Chunk &chunk) override;
+
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  void collect_plan_params(std::vector<PlanParam> &params) override;
+
 private:
   RC filter(RowTuple &tuple, bool &result);
+  RC filter(Chunk &chunk);
+  void append_record(int row);
 
 private:
   Table                                   *table_ = nullptr;
@@ -55,4 +67,9 @@ private:
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_;  // TODO chang predicate to table tuple filter
+
+  std::vector<std::shared_ptr<Column>> columns_;  ///< 向量化执行时每个字段的数据
+  std::shared_ptr<Column>              filter_column_;
+  std::vector<int>                     selection_;
+  bool                                 scan_eof_ = false;
 };
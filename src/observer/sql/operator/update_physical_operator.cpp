@@ -34,7 +34,13 @@ RC UpdatePhysicalOperator::open(Trx *trx)
       return rc;
     }
 
-    records_to_delete.push_back(std::make_unique<Record>(child_tuple->record()));
+    // 扫描出来的记录直接指向页面上的数据，关闭扫描之后就不能再访问了，这里复制一份
+    const Record &child_record     = child_tuple->record();
+    Record       *record_to_delete = new Record();
+    record_to_delete->copy_data(child_record.data(), child_record.len());
+    record_to_delete->set_rid(child_record.rid());
+
+    records_to_delete.emplace_back(record_to_delete);
     records_to_insert.emplace_back(record_to_insert);
   }
 
@@ -49,7 +55,20 @@ RC UpdatePhysicalOperator::open(Trx *trx)
     return rc;
   }
 
-  // 删除所有要更新的记录
+  if (!update_record_maker_.update_unique_key()) {
+    // 逐条原地更新，没有修改的索引不需要动
+    for (size_t i = 0; i < records_to_delete.size(); i++) {
+      rc = trx->update_record(table_, *records_to_delete[i], *records_to_insert[i]);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("Failed to update record, rc = %s", strrc(rc));
+        return rc;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  // 更新了唯一索引上的字段时，逐条更新可能与还没有更新的记录冲突，比如 set id = id + 1，
+  // 所以先删除所有要更新的记录，再插入更新后的记录
   for (auto &reocrd : records_to_delete) {
     rc = trx->delete_record(table_, *reocrd);
     if (rc != RC::SUCCESS) {
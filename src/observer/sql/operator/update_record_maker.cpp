@@ -23,6 +23,13 @@ RC UpdateRecordMaker::init(Table *table, const std::vector<Field> &fields)
       if (!strcmp(fields[j].field_name(), cur_field_meta.name())) {
         update_field_order_.push_back(i);
         update_field_types_.push_back(cur_field_meta.type());
+
+        for (int k = 0; k < table->table_meta().index_num(); k++) {
+          const IndexMeta *index_meta = table->table_meta().index(k);
+          if (index_meta->unique() && 0 == strcmp(index_meta->field(), cur_field_meta.name())) {
+            update_unique_key_ = true;
+          }
+        }
         break;
       }
     }
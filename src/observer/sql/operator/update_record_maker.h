@@ -16,9 +16,15 @@ public:
 
   RC update(const Tuple *tuple, std::vector<Value> new_values, Record &record);
 
+  /**
+   * @brief 是否更新了唯一索引上的字段
+   */
+  bool update_unique_key() const { return update_unique_key_; }
+
 private:
   std::vector<std::unique_ptr<FieldExpr>> table_field_epxrs_;
   std::vector<AttrType>                   update_field_types_;
   std::vector<int>                        update_field_order_;
   Table                                  *table_;
+  bool                                    update_unique_key_ = false;
 };
\ No newline at end of file
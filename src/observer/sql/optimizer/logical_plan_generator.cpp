@@ -29,6 +29,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/logical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/project_logical_operator.h"
+#include "sql/operator/sort_logical_operator.h"
 #include "sql/operator/table_get_logical_operator.h"
 
 #include "sql/operator/update_logical_operator.h"
@@ -168,8 +169,9 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
     }
   }
 
-  if (!select_stmt->aggregate_list().empty()) {
-    group_oper = std::make_unique<GroupLogicalOperator>(std::move(select_stmt->aggregate_list()));
+  if (!select_stmt->aggregate_list().empty() || !select_stmt->group_by_list().empty()) {
+    group_oper = std::make_unique<GroupLogicalOperator>(
+        std::move(select_stmt->aggregate_list()), std::move(select_stmt->group_by_list()));
   }
 
   if (select_stmt->filter()) {
@@ -199,6 +201,15 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
     project->add_child(std::move(child_oper));
   }
 
+  // 排序字段作为投影的一部分计算，所以排序放在投影之上
+  if (!select_stmt->order_by_list().empty()) {
+    unique_ptr<LogicalOperator> sort_oper = make_unique<SortLogicalOperator>(
+        std::move(select_stmt->order_by_list()), select_stmt->tuple_schema(), select_stmt->limit());
+    sort_oper->add_child(std::move(project));
+    logical_operator = std::move(sort_oper);
+    return RC::SUCCESS;
+  }
+
   logical_operator = std::move(project);
 
   return RC::SUCCESS;
@@ -282,7 +293,7 @@ RC LogicalPlanGenerator::create_plan(ExplainStmt *explain_stmt, unique_ptr<Logic
     return rc;
   }
 
-  logical_operator = unique_ptr<LogicalOperator>(new ExplainLogicalOperator);
+  logical_operator = unique_ptr<LogicalOperator>(new ExplainLogicalOperator(explain_stmt->analyze()));
   logical_operator->add_child(std::move(child_oper));
   return rc;
 }
@@ -305,6 +316,10 @@ RC LogicalPlanUtils::get_tuple_schema(const LogicalOperator *logical_operator, s
       const ProjectLogicalOperator *project_oper = static_cast<const ProjectLogicalOperator *>(logical_operator);
       tuple_schema                               = project_oper->tuple_schema();
     } break;
+    case LogicalOperatorType::SORT: {
+      const SortLogicalOperator *sort_oper = static_cast<const SortLogicalOperator *>(logical_operator);
+      tuple_schema                         = sort_oper->tuple_schema();
+    } break;
     case LogicalOperatorType::JOIN: {
       const JoinLogicalOperator *join_oper = static_cast<const JoinLogicalOperator *>(logical_operator);
       vector<TupleCellSpec>      left_tuple_schema;
@@ -39,6 +39,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/predicate_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
 #include "sql/operator/project_physical_operator.h"
+#include "sql/operator/sort_logical_operator.h"
+#include "sql/operator/sort_physical_operator.h"
 #include "sql/operator/table_get_logical_operator.h"
 #include "sql/operator/table_scan_physical_operator.h"
 #include "sql/operator/update_physical_operator.h"
@@ -90,6 +92,10 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
       return create_plan(static_cast<GroupLogicalOperator &>(logical_operator), oper);
     } break;
 
+    case LogicalOperatorType::SORT: {
+      return create_plan(static_cast<SortLogicalOperator &>(logical_operator), oper);
+    } break;
+
     default: {
       return RC::INVALID_ARGUMENT;
     }
@@ -156,6 +162,7 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
         &value,
         true /*right_inclusive*/);
 
+    index_scan_oper->set_value_position(value_expr->position());
     index_scan_oper->set_predicates(std::move(predicates));
     oper = unique_ptr<PhysicalOperator>(index_scan_oper);
     LOG_TRACE("use index scan");
@@ -279,7 +286,7 @@ RC PhysicalPlanGenerator::create_plan(ExplainLogicalOperator &explain_oper, uniq
 
   RC rc = RC::SUCCESS;
 
-  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator);
+  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator(explain_oper.analyze()));
   for (unique_ptr<LogicalOperator> &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper);
@@ -297,7 +304,7 @@ RC PhysicalPlanGenerator::create_plan(ExplainLogicalOperator &explain_oper, uniq
 
 RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr<PhysicalOperator> &oper)
 {
-  RC                                   rc;
+  RC                                   rc = RC::SUCCESS;
   vector<unique_ptr<LogicalOperator>> &child_opers = join_oper.children();
   vector<unique_ptr<PhysicalOperator>> child_phyis_opers;
 
@@ -315,31 +322,17 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     child_phyis_opers.push_back(std::move(child_physical_oper));
   }
 
-  // 简单判断是否使用RbTreeJoin
-  if (!join_oper.expressions().empty() && join_oper.expressions().front()->type() == ExprType::COMPARISON) {
-    unique_ptr<Expression> &condition  = join_oper.expressions().front();
-    ComparisonExpr         *comp_expr  = static_cast<ComparisonExpr *>(condition.get());
-    unique_ptr<Expression> &left_expr  = comp_expr->left();
-    unique_ptr<Expression> &right_expr = comp_expr->right();
-
-    if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::FIELD &&
-        comp_expr->comp() == EQUAL_TO) {
-      LOG_TRACE("use RbTreeEqJoin");
-      vector<TupleCellSpec> tuple_schema;
-      RC                    rc = LogicalPlanUtils::get_tuple_schema(join_oper.children()[0].get(), tuple_schema);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to get tuple schema of RbTreeJoin. rc=%s", strrc(rc));
-        return rc;
-      }
-
-      oper.reset(
-          new RbTreeEqJoinPhysicalOperator(std::move(left_expr), std::move(right_expr), std::move(tuple_schema)));
-
-      for (auto &child_oper : child_phyis_opers) {
-        oper->add_child(std::move(child_oper));
-      }
+  // 有等值连接条件时使用HashJoin
+  if (!join_oper.expressions().empty()) {
+    unique_ptr<PhysicalOperator> hash_join_oper;
+    rc = try_create_hash_join(join_oper, child_phyis_opers, hash_join_oper);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create hash join operator. rc=%s", strrc(rc));
+      return rc;
+    }
 
-      condition = nullptr;
+    if (hash_join_oper) {
+      oper = std::move(hash_join_oper);
       return RC::SUCCESS;
     }
   }
@@ -348,8 +341,7 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
 
   // 使用NestedLoopJoin
   LOG_TRACE("use NestedLoopJoin join");
-  if (join_oper.expressions().empty()) {
-  } else {
+  if (!join_oper.expressions().empty()) {
     perdict.reset(new PredicatePhysicalOperator(std::move(join_oper.expressions().front())));
   }
 
@@ -403,7 +395,118 @@ RC PhysicalPlanGenerator::create_plan(GroupLogicalOperator &logical_oper, std::u
     return rc;
   }
 
-  oper = std::make_unique<GroupPhysicalOperator>(std::move(logical_oper.aggr_descs()));
+  oper = std::make_unique<GroupPhysicalOperator>(
+      std::move(logical_oper.aggr_descs()), std::move(logical_oper.group_exprs()));
   oper->add_child(std::move(child_physical_oper));
   return rc;
 }
+
+RC PhysicalPlanGenerator::create_plan(SortLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper)
+{
+  unique_ptr<PhysicalOperator> child_physical_oper;
+
+  RC rc = create(*logical_oper.children().front(), child_physical_oper);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create child physical operator of sort operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  oper = std::make_unique<SortPhysicalOperator>(
+      std::move(logical_oper.order_by()), logical_oper.tuple_schema(), logical_oper.limit());
+  oper->add_child(std::move(child_physical_oper));
+  return rc;
+}
+
+/**
+ * @brief 判断field是否属于schema中的某个列
+ */
+static bool field_in_schema(const FieldExpr &field_expr, const vector<TupleCellSpec> &schema)
+{
+  for (const TupleCellSpec &spec : schema) {
+    if (0 == strcmp(spec.table_name(), field_expr.table_name()) &&
+        0 == strcmp(spec.field_name(), field_expr.field_name())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC PhysicalPlanGenerator::try_create_hash_join(JoinLogicalOperator &join_oper,
+    vector<unique_ptr<PhysicalOperator>> &child_opers, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<TupleCellSpec> left_schema;
+  vector<TupleCellSpec> right_schema;
+  if (LogicalPlanUtils::get_tuple_schema(join_oper.children()[0].get(), left_schema) != RC::SUCCESS ||
+      LogicalPlanUtils::get_tuple_schema(join_oper.children()[1].get(), right_schema) != RC::SUCCESS) {
+    LOG_TRACE("cannot get tuple schema of join children, fallback to nested loop join");
+    return RC::SUCCESS;
+  }
+
+  // 将连接条件按照AND拆开
+  unique_ptr<Expression>        &condition = join_oper.expressions().front();
+  vector<unique_ptr<Expression>> conjuncts;
+  if (condition->type() == ExprType::CONJUNCTION &&
+      static_cast<ConjunctionExpr *>(condition.get())->conjunction_type() == ConjunctionType::AND) {
+    conjuncts = std::move(static_cast<ConjunctionExpr *>(condition.get())->children());
+  } else {
+    conjuncts.push_back(std::move(condition));
+  }
+
+  // 找出 左表字段 = 右表字段 的条件作为连接键，其它的留在predicate中
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  vector<unique_ptr<Expression>> residual;
+  for (unique_ptr<Expression> &conjunct : conjuncts) {
+    if (conjunct->type() == ExprType::COMPARISON && static_cast<ComparisonExpr *>(conjunct.get())->comp() == EQUAL_TO) {
+      ComparisonExpr         *comp_expr  = static_cast<ComparisonExpr *>(conjunct.get());
+      unique_ptr<Expression> &left_expr  = comp_expr->left();
+      unique_ptr<Expression> &right_expr = comp_expr->right();
+      if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::FIELD) {
+        const FieldExpr &left_field  = static_cast<const FieldExpr &>(*left_expr);
+        const FieldExpr &right_field = static_cast<const FieldExpr &>(*right_expr);
+
+        const bool left_in_left   = field_in_schema(left_field, left_schema);
+        const bool left_in_right  = field_in_schema(left_field, right_schema);
+        const bool right_in_left  = field_in_schema(right_field, left_schema);
+        const bool right_in_right = field_in_schema(right_field, right_schema);
+        if (left_in_left && !left_in_right && right_in_right && !right_in_left) {
+          left_keys.push_back(std::move(left_expr));
+          right_keys.push_back(std::move(right_expr));
+          continue;
+        }
+        if (left_in_right && !left_in_left && right_in_left && !right_in_right) {
+          left_keys.push_back(std::move(right_expr));
+          right_keys.push_back(std::move(left_expr));
+          continue;
+        }
+      }
+    }
+    residual.push_back(std::move(conjunct));
+  }
+
+  if (residual.empty()) {
+    condition = nullptr;
+  } else if (residual.size() == 1) {
+    condition = std::move(residual.front());
+  } else {
+    condition.reset(new ConjunctionExpr(ConjunctionType::AND, residual));
+  }
+
+  if (left_keys.empty()) {
+    return RC::SUCCESS;
+  }
+
+  LOG_TRACE("use HashJoin with %d keys", static_cast<int>(left_keys.size()));
+  oper.reset(new HashJoinPhysicalOperator(
+      std::move(left_keys), std::move(right_keys), std::move(left_schema), std::move(right_schema)));
+  for (auto &child_oper : child_opers) {
+    oper->add_child(std::move(child_oper));
+  }
+
+  if (condition) {
+    unique_ptr<PhysicalOperator> perdict(new PredicatePhysicalOperator(std::move(condition)));
+    perdict->add_child(std::move(oper));
+    oper = std::move(perdict);
+  }
+  return RC::SUCCESS;
+}
@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/project_logical_operator.h"
+#include "sql/operator/sort_logical_operator.h"
 #include "sql/operator/table_get_logical_operator.h"
 #include "sql/operator/update_logical_operator.h"
 
@@ -51,4 +52,12 @@ private:
   RC create_plan(JoinLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(UpdateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(GroupLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_plan(SortLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+
+  /**
+   * @brief 尝试使用连接条件中的等值条件生成HashJoin
+   * @details 不能使用HashJoin时oper为空，连接条件保持语义不变，由调用者继续生成NestedLoopJoin
+   */
+  RC try_create_hash_join(JoinLogicalOperator &join_oper, std::vector<std::unique_ptr<PhysicalOperator>> &child_opers,
+      std::unique_ptr<PhysicalOperator> &oper);
 };
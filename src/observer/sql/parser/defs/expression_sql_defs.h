@@ -25,6 +25,7 @@ class ValueExpressionSqlNode : public ExpressionSqlNode
 {
 public:
   Value value;
+  int   position = -1;  ///< 常量在SQL中的位置，不是SQL中直接出现的常量时为-1
 
   ValueExpressionSqlNode() { ExpressionSqlNode::expr_type = ExprType::VALUE; }
   bool operator==(const ExpressionSqlNode &other) const override
@@ -149,6 +149,7 @@ class ParsedSqlNode;
 struct ExplainSqlNode
 {
   std::unique_ptr<ParsedSqlNode> sql_node = nullptr;
+  bool                           analyze  = false;  ///< explain analyze，执行语句并输出算子的运行统计
 };
 
 /**
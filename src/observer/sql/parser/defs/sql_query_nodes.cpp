@@ -122,6 +122,10 @@ SelectSqlNode::~SelectSqlNode()
     delete group;
   }
   group_by.clear();
+  for (auto order : order_by) {
+    delete order;
+  }
+  order_by.clear();
   if (having) {
     delete having;
     having = nullptr;
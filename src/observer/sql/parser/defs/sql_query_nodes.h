@@ -26,6 +26,15 @@ struct ExpressionWithOrderSqlNode
   ~ExpressionWithOrderSqlNode();
 };
 
+/**
+ * @brief order by子句，包括可选的limit
+ */
+struct OrderBySqlNode
+{
+  std::vector<ExpressionWithOrderSqlNode *> order_by;
+  int                                       limit = -1;  ///< -1 表示没有limit
+};
+
 /**
  * @brief 描述一个select语句
  * @ingroup SQLParser
@@ -45,6 +54,7 @@ struct SelectSqlNode
   std::vector<ExpressionSqlNode *>          group_by;             ///< group by字段
   ExpressionSqlNode                        *having = nullptr;     ///< having条件
   std::vector<ExpressionWithOrderSqlNode *> order_by;             ///< order by字段
+  int                                       limit = -1;           ///< 最多返回的行数，-1 表示没有限制
 
   ~SelectSqlNode();
 };
@@ -12,9 +12,16 @@ See the Mulan PSL v2 for more details. */
 // Created by Meiyi
 //
 
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
 #include "sql/parser/parse.h"
 #include "common/log/log.h"
 #include "sql/expr/expression.h"
+#include "sql/parser/yacc_sql.hpp"
+#include "sql/parser/lex_sql.h"
 
 RC parse(char *st, ParsedSqlNode *sqln);
 
@@ -37,3 +44,90 @@ RC parse(const char *st, ParsedSqlResult *sql_result)
   sql_parse(st, sql_result);
   return RC::SUCCESS;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+extern void scan_string(const char *str, yyscan_t scanner);
+
+void parameterize_sql(const char *sql, std::string &parameterized_sql, std::vector<SqlLiteral> &literals)
+{
+  parameterized_sql.clear();
+  literals.clear();
+
+  yyscan_t scanner;
+  yylex_init(&scanner);
+  scan_string(sql, scanner);
+
+  YYSTYPE value;
+  YYLTYPE location;
+  int     copied = 0;  // sql中已经复制到parameterized_sql的长度
+  int     token  = 0;
+  while ((token = yylex(&value, &location, scanner)) != 0) {
+    const char *placeholder = nullptr;
+    SqlLiteral  literal;
+    switch (token) {
+      case NUMBER: {
+        placeholder = "?";
+        literal.value.set_int(value.number);
+      } break;
+      case FLOAT: {
+        placeholder = "?.?";
+        literal.value.set_float(value.floats);
+      } break;
+      case SSS: {
+        placeholder = "'?'";
+        std::string str(value.string + 1, strlen(value.string) - 2);
+        literal.value.set_string(str.c_str());
+      } break;
+      default: break;
+    }
+
+    if (token == ID || token == SSS) {
+      free(value.string);
+    }
+    if (placeholder == nullptr) {
+      continue;
+    }
+
+    const int length = location.last_column - location.first_column + 1;
+    literal.position = location.first_column;
+    literal.text.assign(sql + location.first_column, length);
+    parameterized_sql.append(sql + copied, location.first_column - copied);
+    parameterized_sql.append(placeholder);
+    copied = location.first_column + length;
+    literals.push_back(std::move(literal));
+  }
+  parameterized_sql.append(sql + copied);
+
+  yylex_destroy(scanner);
+}
+
+void find_sql_params(const char *sql, std::vector<int> &positions)
+{
+  positions.clear();
+
+  yyscan_t scanner;
+  yylex_init(&scanner);
+  scan_string(sql, scanner);
+
+  YYSTYPE value;
+  YYLTYPE location;
+  int     token = 0;
+  while ((token = yylex(&value, &location, scanner)) != 0) {
+    if (token == ID || token == SSS) {
+      free(value.string);
+    } else if (token == '?') {
+      positions.push_back(location.first_column);
+    }
+  }
+
+  yylex_destroy(scanner);
+}
+
+bool is_select_sql(const char *sql)
+{
+  while (isspace(*sql)) {
+    sql++;
+  }
+  return strncasecmp(sql, "select", 6) == 0 && !isalnum(sql[6]) && sql[6] != '_';
+}
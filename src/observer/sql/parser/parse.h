@@ -18,3 +18,38 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse_defs.h"
 
 RC parse(const char *st, ParsedSqlResult *sql_result);
+
+/**
+ * @brief SQL中直接出现的一个常量
+ */
+struct SqlLiteral
+{
+  int         position = 0;  ///< 在SQL中的位置，与语法解析时ValueExpressionSqlNode::position一致
+  std::string text;          ///< SQL中的原文
+  Value       value;
+};
+
+/**
+ * @brief 把SQL中的常量替换成占位符，得到参数化的SQL
+ * @details 执行计划缓存使用参数化的SQL作为key。使用与语法解析相同的词法分析器，所以常量的位置与
+ * 语法解析时记录的位置一致。整数、浮点数和字符串使用不同的占位符(?、?.?和'?')，常量类型不同的SQL
+ * 不会共享执行计划。其它内容保持原样，包括空白和大小写，因为表达式的名字使用了SQL的原文。
+ * @param sql               SQL语句
+ * @param parameterized_sql 参数化之后的SQL
+ * @param literals          按照出现的顺序记录的常量
+ */
+void parameterize_sql(const char *sql, std::string &parameterized_sql, std::vector<SqlLiteral> &literals);
+
+/**
+ * @brief 是否是SELECT语句，不做语法解析，只看第一个单词
+ * @details 执行计划缓存和查询结果缓存只处理SELECT语句，在语法解析之前使用
+ */
+bool is_select_sql(const char *sql);
+
+/**
+ * @brief 找到预处理语句中的参数占位符'?'
+ * @details 使用与语法解析相同的词法分析器，字符串中的'?'不是参数
+ * @param sql       预处理语句
+ * @param positions 按照出现的顺序记录每个参数在SQL中的位置
+ */
+void find_sql_params(const char *sql, std::vector<int> &positions);
@@ -209,62 +209,65 @@ enum yysymbol_kind_t
   YYSYMBOL_STAR = 70,                      /* STAR  */
   YYSYMBOL_DIV = 71,                       /* DIV  */
   YYSYMBOL_UMINUS = 72,                    /* UMINUS  */
-  YYSYMBOL_YYACCEPT = 73,                  /* $accept  */
-  YYSYMBOL_commands = 74,                  /* commands  */
-  YYSYMBOL_command_wrapper = 75,           /* command_wrapper  */
-  YYSYMBOL_exit_stmt = 76,                 /* exit_stmt  */
-  YYSYMBOL_help_stmt = 77,                 /* help_stmt  */
-  YYSYMBOL_sync_stmt = 78,                 /* sync_stmt  */
-  YYSYMBOL_begin_stmt = 79,                /* begin_stmt  */
-  YYSYMBOL_commit_stmt = 80,               /* commit_stmt  */
-  YYSYMBOL_rollback_stmt = 81,             /* rollback_stmt  */
-  YYSYMBOL_drop_table_stmt = 82,           /* drop_table_stmt  */
-  YYSYMBOL_show_tables_stmt = 83,          /* show_tables_stmt  */
-  YYSYMBOL_desc_table_stmt = 84,           /* desc_table_stmt  */
-  YYSYMBOL_create_index_stmt = 85,         /* create_index_stmt  */
-  YYSYMBOL_opt_unique = 86,                /* opt_unique  */
-  YYSYMBOL_index_col_list = 87,            /* index_col_list  */
-  YYSYMBOL_drop_index_stmt = 88,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 89,         /* create_table_stmt  */
-  YYSYMBOL_attr_def_list = 90,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 91,                  /* attr_def  */
-  YYSYMBOL_number = 92,                    /* number  */
-  YYSYMBOL_type = 93,                      /* type  */
-  YYSYMBOL_insert_stmt = 94,               /* insert_stmt  */
-  YYSYMBOL_value_list = 95,                /* value_list  */
-  YYSYMBOL_value = 96,                     /* value  */
-  YYSYMBOL_delete_stmt = 97,               /* delete_stmt  */
-  YYSYMBOL_update_stmt = 98,               /* update_stmt  */
-  YYSYMBOL_update_asgn_factor = 99,        /* update_asgn_factor  */
-  YYSYMBOL_update_asgn_list = 100,         /* update_asgn_list  */
-  YYSYMBOL_select_stmt = 101,              /* select_stmt  */
-  YYSYMBOL_select_with_parenthesis = 102,  /* select_with_parenthesis  */
-  YYSYMBOL_expression_list = 103,          /* expression_list  */
-  YYSYMBOL_expression = 104,               /* expression  */
-  YYSYMBOL_rel_attr = 105,                 /* rel_attr  */
-  YYSYMBOL_opt_where = 106,                /* opt_where  */
-  YYSYMBOL_table_factor = 107,             /* table_factor  */
-  YYSYMBOL_opt_table_refs = 108,           /* opt_table_refs  */
-  YYSYMBOL_table_ref = 109,                /* table_ref  */
-  YYSYMBOL_opt_join_condition = 110,       /* opt_join_condition  */
-  YYSYMBOL_table_ref_list = 111,           /* table_ref_list  */
-  YYSYMBOL_expression_with_order = 112,    /* expression_with_order  */
-  YYSYMBOL_expression_with_order_list = 113, /* expression_with_order_list  */
-  YYSYMBOL_query_expression = 114,         /* query_expression  */
-  YYSYMBOL_query_expression_list = 115,    /* query_expression_list  */
-  YYSYMBOL_opt_order_by = 116,             /* opt_order_by  */
-  YYSYMBOL_opt_group_by = 117,             /* opt_group_by  */
-  YYSYMBOL_opt_order_type = 118,           /* opt_order_type  */
-  YYSYMBOL_opt_having = 119,               /* opt_having  */
-  YYSYMBOL_load_data_stmt = 120,           /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 121,             /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 122,        /* set_variable_stmt  */
-  YYSYMBOL_opt_inner = 123,                /* opt_inner  */
-  YYSYMBOL_opt_semicolon = 124,            /* opt_semicolon  */
-  YYSYMBOL_opt_not = 125,                  /* opt_not  */
-  YYSYMBOL_opt_alias = 126,                /* opt_alias  */
-  YYSYMBOL_opt_as = 127,                   /* opt_as  */
-  YYSYMBOL_opt_nullable = 128              /* opt_nullable  */
+  YYSYMBOL_73_ = 73,                       /* '?'  */
+  YYSYMBOL_YYACCEPT = 74,                  /* $accept  */
+  YYSYMBOL_commands = 75,                  /* commands  */
+  YYSYMBOL_command_wrapper = 76,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 77,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 78,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 79,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 80,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 81,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 82,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 83,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 84,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 85,           /* desc_table_stmt  */
+  YYSYMBOL_create_index_stmt = 86,         /* create_index_stmt  */
+  YYSYMBOL_opt_unique = 87,                /* opt_unique  */
+  YYSYMBOL_index_col_list = 88,            /* index_col_list  */
+  YYSYMBOL_drop_index_stmt = 89,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 90,         /* create_table_stmt  */
+  YYSYMBOL_attr_def_list = 91,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 92,                  /* attr_def  */
+  YYSYMBOL_number = 93,                    /* number  */
+  YYSYMBOL_type = 94,                      /* type  */
+  YYSYMBOL_insert_stmt = 95,               /* insert_stmt  */
+  YYSYMBOL_value_list = 96,                /* value_list  */
+  YYSYMBOL_insert_value = 97,              /* insert_value  */
+  YYSYMBOL_value = 98,                     /* value  */
+  YYSYMBOL_delete_stmt = 99,               /* delete_stmt  */
+  YYSYMBOL_update_stmt = 100,              /* update_stmt  */
+  YYSYMBOL_update_asgn_factor = 101,       /* update_asgn_factor  */
+  YYSYMBOL_update_asgn_list = 102,         /* update_asgn_list  */
+  YYSYMBOL_select_stmt = 103,              /* select_stmt  */
+  YYSYMBOL_select_with_parenthesis = 104,  /* select_with_parenthesis  */
+  YYSYMBOL_expression_list = 105,          /* expression_list  */
+  YYSYMBOL_expression = 106,               /* expression  */
+  YYSYMBOL_rel_attr = 107,                 /* rel_attr  */
+  YYSYMBOL_opt_where = 108,                /* opt_where  */
+  YYSYMBOL_table_factor = 109,             /* table_factor  */
+  YYSYMBOL_opt_table_refs = 110,           /* opt_table_refs  */
+  YYSYMBOL_table_ref = 111,                /* table_ref  */
+  YYSYMBOL_opt_join_condition = 112,       /* opt_join_condition  */
+  YYSYMBOL_table_ref_list = 113,           /* table_ref_list  */
+  YYSYMBOL_expression_with_order = 114,    /* expression_with_order  */
+  YYSYMBOL_expression_with_order_list = 115, /* expression_with_order_list  */
+  YYSYMBOL_query_expression = 116,         /* query_expression  */
+  YYSYMBOL_query_expression_list = 117,    /* query_expression_list  */
+  YYSYMBOL_opt_order_by = 118,             /* opt_order_by  */
+  YYSYMBOL_opt_limit = 119,                /* opt_limit  */
+  YYSYMBOL_opt_group_by = 120,             /* opt_group_by  */
+  YYSYMBOL_opt_order_type = 121,           /* opt_order_type  */
+  YYSYMBOL_opt_having = 122,               /* opt_having  */
+  YYSYMBOL_load_data_stmt = 123,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 124,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 125,        /* set_variable_stmt  */
+  YYSYMBOL_opt_inner = 126,                /* opt_inner  */
+  YYSYMBOL_opt_semicolon = 127,            /* opt_semicolon  */
+  YYSYMBOL_opt_not = 128,                  /* opt_not  */
+  YYSYMBOL_opt_alias = 129,                /* opt_alias  */
+  YYSYMBOL_opt_as = 130,                   /* opt_as  */
+  YYSYMBOL_opt_nullable = 131              /* opt_nullable  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -593,18 +596,18 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  70
+#define YYFINAL  71
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   303
+#define YYLAST   357
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  73
+#define YYNTOKENS  74
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  56
+#define YYNNTS  58
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  135
+#define YYNRULES  140
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  238
+#define YYNSTATES  245
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   327
@@ -627,7 +630,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    73,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -660,20 +663,21 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   209,   209,   217,   218,   219,   220,   221,   222,   223,
-     224,   225,   226,   227,   228,   229,   230,   231,   232,   233,
-     234,   235,   239,   245,   250,   256,   262,   268,   274,   281,
-     287,   295,   309,   310,   314,   319,   330,   341,   362,   365,
-     378,   387,   399,   403,   404,   405,   406,   407,   411,   428,
-     431,   443,   447,   451,   457,   464,   476,   489,   499,   504,
-     517,   543,   553,   560,   565,   577,   586,   595,   604,   613,
-     618,   629,   638,   647,   656,   665,   674,   683,   692,   701,
-     704,   722,   729,   736,   752,   767,   781,   789,   797,   808,
-     814,   821,   826,   837,   840,   845,   852,   861,   864,   869,
-     877,   893,   896,   902,   907,   917,   926,   931,   941,   953,
-     958,   969,   972,   979,   982,   989,   992,   996,  1003,  1006,
-    1012,  1025,  1033,  1043,  1044,  1047,  1048,  1052,  1053,  1057,
-    1058,  1063,  1064,  1067,  1068,  1069
+       0,   212,   212,   220,   221,   222,   223,   224,   225,   226,
+     227,   228,   229,   230,   231,   232,   233,   234,   235,   236,
+     237,   238,   242,   248,   253,   259,   265,   271,   277,   284,
+     290,   298,   312,   313,   317,   322,   333,   344,   365,   368,
+     381,   390,   402,   406,   407,   408,   409,   410,   414,   431,
+     434,   446,   450,   456,   460,   464,   470,   477,   489,   502,
+     512,   517,   530,   557,   567,   574,   579,   591,   600,   609,
+     618,   627,   632,   643,   652,   661,   670,   679,   688,   697,
+     706,   715,   718,   736,   743,   750,   766,   781,   795,   803,
+     812,   823,   829,   836,   841,   852,   855,   860,   867,   876,
+     879,   884,   892,   908,   911,   917,   922,   932,   941,   946,
+     956,   968,   973,   984,   987,   996,   999,  1015,  1018,  1025,
+    1028,  1032,  1039,  1042,  1048,  1061,  1066,  1083,  1093,  1094,
+    1097,  1098,  1102,  1103,  1107,  1108,  1113,  1114,  1117,  1118,
+    1119
 };
 #endif
 
@@ -698,21 +702,21 @@ static const char *const yytname[] =
   "EXPLAIN", "GROUP", "BY", "ORDER", "HAVING", "AS", "JOIN", "EXISTS",
   "IN", "INNER", "UNIQUE", "NUMBER", "FLOAT", "ID", "SSS", "IS", "LIKE",
   "OR", "AND", "NOT", "LT", "GT", "LE", "GE", "EQ", "NE", "ADD", "SUB",
-  "STAR", "DIV", "UMINUS", "$accept", "commands", "command_wrapper",
+  "STAR", "DIV", "UMINUS", "'?'", "$accept", "commands", "command_wrapper",
   "exit_stmt", "help_stmt", "sync_stmt", "begin_stmt", "commit_stmt",
   "rollback_stmt", "drop_table_stmt", "show_tables_stmt",
   "desc_table_stmt", "create_index_stmt", "opt_unique", "index_col_list",
   "drop_index_stmt", "create_table_stmt", "attr_def_list", "attr_def",
-  "number", "type", "insert_stmt", "value_list", "value", "delete_stmt",
-  "update_stmt", "update_asgn_factor", "update_asgn_list", "select_stmt",
-  "select_with_parenthesis", "expression_list", "expression", "rel_attr",
-  "opt_where", "table_factor", "opt_table_refs", "table_ref",
-  "opt_join_condition", "table_ref_list", "expression_with_order",
-  "expression_with_order_list", "query_expression",
-  "query_expression_list", "opt_order_by", "opt_group_by",
-  "opt_order_type", "opt_having", "load_data_stmt", "explain_stmt",
-  "set_variable_stmt", "opt_inner", "opt_semicolon", "opt_not",
-  "opt_alias", "opt_as", "opt_nullable", YY_NULLPTR
+  "number", "type", "insert_stmt", "value_list", "insert_value", "value",
+  "delete_stmt", "update_stmt", "update_asgn_factor", "update_asgn_list",
+  "select_stmt", "select_with_parenthesis", "expression_list",
+  "expression", "rel_attr", "opt_where", "table_factor", "opt_table_refs",
+  "table_ref", "opt_join_condition", "table_ref_list",
+  "expression_with_order", "expression_with_order_list",
+  "query_expression", "query_expression_list", "opt_order_by", "opt_limit",
+  "opt_group_by", "opt_order_type", "opt_having", "load_data_stmt",
+  "explain_stmt", "set_variable_stmt", "opt_inner", "opt_semicolon",
+  "opt_not", "opt_alias", "opt_as", "opt_nullable", YY_NULLPTR
 };
 
 static const char *
@@ -722,12 +726,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-144)
+#define YYPACT_NINF (-147)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-132)
+#define YYTABLE_NINF (-137)
 
 #define yytable_value_is_error(Yyn) \
   ((Yyn) == YYTABLE_NINF)
@@ -736,30 +740,31 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     183,     4,    55,    99,    99,   -24,    37,  -144,    15,    30,
-      11,  -144,  -144,  -144,  -144,  -144,    23,    32,   183,    79,
-      77,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
-    -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
-      26,  -144,    74,    31,    43,    -2,  -144,    65,  -144,  -144,
-      -4,  -144,    99,    99,  -144,  -144,  -144,   176,  -144,    98,
-    -144,    64,  -144,  -144,    66,    67,    82,    54,    83,  -144,
-    -144,  -144,  -144,   105,    70,  -144,    88,   108,    45,    16,
-    -144,    99,   -37,   221,  -144,  -144,    68,    99,    99,  -144,
-      99,    99,    99,    99,    99,    99,    99,    99,    99,    99,
-     -28,  -144,    75,    99,   -12,    95,   100,    95,    80,    17,
-      76,    81,   103,    87,  -144,  -144,   118,   113,  -144,  -144,
-     109,   210,   232,     6,     6,     6,     6,     6,     6,   -51,
-     -51,  -144,  -144,   125,    89,  -144,  -144,    16,  -144,   -23,
-       9,  -144,    99,   101,   128,  -144,    84,   127,    95,  -144,
-     116,    10,   131,   102,  -144,  -144,    99,  -144,    -2,  -144,
-    -144,   137,  -144,   -12,  -144,   110,   198,   115,   119,    17,
-      99,    80,  -144,   155,  -144,  -144,  -144,  -144,  -144,    -6,
-      81,   143,   146,  -144,   147,  -144,  -144,   -12,    99,    99,
-     140,   169,   198,  -144,   135,   138,  -144,   166,  -144,   131,
-    -144,   148,  -144,   -23,  -144,   198,   157,  -144,    17,   188,
-    -144,  -144,   189,  -144,  -144,   182,   190,   172,    28,   169,
-    -144,   -20,   148,  -144,    99,  -144,  -144,  -144,   191,  -144,
-      99,  -144,  -144,  -144,   198,    28,   198,  -144
+     266,     3,    58,   137,   137,   -38,    15,  -147,    -7,     5,
+     -23,  -147,  -147,  -147,  -147,  -147,    21,    18,   199,    43,
+      74,  -147,  -147,  -147,  -147,  -147,  -147,  -147,  -147,  -147,
+    -147,  -147,  -147,  -147,  -147,  -147,  -147,  -147,  -147,  -147,
+      23,  -147,    71,    25,    27,    -2,  -147,    65,  -147,  -147,
+       1,  -147,   137,   137,  -147,  -147,  -147,   113,  -147,    64,
+    -147,    72,  -147,  -147,    32,    45,    73,    46,    68,   266,
+    -147,  -147,  -147,  -147,    93,    80,  -147,    98,   118,    83,
+      60,  -147,   137,   -40,   275,  -147,  -147,    77,   137,   137,
+    -147,   137,   137,   137,   137,   137,   137,   137,   137,   137,
+     137,   -30,  -147,    84,   137,     7,   120,   123,   120,   103,
+      52,   105,  -147,   104,   124,   109,  -147,  -147,   146,   198,
+    -147,  -147,   138,   264,   286,   -34,   -34,   -34,   -34,   -34,
+     -34,     2,     2,  -147,  -147,   167,   131,  -147,  -147,    60,
+    -147,   -24,   -10,  -147,   137,   151,   171,  -147,   129,   176,
+     120,  -147,   164,    90,   179,   145,  -147,  -147,   137,  -147,
+      -2,  -147,  -147,   182,  -147,     7,  -147,   154,   252,   161,
+     165,    -8,   137,   103,  -147,   211,  -147,  -147,  -147,  -147,
+    -147,    -5,   104,   204,   206,  -147,   207,  -147,  -147,     7,
+     137,   137,   183,  -147,   212,  -147,   252,  -147,   172,   178,
+    -147,   205,  -147,   179,  -147,   180,  -147,   -24,  -147,   252,
+     189,  -147,    -8,   220,  -147,  -147,   221,  -147,  -147,   222,
+     224,   208,   137,   212,  -147,     0,   180,  -147,   137,  -147,
+      63,   225,   192,  -147,  -147,  -147,   252,  -147,  -147,  -147,
+     137,   191,  -147,  -147,  -147
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -769,50 +774,51 @@ static const yytype_uint8 yydefact[] =
 {
        0,    32,     0,     0,     0,     0,     0,    24,     0,     0,
        0,    25,    26,    27,    23,    22,     0,     0,     0,     0,
-     125,    21,    20,    13,    14,    15,    16,     8,     9,    10,
+     130,    21,    20,    13,    14,    15,    16,     8,     9,    10,
       11,    12,     7,     4,     6,     5,     3,    17,    18,    19,
-       0,    33,     0,     0,     0,     0,    54,     0,    51,    52,
-      89,    53,     0,     0,    92,    87,    69,   129,    88,   109,
-      61,    97,    30,    29,     0,     0,     0,     0,     0,   121,
-       1,   126,     2,     0,     0,    28,     0,     0,   127,     0,
-      82,     0,     0,    81,    70,   132,   127,     0,     0,   128,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,   108,     0,     0,     0,    93,     0,    93,     0,     0,
-       0,     0,     0,     0,    62,    79,     0,    63,    90,    91,
-       0,    78,    77,    72,    73,    74,    75,    71,    76,    65,
-      66,    67,    68,     0,     0,   130,   110,     0,    95,   129,
-     103,    98,     0,   113,     0,    55,     0,    58,    93,   122,
-       0,     0,    38,     0,    36,    86,     0,    85,     0,    84,
-      80,     0,    99,     0,   124,     0,    94,     0,   118,     0,
-       0,     0,    56,     0,    43,    44,    45,    47,    46,   133,
-       0,     0,     0,    64,     0,    96,   104,     0,     0,     0,
-     111,    49,    57,    59,     0,     0,   135,     0,    41,    38,
-      37,     0,    83,   129,   114,   119,     0,    60,     0,     0,
-     120,    42,     0,   134,    39,    34,     0,   101,   115,    49,
-      48,   133,     0,    31,     0,   100,   117,   116,   106,   112,
-       0,    50,    40,    35,   102,   115,   105,   107
+       0,    33,     0,     0,     0,     0,    56,     0,    53,    54,
+      91,    55,     0,     0,    94,    89,    71,   134,    90,   111,
+      63,    99,    30,    29,     0,     0,     0,     0,     0,     0,
+     125,     1,   131,     2,     0,     0,    28,     0,     0,   132,
+       0,    84,     0,     0,    83,    72,   137,   132,     0,     0,
+     133,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,   110,     0,     0,     0,    95,     0,    95,     0,
+       0,     0,   126,     0,     0,     0,    64,    81,     0,    65,
+      92,    93,     0,    80,    79,    74,    75,    76,    77,    73,
+      78,    67,    68,    69,    70,     0,     0,   135,   112,     0,
+      97,   134,   105,   100,     0,   117,     0,    57,     0,    60,
+      95,   127,     0,     0,    38,     0,    36,    88,     0,    87,
+       0,    86,    82,     0,   101,     0,   129,     0,    96,     0,
+     122,     0,     0,     0,    58,     0,    43,    44,    45,    47,
+      46,   138,     0,     0,     0,    66,     0,    98,   106,     0,
+       0,     0,   113,    52,    49,    51,    59,    61,     0,     0,
+     140,     0,    41,    38,    37,     0,    85,   134,   118,   123,
+       0,    62,     0,     0,   124,    42,     0,   139,    39,    34,
+       0,   103,     0,    49,    48,   138,     0,    31,     0,   102,
+     119,   108,   115,    50,    40,    35,   104,   121,   120,   107,
+       0,     0,   114,   109,   116
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -144,  -144,   194,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
-    -144,  -144,  -144,  -144,    -7,  -144,  -144,    18,    36,  -144,
-    -144,  -144,    -1,  -107,  -144,  -144,  -144,    48,     3,   -36,
-    -143,    -3,  -144,   -90,    41,  -144,  -144,  -144,    61,  -144,
-      -5,  -144,     0,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
-    -144,  -144,   163,  -134,  -144,     8
+    -147,  -147,   -12,  -147,  -147,  -147,  -147,  -147,  -147,  -147,
+    -147,  -147,  -147,  -147,    24,  -147,  -147,    48,    67,  -147,
+    -147,  -147,    29,    41,  -108,  -147,  -147,  -147,    99,   -41,
+     -36,  -146,    -3,  -147,   -90,    85,  -147,  -147,  -147,   108,
+    -147,    38,  -147,    -1,  -147,  -147,  -147,  -147,  -147,  -147,
+    -147,  -147,  -147,  -147,   197,  -136,  -147,    61
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
        0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,    42,   216,    31,    32,   181,   152,   212,
-     179,    33,   209,    55,    34,    35,   147,   148,    77,    56,
-     116,   117,    58,   143,   139,   105,   140,   225,   141,   228,
-     229,    59,    60,   207,   168,   230,   190,    37,    38,    39,
-     165,    72,   100,   101,   102,   198
+      28,    29,    30,    42,   220,    31,    32,   183,   154,   216,
+     181,    33,   213,   194,    55,    34,    35,   149,   150,    36,
+      56,   118,   119,    58,   145,   141,   106,   142,   229,   143,
+     231,   232,    59,    60,   211,   242,   170,   239,   192,    37,
+      38,    39,   167,    73,   101,   102,   103,   202
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -820,72 +826,82 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      57,    57,   149,    36,    61,   162,   137,     3,     4,   196,
-      40,    80,   195,   183,    81,   184,    45,   145,   118,    98,
-      99,    36,   133,   196,    85,     3,     4,    46,    82,   163,
-     134,    62,  -131,   119,   174,   175,   176,   177,   178,   226,
-     227,   197,    78,   138,    63,   204,    46,    47,    64,    83,
-      84,    48,    49,    50,    51,   197,    41,  -123,   172,    52,
-     164,    43,   191,    44,   115,    65,    66,    53,    54,   217,
-      48,    49,    68,    51,    96,    97,    98,    99,    67,    70,
-      71,    73,    74,    79,   121,   122,    75,   123,   124,   125,
-     126,   127,   128,   129,   130,   131,   132,   159,    76,   104,
-      57,   219,    86,   136,    87,    88,    89,    90,    91,    92,
-      93,    94,    95,    96,    97,    98,    99,    45,   103,   108,
-     109,   106,   107,   111,   110,   112,   113,   114,    46,    89,
-     135,   142,   150,   156,   144,   146,   151,   155,   157,   166,
-     161,   153,   154,   158,   167,   160,   169,   171,    47,   173,
-     170,   180,    48,    49,    50,    51,   185,   182,   187,   188,
-      52,   194,   200,  -127,   201,   189,   202,   192,    53,    54,
-      86,  -127,    87,    88,    89,    90,    91,    92,    93,    94,
-      95,    96,    97,    98,    99,   206,   205,     1,     2,   208,
-     210,   211,     3,     4,     5,   213,     6,     7,     8,     9,
-      10,   218,   222,   215,    11,    12,    13,   220,   221,   223,
-     224,   235,    69,    14,    15,   233,   199,   214,   231,   193,
-      16,   234,    17,    85,   186,    18,  -127,   236,   203,   232,
-     237,  -131,     0,    86,  -127,    87,    88,    89,    90,    91,
-      92,    93,    94,    95,    96,    97,    98,    99,  -127,   120,
-       0,     0,     0,     0,     0,    86,  -127,    87,    88,    89,
-      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
-      88,    89,    90,    91,    92,    93,    94,    95,    96,    97,
-      98,    99,  -132,    90,    91,    92,    93,    94,    95,    96,
-      97,    98,    99,    89,    90,    91,    92,    93,    94,    95,
-      96,    97,    98,    99
+      57,    57,   151,    61,    78,   164,    70,     3,     4,    40,
+     165,    81,   185,   199,   186,   120,    45,    62,   147,    82,
+     135,    46,    63,    86,   200,   139,    64,    46,   136,   200,
+     121,  -136,    66,    83,    97,    98,    99,   100,  -128,    78,
+      65,   166,    79,    71,   208,    48,    49,    47,    51,    84,
+      85,    48,    49,    50,    51,    41,   201,   112,    68,    52,
+     174,   201,   140,   195,    43,   193,    44,    53,    54,     3,
+       4,   221,    99,   100,   237,   238,    67,    72,    74,    75,
+      76,    46,    77,    80,   104,   123,   124,   107,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   163,   161,
+     108,    57,   117,   138,   195,    48,    49,   105,    51,   111,
+     109,   113,   110,  -132,   176,   177,   178,   179,   180,    78,
+      87,  -132,    88,    89,    90,    91,    92,    93,    94,    95,
+      96,    97,    98,    99,   100,   114,   115,   116,    90,   137,
+      87,   168,    88,    89,    90,    91,    92,    93,    94,    95,
+      96,    97,    98,    99,   100,    45,   144,   146,   148,   153,
+      86,   152,   155,  -132,   156,   157,    46,   159,  -136,   196,
+      87,  -132,    88,    89,    90,    91,    92,    93,    94,    95,
+      96,    97,    98,    99,   100,   160,    47,   162,   209,   171,
+      48,    49,    50,    51,   169,   172,   173,   175,    52,   182,
+     184,   187,   189,     1,     2,   190,    53,    54,     3,     4,
+       5,   191,     6,     7,     8,     9,    10,   198,   158,   230,
+      11,    12,    13,   204,   205,   236,   206,   214,   210,    14,
+      15,   215,   212,   222,   217,   219,    16,   230,    17,   224,
+     225,    18,   226,   227,   244,   240,   228,   241,  -132,   203,
+     235,   218,   233,   223,    69,    87,  -132,    88,    89,    90,
+      91,    92,    93,    94,    95,    96,    97,    98,    99,   100,
+       1,     2,   197,   188,   207,     3,     4,     5,   243,     6,
+       7,     8,     9,    10,   122,     0,   234,    11,    12,    13,
+       0,     0,     0,     0,     0,     0,    14,    15,     0,     0,
+       0,     0,  -132,    16,     0,    17,     0,     0,    18,    87,
+    -132,    88,    89,    90,    91,    92,    93,    94,    95,    96,
+      97,    98,    99,   100,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,  -137,    91,    92,    93,
+      94,    95,    96,    97,    98,    99,   100,    90,    91,    92,
+      93,    94,    95,    96,    97,    98,    99,   100
 };
 
 static const yytype_int16 yycheck[] =
 {
-       3,     4,   109,     0,     4,   139,    18,     9,    10,    29,
-       6,    47,    18,   156,    18,   158,    18,   107,    55,    70,
-      71,    18,    50,    29,    47,     9,    10,    29,    32,    20,
-      58,    55,    55,    70,    24,    25,    26,    27,    28,    11,
-      12,    61,    45,    55,     7,   188,    29,    49,    33,    52,
-      53,    53,    54,    55,    56,    61,    52,    48,   148,    61,
-      51,     6,   169,     8,    19,    35,    55,    69,    70,   203,
-      53,    54,    40,    56,    68,    69,    70,    71,    55,     0,
-       3,    55,     8,    18,    87,    88,    55,    90,    91,    92,
-      93,    94,    95,    96,    97,    98,    99,   133,    55,    35,
-     103,   208,    57,   103,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69,    70,    71,    18,    20,    37,
-      66,    55,    55,    18,    41,    55,    38,    19,    29,    61,
-      55,    36,    56,    20,    34,    55,    55,    19,    29,   142,
-     137,    38,    55,    18,    43,    56,    18,    20,    49,    33,
-      66,    20,    53,    54,    55,    56,    19,    55,    48,    44,
-      61,     6,    19,    50,    18,    46,    19,   170,    69,    70,
+       3,     4,   110,     4,    45,   141,    18,     9,    10,     6,
+      20,    47,   158,    18,   160,    55,    18,    55,   108,    18,
+      50,    29,     7,    47,    29,    18,    33,    29,    58,    29,
+      70,    55,    55,    32,    68,    69,    70,    71,    48,    80,
+      35,    51,    45,     0,   190,    53,    54,    49,    56,    52,
+      53,    53,    54,    55,    56,    52,    61,    69,    40,    61,
+     150,    61,    55,   171,     6,    73,     8,    69,    70,     9,
+      10,   207,    70,    71,    11,    12,    55,     3,    55,     8,
+      55,    29,    55,    18,    20,    88,    89,    55,    91,    92,
+      93,    94,    95,    96,    97,    98,    99,   100,   139,   135,
+      55,   104,    19,   104,   212,    53,    54,    35,    56,    41,
+      37,    18,    66,    50,    24,    25,    26,    27,    28,   160,
+      57,    58,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    55,    38,    19,    61,    55,
+      57,   144,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    18,    36,    34,    55,    55,
+      47,    56,    38,    50,    55,    19,    29,    29,    55,   172,
       57,    58,    59,    60,    61,    62,    63,    64,    65,    66,
-      67,    68,    69,    70,    71,    45,   189,     4,     5,    20,
-      55,    53,     9,    10,    11,    29,    13,    14,    15,    16,
-      17,    44,    20,    55,    21,    22,    23,    19,    19,    19,
-      38,    20,    18,    30,    31,   222,   180,   199,   219,   171,
-      37,   224,    39,    47,   163,    42,    50,   230,   187,   221,
-     235,    55,    -1,    57,    58,    59,    60,    61,    62,    63,
-      64,    65,    66,    67,    68,    69,    70,    71,    50,    86,
-      -1,    -1,    -1,    -1,    -1,    57,    58,    59,    60,    61,
+      67,    68,    69,    70,    71,    18,    49,    56,   191,    18,
+      53,    54,    55,    56,    43,    66,    20,    33,    61,    20,
+      55,    19,    48,     4,     5,    44,    69,    70,     9,    10,
+      11,    46,    13,    14,    15,    16,    17,     6,    20,   222,
+      21,    22,    23,    19,    18,   228,    19,    55,    45,    30,
+      31,    53,    20,    44,    29,    55,    37,   240,    39,    19,
+      19,    42,    20,    19,    53,    20,    38,    55,    50,   182,
+     226,   203,   223,   212,    55,    57,    58,    59,    60,    61,
       62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
-      60,    61,    62,    63,    64,    65,    66,    67,    68,    69,
-      70,    71,    61,    62,    63,    64,    65,    66,    67,    68,
-      69,    70,    71,    61,    62,    63,    64,    65,    66,    67,
-      68,    69,    70,    71
+       4,     5,   173,   165,   189,     9,    10,    11,   240,    13,
+      14,    15,    16,    17,    87,    -1,   225,    21,    22,    23,
+      -1,    -1,    -1,    -1,    -1,    -1,    30,    31,    -1,    -1,
+      -1,    -1,    50,    37,    -1,    39,    -1,    -1,    42,    57,
+      58,    59,    60,    61,    62,    63,    64,    65,    66,    67,
+      68,    69,    70,    71,    60,    61,    62,    63,    64,    65,
+      66,    67,    68,    69,    70,    71,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -893,48 +909,50 @@ static const yytype_int16 yycheck[] =
 static const yytype_uint8 yystos[] =
 {
        0,     4,     5,     9,    10,    11,    13,    14,    15,    16,
-      17,    21,    22,    23,    30,    31,    37,    39,    42,    74,
-      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
-      85,    88,    89,    94,    97,    98,   101,   120,   121,   122,
-       6,    52,    86,     6,     8,    18,    29,    49,    53,    54,
-      55,    56,    61,    69,    70,    96,   102,   104,   105,   114,
-     115,   115,    55,     7,    33,    35,    55,    55,    40,    75,
-       0,     3,   124,    55,     8,    55,    55,   101,   104,    18,
-     102,    18,    32,   104,   104,    47,    57,    59,    60,    61,
-      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
-     125,   126,   127,    20,    35,   108,    55,    55,    37,    66,
-      41,    18,    55,    38,    19,    19,   103,   104,    55,    70,
-     125,   104,   104,   104,   104,   104,   104,   104,   104,   104,
-     104,   104,   104,    50,    58,    55,   115,    18,    55,   107,
-     109,   111,    36,   106,    34,   106,    55,    99,   100,    96,
-      56,    55,    91,    38,    55,    19,    20,    29,    18,   102,
-      56,   101,   126,    20,    51,   123,   104,    43,   117,    18,
-      66,    20,   106,    33,    24,    25,    26,    27,    28,    93,
-      20,    90,    55,   103,   103,    19,   111,    48,    44,    46,
-     119,    96,   104,   100,     6,    18,    29,    61,   128,    91,
-      19,    18,    19,   107,   103,   104,    45,   116,    20,    95,
-      55,    53,    92,    29,    90,    55,    87,   126,    44,    96,
-      19,    19,    20,    19,    38,   110,    11,    12,   112,   113,
-     118,    95,   128,    87,   104,    20,   104,   113
+      17,    21,    22,    23,    30,    31,    37,    39,    42,    75,
+      76,    77,    78,    79,    80,    81,    82,    83,    84,    85,
+      86,    89,    90,    95,    99,   100,   103,   123,   124,   125,
+       6,    52,    87,     6,     8,    18,    29,    49,    53,    54,
+      55,    56,    61,    69,    70,    98,   104,   106,   107,   116,
+     117,   117,    55,     7,    33,    35,    55,    55,    40,    55,
+      76,     0,     3,   127,    55,     8,    55,    55,   103,   106,
+      18,   104,    18,    32,   106,   106,    47,    57,    59,    60,
+      61,    62,    63,    64,    65,    66,    67,    68,    69,    70,
+      71,   128,   129,   130,    20,    35,   110,    55,    55,    37,
+      66,    41,    76,    18,    55,    38,    19,    19,   105,   106,
+      55,    70,   128,   106,   106,   106,   106,   106,   106,   106,
+     106,   106,   106,   106,   106,    50,    58,    55,   117,    18,
+      55,   109,   111,   113,    36,   108,    34,   108,    55,   101,
+     102,    98,    56,    55,    92,    38,    55,    19,    20,    29,
+      18,   104,    56,   103,   129,    20,    51,   126,   106,    43,
+     120,    18,    66,    20,   108,    33,    24,    25,    26,    27,
+      28,    94,    20,    91,    55,   105,   105,    19,   113,    48,
+      44,    46,   122,    73,    97,    98,   106,   102,     6,    18,
+      29,    61,   131,    92,    19,    18,    19,   109,   105,   106,
+      45,   118,    20,    96,    55,    53,    93,    29,    91,    55,
+      88,   129,    44,    97,    19,    19,    20,    19,    38,   112,
+     106,   114,   115,    96,   131,    88,   106,    11,    12,   121,
+      20,    55,   119,   115,    53
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_uint8 yyr1[] =
 {
-       0,    73,    74,    75,    75,    75,    75,    75,    75,    75,
-      75,    75,    75,    75,    75,    75,    75,    75,    75,    75,
-      75,    75,    76,    77,    78,    79,    80,    81,    82,    83,
-      84,    85,    86,    86,    87,    87,    88,    89,    90,    90,
-      91,    91,    92,    93,    93,    93,    93,    93,    94,    95,
-      95,    96,    96,    96,    96,    97,    98,    99,   100,   100,
-     101,   101,   102,   103,   103,   104,   104,   104,   104,   104,
-     104,   104,   104,   104,   104,   104,   104,   104,   104,   104,
-     104,   104,   104,   104,   104,   104,   104,   104,   104,   105,
-     105,   105,   105,   106,   106,   107,   107,   108,   108,   109,
-     109,   110,   110,   111,   111,   112,   113,   113,   114,   115,
-     115,   116,   116,   117,   117,   118,   118,   118,   119,   119,
-     120,   121,   122,   123,   123,   124,   124,   125,   125,   126,
-     126,   127,   127,   128,   128,   128
+       0,    74,    75,    76,    76,    76,    76,    76,    76,    76,
+      76,    76,    76,    76,    76,    76,    76,    76,    76,    76,
+      76,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    87,    88,    88,    89,    90,    91,    91,
+      92,    92,    93,    94,    94,    94,    94,    94,    95,    96,
+      96,    97,    97,    98,    98,    98,    98,    99,   100,   101,
+     102,   102,   103,   103,   104,   105,   105,   106,   106,   106,
+     106,   106,   106,   106,   106,   106,   106,   106,   106,   106,
+     106,   106,   106,   106,   106,   106,   106,   106,   106,   106,
+     106,   107,   107,   107,   107,   108,   108,   109,   109,   110,
+     110,   111,   111,   112,   112,   113,   113,   114,   115,   115,
+     116,   117,   117,   118,   118,   119,   119,   120,   120,   121,
+     121,   121,   122,   122,   123,   124,   124,   125,   126,   126,
+     127,   127,   128,   128,   129,   129,   130,   130,   131,   131,
+     131
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -945,15 +963,16 @@ static const yytype_int8 yyr2[] =
        1,     1,     1,     1,     1,     1,     1,     1,     3,     2,
        2,     9,     0,     1,     1,     3,     5,     7,     0,     3,
        6,     3,     1,     1,     1,     1,     1,     1,     8,     0,
-       3,     1,     1,     1,     1,     4,     5,     3,     1,     3,
-       7,     2,     3,     1,     3,     3,     3,     3,     3,     1,
-       2,     3,     3,     3,     3,     3,     3,     3,     3,     3,
-       4,     2,     2,     6,     4,     4,     4,     1,     1,     1,
-       3,     3,     1,     0,     2,     1,     3,     0,     2,     2,
-       6,     0,     2,     1,     3,     2,     1,     3,     2,     1,
-       3,     0,     3,     0,     3,     0,     1,     1,     0,     2,
-       7,     2,     4,     0,     1,     0,     1,     0,     1,     0,
-       2,     0,     1,     0,     2,     1
+       3,     1,     1,     1,     1,     1,     1,     4,     5,     3,
+       1,     3,     7,     2,     3,     1,     3,     3,     3,     3,
+       3,     1,     2,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     4,     2,     2,     6,     4,     4,     4,     1,
+       1,     1,     3,     3,     1,     0,     2,     1,     3,     0,
+       2,     2,     6,     0,     2,     1,     3,     2,     1,     3,
+       2,     1,     3,     0,     4,     0,     2,     0,     3,     0,
+       1,     1,     0,     2,     7,     2,     3,     4,     0,     1,
+       0,     1,     0,     1,     0,     2,     0,     1,     0,     2,
+       1
 };
 
 
@@ -1815,93 +1834,93 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 210 "yacc_sql.y"
+#line 213 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1824 "yacc_sql.cpp"
+#line 1843 "yacc_sql.cpp"
     break;
 
   case 22: /* exit_stmt: EXIT  */
-#line 239 "yacc_sql.y"
+#line 242 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1833 "yacc_sql.cpp"
+#line 1852 "yacc_sql.cpp"
     break;
 
   case 23: /* help_stmt: HELP  */
-#line 245 "yacc_sql.y"
+#line 248 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1841 "yacc_sql.cpp"
+#line 1860 "yacc_sql.cpp"
     break;
 
   case 24: /* sync_stmt: SYNC  */
-#line 250 "yacc_sql.y"
+#line 253 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1849 "yacc_sql.cpp"
+#line 1868 "yacc_sql.cpp"
     break;
 
   case 25: /* begin_stmt: TRX_BEGIN  */
-#line 256 "yacc_sql.y"
+#line 259 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1857 "yacc_sql.cpp"
+#line 1876 "yacc_sql.cpp"
     break;
 
   case 26: /* commit_stmt: TRX_COMMIT  */
-#line 262 "yacc_sql.y"
+#line 265 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1865 "yacc_sql.cpp"
+#line 1884 "yacc_sql.cpp"
     break;
 
   case 27: /* rollback_stmt: TRX_ROLLBACK  */
-#line 268 "yacc_sql.y"
+#line 271 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1873 "yacc_sql.cpp"
+#line 1892 "yacc_sql.cpp"
     break;
 
   case 28: /* drop_table_stmt: DROP TABLE ID  */
-#line 274 "yacc_sql.y"
+#line 277 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1883 "yacc_sql.cpp"
+#line 1902 "yacc_sql.cpp"
     break;
 
   case 29: /* show_tables_stmt: SHOW TABLES  */
-#line 281 "yacc_sql.y"
+#line 284 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1891 "yacc_sql.cpp"
+#line 1910 "yacc_sql.cpp"
     break;
 
   case 30: /* desc_table_stmt: DESC ID  */
-#line 287 "yacc_sql.y"
+#line 290 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1901 "yacc_sql.cpp"
+#line 1920 "yacc_sql.cpp"
     break;
 
   case 31: /* create_index_stmt: CREATE opt_unique INDEX ID ON ID LBRACE index_col_list RBRACE  */
-#line 296 "yacc_sql.y"
+#line 299 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
@@ -1913,33 +1932,33 @@ yyreduce:
       free((yyvsp[-3].string));
       delete (yyvsp[-1].string_list);
     }
-#line 1917 "yacc_sql.cpp"
+#line 1936 "yacc_sql.cpp"
     break;
 
   case 32: /* opt_unique: %empty  */
-#line 309 "yacc_sql.y"
+#line 312 "yacc_sql.y"
     {(yyval.booleans) = false;}
-#line 1923 "yacc_sql.cpp"
+#line 1942 "yacc_sql.cpp"
     break;
 
   case 33: /* opt_unique: UNIQUE  */
-#line 310 "yacc_sql.y"
+#line 313 "yacc_sql.y"
              {(yyval.booleans) = true;}
-#line 1929 "yacc_sql.cpp"
+#line 1948 "yacc_sql.cpp"
     break;
 
   case 34: /* index_col_list: ID  */
-#line 314 "yacc_sql.y"
+#line 317 "yacc_sql.y"
                    {
       (yyval.string_list) = new std::vector<std::string>;
       (yyval.string_list)->push_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 1939 "yacc_sql.cpp"
+#line 1958 "yacc_sql.cpp"
     break;
 
   case 35: /* index_col_list: ID COMMA index_col_list  */
-#line 319 "yacc_sql.y"
+#line 322 "yacc_sql.y"
                                 {
       if ((yyvsp[0].string_list) != nullptr) {
         (yyval.string_list) = (yyvsp[0].string_list);
@@ -1949,11 +1968,11 @@ yyreduce:
       (yyval.string_list)->insert((yyval.string_list)->begin(), (yyvsp[-2].string));
       free((yyvsp[-2].string));
     }
-#line 1953 "yacc_sql.cpp"
+#line 1972 "yacc_sql.cpp"
     break;
 
   case 36: /* drop_index_stmt: DROP INDEX ID ON ID  */
-#line 331 "yacc_sql.y"
+#line 334 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -1961,11 +1980,11 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 1965 "yacc_sql.cpp"
+#line 1984 "yacc_sql.cpp"
     break;
 
   case 37: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE  */
-#line 342 "yacc_sql.y"
+#line 345 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
@@ -1982,19 +2001,19 @@ yyreduce:
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete (yyvsp[-2].attr_info);
     }
-#line 1986 "yacc_sql.cpp"
+#line 2005 "yacc_sql.cpp"
     break;
 
   case 38: /* attr_def_list: %empty  */
-#line 362 "yacc_sql.y"
+#line 365 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1994 "yacc_sql.cpp"
+#line 2013 "yacc_sql.cpp"
     break;
 
   case 39: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 366 "yacc_sql.y"
+#line 369 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -2004,11 +2023,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 2008 "yacc_sql.cpp"
+#line 2027 "yacc_sql.cpp"
     break;
 
   case 40: /* attr_def: ID type LBRACE number RBRACE opt_nullable  */
-#line 379 "yacc_sql.y"
+#line 382 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-4].number);
@@ -2017,11 +2036,11 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].booleans);
       free((yyvsp[-5].string));
     }
-#line 2021 "yacc_sql.cpp"
+#line 2040 "yacc_sql.cpp"
     break;
 
   case 41: /* attr_def: ID type opt_nullable  */
-#line 388 "yacc_sql.y"
+#line 391 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-1].number);
@@ -2030,47 +2049,47 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].booleans);
       free((yyvsp[-2].string));
     }
-#line 2034 "yacc_sql.cpp"
+#line 2053 "yacc_sql.cpp"
     break;
 
   case 42: /* number: NUMBER  */
-#line 399 "yacc_sql.y"
+#line 402 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 2040 "yacc_sql.cpp"
+#line 2059 "yacc_sql.cpp"
     break;
 
   case 43: /* type: INT_T  */
-#line 403 "yacc_sql.y"
+#line 406 "yacc_sql.y"
                { (yyval.number)=INTS; }
-#line 2046 "yacc_sql.cpp"
+#line 2065 "yacc_sql.cpp"
     break;
 
   case 44: /* type: STRING_T  */
-#line 404 "yacc_sql.y"
+#line 407 "yacc_sql.y"
                { (yyval.number)=CHARS; }
-#line 2052 "yacc_sql.cpp"
+#line 2071 "yacc_sql.cpp"
     break;
 
   case 45: /* type: FLOAT_T  */
-#line 405 "yacc_sql.y"
+#line 408 "yacc_sql.y"
                { (yyval.number)=FLOATS; }
-#line 2058 "yacc_sql.cpp"
+#line 2077 "yacc_sql.cpp"
     break;
 
   case 46: /* type: TEXT_T  */
-#line 406 "yacc_sql.y"
+#line 409 "yacc_sql.y"
                { (yyval.number)=TEXTS; }
-#line 2064 "yacc_sql.cpp"
+#line 2083 "yacc_sql.cpp"
     break;
 
   case 47: /* type: DATE_T  */
-#line 407 "yacc_sql.y"
+#line 410 "yacc_sql.y"
                { (yyval.number)=DATES; }
-#line 2070 "yacc_sql.cpp"
+#line 2089 "yacc_sql.cpp"
     break;
 
-  case 48: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
-#line 412 "yacc_sql.y"
+  case 48: /* insert_stmt: INSERT INTO ID VALUES LBRACE insert_value value_list RBRACE  */
+#line 415 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-5].string);
@@ -2083,20 +2102,20 @@ yyreduce:
       delete (yyvsp[-2].value);
       free((yyvsp[-5].string));
     }
-#line 2087 "yacc_sql.cpp"
+#line 2106 "yacc_sql.cpp"
     break;
 
   case 49: /* value_list: %empty  */
-#line 428 "yacc_sql.y"
+#line 431 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 2095 "yacc_sql.cpp"
+#line 2114 "yacc_sql.cpp"
     break;
 
-  case 50: /* value_list: COMMA value value_list  */
-#line 431 "yacc_sql.y"
-                              { 
+  case 50: /* value_list: COMMA insert_value value_list  */
+#line 434 "yacc_sql.y"
+                                     { 
       if ((yyvsp[0].value_list) != nullptr) {
         (yyval.value_list) = (yyvsp[0].value_list);
       } else {
@@ -2105,49 +2124,65 @@ yyreduce:
       (yyval.value_list)->emplace_back(*(yyvsp[-1].value));
       delete (yyvsp[-1].value);
     }
-#line 2109 "yacc_sql.cpp"
+#line 2128 "yacc_sql.cpp"
     break;
 
-  case 51: /* value: NUMBER  */
-#line 443 "yacc_sql.y"
+  case 51: /* insert_value: value  */
+#line 446 "yacc_sql.y"
+          {
+      (yyval.value) = (yyvsp[0].value);
+    }
+#line 2136 "yacc_sql.cpp"
+    break;
+
+  case 52: /* insert_value: '?'  */
+#line 450 "yacc_sql.y"
+          {
+      (yyval.value) = new Value();
+    }
+#line 2144 "yacc_sql.cpp"
+    break;
+
+  case 53: /* value: NUMBER  */
+#line 456 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2118 "yacc_sql.cpp"
+#line 2153 "yacc_sql.cpp"
     break;
 
-  case 52: /* value: FLOAT  */
-#line 447 "yacc_sql.y"
+  case 54: /* value: FLOAT  */
+#line 460 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2127 "yacc_sql.cpp"
+#line 2162 "yacc_sql.cpp"
     break;
 
-  case 53: /* value: SSS  */
-#line 451 "yacc_sql.y"
+  case 55: /* value: SSS  */
+#line 464 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
       free((yyvsp[0].string));
     }
-#line 2138 "yacc_sql.cpp"
+#line 2173 "yacc_sql.cpp"
     break;
 
-  case 54: /* value: THE_NULL  */
-#line 457 "yacc_sql.y"
+  case 56: /* value: THE_NULL  */
+#line 470 "yacc_sql.y"
               {
       (yyval.value) = new Value();
       (yyval.value)->set_null();
     }
-#line 2147 "yacc_sql.cpp"
+#line 2182 "yacc_sql.cpp"
     break;
 
-  case 55: /* delete_stmt: DELETE FROM ID opt_where  */
-#line 465 "yacc_sql.y"
+  case 57: /* delete_stmt: DELETE FROM ID opt_where  */
+#line 478 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2156,11 +2191,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2160 "yacc_sql.cpp"
+#line 2195 "yacc_sql.cpp"
     break;
 
-  case 56: /* update_stmt: UPDATE ID SET update_asgn_list opt_where  */
-#line 477 "yacc_sql.y"
+  case 58: /* update_stmt: UPDATE ID SET update_asgn_list opt_where  */
+#line 490 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-3].string);
@@ -2170,11 +2205,11 @@ yyreduce:
       }
       free((yyvsp[-3].string));
     }
-#line 2174 "yacc_sql.cpp"
+#line 2209 "yacc_sql.cpp"
     break;
 
-  case 57: /* update_asgn_factor: ID EQ expression  */
-#line 490 "yacc_sql.y"
+  case 59: /* update_asgn_factor: ID EQ expression  */
+#line 503 "yacc_sql.y"
     {
       UpdateAssignmentSqlNode *tmp = new UpdateAssignmentSqlNode;
       tmp->attribute_name = (yyvsp[-2].string);
@@ -2182,20 +2217,20 @@ yyreduce:
 
       (yyval.update_asgn_factor) = tmp;
     }
-#line 2186 "yacc_sql.cpp"
+#line 2221 "yacc_sql.cpp"
     break;
 
-  case 58: /* update_asgn_list: update_asgn_factor  */
-#line 500 "yacc_sql.y"
+  case 60: /* update_asgn_list: update_asgn_factor  */
+#line 513 "yacc_sql.y"
     {
       (yyval.update_asgn_list) = new std::vector<UpdateAssignmentSqlNode *>;
       (yyval.update_asgn_list)->push_back((yyvsp[0].update_asgn_factor));
     }
-#line 2195 "yacc_sql.cpp"
+#line 2230 "yacc_sql.cpp"
     break;
 
-  case 59: /* update_asgn_list: update_asgn_factor COMMA update_asgn_list  */
-#line 505 "yacc_sql.y"
+  case 61: /* update_asgn_list: update_asgn_factor COMMA update_asgn_list  */
+#line 518 "yacc_sql.y"
     {
       if ((yyvsp[0].update_asgn_list) != nullptr) {
         (yyval.update_asgn_list) = (yyvsp[0].update_asgn_list);
@@ -2204,11 +2239,11 @@ yyreduce:
       }
       (yyval.update_asgn_list)->insert((yyval.update_asgn_list)->begin(), (yyvsp[-2].update_asgn_factor));
     }
-#line 2208 "yacc_sql.cpp"
+#line 2243 "yacc_sql.cpp"
     break;
 
-  case 60: /* select_stmt: SELECT query_expression_list opt_table_refs opt_where opt_group_by opt_having opt_order_by  */
-#line 518 "yacc_sql.y"
+  case 62: /* select_stmt: SELECT query_expression_list opt_table_refs opt_where opt_group_by opt_having opt_order_by  */
+#line 531 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[-5].expression_with_alias_list) != nullptr) {
@@ -2229,16 +2264,17 @@ yyreduce:
       if ((yyvsp[-1].expression) != nullptr) {
         (yyval.sql_node)->selection.having = (yyvsp[-1].expression);
       }
-      if ((yyvsp[0].order_by_list) != nullptr) {
-        (yyval.sql_node)->selection.order_by.swap(*(yyvsp[0].order_by_list));
-        delete (yyvsp[0].order_by_list);
+      if ((yyvsp[0].order_by_clause) != nullptr) {
+        (yyval.sql_node)->selection.order_by.swap((yyvsp[0].order_by_clause)->order_by);
+        (yyval.sql_node)->selection.limit = (yyvsp[0].order_by_clause)->limit;
+        delete (yyvsp[0].order_by_clause);
       }
     }
-#line 2238 "yacc_sql.cpp"
+#line 2274 "yacc_sql.cpp"
     break;
 
-  case 61: /* select_stmt: CALC query_expression_list  */
-#line 544 "yacc_sql.y"
+  case 63: /* select_stmt: CALC query_expression_list  */
+#line 558 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[0].expression_with_alias_list) != nullptr) {
@@ -2246,29 +2282,29 @@ yyreduce:
         delete (yyvsp[0].expression_with_alias_list);
       }
     }
-#line 2250 "yacc_sql.cpp"
+#line 2286 "yacc_sql.cpp"
     break;
 
-  case 62: /* select_with_parenthesis: LBRACE select_stmt RBRACE  */
-#line 554 "yacc_sql.y"
+  case 64: /* select_with_parenthesis: LBRACE select_stmt RBRACE  */
+#line 568 "yacc_sql.y"
     {
       (yyval.subquery) = new SubqueryExpressionSqlNode;
       (yyval.subquery)->subquery = (yyvsp[-1].sql_node);
     }
-#line 2259 "yacc_sql.cpp"
+#line 2295 "yacc_sql.cpp"
     break;
 
-  case 63: /* expression_list: expression  */
-#line 561 "yacc_sql.y"
+  case 65: /* expression_list: expression  */
+#line 575 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<ExpressionSqlNode *>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2268 "yacc_sql.cpp"
+#line 2304 "yacc_sql.cpp"
     break;
 
-  case 64: /* expression_list: expression COMMA expression_list  */
-#line 566 "yacc_sql.y"
+  case 66: /* expression_list: expression COMMA expression_list  */
+#line 580 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2277,11 +2313,11 @@ yyreduce:
       }
       (yyval.expression_list)->insert((yyval.expression_list)->begin(), (yyvsp[-2].expression));
     }
-#line 2281 "yacc_sql.cpp"
+#line 2317 "yacc_sql.cpp"
     break;
 
-  case 65: /* expression: expression ADD expression  */
-#line 577 "yacc_sql.y"
+  case 67: /* expression: expression ADD expression  */
+#line 591 "yacc_sql.y"
                               {
       ArithmeticExpressionSqlNode* tmp = new ArithmeticExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2291,11 +2327,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2295 "yacc_sql.cpp"
+#line 2331 "yacc_sql.cpp"
     break;
 
-  case 66: /* expression: expression SUB expression  */
-#line 586 "yacc_sql.y"
+  case 68: /* expression: expression SUB expression  */
+#line 600 "yacc_sql.y"
                                 {
       ArithmeticExpressionSqlNode* tmp = new ArithmeticExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2305,11 +2341,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2309 "yacc_sql.cpp"
+#line 2345 "yacc_sql.cpp"
     break;
 
-  case 67: /* expression: expression STAR expression  */
-#line 595 "yacc_sql.y"
+  case 69: /* expression: expression STAR expression  */
+#line 609 "yacc_sql.y"
                                  {
       ArithmeticExpressionSqlNode* tmp = new ArithmeticExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2319,11 +2355,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2323 "yacc_sql.cpp"
+#line 2359 "yacc_sql.cpp"
     break;
 
-  case 68: /* expression: expression DIV expression  */
-#line 604 "yacc_sql.y"
+  case 70: /* expression: expression DIV expression  */
+#line 618 "yacc_sql.y"
                                 {
       ArithmeticExpressionSqlNode* tmp = new ArithmeticExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2333,21 +2369,21 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2337 "yacc_sql.cpp"
+#line 2373 "yacc_sql.cpp"
     break;
 
-  case 69: /* expression: select_with_parenthesis  */
-#line 613 "yacc_sql.y"
+  case 71: /* expression: select_with_parenthesis  */
+#line 627 "yacc_sql.y"
                               {
       (yyval.expression) = (yyvsp[0].subquery);
 
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2347 "yacc_sql.cpp"
+#line 2383 "yacc_sql.cpp"
     break;
 
-  case 70: /* expression: SUB expression  */
-#line 618 "yacc_sql.y"
+  case 72: /* expression: SUB expression  */
+#line 632 "yacc_sql.y"
                                   {
       ArithmeticExpressionSqlNode* tmp = new ArithmeticExpressionSqlNode;
       tmp->right = (yyvsp[0].expression);
@@ -2359,11 +2395,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = token_name(sql_string, &(yyloc));
     }
-#line 2363 "yacc_sql.cpp"
+#line 2399 "yacc_sql.cpp"
     break;
 
-  case 71: /* expression: expression EQ expression  */
-#line 629 "yacc_sql.y"
+  case 73: /* expression: expression EQ expression  */
+#line 643 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = EQUAL_TO;
@@ -2373,11 +2409,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2377 "yacc_sql.cpp"
+#line 2413 "yacc_sql.cpp"
     break;
 
-  case 72: /* expression: expression LT expression  */
-#line 638 "yacc_sql.y"
+  case 74: /* expression: expression LT expression  */
+#line 652 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = LESS_THAN;
@@ -2387,11 +2423,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2391 "yacc_sql.cpp"
+#line 2427 "yacc_sql.cpp"
     break;
 
-  case 73: /* expression: expression GT expression  */
-#line 647 "yacc_sql.y"
+  case 75: /* expression: expression GT expression  */
+#line 661 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = GREAT_THAN;
@@ -2401,11 +2437,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2405 "yacc_sql.cpp"
+#line 2441 "yacc_sql.cpp"
     break;
 
-  case 74: /* expression: expression LE expression  */
-#line 656 "yacc_sql.y"
+  case 76: /* expression: expression LE expression  */
+#line 670 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = LESS_EQUAL;
@@ -2415,11 +2451,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2419 "yacc_sql.cpp"
+#line 2455 "yacc_sql.cpp"
     break;
 
-  case 75: /* expression: expression GE expression  */
-#line 665 "yacc_sql.y"
+  case 77: /* expression: expression GE expression  */
+#line 679 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = GREAT_EQUAL;
@@ -2429,11 +2465,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2433 "yacc_sql.cpp"
+#line 2469 "yacc_sql.cpp"
     break;
 
-  case 76: /* expression: expression NE expression  */
-#line 674 "yacc_sql.y"
+  case 78: /* expression: expression NE expression  */
+#line 688 "yacc_sql.y"
                                {
       ComparisonExpressionSqlNode *tmp = new ComparisonExpressionSqlNode;
       tmp->comp_op = NOT_EQUAL;
@@ -2443,11 +2479,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2447 "yacc_sql.cpp"
+#line 2483 "yacc_sql.cpp"
     break;
 
-  case 77: /* expression: expression AND expression  */
-#line 683 "yacc_sql.y"
+  case 79: /* expression: expression AND expression  */
+#line 697 "yacc_sql.y"
                                 {
       ConjunctionExpressionSqlNode *tmp = new ConjunctionExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2457,11 +2493,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2461 "yacc_sql.cpp"
+#line 2497 "yacc_sql.cpp"
     break;
 
-  case 78: /* expression: expression OR expression  */
-#line 692 "yacc_sql.y"
+  case 80: /* expression: expression OR expression  */
+#line 706 "yacc_sql.y"
                                {
       ConjunctionExpressionSqlNode *tmp = new ConjunctionExpressionSqlNode;
       tmp->left = (yyvsp[-2].expression);
@@ -2471,19 +2507,19 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2475 "yacc_sql.cpp"
+#line 2511 "yacc_sql.cpp"
     break;
 
-  case 79: /* expression: LBRACE expression RBRACE  */
-#line 701 "yacc_sql.y"
+  case 81: /* expression: LBRACE expression RBRACE  */
+#line 715 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
     }
-#line 2483 "yacc_sql.cpp"
+#line 2519 "yacc_sql.cpp"
     break;
 
-  case 80: /* expression: expression opt_not LIKE SSS  */
-#line 704 "yacc_sql.y"
+  case 82: /* expression: expression opt_not LIKE SSS  */
+#line 718 "yacc_sql.y"
                                   {
       LikeExpressionSqlNode *tmp = new LikeExpressionSqlNode;
       tmp->child = (yyvsp[-3].expression);
@@ -2502,11 +2538,11 @@ yyreduce:
 
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2506 "yacc_sql.cpp"
+#line 2542 "yacc_sql.cpp"
     break;
 
-  case 81: /* expression: NOT expression  */
-#line 722 "yacc_sql.y"
+  case 83: /* expression: NOT expression  */
+#line 736 "yacc_sql.y"
                      {
       NotExpressionSqlNode *tmp = new NotExpressionSqlNode;
       tmp->child = (yyvsp[0].expression);
@@ -2514,11 +2550,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2518 "yacc_sql.cpp"
+#line 2554 "yacc_sql.cpp"
     break;
 
-  case 82: /* expression: EXISTS select_with_parenthesis  */
-#line 729 "yacc_sql.y"
+  case 84: /* expression: EXISTS select_with_parenthesis  */
+#line 743 "yacc_sql.y"
                                      {
       ExistsExpressionSqlNode *tmp = new ExistsExpressionSqlNode;
       tmp->subquery = (yyvsp[0].subquery);
@@ -2526,11 +2562,11 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2530 "yacc_sql.cpp"
+#line 2566 "yacc_sql.cpp"
     break;
 
-  case 83: /* expression: expression opt_not IN LBRACE expression_list RBRACE  */
-#line 736 "yacc_sql.y"
+  case 85: /* expression: expression opt_not IN LBRACE expression_list RBRACE  */
+#line 750 "yacc_sql.y"
                                                           {
       InExpressionSqlNode *tmp = new InExpressionSqlNode;
       tmp->child = (yyvsp[-5].expression);
@@ -2547,11 +2583,11 @@ yyreduce:
 
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2551 "yacc_sql.cpp"
+#line 2587 "yacc_sql.cpp"
     break;
 
-  case 84: /* expression: expression opt_not IN select_with_parenthesis  */
-#line 752 "yacc_sql.y"
+  case 86: /* expression: expression opt_not IN select_with_parenthesis  */
+#line 766 "yacc_sql.y"
                                                     {
       InExpressionSqlNode *tmp = new InExpressionSqlNode;
       tmp->child = (yyvsp[-3].expression);
@@ -2567,11 +2603,11 @@ yyreduce:
 
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2571 "yacc_sql.cpp"
+#line 2607 "yacc_sql.cpp"
     break;
 
-  case 85: /* expression: expression IS opt_not THE_NULL  */
-#line 767 "yacc_sql.y"
+  case 87: /* expression: expression IS opt_not THE_NULL  */
+#line 781 "yacc_sql.y"
                                      {
       IsNullExpressionSqlNode *tmp = new IsNullExpressionSqlNode;
       tmp->child = (yyvsp[-3].expression);
@@ -2586,11 +2622,11 @@ yyreduce:
 
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2590 "yacc_sql.cpp"
+#line 2626 "yacc_sql.cpp"
     break;
 
-  case 86: /* expression: ID LBRACE expression_list RBRACE  */
-#line 781 "yacc_sql.y"
+  case 88: /* expression: ID LBRACE expression_list RBRACE  */
+#line 795 "yacc_sql.y"
                                        {
       FunctionExpressionSqlNode *tmp = new FunctionExpressionSqlNode;
       tmp->param_exprs.swap(*(yyvsp[-1].expression_list));
@@ -2599,24 +2635,25 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2603 "yacc_sql.cpp"
+#line 2639 "yacc_sql.cpp"
     break;
 
-  case 87: /* expression: value  */
-#line 789 "yacc_sql.y"
+  case 89: /* expression: value  */
+#line 803 "yacc_sql.y"
             {
       ValueExpressionSqlNode *tmp = new ValueExpressionSqlNode;
       tmp->value = *(yyvsp[0].value);
+      tmp->position = (yylsp[0]).first_column;
       delete (yyvsp[0].value);
 
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2616 "yacc_sql.cpp"
+#line 2653 "yacc_sql.cpp"
     break;
 
-  case 88: /* expression: rel_attr  */
-#line 797 "yacc_sql.y"
+  case 90: /* expression: rel_attr  */
+#line 812 "yacc_sql.y"
                {
       FieldExpressionSqlNode *tmp = new FieldExpressionSqlNode;
       tmp->field = *(yyvsp[0].rel_attr);
@@ -2625,22 +2662,22 @@ yyreduce:
       (yyval.expression) = tmp;
       (yyval.expression)->name = (token_name(sql_string, &(yyloc)));
     }
-#line 2629 "yacc_sql.cpp"
+#line 2666 "yacc_sql.cpp"
     break;
 
-  case 89: /* rel_attr: ID  */
-#line 808 "yacc_sql.y"
+  case 91: /* rel_attr: ID  */
+#line 823 "yacc_sql.y"
        {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name = "";
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2640 "yacc_sql.cpp"
+#line 2677 "yacc_sql.cpp"
     break;
 
-  case 90: /* rel_attr: ID DOT ID  */
-#line 814 "yacc_sql.y"
+  case 92: /* rel_attr: ID DOT ID  */
+#line 829 "yacc_sql.y"
                 {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
@@ -2648,85 +2685,85 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2652 "yacc_sql.cpp"
+#line 2689 "yacc_sql.cpp"
     break;
 
-  case 91: /* rel_attr: ID DOT STAR  */
-#line 821 "yacc_sql.y"
+  case 93: /* rel_attr: ID DOT STAR  */
+#line 836 "yacc_sql.y"
                   {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
       (yyval.rel_attr)->attribute_name = "*";
     }
-#line 2662 "yacc_sql.cpp"
+#line 2699 "yacc_sql.cpp"
     break;
 
-  case 92: /* rel_attr: STAR  */
-#line 826 "yacc_sql.y"
+  case 94: /* rel_attr: STAR  */
+#line 841 "yacc_sql.y"
            {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = "";
       (yyval.rel_attr)->attribute_name = "*";
     }
-#line 2672 "yacc_sql.cpp"
+#line 2709 "yacc_sql.cpp"
     break;
 
-  case 93: /* opt_where: %empty  */
-#line 837 "yacc_sql.y"
+  case 95: /* opt_where: %empty  */
+#line 852 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 2680 "yacc_sql.cpp"
+#line 2717 "yacc_sql.cpp"
     break;
 
-  case 94: /* opt_where: WHERE expression  */
-#line 840 "yacc_sql.y"
+  case 96: /* opt_where: WHERE expression  */
+#line 855 "yacc_sql.y"
                        {
       (yyval.expression) = (yyvsp[0].expression);  
     }
-#line 2688 "yacc_sql.cpp"
+#line 2725 "yacc_sql.cpp"
     break;
 
-  case 95: /* table_factor: ID  */
-#line 846 "yacc_sql.y"
+  case 97: /* table_factor: ID  */
+#line 861 "yacc_sql.y"
     {
       TablePrimarySqlNode* tmp = new TablePrimarySqlNode;
       tmp->relation_name = (yyvsp[0].string);
 
       (yyval.table_factor_node) = tmp;
     }
-#line 2699 "yacc_sql.cpp"
+#line 2736 "yacc_sql.cpp"
     break;
 
-  case 96: /* table_factor: LBRACE select_stmt RBRACE  */
-#line 853 "yacc_sql.y"
+  case 98: /* table_factor: LBRACE select_stmt RBRACE  */
+#line 868 "yacc_sql.y"
     {
       TableSubquerySqlNode* tmp = new TableSubquerySqlNode;
       tmp->subquery = (yyvsp[-1].sql_node)->selection;
 
       (yyval.table_factor_node) = tmp;
     }
-#line 2710 "yacc_sql.cpp"
+#line 2747 "yacc_sql.cpp"
     break;
 
-  case 97: /* opt_table_refs: %empty  */
-#line 861 "yacc_sql.y"
+  case 99: /* opt_table_refs: %empty  */
+#line 876 "yacc_sql.y"
     {
       (yyval.table_reference_list) = nullptr;
     }
-#line 2718 "yacc_sql.cpp"
+#line 2755 "yacc_sql.cpp"
     break;
 
-  case 98: /* opt_table_refs: FROM table_ref_list  */
-#line 865 "yacc_sql.y"
+  case 100: /* opt_table_refs: FROM table_ref_list  */
+#line 880 "yacc_sql.y"
     {
       (yyval.table_reference_list) = (yyvsp[0].table_reference_list);
     }
-#line 2726 "yacc_sql.cpp"
+#line 2763 "yacc_sql.cpp"
     break;
 
-  case 99: /* table_ref: table_factor opt_alias  */
-#line 870 "yacc_sql.y"
+  case 101: /* table_ref: table_factor opt_alias  */
+#line 885 "yacc_sql.y"
     {
       (yyval.table_reference) = (yyvsp[-1].table_factor_node);
       if ((yyvsp[0].string) != nullptr) {
@@ -2734,11 +2771,11 @@ yyreduce:
         free((yyvsp[0].string));
       }
     }
-#line 2738 "yacc_sql.cpp"
+#line 2775 "yacc_sql.cpp"
     break;
 
-  case 100: /* table_ref: table_ref opt_inner JOIN table_factor opt_alias opt_join_condition  */
-#line 878 "yacc_sql.y"
+  case 102: /* table_ref: table_ref opt_inner JOIN table_factor opt_alias opt_join_condition  */
+#line 893 "yacc_sql.y"
     {
       TableJoinSqlNode *tmp = new TableJoinSqlNode;
       tmp->left = (yyvsp[-5].table_reference);
@@ -2752,36 +2789,36 @@ yyreduce:
 
       (yyval.table_reference) = tmp;
     }
-#line 2756 "yacc_sql.cpp"
+#line 2793 "yacc_sql.cpp"
     break;
 
-  case 101: /* opt_join_condition: %empty  */
-#line 893 "yacc_sql.y"
+  case 103: /* opt_join_condition: %empty  */
+#line 908 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 2764 "yacc_sql.cpp"
+#line 2801 "yacc_sql.cpp"
     break;
 
-  case 102: /* opt_join_condition: ON expression  */
-#line 897 "yacc_sql.y"
+  case 104: /* opt_join_condition: ON expression  */
+#line 912 "yacc_sql.y"
     {
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 2772 "yacc_sql.cpp"
+#line 2809 "yacc_sql.cpp"
     break;
 
-  case 103: /* table_ref_list: table_ref  */
-#line 903 "yacc_sql.y"
+  case 105: /* table_ref_list: table_ref  */
+#line 918 "yacc_sql.y"
     {
       (yyval.table_reference_list) = new std::vector<TableReferenceSqlNode *>;
       (yyval.table_reference_list)->push_back((yyvsp[0].table_reference));
     }
-#line 2781 "yacc_sql.cpp"
+#line 2818 "yacc_sql.cpp"
     break;
 
-  case 104: /* table_ref_list: table_ref COMMA table_ref_list  */
-#line 908 "yacc_sql.y"
+  case 106: /* table_ref_list: table_ref COMMA table_ref_list  */
+#line 923 "yacc_sql.y"
     {
       if ((yyvsp[0].table_reference_list) != nullptr) {
         (yyval.table_reference_list) = (yyvsp[0].table_reference_list);
@@ -2790,32 +2827,32 @@ yyreduce:
       }
       (yyval.table_reference_list)->insert((yyval.table_reference_list)->begin(), (yyvsp[-2].table_reference));
     }
-#line 2794 "yacc_sql.cpp"
+#line 2831 "yacc_sql.cpp"
     break;
 
-  case 105: /* expression_with_order: opt_order_type expression  */
-#line 918 "yacc_sql.y"
+  case 107: /* expression_with_order: expression opt_order_type  */
+#line 933 "yacc_sql.y"
     {
       ExpressionWithOrderSqlNode *tmp = new ExpressionWithOrderSqlNode;
-      tmp->expr = (yyvsp[0].expression);
-      tmp->order_type = (yyvsp[-1].order_type);
+      tmp->expr = (yyvsp[-1].expression);
+      tmp->order_type = (yyvsp[0].order_type);
 
       (yyval.order_by_node) = tmp;
     }
-#line 2806 "yacc_sql.cpp"
+#line 2843 "yacc_sql.cpp"
     break;
 
-  case 106: /* expression_with_order_list: expression_with_order  */
-#line 927 "yacc_sql.y"
+  case 108: /* expression_with_order_list: expression_with_order  */
+#line 942 "yacc_sql.y"
     {
       (yyval.order_by_list) = new std::vector<ExpressionWithOrderSqlNode *>;
       (yyval.order_by_list)->push_back((yyvsp[0].order_by_node));
     }
-#line 2815 "yacc_sql.cpp"
+#line 2852 "yacc_sql.cpp"
     break;
 
-  case 107: /* expression_with_order_list: expression_with_order COMMA expression_with_order_list  */
-#line 932 "yacc_sql.y"
+  case 109: /* expression_with_order_list: expression_with_order COMMA expression_with_order_list  */
+#line 947 "yacc_sql.y"
     {
       if ((yyvsp[0].order_by_list) != nullptr) {
         (yyval.order_by_list) = (yyvsp[0].order_by_list);
@@ -2824,11 +2861,11 @@ yyreduce:
       }
       (yyval.order_by_list)->insert((yyval.order_by_list)->begin(), (yyvsp[-2].order_by_node));
     }
-#line 2828 "yacc_sql.cpp"
+#line 2865 "yacc_sql.cpp"
     break;
 
-  case 108: /* query_expression: expression opt_alias  */
-#line 942 "yacc_sql.y"
+  case 110: /* query_expression: expression opt_alias  */
+#line 957 "yacc_sql.y"
     {
       ExpressionWithAliasSqlNode *tmp = new ExpressionWithAliasSqlNode;
       tmp->expr = (yyvsp[-1].expression);
@@ -2839,20 +2876,20 @@ yyreduce:
 
       (yyval.expression_with_alias) = tmp;
     }
-#line 2843 "yacc_sql.cpp"
+#line 2880 "yacc_sql.cpp"
     break;
 
-  case 109: /* query_expression_list: query_expression  */
-#line 954 "yacc_sql.y"
+  case 111: /* query_expression_list: query_expression  */
+#line 969 "yacc_sql.y"
     {
       (yyval.expression_with_alias_list) = new std::vector<ExpressionWithAliasSqlNode *>;
       (yyval.expression_with_alias_list)->push_back((yyvsp[0].expression_with_alias));
     }
-#line 2852 "yacc_sql.cpp"
+#line 2889 "yacc_sql.cpp"
     break;
 
-  case 110: /* query_expression_list: query_expression COMMA query_expression_list  */
-#line 959 "yacc_sql.y"
+  case 112: /* query_expression_list: query_expression COMMA query_expression_list  */
+#line 974 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_with_alias_list) != nullptr) {
         (yyval.expression_with_alias_list) = (yyvsp[0].expression_with_alias_list);
@@ -2861,83 +2898,111 @@ yyreduce:
       }
       (yyval.expression_with_alias_list)->insert((yyval.expression_with_alias_list)->begin(), (yyvsp[-2].expression_with_alias));
     }
-#line 2865 "yacc_sql.cpp"
+#line 2902 "yacc_sql.cpp"
     break;
 
-  case 111: /* opt_order_by: %empty  */
-#line 969 "yacc_sql.y"
+  case 113: /* opt_order_by: %empty  */
+#line 984 "yacc_sql.y"
+    {
+      (yyval.order_by_clause) = nullptr;
+    }
+#line 2910 "yacc_sql.cpp"
+    break;
+
+  case 114: /* opt_order_by: ORDER BY expression_with_order_list opt_limit  */
+#line 988 "yacc_sql.y"
+    {
+      (yyval.order_by_clause) = new OrderBySqlNode;
+      (yyval.order_by_clause)->order_by.swap(*(yyvsp[-1].order_by_list));
+      (yyval.order_by_clause)->limit = (yyvsp[0].number);
+      delete (yyvsp[-1].order_by_list);
+    }
+#line 2921 "yacc_sql.cpp"
+    break;
+
+  case 115: /* opt_limit: %empty  */
+#line 996 "yacc_sql.y"
     {
-      (yyval.order_by_list) = nullptr;
+      (yyval.number) = -1;
     }
-#line 2873 "yacc_sql.cpp"
+#line 2929 "yacc_sql.cpp"
     break;
 
-  case 112: /* opt_order_by: ORDER BY expression_with_order_list  */
-#line 973 "yacc_sql.y"
+  case 116: /* opt_limit: ID NUMBER  */
+#line 1000 "yacc_sql.y"
     {
-      (yyval.order_by_list) = (yyvsp[0].order_by_list);
+      // 增加LIMIT关键字需要用flex重新生成词法分析器(gen_parser.sh)，当时的构建环境中没有flex，
+      // 所以这里匹配名字是limit的标识符。也因此LIMIT只能跟在ORDER BY后面：其它位置的标识符，
+      // 比如不带AS的表别名，会和它冲突。增加LIMIT关键字之后就可以去掉这个限制
+      if (0 != strcasecmp((yyvsp[-1].string), "limit")) {
+        free((yyvsp[-1].string));
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      free((yyvsp[-1].string));
+      (yyval.number) = (yyvsp[0].number);
     }
-#line 2881 "yacc_sql.cpp"
+#line 2946 "yacc_sql.cpp"
     break;
 
-  case 113: /* opt_group_by: %empty  */
-#line 979 "yacc_sql.y"
+  case 117: /* opt_group_by: %empty  */
+#line 1015 "yacc_sql.y"
     {
       (yyval.expression_list) =nullptr;
     }
-#line 2889 "yacc_sql.cpp"
+#line 2954 "yacc_sql.cpp"
     break;
 
-  case 114: /* opt_group_by: GROUP BY expression_list  */
-#line 983 "yacc_sql.y"
+  case 118: /* opt_group_by: GROUP BY expression_list  */
+#line 1019 "yacc_sql.y"
     {
       (yyval.expression_list) = (yyvsp[0].expression_list);
     }
-#line 2897 "yacc_sql.cpp"
+#line 2962 "yacc_sql.cpp"
     break;
 
-  case 115: /* opt_order_type: %empty  */
-#line 989 "yacc_sql.y"
+  case 119: /* opt_order_type: %empty  */
+#line 1025 "yacc_sql.y"
     {
       (yyval.order_type) = OrderType::ASC;
     }
-#line 2905 "yacc_sql.cpp"
+#line 2970 "yacc_sql.cpp"
     break;
 
-  case 116: /* opt_order_type: ASC  */
-#line 993 "yacc_sql.y"
+  case 120: /* opt_order_type: ASC  */
+#line 1029 "yacc_sql.y"
     {
       (yyval.order_type) = OrderType::ASC;
     }
-#line 2913 "yacc_sql.cpp"
+#line 2978 "yacc_sql.cpp"
     break;
 
-  case 117: /* opt_order_type: DESC  */
-#line 997 "yacc_sql.y"
+  case 121: /* opt_order_type: DESC  */
+#line 1033 "yacc_sql.y"
     {
       (yyval.order_type) = OrderType::DESC;
     }
-#line 2921 "yacc_sql.cpp"
+#line 2986 "yacc_sql.cpp"
     break;
 
-  case 118: /* opt_having: %empty  */
-#line 1003 "yacc_sql.y"
+  case 122: /* opt_having: %empty  */
+#line 1039 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 2929 "yacc_sql.cpp"
+#line 2994 "yacc_sql.cpp"
     break;
 
-  case 119: /* opt_having: HAVING expression  */
-#line 1007 "yacc_sql.y"
+  case 123: /* opt_having: HAVING expression  */
+#line 1043 "yacc_sql.y"
     {
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 2937 "yacc_sql.cpp"
+#line 3002 "yacc_sql.cpp"
     break;
 
-  case 120: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
-#line 1013 "yacc_sql.y"
+  case 124: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 1049 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -2947,20 +3012,38 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 2951 "yacc_sql.cpp"
+#line 3016 "yacc_sql.cpp"
+    break;
+
+  case 125: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 1062 "yacc_sql.y"
+    {
+      (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
+      (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
+    }
+#line 3025 "yacc_sql.cpp"
     break;
 
-  case 121: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 1026 "yacc_sql.y"
+  case 126: /* explain_stmt: EXPLAIN ID command_wrapper  */
+#line 1067 "yacc_sql.y"
     {
+      // ANALYZE 不是关键字，避免影响使用analyze作为表名或者字段名
+      if (0 != strcasecmp((yyvsp[-1].string), "analyze")) {
+        free((yyvsp[-1].string));
+        delete (yyvsp[0].sql_node);
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      free((yyvsp[-1].string));
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
+      (yyval.sql_node)->explain.analyze  = true;
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 2960 "yacc_sql.cpp"
+#line 3043 "yacc_sql.cpp"
     break;
 
-  case 122: /* set_variable_stmt: SET ID EQ value  */
-#line 1034 "yacc_sql.y"
+  case 127: /* set_variable_stmt: SET ID EQ value  */
+#line 1084 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -2968,55 +3051,55 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2972 "yacc_sql.cpp"
+#line 3055 "yacc_sql.cpp"
     break;
 
-  case 127: /* opt_not: %empty  */
-#line 1052 "yacc_sql.y"
+  case 132: /* opt_not: %empty  */
+#line 1102 "yacc_sql.y"
     {(yyval.booleans) = false;}
-#line 2978 "yacc_sql.cpp"
+#line 3061 "yacc_sql.cpp"
     break;
 
-  case 128: /* opt_not: NOT  */
-#line 1053 "yacc_sql.y"
+  case 133: /* opt_not: NOT  */
+#line 1103 "yacc_sql.y"
           {(yyval.booleans) = true;}
-#line 2984 "yacc_sql.cpp"
+#line 3067 "yacc_sql.cpp"
     break;
 
-  case 129: /* opt_alias: %empty  */
-#line 1057 "yacc_sql.y"
+  case 134: /* opt_alias: %empty  */
+#line 1107 "yacc_sql.y"
     {(yyval.string) = nullptr;}
-#line 2990 "yacc_sql.cpp"
+#line 3073 "yacc_sql.cpp"
     break;
 
-  case 130: /* opt_alias: opt_as ID  */
-#line 1059 "yacc_sql.y"
+  case 135: /* opt_alias: opt_as ID  */
+#line 1109 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2998 "yacc_sql.cpp"
+#line 3081 "yacc_sql.cpp"
     break;
 
-  case 133: /* opt_nullable: %empty  */
-#line 1067 "yacc_sql.y"
+  case 138: /* opt_nullable: %empty  */
+#line 1117 "yacc_sql.y"
                {(yyval.booleans) = true;}
-#line 3004 "yacc_sql.cpp"
+#line 3087 "yacc_sql.cpp"
     break;
 
-  case 134: /* opt_nullable: NOT THE_NULL  */
-#line 1068 "yacc_sql.y"
+  case 139: /* opt_nullable: NOT THE_NULL  */
+#line 1118 "yacc_sql.y"
                    {(yyval.booleans) = false;}
-#line 3010 "yacc_sql.cpp"
+#line 3093 "yacc_sql.cpp"
     break;
 
-  case 135: /* opt_nullable: THE_NULL  */
-#line 1069 "yacc_sql.y"
+  case 140: /* opt_nullable: THE_NULL  */
+#line 1119 "yacc_sql.y"
                {(yyval.booleans) = true;}
-#line 3016 "yacc_sql.cpp"
+#line 3099 "yacc_sql.cpp"
     break;
 
 
-#line 3020 "yacc_sql.cpp"
+#line 3103 "yacc_sql.cpp"
 
       default: break;
     }
@@ -3245,7 +3328,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 1072 "yacc_sql.y"
+#line 1122 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
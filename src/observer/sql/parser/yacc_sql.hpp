@@ -154,13 +154,14 @@ union YYSTYPE
   TableReferenceSqlNode *                         table_factor_node;
   ExpressionWithOrderSqlNode *                    order_by_node;
   std::vector<ExpressionWithOrderSqlNode *> *     order_by_list;
+  OrderBySqlNode *                                order_by_clause;
   ExpressionWithAliasSqlNode *                    expression_with_alias;
   std::vector<ExpressionWithAliasSqlNode *> *     expression_with_alias_list;
   UpdateAssignmentSqlNode *                       update_asgn_factor;
   std::vector<UpdateAssignmentSqlNode *> *        update_asgn_list;
   OrderType                                       order_type;
 
-#line 164 "yacc_sql.hpp"
+#line 165 "yacc_sql.hpp"
 
 };
 typedef union YYSTYPE YYSTYPE;
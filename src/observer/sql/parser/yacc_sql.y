@@ -126,6 +126,7 @@ int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result,
   TableReferenceSqlNode *                         table_factor_node;
   ExpressionWithOrderSqlNode *                    order_by_node;
   std::vector<ExpressionWithOrderSqlNode *> *     order_by_list;
+  OrderBySqlNode *                                order_by_clause;
   ExpressionWithAliasSqlNode *                    expression_with_alias;
   std::vector<ExpressionWithAliasSqlNode *> *     expression_with_alias_list;
   UpdateAssignmentSqlNode *                       update_asgn_factor;
@@ -143,6 +144,7 @@ int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result,
 /** type 定义了各种解析后的结果输出的是什么类型。类型对应了 union 中的定义的成员变量名称 **/
 %type <number>              type
 %type <value>               value
+%type <value>               insert_value
 %type <number>              number
 %type <rel_attr>            rel_attr
 %type <attr_infos>          attr_def_list
@@ -177,7 +179,7 @@ int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result,
 %type <table_reference_list> opt_table_refs
 %type <table_factor_node>   table_factor
 %type <order_by_node>       expression_with_order
-%type <order_by_list>       opt_order_by
+%type <order_by_clause>     opt_order_by
 %type <order_by_list>       expression_with_order_list
 %type <subquery>            select_with_parenthesis
 %type <expression_list>     opt_group_by
@@ -187,6 +189,7 @@ int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result,
 %type <booleans>            opt_not
 %type <string>              opt_alias
 %type <order_type>          opt_order_type
+%type <number>              opt_limit
 %type <expression_with_alias> query_expression
 %type <expression_with_alias_list> query_expression_list
 %type <update_asgn_factor>  update_asgn_factor
@@ -408,7 +411,7 @@ type:
     ;
 
 insert_stmt:        /*insert   语句的语法解析树*/
-    INSERT INTO ID VALUES LBRACE value value_list RBRACE 
+    INSERT INTO ID VALUES LBRACE insert_value value_list RBRACE 
     {
       $$ = new ParsedSqlNode(SCF_INSERT);
       $$->insertion.relation_name = $3;
@@ -428,7 +431,7 @@ value_list:
     {
       $$ = nullptr;
     }
-    | COMMA value value_list  { 
+    | COMMA insert_value value_list  { 
       if ($3 != nullptr) {
         $$ = $3;
       } else {
@@ -439,6 +442,16 @@ value_list:
     }
     ;
     
+insert_value:
+    value {
+      $$ = $1;
+    }
+    /* 预处理语句中的参数，类型是UNDEFINED，执行时替换成实际的值 */
+    | '?' {
+      $$ = new Value();
+    }
+    ;
+
 value:
     NUMBER {
       $$ = new Value((int)$1);
@@ -536,7 +549,8 @@ select_stmt:        /*  select 语句的语法解析树*/
         $$->selection.having = $6;
       }
       if ($7 != nullptr) {
-        $$->selection.order_by.swap(*$7);
+        $$->selection.order_by.swap($7->order_by);
+        $$->selection.limit = $7->limit;
         delete $7;
       }
     }
@@ -789,6 +803,7 @@ expression:
     | value {
       ValueExpressionSqlNode *tmp = new ValueExpressionSqlNode;
       tmp->value = *$1;
+      tmp->position = @1.first_column;
       delete $1;
 
       $$ = tmp;
@@ -914,11 +929,11 @@ table_ref_list : table_ref
       $$->insert($$->begin(), $1);
     }
 
-expression_with_order : opt_order_type expression 
+expression_with_order : expression opt_order_type
     {
       ExpressionWithOrderSqlNode *tmp = new ExpressionWithOrderSqlNode;
-      tmp->expr = $2;
-      tmp->order_type = $1;
+      tmp->expr = $1;
+      tmp->order_type = $2;
 
       $$ = tmp;
     }
@@ -969,9 +984,30 @@ opt_order_by : /*empty*/
     {
       $$ = nullptr;
     }
-    | ORDER BY expression_with_order_list
+    | ORDER BY expression_with_order_list opt_limit
     {
-      $$ = $3;
+      $$ = new OrderBySqlNode;
+      $$->order_by.swap(*$3);
+      $$->limit = $4;
+      delete $3;
+    }
+
+opt_limit : /*empty*/
+    {
+      $$ = -1;
+    }
+    | ID NUMBER
+    {
+      // 增加LIMIT关键字需要用flex重新生成词法分析器(gen_parser.sh)，当时的构建环境中没有flex，
+      // 所以这里匹配名字是limit的标识符。也因此LIMIT只能跟在ORDER BY后面：其它位置的标识符，
+      // 比如不带AS的表别名，会和它冲突。增加LIMIT关键字之后就可以去掉这个限制
+      if (0 != strcasecmp($1, "limit")) {
+        free($1);
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      free($1);
+      $$ = $2;
     }
 
 
@@ -1027,6 +1063,20 @@ explain_stmt:
       $$ = new ParsedSqlNode(SCF_EXPLAIN);
       $$->explain.sql_node = std::unique_ptr<ParsedSqlNode>($2);
     }
+    | EXPLAIN ID command_wrapper
+    {
+      // ANALYZE 不是关键字，避免影响使用analyze作为表名或者字段名
+      if (0 != strcasecmp($2, "analyze")) {
+        free($2);
+        delete $3;
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      free($2);
+      $$ = new ParsedSqlNode(SCF_EXPLAIN);
+      $$->explain.analyze  = true;
+      $$->explain.sql_node = std::unique_ptr<ParsedSqlNode>($3);
+    }
     ;
 
 set_variable_stmt:
@@ -0,0 +1,217 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <iterator>
+
+#include "sql/plan_cache/plan_cache.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/stmt/stmt.h"
+
+using namespace std;
+
+CachedPlan::CachedPlan(
+    string key, vector<SqlLiteral> literals, unique_ptr<Stmt> stmt, unique_ptr<PhysicalOperator> oper)
+    : key_(std::move(key)), literals_(std::move(literals)), stmt_(std::move(stmt)), operator_(std::move(oper))
+{}
+
+CachedPlan::~CachedPlan()
+{
+  // 算子中可能引用了stmt中的数据，先释放算子
+  operator_.reset();
+  stmt_.reset();
+}
+
+bool CachedPlan::init()
+{
+  vector<PlanParam> plan_params;
+  operator_->collect_plan_params(plan_params);
+
+  bindable_.assign(literals_.size(), false);
+  params_.clear();
+  for (const PlanParam &plan_param : plan_params) {
+    auto iter = lower_bound(literals_.begin(), literals_.end(), plan_param.position,
+        [](const SqlLiteral &literal, int position) { return literal.position < position; });
+    if (iter == literals_.end() || iter->position != plan_param.position) {
+      LOG_WARN("cannot find literal of plan param. sql=%s, position=%d", key_.c_str(), plan_param.position);
+      return false;
+    }
+
+    const int ordinal = static_cast<int>(iter - literals_.begin());
+    if (plan_param.value->attr_type() != literals_[ordinal].value.attr_type()) {
+      // 生成计划时修改过常量的类型，不能直接替换
+      LOG_WARN("type of plan param changed. sql=%s, position=%d", key_.c_str(), plan_param.position);
+      return false;
+    }
+    bindable_[ordinal] = true;
+    params_.emplace_back(ordinal, plan_param.value);
+  }
+  return true;
+}
+
+bool CachedPlan::match(const vector<SqlLiteral> &literals) const
+{
+  if (literals.size() != literals_.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < literals.size(); i++) {
+    if (!bindable_[i] && literals[i].text != literals_[i].text) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CachedPlan::bind(const vector<SqlLiteral> &literals)
+{
+  for (auto &[ordinal, value] : params_) {
+    *value = literals[ordinal].value;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PlanCache::~PlanCache()
+{
+  plan_index_.clear();
+  plans_.clear();
+}
+
+unique_ptr<CachedPlan> PlanCache::acquire(const string &key, const vector<SqlLiteral> &literals)
+{
+  unique_ptr<CachedPlan> plan;
+  {
+    lock_guard<mutex> guard(lock_);
+
+    auto range = plan_index_.equal_range(key);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+      PlanList::iterator plan_iter = iter->second;
+      if ((*plan_iter)->match(literals)) {
+        plan = std::move(*plan_iter);
+        plans_.erase(plan_iter);
+        plan_index_.erase(iter);
+        break;
+      }
+    }
+  }
+
+  if (!plan) {
+    misses_++;
+    return nullptr;
+  }
+
+  hits_++;
+  plan->bind(literals);
+  return plan;
+}
+
+void PlanCache::release(unique_ptr<CachedPlan> plan)
+{
+  lock_guard<mutex> guard(lock_);
+  if (plan->version() != version_.load()) {
+    LOG_TRACE("drop expired plan. sql=%s", plan->key().c_str());
+    return;
+  }
+
+  const string &key = plan->key();
+  plans_.push_front(std::move(plan));
+  plan_index_.emplace(key, plans_.begin());
+
+  if (plans_.size() > capacity_) {
+    PlanList::iterator last  = prev(plans_.end());
+    auto               range = plan_index_.equal_range((*last)->key());
+    for (auto iter = range.first; iter != range.second; ++iter) {
+      if (iter->second == last) {
+        plan_index_.erase(iter);
+        break;
+      }
+    }
+    plans_.erase(last);
+  }
+}
+
+void PlanCache::invalidate()
+{
+  PlanList plans;
+  {
+    lock_guard<mutex> guard(lock_);
+    version_++;
+    plan_index_.clear();
+    plans.swap(plans_);
+  }
+  invalidations_++;
+  LOG_INFO("plan cache invalidated. dropped plans=%ld", plans.size());
+}
+
+size_t PlanCache::size() const
+{
+  lock_guard<mutex> guard(lock_);
+  return plans_.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CachedPlanPhysicalOperator::CachedPlanPhysicalOperator(PlanCache *plan_cache, unique_ptr<CachedPlan> plan)
+    : plan_cache_(plan_cache), plan_(std::move(plan)), root_(plan_->physical_operator())
+{}
+
+CachedPlanPhysicalOperator::~CachedPlanPhysicalOperator()
+{
+  if (opened_) {
+    // 没有正常关闭的算子，状态不确定，不再复用
+    root_->close();
+    failed_ = true;
+  }
+
+  if (!failed_ && plan_cache_ != nullptr) {
+    plan_cache_->release(std::move(plan_));
+  }
+}
+
+RC CachedPlanPhysicalOperator::open(Trx *trx)
+{
+  RC rc = root_->open(trx);
+  if (OB_FAIL(rc)) {
+    failed_ = true;
+    return rc;
+  }
+  opened_ = true;
+  return rc;
+}
+
+RC CachedPlanPhysicalOperator::next()
+{
+  RC rc = root_->next();
+  if (OB_FAIL(rc) && rc != RC::RECORD_EOF) {
+    failed_ = true;
+  }
+  return rc;
+}
+
+RC CachedPlanPhysicalOperator::next_chunk(Chunk &chunk)
+{
+  RC rc = root_->next_chunk(chunk);
+  if (OB_FAIL(rc) && rc != RC::RECORD_EOF) {
+    failed_ = true;
+  }
+  return rc;
+}
+
+RC CachedPlanPhysicalOperator::close()
+{
+  RC rc   = root_->close();
+  opened_ = false;
+  if (OB_FAIL(rc)) {
+    failed_ = true;
+  }
+  return rc;
+}
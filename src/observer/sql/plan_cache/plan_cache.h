@@ -0,0 +1,164 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/operator/physical_operator.h"
+#include "sql/parser/parse.h"
+
+class Stmt;
+class PlanCache;
+
+/**
+ * @brief 缓存的执行计划
+ * @ingroup SQLStage
+ * @details 包含生成计划时的Stmt和物理算子。同一时刻只能有一个请求使用，使用时从缓存中取出，用完再放回。
+ * 计划中来自过滤条件的常量(PlanParam)可以替换，其它常量在计划生成时就确定了，只有SQL中对应的常量与生成计划时完全
+ * 相同，才能复用这个计划。
+ */
+class CachedPlan
+{
+public:
+  CachedPlan(std::string key, std::vector<SqlLiteral> literals, std::unique_ptr<Stmt> stmt,
+      std::unique_ptr<PhysicalOperator> oper);
+  ~CachedPlan();
+
+  /**
+   * @brief 收集计划中可以替换的常量
+   * @return 计划中的常量与SQL中的常量对应不上时返回false，这样的计划不能缓存
+   */
+  bool init();
+
+  const std::string &key() const { return key_; }
+  Stmt              *stmt() const { return stmt_.get(); }
+  PhysicalOperator  *physical_operator() const { return operator_.get(); }
+
+  uint64_t version() const { return version_; }
+  void     set_version(uint64_t version) { version_ = version; }
+
+  /**
+   * @brief 参数化后相同的SQL，不可替换的常量也相同时才能使用这个计划
+   */
+  bool match(const std::vector<SqlLiteral> &literals) const;
+
+  /**
+   * @brief 把计划中的常量替换成新SQL中的值
+   */
+  void bind(const std::vector<SqlLiteral> &literals);
+
+private:
+  std::string                       key_;       ///< 参数化后的SQL
+  std::vector<SqlLiteral>           literals_;  ///< 生成计划时SQL中的常量
+  std::vector<bool>                 bindable_;  ///< 每个常量是否可以替换
+  std::vector<std::pair<int, Value *>> params_;  ///< 计划中可以替换的值，以及对应的常量序号
+  std::unique_ptr<Stmt>             stmt_;
+  std::unique_ptr<PhysicalOperator> operator_;
+  uint64_t                          version_ = 0;  ///< 生成计划时缓存的版本，DDL之后版本会变化
+};
+
+/**
+ * @brief 执行计划缓存
+ * @ingroup SQLStage
+ * @details 每个数据库一个，按照参数化(去掉常量)之后的SQL查找。
+ * 缓存中只保存空闲的计划，使用时取出，执行结束后放回。相同的SQL可以同时有多个计划，
+ * 空闲计划数量超过容量时淘汰最久没有使用的。
+ * 表结构变化(创建、删除表，创建索引)时调用invalidate，清空缓存，正在使用的计划执行结束后也不再放回。
+ */
+class PlanCache
+{
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+  explicit PlanCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+  ~PlanCache();
+
+  /**
+   * @brief 取出一个可以使用的计划，并替换其中的常量
+   * @return 没有命中时返回nullptr
+   */
+  std::unique_ptr<CachedPlan> acquire(const std::string &key, const std::vector<SqlLiteral> &literals);
+
+  /**
+   * @brief 放回使用结束的计划
+   * @details 计划生成之后缓存失效过，就直接丢弃
+   */
+  void release(std::unique_ptr<CachedPlan> plan);
+
+  /**
+   * @brief 丢弃所有缓存的计划，在表结构发生变化时调用
+   */
+  void invalidate();
+
+  /**
+   * @brief 当前缓存的版本，新生成的计划需要设置这个版本
+   */
+  uint64_t version() const { return version_.load(); }
+
+  size_t size() const;
+
+  uint64_t hits() const { return hits_.load(); }
+  uint64_t misses() const { return misses_.load(); }
+  uint64_t invalidations() const { return invalidations_.load(); }
+
+private:
+  using PlanList = std::list<std::unique_ptr<CachedPlan>>;
+
+  mutable std::mutex                                          lock_;
+  size_t                                                      capacity_;
+  PlanList                                                    plans_;  ///< 空闲的计划，最近使用的在前面
+  std::unordered_multimap<std::string, PlanList::iterator> plan_index_;
+
+  std::atomic<uint64_t> version_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> invalidations_{0};
+};
+
+/**
+ * @brief 执行缓存计划的算子
+ * @ingroup PhysicalOperator
+ * @details 把请求转发给计划中的算子，自己销毁时把计划放回缓存。
+ * 只有正常打开、关闭过的计划才放回，执行出错的计划直接丢弃。plan_cache为空时计划只执行一次，不放回缓存。
+ */
+class CachedPlanPhysicalOperator : public PhysicalOperator
+{
+public:
+  CachedPlanPhysicalOperator(PlanCache *plan_cache, std::unique_ptr<CachedPlan> plan);
+  virtual ~CachedPlanPhysicalOperator();
+
+  std::string          name() const override { return root_->name(); }
+  std::string          param() const override { return root_->param(); }
+  PhysicalOperatorType type() const override { return root_->type(); }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override { return root_->current_tuple(); }
+
+  bool support_chunk() const override { return root_->support_chunk(); }
+  RC   next_chunk(Chunk &chunk) override;
+
+private:
+  PlanCache                  *plan_cache_ = nullptr;
+  std::unique_ptr<CachedPlan> plan_;
+  PhysicalOperator           *root_   = nullptr;
+  bool                        opened_ = false;
+  bool                        failed_ = false;  ///< 执行中出现过错误，计划不再复用
+};
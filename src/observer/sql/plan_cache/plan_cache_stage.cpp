@@ -12,4 +12,90 @@ See the Mulan PSL v2 for more details. */
 // Created by Longda on 2021/4/13.
 //
 
-// 这里什么都没有哦
\ No newline at end of file
+#include "sql/plan_cache/plan_cache_stage.h"
+#include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/parser/parse.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/stmt/stmt.h"
+#include "storage/db/db.h"
+
+using namespace std;
+
+/**
+ * @brief 获取可以使用执行计划缓存的数据库
+ * @return 当前会话关闭了执行计划缓存、没有选择数据库或者不是SELECT语句时返回nullptr
+ */
+static Db *plan_cache_db(SQLStageEvent *sql_event)
+{
+  Session *session = sql_event->session_event()->session();
+  if (!session->plan_cache()) {
+    return nullptr;
+  }
+
+  Db *db = session->get_current_db();
+  if (nullptr == db || !is_select_sql(sql_event->sql().c_str())) {
+    return nullptr;
+  }
+  return db;
+}
+
+RC PlanCacheStage::handle_request(SQLStageEvent *sql_event)
+{
+  Db *db = plan_cache_db(sql_event);
+  if (nullptr == db) {
+    return RC::SUCCESS;
+  }
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql(sql_event->sql().c_str(), key, literals);
+
+  PlanCache             &plan_cache = db->plan_cache();
+  unique_ptr<CachedPlan> plan       = plan_cache.acquire(key, literals);
+  if (!plan) {
+    return RC::SUCCESS;
+  }
+
+  LOG_TRACE("plan cache hit. sql=%s", key.c_str());
+  sql_event->set_borrowed_stmt(plan->stmt());
+  sql_event->set_operator(make_unique<CachedPlanPhysicalOperator>(&plan_cache, std::move(plan)));
+  return RC::SUCCESS;
+}
+
+RC PlanCacheStage::cache_plan(SQLStageEvent *sql_event)
+{
+  Stmt *stmt = sql_event->stmt();
+  if (nullptr == stmt || stmt->type() != StmtType::SELECT || !sql_event->physical_operator()) {
+    return RC::SUCCESS;
+  }
+
+  Db *db = plan_cache_db(sql_event);
+  if (nullptr == db) {
+    return RC::SUCCESS;
+  }
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql(sql_event->sql().c_str(), key, literals);
+
+  PlanCache &plan_cache = db->plan_cache();
+  auto       plan       = make_unique<CachedPlan>(std::move(key),
+      std::move(literals),
+      unique_ptr<Stmt>(sql_event->release_stmt()),
+      std::move(sql_event->physical_operator()));
+  plan->set_version(plan_cache.version());
+
+  // 计划已经交给CachedPlan管理，即使不能缓存也要通过CachedPlanPhysicalOperator执行
+  PlanCache *owner = &plan_cache;
+  if (!plan->init()) {
+    LOG_TRACE("plan cannot be cached. sql=%s", sql_event->sql().c_str());
+    owner = nullptr;
+  }
+
+  sql_event->set_borrowed_stmt(plan->stmt());
+  sql_event->set_operator(make_unique<CachedPlanPhysicalOperator>(owner, std::move(plan)));
+  return RC::SUCCESS;
+}
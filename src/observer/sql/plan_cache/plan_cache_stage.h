@@ -14,12 +14,33 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/rc.h"
+
+class SQLStageEvent;
 
 /**
  * @brief 尝试从Plan的缓存中获取Plan，如果没有命中，则执行Optimizer
  * @ingroup SQLStage
- * @details 实际上现在什么都没做。不过PlanCache对数据库的优化提升明显，是一个非常有趣的功能，
- * 感兴趣的同学可以参考OceanBase的实现
+ * @details 只缓存SELECT语句的计划。SQL中的常量替换成占位符之后作为缓存的键，命中时替换计划中过滤条件的常量，
+ * 跳过解析、Resolve和优化，直接执行缓存的计划。可以通过会话变量plan_cache关闭。
+ * 缓存的实现可以参考PlanCache。
  */
 class PlanCacheStage
-{};
+{
+public:
+  PlanCacheStage()          = default;
+  virtual ~PlanCacheStage() = default;
+
+public:
+  /**
+   * @brief 查找缓存的计划
+   * @details 命中时设置sql_event的stmt和物理算子，没有命中时什么都不做
+   */
+  RC handle_request(SQLStageEvent *sql_event);
+
+  /**
+   * @brief 把优化之后生成的计划放到缓存中
+   * @details 计划交给缓存管理，sql_event中的物理算子替换成使用缓存计划的算子
+   */
+  RC cache_plan(SQLStageEvent *sql_event);
+};
@@ -0,0 +1,160 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "sql/prepared_stmt/prepared_stmt.h"
+#include "common/log/log.h"
+#include "sql/parser/parse.h"
+
+using namespace std;
+
+PreparedStmt::PreparedStmt(uint32_t id, string sql) : id_(id), sql_(std::move(sql)) {}
+
+PreparedStmt::~PreparedStmt() = default;
+
+RC PreparedStmt::init()
+{
+  find_sql_params(sql_.c_str(), param_positions_);
+
+  ParsedSqlResult parsed_sql_result;
+  parse(sql_.c_str(), &parsed_sql_result);
+  if (parsed_sql_result.sql_nodes().size() != 1 || parsed_sql_result.sql_nodes().front()->flag != SCF_INSERT) {
+    // 其它语句执行时再解析，语法错误也在执行时返回
+    return RC::SUCCESS;
+  }
+
+  unique_ptr<ParsedSqlNode> &sql_node    = parsed_sql_result.sql_nodes().front();
+  int                        param_count = 0;
+  for (const Value &value : sql_node->insertion.values) {
+    if (value.attr_type() == AttrType::UNDEFINED) {
+      param_count++;
+    }
+  }
+
+  if (param_count != this->param_count()) {
+    LOG_WARN("param count mismatch. sql=%s, placeholders=%d, params in values=%d",
+             sql_.c_str(), this->param_count(), param_count);
+    return RC::SUCCESS;
+  }
+
+  sql_node_ = std::move(sql_node);
+  return RC::SUCCESS;
+}
+
+void PreparedStmt::append_long_data(int param_index, const char *data, int length)
+{
+  long_data_[param_index].append(data, length);
+}
+
+const string *PreparedStmt::long_data(int param_index) const
+{
+  auto iter = long_data_.find(param_index);
+  return iter == long_data_.end() ? nullptr : &iter->second;
+}
+
+RC PreparedStmt::bind(const vector<Value> &params, string &sql, unique_ptr<ParsedSqlNode> &sql_node) const
+{
+  if (static_cast<int>(params.size()) != param_count()) {
+    LOG_WARN("param count mismatch. expect=%d, actual=%d", param_count(), static_cast<int>(params.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (sql_node_) {
+    sql      = sql_;
+    sql_node = make_unique<ParsedSqlNode>(SCF_INSERT);
+    sql_node->insertion.relation_name = sql_node_->insertion.relation_name;
+    sql_node->insertion.values        = sql_node_->insertion.values;
+
+    size_t param_index = 0;
+    for (Value &value : sql_node->insertion.values) {
+      if (value.attr_type() == AttrType::UNDEFINED) {
+        value = params[param_index++];
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  sql.clear();
+  sql_node.reset();
+
+  int copied = 0;  // sql_中已经复制到sql的长度
+  for (int i = 0; i < param_count(); i++) {
+    string literal;
+    RC     rc = to_sql_literal(params[i], literal);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to convert param to sql literal. index=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+
+    sql.append(sql_, copied, param_positions_[i] - copied);
+    sql.append(literal);
+    copied = param_positions_[i] + 1;
+  }
+  sql.append(sql_, copied, string::npos);
+  return RC::SUCCESS;
+}
+
+RC PreparedStmt::to_sql_literal(const Value &value, string &literal)
+{
+  switch (value.attr_type()) {
+    case AttrType::NULLS: {
+      literal = "null";
+    } break;
+
+    case AttrType::INTS: {
+      literal = std::to_string(value.get_int());
+    } break;
+
+    case AttrType::BOOLEANS: {
+      literal = value.get_boolean() ? "1" : "0";
+    } break;
+
+    case AttrType::FLOATS: {
+      // 词法分析只识别"数字.数字"形式的浮点数
+      const float float_value = value.get_float();
+      if (!std::isfinite(float_value)) {
+        return RC::INVALID_ARGUMENT;
+      }
+
+      char buf[64];
+      snprintf(buf, sizeof(buf), "%.9g", float_value);
+      if (strchr(buf, 'e') != nullptr) {
+        snprintf(buf, sizeof(buf), "%f", float_value);
+      } else if (strchr(buf, '.') == nullptr) {
+        strncat(buf, ".0", sizeof(buf) - strlen(buf) - 1);
+      }
+      literal = buf;
+    } break;
+
+    case AttrType::CHARS:
+    case AttrType::TEXTS:
+    case AttrType::DATES: {
+      // 字符串常量不支持转义，选择一个字符串中没有出现的引号
+      const string str = value.to_string();
+      if (str.find('\'') == string::npos) {
+        literal = "'" + str + "'";
+      } else if (str.find('"') == string::npos) {
+        literal = "\"" + str + "\"";
+      } else {
+        LOG_WARN("string param contains both quotes. str=%s", str.c_str());
+        return RC::INVALID_ARGUMENT;
+      }
+    } break;
+
+    default: {
+      LOG_WARN("unsupported param type. type=%d", value.attr_type());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  return RC::SUCCESS;
+}
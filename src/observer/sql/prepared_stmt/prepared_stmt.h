@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/rc.h"
+#include "sql/parser/parse_defs.h"
+
+/**
+ * @brief 服务端的预处理语句
+ * @ingroup SQLStage
+ * @details 客户端先发送带有参数占位符'?'的SQL，执行时只发送参数的值。
+ * INSERT语句在预处理时就完成语法解析，执行时把参数填到语法树的副本中，不需要再解析SQL。
+ * 其它语句执行时把参数转换成SQL常量替换掉占位符，得到普通的SQL再执行。这样的SELECT语句
+ * 参数化之后的SQL都是相同的，可以直接使用执行计划缓存。
+ */
+class PreparedStmt
+{
+public:
+  PreparedStmt(uint32_t id, std::string sql);
+  ~PreparedStmt();
+
+  /**
+   * @brief 查找参数，如果是INSERT语句就做语法解析
+   */
+  RC init();
+
+  uint32_t           id() const { return id_; }
+  const std::string &sql() const { return sql_; }
+  int                param_count() const { return static_cast<int>(param_positions_.size()); }
+
+  /**
+   * @brief 客户端指定的参数类型
+   * @details 参数类型的定义由通讯协议决定，客户端可以只在第一次执行时发送参数类型，所以需要保存下来
+   */
+  const std::vector<int> &param_types() const { return param_types_; }
+  void                    set_param_types(std::vector<int> param_types) { param_types_ = std::move(param_types); }
+
+  /**
+   * @brief 客户端在执行之前单独发送的参数数据，执行之后清空
+   */
+  void               append_long_data(int param_index, const char *data, int length);
+  const std::string *long_data(int param_index) const;
+  void               clear_long_data() { long_data_.clear(); }
+
+  /**
+   * @brief 绑定参数，生成一次执行的请求
+   * @param params   参数的值，数量必须与占位符的数量相同
+   * @param sql      替换参数之后的SQL
+   * @param sql_node 不为空时直接执行这个语法树，不再解析sql
+   */
+  RC bind(const std::vector<Value> &params, std::string &sql, std::unique_ptr<ParsedSqlNode> &sql_node) const;
+
+private:
+  /**
+   * @brief 把参数转换成SQL中的常量
+   */
+  static RC to_sql_literal(const Value &value, std::string &literal);
+
+private:
+  uint32_t                       id_ = 0;
+  std::string                    sql_;
+  std::vector<int>               param_positions_;  ///< 每个占位符在SQL中的位置
+  std::vector<int>               param_types_;
+  std::map<int, std::string>     long_data_;
+  std::unique_ptr<ParsedSqlNode> sql_node_;  ///< INSERT语句的语法树，参数的值是UNDEFINED
+};
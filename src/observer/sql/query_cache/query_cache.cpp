@@ -0,0 +1,221 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/query_cache/query_cache.h"
+#include "common/log/log.h"
+#include "sql/executor/sql_result.h"
+#include "sql/expr/row_codec.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+void QueryResult::add_table(const Table *table) { table_versions_.emplace_back(table->table_id(), table->version()); }
+
+bool QueryResult::expired(const Db &db) const
+{
+  for (const auto &[table_id, version] : table_versions_) {
+    const Table *table = db.find_table(table_id);
+    if (nullptr == table || table->version() != version) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void QueryResult::append_row(const vector<Value> &cells)
+{
+  const size_t offset = rows_.size();
+  rows_.resize(offset + RowCodec::encoded_size(cells));
+  RowCodec::encode(cells, rows_.data() + offset);
+  row_count_++;
+}
+
+void QueryResult::clear_rows()
+{
+  rows_.clear();
+  rows_.shrink_to_fit();
+  row_count_ = 0;
+}
+
+size_t QueryResult::memory_size() const
+{
+  return sizeof(*this) + rows_.capacity() + schema_.cell_num() * sizeof(TupleCellSpec) +
+         table_versions_.size() * sizeof(table_versions_[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+shared_ptr<const QueryResult> QueryCache::lookup(const string &sql, const Db &db)
+{
+  lock_guard<mutex> guard(lock_);
+
+  auto iter = entry_index_.find(sql);
+  if (iter == entry_index_.end()) {
+    misses_++;
+    return nullptr;
+  }
+
+  EntryList::iterator entry_iter = iter->second;
+  if (entry_iter->result->expired(db)) {
+    LOG_TRACE("query result expired. sql=%s", sql.c_str());
+    erase(entry_iter);
+    misses_++;
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry_iter);
+  hits_++;
+  return entry_iter->result;
+}
+
+void QueryCache::insert(const string &sql, shared_ptr<const QueryResult> result)
+{
+  const size_t memory_size = result->memory_size() + sql.size() + sizeof(Entry);
+  if (memory_size > max_result_size()) {
+    return;
+  }
+
+  lock_guard<mutex> guard(lock_);
+
+  auto iter = entry_index_.find(sql);
+  if (iter != entry_index_.end()) {
+    erase(iter->second);
+  }
+
+  entries_.push_front(Entry{sql, std::move(result), memory_size});
+  entry_index_.emplace(sql, entries_.begin());
+  memory_size_ += memory_size;
+
+  while (memory_size_ > capacity_) {
+    erase(prev(entries_.end()));
+  }
+}
+
+void QueryCache::erase(EntryList::iterator iter)
+{
+  memory_size_ -= iter->memory_size;
+  entry_index_.erase(iter->sql);
+  entries_.erase(iter);
+}
+
+void QueryCache::clear()
+{
+  lock_guard<mutex> guard(lock_);
+  entry_index_.clear();
+  entries_.clear();
+  memory_size_ = 0;
+}
+
+size_t QueryCache::size() const
+{
+  lock_guard<mutex> guard(lock_);
+  return entries_.size();
+}
+
+size_t QueryCache::memory_size() const
+{
+  lock_guard<mutex> guard(lock_);
+  return memory_size_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QueryResultPhysicalOperator::QueryResultPhysicalOperator(shared_ptr<const QueryResult> result)
+    : result_(std::move(result)), tuple_(cell_specs_)
+{
+  const TupleSchema &schema = result_->schema();
+  for (int i = 0; i < schema.cell_num(); i++) {
+    cell_specs_.push_back(schema.cell_at(i));
+  }
+}
+
+RC QueryResultPhysicalOperator::open(Trx *)
+{
+  offset_ = 0;
+  tuple_.set_data(nullptr);
+  return RC::SUCCESS;
+}
+
+RC QueryResultPhysicalOperator::next()
+{
+  const string &rows = result_->rows();
+  if (offset_ >= rows.size()) {
+    return RC::RECORD_EOF;
+  }
+
+  const char *row = rows.data() + offset_;
+  tuple_.set_data(row);
+  offset_ += RowCodec::row_size(row);
+  return RC::SUCCESS;
+}
+
+RC QueryResultPhysicalOperator::close() { return RC::SUCCESS; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+QueryResultRecordPhysicalOperator::QueryResultRecordPhysicalOperator(
+    QueryCache &query_cache, string sql, shared_ptr<QueryResult> result, const SqlResult *sql_result)
+    : query_cache_(query_cache), sql_(std::move(sql)), result_(std::move(result)), sql_result_(sql_result)
+{}
+
+RC QueryResultRecordPhysicalOperator::open(Trx *trx)
+{
+  result_->clear_rows();
+  recording_ = true;
+  eof_       = false;
+
+  RC rc = children_[0]->open(trx);
+  if (OB_FAIL(rc)) {
+    recording_ = false;
+  }
+  return rc;
+}
+
+RC QueryResultRecordPhysicalOperator::next()
+{
+  RC rc = children_[0]->next();
+  if (rc == RC::RECORD_EOF) {
+    eof_ = true;
+    return rc;
+  }
+  if (OB_FAIL(rc)) {
+    recording_ = false;
+    return rc;
+  }
+
+  if (recording_) {
+    RC rc2 = RowCodec::read_cells(*children_[0]->current_tuple(), cells_);
+    if (OB_FAIL(rc2)) {
+      LOG_WARN("failed to read cells of query result. rc=%s", strrc(rc2));
+      recording_ = false;
+    } else {
+      result_->append_row(cells_);
+      if (result_->memory_size() > query_cache_.max_result_size()) {
+        LOG_TRACE("query result is too large to cache. sql=%s", sql_.c_str());
+        recording_ = false;
+        result_->clear_rows();
+      }
+    }
+  }
+  return rc;
+}
+
+RC QueryResultRecordPhysicalOperator::close()
+{
+  RC rc = children_[0]->close();
+  if (OB_SUCC(rc) && recording_ && eof_) {
+    result_->set_schema(sql_result_->tuple_schema());
+    query_cache_.insert(sql_, std::move(result_));
+    result_ = make_shared<QueryResult>();
+  }
+  recording_ = false;
+  return rc;
+}
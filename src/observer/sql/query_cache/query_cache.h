@@ -0,0 +1,193 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+
+class Db;
+class Table;
+class SqlResult;
+class QueryCache;
+
+/**
+ * @brief 缓存的一个查询结果
+ * @ingroup SQLStage
+ * @details 保存表头和使用RowCodec编码的所有行，以及查询开始时涉及的每个表的版本。
+ * 任何一个表的版本发生变化，或者表被删除，结果就过期了。
+ */
+class QueryResult
+{
+public:
+  QueryResult() = default;
+
+  /**
+   * @brief 记录表当前的版本，需要在执行查询之前调用
+   */
+  void add_table(const Table *table);
+
+  /**
+   * @brief 查询涉及的表是否有修改
+   */
+  bool expired(const Db &db) const;
+
+  void               set_schema(const TupleSchema &schema) { schema_ = schema; }
+  const TupleSchema &schema() const { return schema_; }
+
+  void append_row(const std::vector<Value> &cells);
+  void clear_rows();
+
+  const std::string &rows() const { return rows_; }
+  int                row_count() const { return row_count_; }
+
+  /**
+   * @brief 占用的内存大小，用于控制缓存的大小
+   */
+  size_t memory_size() const;
+
+private:
+  TupleSchema                               schema_;
+  std::vector<std::pair<int32_t, uint64_t>> table_versions_;  ///< 表ID和查询开始时表的版本
+  std::string                               rows_;            ///< 依次编码的所有行
+  int                                       row_count_ = 0;
+};
+
+/**
+ * @brief 查询结果缓存
+ * @ingroup SQLStage
+ * @details 每个数据库一个，按照SQL原文查找。只缓存自动提交模式下的SELECT语句，
+ * 表数据修改时不主动清理缓存，查找时发现结果过期再删除。
+ * 缓存的总大小超过容量时淘汰最久没有使用的结果。
+ */
+class QueryCache
+{
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 16 * 1024 * 1024;
+
+  explicit QueryCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+  /**
+   * @brief 查找没有过期的结果
+   * @return 没有命中时返回nullptr
+   */
+  std::shared_ptr<const QueryResult> lookup(const std::string &sql, const Db &db);
+
+  /**
+   * @brief 缓存一个查询结果，已经有相同SQL的结果时替换
+   */
+  void insert(const std::string &sql, std::shared_ptr<const QueryResult> result);
+
+  void clear();
+
+  /**
+   * @brief 单个结果大小的上限，超过的结果不缓存，避免一个大的结果把其它结果都淘汰掉
+   */
+  size_t max_result_size() const { return capacity_ / 4; }
+
+  size_t size() const;
+  size_t memory_size() const;
+
+  uint64_t hits() const { return hits_.load(); }
+  uint64_t misses() const { return misses_.load(); }
+
+private:
+  struct Entry
+  {
+    std::string                        sql;
+    std::shared_ptr<const QueryResult> result;
+    size_t                             memory_size = 0;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator iter);
+
+private:
+  mutable std::mutex                                   lock_;
+  size_t                                               capacity_;
+  size_t                                               memory_size_ = 0;
+  EntryList                                            entries_;  ///< 最近使用的在前面
+  std::unordered_map<std::string, EntryList::iterator> entry_index_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+/**
+ * @brief 输出缓存的查询结果
+ * @ingroup PhysicalOperator
+ */
+class QueryResultPhysicalOperator : public PhysicalOperator
+{
+public:
+  QueryResultPhysicalOperator(std::shared_ptr<const QueryResult> result);
+  virtual ~QueryResultPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  std::shared_ptr<const QueryResult> result_;
+  std::vector<TupleCellSpec>         cell_specs_;  ///< tuple_引用了这里的数据，需要在tuple_之前定义
+  EncodedTuple                       tuple_;
+  size_t                             offset_ = 0;  ///< 下一行在rows中的位置
+};
+
+/**
+ * @brief 执行查询的同时记录输出的结果
+ * @ingroup PhysicalOperator
+ * @details 作为执行计划的根节点，完整输出所有结果并正常关闭后，把结果放到缓存中。
+ * 结果超过缓存的大小限制或者执行出错时不缓存。
+ */
+class QueryResultRecordPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @param result     记录了查询涉及的表的版本
+   * @param sql_result 执行结束时从这里获取表头
+   */
+  QueryResultRecordPhysicalOperator(
+      QueryCache &query_cache, std::string sql, std::shared_ptr<QueryResult> result, const SqlResult *sql_result);
+  virtual ~QueryResultRecordPhysicalOperator() = default;
+
+  std::string          name() const override { return children_[0]->name(); }
+  std::string          param() const override { return children_[0]->param(); }
+  PhysicalOperatorType type() const override { return children_[0]->type(); }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override { return children_[0]->current_tuple(); }
+
+private:
+  QueryCache                  &query_cache_;
+  std::string                  sql_;
+  std::shared_ptr<QueryResult> result_;
+  const SqlResult             *sql_result_ = nullptr;
+  std::vector<Value>           cells_;
+  bool                         recording_ = false;
+  bool                         eof_       = false;
+};
@@ -12,12 +12,86 @@ See the Mulan PSL v2 for more details. */
 // Created by Longda on 2021/4/13.
 //
 
+#include "sql/query_cache/query_cache_stage.h"
+#include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/executor/sql_result.h"
+#include "sql/parser/parse.h"
+#include "sql/query_cache/query_cache.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/db/db.h"
 
+using namespace std;
 
-#include "query_cache_stage.h"
+/**
+ * @brief 获取可以使用查询结果缓存的数据库
+ * @details 多语句事务中的查询可能看到本事务未提交的修改，不使用缓存
+ * @return 当前会话关闭了查询结果缓存、没有选择数据库或者不是自动提交的SELECT语句时返回nullptr
+ */
+static Db *query_cache_db(SQLStageEvent *sql_event)
+{
+  Session *session = sql_event->session_event()->session();
+  if (!session->query_cache() || session->is_trx_multi_operation_mode()) {
+    return nullptr;
+  }
 
+  Db *db = session->get_current_db();
+  if (nullptr == db || !is_select_sql(sql_event->sql().c_str())) {
+    return nullptr;
+  }
+  return db;
+}
 
 RC QueryCacheStage::handle_request(SQLStageEvent *sql_event)
 {
+  Db *db = query_cache_db(sql_event);
+  if (nullptr == db) {
+    return RC::SUCCESS;
+  }
+
+  shared_ptr<const QueryResult> result = db->query_cache().lookup(sql_event->sql(), *db);
+  if (!result) {
+    return RC::SUCCESS;
+  }
+
+  LOG_TRACE("query cache hit. sql=%s", sql_event->sql().c_str());
+  SqlResult *sql_result = sql_event->session_event()->sql_result();
+  sql_result->set_tuple_schema(result->schema());
+  sql_result->set_operator(make_unique<QueryResultPhysicalOperator>(std::move(result)));
+  return RC::SUCCESS;
+}
+
+RC QueryCacheStage::cache_result(SQLStageEvent *sql_event)
+{
+  Stmt *stmt = sql_event->stmt();
+  if (nullptr == stmt || stmt->type() != StmtType::SELECT || !sql_event->physical_operator()) {
+    return RC::SUCCESS;
+  }
+
+  Db *db = query_cache_db(sql_event);
+  if (nullptr == db) {
+    return RC::SUCCESS;
+  }
+
+  // 只缓存查询普通表的语句，子查询和派生表涉及的表没有记录版本
+  SelectStmt *select_stmt = static_cast<SelectStmt *>(stmt);
+  if (!select_stmt->subquery_list().empty()) {
+    return RC::SUCCESS;
+  }
+
+  auto result = make_shared<QueryResult>();
+  for (const TableFactorDesc &table_desc : select_stmt->table_descs()) {
+    if (nullptr == table_desc.table()) {
+      return RC::SUCCESS;
+    }
+    result->add_table(table_desc.table());
+  }
+
+  auto recorder = make_unique<QueryResultRecordPhysicalOperator>(
+      db->query_cache(), sql_event->sql(), std::move(result), sql_event->session_event()->sql_result());
+  recorder->add_child(std::move(sql_event->physical_operator()));
+  sql_event->set_operator(std::move(recorder));
   return RC::SUCCESS;
 }
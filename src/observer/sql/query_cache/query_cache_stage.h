@@ -21,7 +21,9 @@ class SQLStageEvent;
 /**
  * @brief 查询缓存处理
  * @ingroup SQLStage
- * @details 当前什么都没做
+ * @details 会话打开query_cache后，自动提交模式下的SELECT语句先按照SQL原文查找当前数据库缓存的结果，
+ * 命中时直接输出缓存的结果，不再解析和执行。没有命中时在执行计划上加一个记录结果的算子，
+ * 查询正常结束后把结果放到缓存中。
  */
 class QueryCacheStage
 {
@@ -30,5 +32,13 @@ public:
   virtual ~QueryCacheStage() = default;
 
 public:
+  /**
+   * @brief 查找缓存的结果，命中时设置SqlResult的表头和输出结果的算子
+   */
   RC handle_request(SQLStageEvent *sql_event);
+
+  /**
+   * @brief 在执行之前调用，可以缓存的查询在执行的同时记录结果
+   */
+  RC cache_result(SQLStageEvent *sql_event);
 };
@@ -83,7 +83,10 @@ RC make_values(const vector<Value> &values, const TableMeta &meta, Value *&res,
     Value           &res_value    = res[i];
     const Value     &origin_value = values[i];
 
-    if (value_type == AttrType::NULLS && field_meta->nullable()) {
+    if (value_type == AttrType::UNDEFINED) {
+      LOG_WARN("parameter is not bound. field name=%s", field_meta->name());
+      return RC::INVALID_ARGUMENT;
+    } else if (value_type == AttrType::NULLS && field_meta->nullable()) {
       res_value = origin_value;
     } else if (value_type == AttrType::NULLS && !field_meta->nullable()) {
       LOG_WARN("field is not nullable. field name=%s", field_meta->name());
@@ -27,6 +27,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/table/table.h"
 #include <cassert>
 #include <cstdio>
+#include <strings.h>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -41,11 +42,6 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, const std::vector
   select_stmt->group_exprs_ = select_sql.group_by;
   select_stmt->db_          = db;
 
-  if (!select_sql.group_by.empty()) {
-    LOG_WARN("Group by is not supported yet");
-    return RC::UNIMPLENMENT;
-  }
-
   if (!select_sql.relations.empty()) {
     rc = select_stmt->resolve_table(select_sql.relations);
     if (rc != RC::SUCCESS) {
@@ -54,8 +50,16 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, const std::vector
     }
   }
 
+  if (!select_sql.group_by.empty()) {
+    rc = select_stmt->resolve_group_by(select_sql.group_by);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to resolve group by, rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
   assert(!select_sql.attributes.empty());
-  rc = select_stmt->resovle_attributes(select_sql.attributes);
+  rc = select_stmt->resovle_attributes(select_sql.attributes, select_sql.order_by);
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to resolve attributes, rc=%s", strrc(rc));
     return rc;
@@ -69,12 +73,38 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, const std::vector
     }
   }
 
+  select_stmt->limit_ = select_sql.limit;
+
   stmt = select_stmt;
 
   return RC::SUCCESS;
 }
 
-RC SelectStmt::resovle_attributes(const std::vector<ExpressionWithAliasSqlNode *> &attributes)
+/**
+ * @brief 查找order by中引用的select别名
+ * @return 别名对应的投影列，-1表示不是别名
+ */
+static int find_alias(const ExpressionSqlNode *sql_node, const vector<TupleCellSpec> &tuple_schema)
+{
+  if (sql_node->expr_type != ExprType::FIELD) {
+    return -1;
+  }
+
+  const RelAttrSqlNode &field = static_cast<const FieldExpressionSqlNode *>(sql_node)->field;
+  if (!field.relation_name.empty()) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < tuple_schema.size(); i++) {
+    if (0 == strcasecmp(tuple_schema[i].alias(), field.attribute_name.c_str())) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+RC SelectStmt::resovle_attributes(
+    const std::vector<ExpressionWithAliasSqlNode *> &attributes, const std::vector<ExpressionWithOrderSqlNode *> &order_by)
 {
   ProjectExpressionResovler resolver(db_, table_descs_, outter_tuple_schema_, group_exprs_);
 
@@ -85,7 +115,55 @@ RC SelectStmt::resovle_attributes(const std::vector<ExpressionWithAliasSqlNode *
   }
 
   // 生成tuple_schema
-  tuple_schema_ = std::move(resolver.attr_tuple());
+  tuple_schema_ = resolver.attr_tuple();
+  tuple_value_types_ = resolver.attr_types();
+
+  // order by的表达式作为额外的投影列解析，聚合函数和group by字段的处理与select中的表达式完全一致。
+  // 这些列只用于排序，SortOperator不会输出它们。引用select别名时直接使用对应的投影列
+  vector<ExpressionWithOrderSqlNode *>           order_sources;
+  vector<unique_ptr<ExpressionWithAliasSqlNode>> order_nodes;
+  vector<ExpressionWithAliasSqlNode *>           order_node_ptrs;
+  for (ExpressionWithOrderSqlNode *order_node : order_by) {
+    const bool is_asc = order_node->order_type == OrderType::ASC;
+    const int  index  = find_alias(order_node->expr, tuple_schema_);
+    if (index >= 0) {
+      order_by_list_.push_back({index, is_asc, order_node->expr->name});
+      continue;
+    }
+
+    if (order_node->expr->expr_type == ExprType::FIELD &&
+        static_cast<FieldExpressionSqlNode *>(order_node->expr)->field.attribute_name == "*") {
+      LOG_WARN("Wildcard is not allowed in order by");
+      return RC::INVALID_ARGUMENT;
+    }
+
+    order_by_list_.push_back(
+        {static_cast<int>(project_expr_list_.size() + order_nodes.size()), is_asc, order_node->expr->name});
+    order_nodes.push_back(make_unique<ExpressionWithAliasSqlNode>());
+    order_nodes.back()->expr = order_node->expr;
+    order_sources.push_back(order_node);
+    order_node_ptrs.push_back(order_nodes.back().get());
+  }
+
+  if (!order_nodes.empty()) {
+    vector<unique_ptr<Expression>> order_exprs;
+    rc = resolver.resolve_projection_list(order_node_ptrs, order_exprs);
+
+    // 解析时可能替换了表达式的根节点，把所有权还给order by节点
+    for (size_t i = 0; i < order_nodes.size(); i++) {
+      order_sources[i]->expr = order_nodes[i]->expr;
+      order_nodes[i]->expr   = nullptr;
+    }
+
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to resolve order by expression, rc=%s", strrc(rc));
+      return rc;
+    }
+
+    project_expr_list_.insert(project_expr_list_.end(),
+        std::make_move_iterator(order_exprs.begin()),
+        std::make_move_iterator(order_exprs.end()));
+  }
 
   aggregate_list_ = std::move(resolver.aggregate_desc());
 
@@ -109,6 +187,28 @@ RC SelectStmt::resolve_where( ExpressionSqlNode *where_expr) {
   return RC::SUCCESS;
 }
 
+RC SelectStmt::resolve_group_by(const std::vector<ExpressionSqlNode *> &group_by)
+{
+  for (ExpressionSqlNode *sql_node : group_by) {
+    GroupByExpressionResolver resolver(db_, table_descs_, {});
+    unique_ptr<Expression>    expr;
+
+    RC rc = resolver.resolve(sql_node, expr);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to resolve group by expression, rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (!resolver.subquery_sqls().empty()) {
+      LOG_WARN("Subquery in group by is not supported");
+      return RC::UNIMPLENMENT;
+    }
+
+    group_by_list_.push_back(std::move(expr));
+  }
+  return RC::SUCCESS;
+}
+
 RC SelectStmt::resolve_table(const std::vector<TableReferenceSqlNode *> &table_refs)
 {
   TableSqlResovler table_stmt_generator;
@@ -55,30 +55,34 @@ public:
   std::vector<std::unique_ptr<SubqueryStmt>>  &subquery_list() { return subquery_list_; }
   std::vector<std::unique_ptr<AggregateDesc>> &aggregate_list() { return aggregate_list_; }
   std::vector<std::unique_ptr<Expression>>    &group_by_list() { return group_by_list_; }
-  std::vector<std::unique_ptr<ExprWithOrder>> &order_by_list() { return order_by_list_; }
+  std::vector<OrderByDesc>                    &order_by_list() { return order_by_list_; }
   std::unique_ptr<Expression>                 &filter() { return filter_; }
   std::vector<TableFactorDesc>                &table_descs() { return table_descs_; }
 
   const std::vector<std::unique_ptr<Expression>>    &project_expr_list() const { return project_expr_list_; }
   const std::vector<TupleCellSpec>                  &tuple_schema() const { return tuple_schema_; }
+  const std::vector<AttrType>                       &tuple_value_types() const { return tuple_value_types_; }
   const std::unique_ptr<TableStmt>                  &table_stmt() const { return table_stmt_; }
   const std::vector<std::unique_ptr<SubqueryStmt>>  &subquery_list() const { return subquery_list_; }
   const std::vector<std::unique_ptr<AggregateDesc>> &aggregate_list() const { return aggregate_list_; }
   const std::vector<std::unique_ptr<Expression>>    &group_by_list() const { return group_by_list_; }
-  const std::vector<std::unique_ptr<ExprWithOrder>> &order_by_list() const { return order_by_list_; }
+  const std::vector<OrderByDesc>                    &order_by_list() const { return order_by_list_; }
+  int                                                limit() const { return limit_; }
   const std::unique_ptr<Expression>                 &filter() const { return filter_; }
   const std::vector<TableFactorDesc>                &table_descs() const { return table_descs_; }
 
 private:
   /**
    * SelectStmt的解析过程
-   * 解析表 -> 解析属性 -> 解析where表达式
+   * 解析表 -> 解析group by -> 解析属性 -> 解析where表达式
    * 
    */
 
   RC resolve_table(const std::vector<TableReferenceSqlNode *> &table_refs);
-  RC resovle_attributes(const std::vector<ExpressionWithAliasSqlNode *> &attributes);
+  RC resovle_attributes(const std::vector<ExpressionWithAliasSqlNode *> &attributes,
+      const std::vector<ExpressionWithOrderSqlNode *>                  &order_by);
   RC resolve_where( ExpressionSqlNode *where_expr);
+  RC resolve_group_by(const std::vector<ExpressionSqlNode *> &group_by);
 
 private:
   Db                              *db_ = nullptr;
@@ -89,6 +93,7 @@ private:
   std::vector<std::unique_ptr<Expression>> project_expr_list_;  // 用于生成ProjectOperator
   std::vector<TupleCellSpec>               tuple_schema_;       // 显示的名字,
                                              // 由于投影的名称可能是别名，所以需要计算出应该显示的名字
+  std::vector<AttrType> tuple_value_types_;  // 每个显示列的值的类型，生成执行计划时投影表达式会被移走
 
   std::unique_ptr<TableStmt> table_stmt_ = nullptr;  // 用于生成相应的表
 
@@ -97,7 +102,8 @@ private:
   std::vector<std::unique_ptr<AggregateDesc>> aggregate_list_;  // 用于生成AggregateOperator, 当不需要聚合时，该字段为空
   std::vector<std::unique_ptr<Expression>> group_by_list_;  // 用于生成GroupByOperator, 当不需要group by时，该字段为空
 
-  std::vector<std::unique_ptr<ExprWithOrder>> order_by_list_;  // 用于生成SortOperator, 当不需要排序时，该字段为空
+  std::vector<OrderByDesc> order_by_list_;  // 用于生成SortOperator, 当不需要排序时，该字段为空
+  int                      limit_ = -1;     // 排序后最多输出的行数，-1 表示没有限制
 
   std::unique_ptr<Expression> filter_ = nullptr;  // 用于生成PerdictOperator
 };
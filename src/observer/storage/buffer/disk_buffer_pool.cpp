@@ -11,8 +11,12 @@ See the Mulan PSL v2 for more details. */
 //
 // Created by Meiyi & Longda on 2021/4/13.
 //
+#include <algorithm>
 #include <errno.h>
+#include <limits>
 #include <string.h>
+#include <sys/stat.h>
+#include <thread>
 
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
@@ -20,6 +24,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/math/crc.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/buffer/buffer_pool_log.h"
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/read_ahead.h"
 #include "storage/db/db.h"
 
 using namespace common;
@@ -36,12 +42,70 @@ string BPFileHeader::to_string() const
   return ss.str();
 }
 
+string BPReadAheadStat::to_string() const
+{
+  stringstream ss;
+  ss << "requests:" << request_count << ", dropped:" << dropped_count << ", read pages:" << read_pages
+     << ", hit pages:" << hit_pages << ", wasted pages:" << wasted_pages;
+  return ss.str();
+}
+
+string BPFrameShardStat::to_string(const vector<BPFrameShardStat> &stats)
+{
+  uint64_t lock_count       = 0;
+  uint64_t contention_count = 0;
+  size_t   hottest          = 0;
+  for (size_t i = 0; i < stats.size(); i++) {
+    lock_count += stats[i].lock_count;
+    contention_count += stats[i].contention_count;
+    if (stats[i].contention_count > stats[hottest].contention_count) {
+      hottest = i;
+    }
+  }
+
+  stringstream ss;
+  ss << "shards:" << stats.size() << ", locks:" << lock_count << ", contentions:" << contention_count;
+  if (!stats.empty()) {
+    ss << ", hottest shard:" << hottest << ", hottest shard locks:" << stats[hottest].lock_count
+       << ", hottest shard contentions:" << stats[hottest].contention_count;
+  }
+  return ss.str();
+}
+
+string BPHitStat::to_string() const
+{
+  stringstream ss;
+  ss << "replacement policy:" << replacement_policy << ", accesses:" << access_count << ", hits:" << hit_count
+     << ", hit ratio:" << hit_ratio();
+  return ss.str();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
+unique_lock<mutex> BPFrameManager::Shard::guard() const
+{
+  unique_lock<mutex> lock_guard(lock, try_to_lock);
+  if (!lock_guard.owns_lock()) {
+    contention_count.fetch_add(1, memory_order_relaxed);
+    lock_guard.lock();
+  }
+  lock_count.fetch_add(1, memory_order_relaxed);
+  return lock_guard;
+}
+
 BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
 
-RC BPFrameManager::init(int pool_num)
+RC BPFrameManager::init(int pool_num, int shard_num /* = DEFAULT_SHARD_NUM */)
 {
+  if (shard_num <= 0) {
+    shard_num = DEFAULT_SHARD_NUM;
+  }
+  shards_    = make_unique<Shard[]>(shard_num);
+  shard_num_ = shard_num;
+  for (int i = 0; i < shard_num_; i++) {
+    shards_[i].frames = FrameReplacer::create(replacement_policy_.c_str());
+  }
+
   int ret = allocator_.init(false, pool_num);
   if (ret == 0) {
     return RC::SUCCESS;
@@ -51,26 +115,73 @@ RC BPFrameManager::init(int pool_num)
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (int i = 0; i < shard_num_; i++) {
+    shards_[i].frames = FrameReplacer::create(replacement_policy_.c_str());
+  }
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+RC BPFrameManager::set_replacement_policy(const char *name)
 {
-  lock_guard<mutex> lock_guard(lock_);
+  if (frame_num() > 0) {
+    LOG_WARN("cannot change replacement policy while there are frames in memory. frame num=%ld", frame_num());
+    return RC::INTERNAL;
+  }
 
-  vector<Frame *> frames_can_purge;
+  vector<unique_ptr<FrameReplacer>> replacers(shard_num_);
+  for (int i = 0; i < shard_num_; i++) {
+    replacers[i] = FrameReplacer::create(name);
+    if (!replacers[i]) {
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  for (int i = 0; i < shard_num_; i++) {
+    lock_guard<mutex> lock_guard(shards_[i].lock);
+    shards_[i].frames = std::move(replacers[i]);
+  }
+  replacement_policy_ = shards_[0].frames->name();
+  LOG_INFO("frame manager use replacement policy %s", replacement_policy_.c_str());
+  return RC::SUCCESS;
+}
+
+int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+{
   if (count <= 0) {
     count = 1;
   }
+
+  int freed_count = 0;
+  for (int i = 0; i < shard_num_ && freed_count < count; i++) {
+    Shard &shard = shards_[purge_cursor_.fetch_add(1, memory_order_relaxed) % shard_num_];
+
+    unique_lock<mutex> lock_guard = shard.guard();
+    freed_count += purge_shard_frames(shard, count - freed_count, purger);
+  }
+  LOG_INFO("purge frame done. number=%d", freed_count);
+  return freed_count;
+}
+
+int BPFrameManager::purge_shard_frames(Shard &shard, int count, const function<RC(Frame *frame)> &purger)
+{
+  vector<Frame *> frames_can_purge;
+  vector<Frame *> dirty_frames;
   frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
+  // 优先淘汰干净的页面，不够的时候再淘汰需要刷盘的脏页
+  auto purge_finder = [&frames_can_purge, &dirty_frames, count](const FrameId &frame_id, Frame *const frame) {
     if (frame->can_purge()) {
+      if (frame->dirty()) {
+        if (dirty_frames.size() < static_cast<size_t>(count)) {
+          dirty_frames.push_back(frame);
+        }
+        return true;
+      }
+
       frame->pin();
       frames_can_purge.push_back(frame);
       if (frames_can_purge.size() >= static_cast<size_t>(count)) {
@@ -80,16 +191,25 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
     return true;  // true continue to look up
   };
 
-  frames_.foreach_reverse(purge_finder);
-  LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
+  shard.frames->foreach_victim(purge_finder);
+  for (Frame *frame : dirty_frames) {
+    if (frames_can_purge.size() >= static_cast<size_t>(count)) {
+      break;
+    }
+    if (frame->can_purge()) {
+      frame->pin();
+      frames_can_purge.push_back(frame);
+    }
+  }
+  LOG_DEBUG("purge frames find %ld pages in shard", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
+  /// 当前还在分片的锁内，而 purger 是一个非常耗时的操作
+  /// 他需要把脏页数据刷新到磁盘上去，所以会阻塞访问这个分片的其它线程
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      free_internal(shard, frame->frame_id(), frame, true /*evicted*/);
       freed_count++;
     } else {
       frame->unpin();
@@ -97,22 +217,26 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
                frame->frame_id().to_string().c_str(), strrc(rc));
     }
   }
-  LOG_INFO("purge frame done. number=%d", freed_count);
   return freed_count;
 }
 
 Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
 {
-  FrameId                     frame_id(buffer_pool_id, page_num);
+  FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  unique_lock<mutex> lock_guard = shard.guard();
+  Frame *frame = get_internal(shard, frame_id);
+  if (frame != nullptr && frame->clear_read_ahead()) {
+    read_ahead_hits_.fetch_add(1, memory_order_relaxed);
+  }
+  return frame;
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+Frame *BPFrameManager::get_internal(Shard &shard, const FrameId &frame_id)
 {
   Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
+  (void)shard.frames->get(frame_id, frame);
   if (frame != nullptr) {
     frame->pin();
   }
@@ -122,10 +246,11 @@ Frame *BPFrameManager::get_internal(const FrameId &frame_id)
 Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
 {
   FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
+  unique_lock<mutex> lock_guard = shard.guard();
 
-  Frame                      *frame = get_internal(frame_id);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
@@ -137,38 +262,97 @@ Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
     frame->set_buffer_pool_id(buffer_pool_id);
     frame->set_page_num(page_num);
     frame->pin();
-    frames_.put(frame_id, frame);
+    shard.frames->put(frame_id, frame);
+  }
+  return frame;
+}
+
+Frame *BPFrameManager::alloc_read_ahead(int buffer_pool_id, PageNum page_num, bool &exists)
+{
+  FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
+
+  unique_lock<mutex> lock_guard = shard.guard();
+
+  Frame *frame = nullptr;
+  exists       = shard.frames->peek(frame_id, frame);
+  if (exists) {
+    return nullptr;
+  }
+
+  frame = allocator_.alloc();
+  if (frame != nullptr) {
+    ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s",
+           frame->to_string().c_str());
+    frame->set_buffer_pool_id(buffer_pool_id);
+    frame->set_page_num(page_num);
+    frame->set_loading();
+    frame->pin();
+    shard.frames->put(frame_id, frame);
   }
   return frame;
 }
 
+void BPFrameManager::finish_read_ahead(Frame *frame, bool success)
+{
+  if (success) {
+    frame->set_read_ahead(true);
+    frame->set_loaded(true);
+    frame->unpin();
+    read_ahead_pages_.fetch_add(1, memory_order_relaxed);
+    return;
+  }
+
+  const FrameId frame_id = frame->frame_id();
+  Shard        &shard    = shard_of(frame_id);
+  {
+    unique_lock<mutex> lock_guard = shard.guard();
+    shard.frames->remove(frame_id, false /*evicted*/);
+  }
+
+  // 已经找到这个页帧的线程会看到加载失败，然后放弃这个页帧
+  frame->set_loaded(false);
+  while (frame->pin_count() > 1) {
+    this_thread::yield();
+  }
+
+  frame->set_page_num(-1);
+  frame->set_loaded(true);
+  frame->unpin();
+  allocator_.free(frame);
+}
+
 RC BPFrameManager::free(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
   FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  unique_lock<mutex> lock_guard = shard.guard();
+  return free_internal(shard, frame_id, frame, false /*evicted*/);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_internal(Shard &shard, const FrameId &frame_id, Frame *frame, bool evicted)
 {
   Frame                *frame_source = nullptr;
-  [[maybe_unused]] bool found        = frames_.get(frame_id, frame_source);
+  [[maybe_unused]] bool found        = shard.frames->peek(frame_id, frame_source);
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
       "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
       found, frame_id.to_string().c_str(), frame_source, frame, frame->pin_count(), lbt());
 
+  if (frame->clear_read_ahead()) {
+    read_ahead_wastes_.fetch_add(1, memory_order_relaxed);
+  }
+
   frame->set_page_num(-1);
+  frame->clear_dirty();
   frame->unpin();
-  frames_.remove(frame_id);
+  shard.frames->remove(frame_id, evicted);
   allocator_.free(frame);
   return RC::SUCCESS;
 }
 
 list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
   list<Frame *> frames;
   auto               fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
     if (buffer_pool_id == frame_id.buffer_pool_id()) {
@@ -177,10 +361,152 @@ list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
     }
     return true;
   };
-  frames_.foreach (fetcher);
+
+  for (int i = 0; i < shard_num_; i++) {
+    unique_lock<mutex> lock_guard = shards_[i].guard();
+    shards_[i].frames->foreach(fetcher);
+  }
   return frames;
 }
 
+LSN BPFrameManager::min_recovery_lsn(LSN lsn)
+{
+  auto checker = [&lsn](const FrameId &, Frame *const frame) -> bool {
+    if (frame->pin_count() == 0 && !frame->dirty()) {
+      return true;
+    }
+
+    LSN recovery_lsn = frame->recovery_lsn();
+    if (recovery_lsn == 0) {
+      // 日志写入之后、设置页面LSN之前的页面，拿不到读锁或者已经标记为脏页
+      bool modifying = false;
+      frame->pin();
+      if (frame->try_read_latch()) {
+        recovery_lsn = frame->recovery_lsn();
+        frame->read_unlatch();
+      } else {
+        modifying = true;
+      }
+      frame->unpin();
+
+      if (recovery_lsn == 0 && (modifying || frame->dirty())) {
+        recovery_lsn = frame->lsn() + 1;
+      }
+    }
+
+    if (recovery_lsn > 0 && recovery_lsn < lsn) {
+      lsn = recovery_lsn;
+    }
+    return true;
+  };
+
+  for (int i = 0; i < shard_num_; i++) {
+    unique_lock<mutex> lock_guard = shards_[i].guard();
+    shards_[i].frames->foreach(checker);
+  }
+  return lsn;
+}
+
+void BPFrameManager::dirty_frames(vector<BPDirtyFrame> &frames)
+{
+  frames.clear();
+  auto collector = [&frames](const FrameId &frame_id, Frame *const frame) -> bool {
+    if (frame_id.page_num() != BP_HEADER_PAGE && frame->dirty()) {
+      // 没有设置过LSN的脏页排在最后
+      LSN recovery_lsn = frame->recovery_lsn();
+      frames.push_back(BPDirtyFrame{frame_id, recovery_lsn > 0 ? recovery_lsn : numeric_limits<LSN>::max()});
+    }
+    return true;
+  };
+
+  for (int i = 0; i < shard_num_; i++) {
+    unique_lock<mutex> lock_guard = shards_[i].guard();
+    shards_[i].frames->foreach(collector);
+  }
+
+  sort(frames.begin(), frames.end(), [](const BPDirtyFrame &left, const BPDirtyFrame &right) {
+    return left.recovery_lsn < right.recovery_lsn;
+  });
+}
+
+void BPFrameManager::lru_tail_dirty_frames(int depth, vector<FrameId> &frame_ids)
+{
+  frame_ids.clear();
+  for (int i = 0; i < shard_num_; i++) {
+    int  scanned   = 0;
+    auto collector = [&frame_ids, &scanned, depth](const FrameId &frame_id, Frame *const frame) -> bool {
+      if (frame_id.page_num() != BP_HEADER_PAGE && frame->can_purge() && frame->dirty()) {
+        frame_ids.push_back(frame_id);
+      }
+      return ++scanned < depth;
+    };
+
+    unique_lock<mutex> lock_guard = shards_[i].guard();
+    shards_[i].frames->foreach_victim(collector);
+  }
+}
+
+Frame *BPFrameManager::pin_dirty(const FrameId &frame_id)
+{
+  Shard &shard = shard_of(frame_id);
+
+  unique_lock<mutex> lock_guard = shard.guard();
+
+  Frame *frame = nullptr;
+  if (!shard.frames->peek(frame_id, frame) || !frame->dirty()) {
+    return nullptr;
+  }
+  frame->pin();
+  return frame;
+}
+
+size_t BPFrameManager::frame_num() const
+{
+  size_t num = 0;
+  for (int i = 0; i < shard_num_; i++) {
+    lock_guard<mutex> lock_guard(shards_[i].lock);
+    num += shards_[i].frames->count();
+  }
+  return num;
+}
+
+void BPFrameManager::record_access(bool hit)
+{
+  access_count_.fetch_add(1, memory_order_relaxed);
+  if (hit) {
+    hit_count_.fetch_add(1, memory_order_relaxed);
+  }
+}
+
+void BPFrameManager::hit_stat(BPHitStat &stat) const
+{
+  stat.replacement_policy = replacement_policy_;
+  stat.access_count       = access_count_.load(memory_order_relaxed);
+  stat.hit_count          = hit_count_.load(memory_order_relaxed);
+}
+
+void BPFrameManager::read_ahead_stat(BPReadAheadStat &stat) const
+{
+  stat.read_pages   = read_ahead_pages_.load(memory_order_relaxed);
+  stat.hit_pages    = read_ahead_hits_.load(memory_order_relaxed);
+  stat.wasted_pages = read_ahead_wastes_.load(memory_order_relaxed);
+}
+
+vector<BPFrameShardStat> BPFrameManager::shard_stats() const
+{
+  vector<BPFrameShardStat> stats(shard_num_);
+  for (int i = 0; i < shard_num_; i++) {
+    const Shard &shard = shards_[i];
+    {
+      lock_guard<mutex> lock_guard(shard.lock);
+      stats[i].frame_num = shard.frames->count();
+    }
+    stats[i].lock_count       = shard.lock_count.load(memory_order_relaxed);
+    stats[i].contention_count = shard.contention_count.load(memory_order_relaxed);
+  }
+  return stats;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolIterator::BufferPoolIterator() {}
 BufferPoolIterator::~BufferPoolIterator() {}
@@ -281,6 +607,8 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
+  lock_guard<recursive_mutex> clean_guard(bp_manager_.clean_lock());
+
   hdr_frame_->unpin();
 
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
@@ -314,15 +642,27 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   RC rc  = RC::SUCCESS;
   *frame = nullptr;
 
-  Frame *used_match_frame = frame_manager_.get(id(), page_num);
+  Frame *used_match_frame = get_loaded_frame(page_num);
   if (used_match_frame != nullptr) {
     used_match_frame->access();
+    frame_manager_.record_access(true);
     *frame = used_match_frame;
     return RC::SUCCESS;
   }
 
   scoped_lock lock_guard(lock_);  // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
 
+  // 等锁的时候其它线程可能已经加载了这个页面
+  used_match_frame = get_loaded_frame(page_num);
+  if (used_match_frame != nullptr) {
+    used_match_frame->access();
+    frame_manager_.record_access(true);
+    *frame = used_match_frame;
+    return RC::SUCCESS;
+  }
+
+  frame_manager_.record_access(false);
+
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
 
@@ -346,6 +686,87 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   return RC::SUCCESS;
 }
 
+Frame *DiskBufferPool::get_loaded_frame(PageNum page_num)
+{
+  Frame *frame = frame_manager_.get(id(), page_num);
+  if (frame != nullptr && !frame->wait_loaded()) {
+    frame->unpin();
+    frame = nullptr;
+  }
+  return frame;
+}
+
+void DiskBufferPool::hint_read_ahead(PageNum start_page, int page_count)
+{
+  bp_manager_.submit_read_ahead(id(), start_page, page_count);
+}
+
+RC DiskBufferPool::read_ahead(PageNum start_page, int page_count, int &read_count)
+{
+  read_count = 0;
+
+  vector<Frame *> frames;
+  {
+    scoped_lock lock_guard(lock_);
+
+    const PageNum end_page = min(start_page + page_count, file_header_->page_count);
+    for (PageNum page_num = max(start_page, BP_HEADER_PAGE + 1); page_num < end_page; page_num++) {
+      if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0) {
+        continue;
+      }
+
+      bool   exists = false;
+      Frame *frame  = frame_manager_.alloc_read_ahead(id(), page_num, exists);
+      if (frame == nullptr && !exists) {
+        purge_frames_for_alloc(end_page - page_num);
+        frame = frame_manager_.alloc_read_ahead(id(), page_num, exists);
+      }
+
+      if (frame != nullptr) {
+        frames.push_back(frame);
+      } else if (!exists) {
+        break;
+      }
+    }
+  }
+
+  // 页面最新的数据可能还在double write buffer中，其它页面作为一批从文件中读取
+  vector<IoRequest> requests;
+  vector<Frame *>   io_frames;
+  for (Frame *frame : frames) {
+    if (OB_SUCC(dblwr_manager_.read_page(this, frame->page_num(), frame->page()))) {
+      frame_manager_.finish_read_ahead(frame, true);
+      read_count++;
+      continue;
+    }
+
+    IoRequest request;
+    request.type   = IoRequest::Type::READ;
+    request.fd     = file_desc_;
+    request.offset = static_cast<int64_t>(frame->page_num()) * BP_PAGE_SIZE;
+    request.buf    = &frame->page();
+    request.size   = BP_PAGE_SIZE;
+    requests.push_back(request);
+    io_frames.push_back(frame);
+  }
+
+  RC rc = bp_manager_.io_engine().submit(requests);
+  for (size_t i = 0; i < io_frames.size(); i++) {
+    const bool success = OB_SUCC(requests[i].rc);
+    if (!success) {
+      LOG_WARN("failed to read ahead page. file=%s, page num=%d, rc=%s",
+          file_name_.c_str(), io_frames[i]->page_num(), strrc(requests[i].rc));
+    } else {
+      read_count++;
+    }
+    frame_manager_.finish_read_ahead(io_frames[i], success);
+  }
+
+  LOG_DEBUG("read ahead pages. file=%s, start page=%d, page count=%d, read count=%d",
+      file_name_.c_str(), start_page, page_count, read_count);
+  return rc;
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
@@ -385,6 +806,7 @@ RC DiskBufferPool::allocate_page(Frame **frame)
     return RC::BUFFERPOOL_NOBUF;
   }
 
+  hdr_frame_->mark_dirty();
   LSN lsn = 0;
   rc = log_handler_.allocate_page(file_header_->page_count, lsn);
   if (OB_FAIL(rc)) {
@@ -440,12 +862,17 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
   scoped_lock lock_guard(lock_);
   Frame           *used_frame = frame_manager_.get(id(), page_num);
   if (used_frame != nullptr) {
+    // 后台刷脏页的线程和检查点可能会短暂地pin住页面，它们都不需要buffer pool的锁
+    while (used_frame->pin_count() > 1) {
+      this_thread::yield();
+    }
     ASSERT("the page try to dispose is in use. frame:%s", used_frame->to_string().c_str());
     frame_manager_.free(id(), page_num, used_frame);
   } else {
     LOG_DEBUG("page not found in memory while disposing it. pageNum=%d", page_num);
   }
 
+  hdr_frame_->mark_dirty();
   LSN lsn = 0;
   RC rc = log_handler_.deallocate_page(page_num, lsn);
   if (OB_FAIL(rc)) {
@@ -454,7 +881,6 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
   }
 
   hdr_frame_->set_lsn(lsn);
-  hdr_frame_->mark_dirty();
   file_header_->allocated_pages--;
   char tmp = 1 << (page_num % 8);
   file_header_->bitmap[page_num / 8] &= ~tmp;
@@ -562,6 +988,15 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::clean_page(Frame &frame)
+{
+  if (frame.page_num() == BP_HEADER_PAGE) {
+    LOG_WARN("cannot clean header page without lock. file=%s", file_name_.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+  return flush_page_internal(frame);
+}
+
 RC DiskBufferPool::flush_all_pages()
 {
   list<Frame *> used = frame_manager_.find_list(id());
@@ -594,16 +1029,11 @@ RC DiskBufferPool::recover_page(PageNum page_num)
 
 RC DiskBufferPool::write_page(PageNum page_num, Page &page)
 {
-  scoped_lock lock_guard(wr_lock_);
-  int64_t     offset = ((int64_t)page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to write page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to write page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
+  int64_t offset = ((int64_t)page_num) * sizeof(Page);
+  RC      rc     = bp_manager_.io_engine().write(file_desc_, offset, &page, sizeof(Page));
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write page %lld of %d. rc=%s", offset, file_desc_, strrc(rc));
+    return rc;
   }
 
   LOG_TRACE("write_page: buffer_pool_id:%d, page_num:%d, lsn=%d, check_sum=%d", id(), page_num, page.lsn, page.check_sum);
@@ -681,7 +1111,7 @@ RC DiskBufferPool::redo_deallocate_page(LSN lsn, PageNum page_num)
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+void DiskBufferPool::purge_frames_for_alloc(int count)
 {
   auto purger = [this](Frame *frame) {
     if (!frame->dirty()) {
@@ -701,6 +1131,12 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     return rc;
   };
 
+  bp_manager_.wake_up_page_cleaner();
+  (void)frame_manager_.purge_frames(count, purger);
+}
+
+RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+{
   while (true) {
     Frame *frame = frame_manager_.alloc(id(), page_num);
     if (frame != nullptr) {
@@ -710,7 +1146,7 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     }
 
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
-    (void)frame_manager_.purge_frames(1 /*count*/, purger);
+    purge_frames_for_alloc(1 /*count*/);
   }
   return RC::BUFFERPOOL_NOBUF;
 }
@@ -736,19 +1172,21 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
     return rc;
   }
 
-  scoped_lock lock_guard(wr_lock_);
-  int64_t          offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
+  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
+  rc = bp_manager_.io_engine().read(file_desc_, offset, &page, BP_PAGE_SIZE);
+  // 页面分配之后还没有写入过文件。double write buffer攒够一批才会写文件，异常退出时页面可能只在内存中，
+  // 这时当做一个空页面，页面内容由redo日志恢复
+  struct stat file_stat;
+  if (OB_FAIL(rc) && fstat(file_desc_, &file_stat) == 0 && file_stat.st_size <= offset) {
+    LOG_INFO("page has not been written to file, use an empty page. file=%s, page num=%d",
+             file_name_.c_str(), page_num);
+    memset(&page, 0, BP_PAGE_SIZE);
+    rc = RC::SUCCESS;
   }
-
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
-  if (ret != 0) {
-    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-              file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
-    return RC::IOERR_READ;
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, rc=%s",
+              file_name_.c_str(), file_desc_, page_num, strrc(rc));
+    return rc;
   }
 
   frame->set_page_num(page_num);
@@ -761,19 +1199,25 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
 int DiskBufferPool::file_desc() const { return file_desc_; }
 
 ////////////////////////////////////////////////////////////////////////////////
-BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
+BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */, int frame_shard_num /* = 0 */)
 {
   if (memory_size <= 0) {
     memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
   }
   const int pool_num = max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
-  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d",
-           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
+  frame_manager_.init(pool_num, frame_shard_num);
+  io_engine_ = make_unique<PreadIoEngine>();
+  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d, frame shard num: %d",
+           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num, frame_manager_.shard_num());
 }
 
 BufferPoolManager::~BufferPoolManager()
 {
+  stop_read_ahead();
+  stop_page_cleaner();
+
+  log_stat();
+
   unordered_map<string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -782,9 +1226,13 @@ BufferPoolManager::~BufferPoolManager()
   }
 }
 
-RC BufferPoolManager::init(unique_ptr<DoubleWriteBuffer> dblwr_buffer)
+RC BufferPoolManager::init(unique_ptr<DoubleWriteBuffer> dblwr_buffer, unique_ptr<IoEngine> io_engine /* = nullptr */)
 {
   dblwr_buffer_ = std::move(dblwr_buffer);
+  if (io_engine) {
+    io_engine_ = std::move(io_engine);
+  }
+  LOG_INFO("buffer pool manager use io engine %s", io_engine_->name());
   return RC::SUCCESS;
 }
 
@@ -867,6 +1315,7 @@ RC BufferPoolManager::close_file(const char *_file_name)
 {
   string file_name(_file_name);
 
+  lock_guard<recursive_mutex> clean_guard(clean_lock_);
   lock_.lock();
 
   auto iter = buffer_pools_.find(file_name);
@@ -890,17 +1339,140 @@ RC BufferPoolManager::flush_page(Frame &frame)
 {
   int buffer_pool_id = frame.buffer_pool_id();
 
-  scoped_lock lock_guard(lock_);
-  auto             iter = id_to_buffer_pools_.find(buffer_pool_id);
-  if (iter == id_to_buffer_pools_.end()) {
-    LOG_WARN("unknown buffer pool of id %d", buffer_pool_id);
-    return RC::INTERNAL;
+  // 只在查找时加锁。double write buffer写满时也要查找buffer pool，刷新页面时加着锁会相互等待。
+  // 调用者淘汰页面时持有页面所在分片的锁，关闭文件要等淘汰结束才能释放这个文件的页面
+  DiskBufferPool *bp = nullptr;
+  RC              rc = get_buffer_pool(buffer_pool_id, bp);
+  if (OB_FAIL(rc)) {
+    return rc;
   }
 
-  DiskBufferPool *bp = iter->second;
   return bp->flush_page(frame);
 }
 
+RC BufferPoolManager::start_page_cleaner()
+{
+  if (!page_cleaner_) {
+    page_cleaner_ = make_unique<PageCleaner>(*this);
+  }
+  return page_cleaner_->start();
+}
+
+void BufferPoolManager::stop_page_cleaner()
+{
+  if (page_cleaner_) {
+    page_cleaner_->stop();
+  }
+}
+
+void BufferPoolManager::wake_up_page_cleaner()
+{
+  if (page_cleaner_) {
+    page_cleaner_->wake_up();
+  }
+}
+
+RC BufferPoolManager::start_read_ahead()
+{
+  if (!read_ahead_worker_) {
+    read_ahead_worker_ = make_unique<ReadAheadWorker>(*this);
+  }
+  return read_ahead_worker_->start();
+}
+
+void BufferPoolManager::stop_read_ahead()
+{
+  if (read_ahead_worker_) {
+    read_ahead_worker_->stop();
+  }
+}
+
+void BufferPoolManager::submit_read_ahead(int32_t buffer_pool_id, PageNum start_page, int page_count)
+{
+  if (read_ahead_worker_ && page_count > 0) {
+    (void)read_ahead_worker_->submit(buffer_pool_id, start_page, page_count);
+  }
+}
+
+RC BufferPoolManager::read_ahead(int32_t buffer_pool_id, PageNum start_page, int page_count, int &read_count)
+{
+  read_count = 0;
+
+  lock_guard<recursive_mutex> clean_guard(clean_lock_);
+
+  DiskBufferPool *bp = nullptr;
+  {
+    scoped_lock lock_guard(lock_);
+    auto        iter = id_to_buffer_pools_.find(buffer_pool_id);
+    if (iter == id_to_buffer_pools_.end()) {
+      return RC::SUCCESS;  // 文件已经关闭了
+    }
+    bp = iter->second;
+  }
+
+  return bp->read_ahead(start_page, page_count, read_count);
+}
+
+BPHitStat BufferPoolManager::hit_stat() const
+{
+  BPHitStat stat;
+  frame_manager_.hit_stat(stat);
+  return stat;
+}
+
+void BufferPoolManager::log_stat() const
+{
+  LOG_INFO("buffer pool hit stat: %s", hit_stat().to_string().c_str());
+  LOG_INFO("buffer pool frame shard stat: %s",
+           BPFrameShardStat::to_string(frame_manager_.shard_stats()).c_str());
+  if (read_ahead_worker_) {
+    LOG_INFO("read ahead stat: %s", read_ahead_stat().to_string().c_str());
+  }
+}
+
+BPReadAheadStat BufferPoolManager::read_ahead_stat() const
+{
+  BPReadAheadStat stat;
+  frame_manager_.read_ahead_stat(stat);
+  if (read_ahead_worker_) {
+    stat.request_count = read_ahead_worker_->request_count();
+    stat.dropped_count = read_ahead_worker_->dropped_count();
+  }
+  return stat;
+}
+
+RC BufferPoolManager::clean_page(const FrameId &frame_id, bool &flushed)
+{
+  flushed = false;
+
+  lock_guard<recursive_mutex> clean_guard(clean_lock_);
+
+  DiskBufferPool *bp = nullptr;
+  {
+    scoped_lock lock_guard(lock_);
+    auto        iter = id_to_buffer_pools_.find(frame_id.buffer_pool_id());
+    if (iter == id_to_buffer_pools_.end()) {
+      return RC::SUCCESS;  // 文件已经关闭了
+    }
+    bp = iter->second;
+  }
+
+  Frame *frame = frame_manager_.pin_dirty(frame_id);
+  if (nullptr == frame) {
+    return RC::SUCCESS;
+  }
+
+  // 拿不到读锁说明页面正在被修改，等下一轮再刷
+  RC rc = RC::SUCCESS;
+  if (frame->try_read_latch()) {
+    rc      = bp->clean_page(*frame);
+    flushed = OB_SUCC(rc);
+    frame->read_unlatch();
+  }
+  frame->unpin();
+  return rc;
+}
+
 RC BufferPoolManager::get_buffer_pool(int32_t id, DiskBufferPool *&bp)
 {
   bp = nullptr;
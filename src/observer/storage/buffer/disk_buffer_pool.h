@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 #pragma once
 
+#include <atomic>
 #include <fcntl.h>
 #include <functional>
 #include <mutex>
@@ -26,14 +27,16 @@ See the Mulan PSL v2 for more details. */
 #include <unordered_map>
 #include <optional>
 #include <memory>
+#include <vector>
 
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
 #include "common/lang/mutex.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
 #include "common/types.h"
 #include "storage/buffer/frame.h"
+#include "storage/buffer/frame_replacer.h"
+#include "storage/buffer/io_engine.h"
 #include "storage/buffer/page.h"
 #include "storage/buffer/buffer_pool_log.h"
 
@@ -42,6 +45,8 @@ class DiskBufferPool;
 class DoubleWriteBuffer;
 class LogHandler;
 class BufferPoolLogHandler;
+class PageCleaner;
+class ReadAheadWorker;
 
 /**
  * @brief BufferPool 的实现
@@ -76,6 +81,62 @@ struct BPFileHeader
   std::string to_string() const;
 };
 
+/**
+ * @brief 页帧管理器一个分片的统计信息
+ * @ingroup BufferPool
+ */
+struct BPFrameShardStat
+{
+  size_t   frame_num        = 0;  ///< 分片中当前的页帧个数
+  uint64_t lock_count       = 0;  ///< 分片的锁被获取的次数
+  uint64_t contention_count = 0;  ///< 获取锁时需要等待的次数
+
+  /**
+   * @brief 汇总所有分片的锁统计，并给出等待最多的分片
+   */
+  static std::string to_string(const std::vector<BPFrameShardStat> &stats);
+};
+
+/**
+ * @brief 一个脏页和它的recovery lsn
+ * @ingroup BufferPool
+ */
+struct BPDirtyFrame
+{
+  FrameId frame_id;
+  LSN     recovery_lsn = 0;  ///< 页面第一次被修改时的LSN，刷新这个页面之后检查点才能推进到后面
+};
+
+/**
+ * @brief 预读的统计信息
+ * @ingroup BufferPool
+ */
+struct BPReadAheadStat
+{
+  uint64_t request_count = 0;  ///< 提交的预读请求个数
+  uint64_t dropped_count = 0;  ///< 后台线程来不及处理而丢弃的预读请求个数
+  uint64_t read_pages    = 0;  ///< 预读加载的页面个数
+  uint64_t hit_pages     = 0;  ///< 预读的页面在淘汰之前被访问的个数
+  uint64_t wasted_pages  = 0;  ///< 预读的页面没有被访问就被淘汰的个数
+
+  std::string to_string() const;
+};
+
+/**
+ * @brief 页面的命中率统计
+ * @ingroup BufferPool
+ * @details 用来比较不同替换策略的效果
+ */
+struct BPHitStat
+{
+  std::string replacement_policy;
+  uint64_t    access_count = 0;  ///< 获取页面的次数
+  uint64_t    hit_count    = 0;  ///< 页面已经在内存中，不需要读磁盘的次数
+
+  double      hit_ratio() const { return access_count == 0 ? 0.0 : static_cast<double>(hit_count) / access_count; }
+  std::string to_string() const;
+};
+
 /**
  * @brief 管理页面Frame
  * @ingroup BufferPool
@@ -83,15 +144,32 @@ struct BPFileHeader
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ * 为了减少多线程访问页面时的锁冲突，页帧按照FrameId的哈希值分到多个分片中，
+ * 每个分片有自己的锁和替换策略(参考 FrameReplacer)，访问不同分片的页面不会相互阻塞。
+ * 淘汰页面时也是逐个分片处理的，所以淘汰顺序只在分片内是精确的。
+ * 页帧的内存由所有分片共享，只有在分配和释放页帧时才会访问。
  */
 class BPFrameManager
 {
 public:
+  static constexpr int DEFAULT_SHARD_NUM = 16;
+
   BPFrameManager(const char *tag);
 
-  RC init(int pool_num);
+  /**
+   * @param pool_num  页帧内存池的个数，每个内存池有DEFAULT_ITEM_NUM_PER_POOL个页帧
+   * @param shard_num 分片的个数，小于等于0时使用DEFAULT_SHARD_NUM
+   */
+  RC init(int pool_num, int shard_num = DEFAULT_SHARD_NUM);
   RC cleanup();
 
+  /**
+   * @brief 设置替换策略，只能在没有页帧的时候设置
+   * @param name 参考 FrameReplacer::create
+   */
+  RC          set_replacement_policy(const char *name);
+  const char *replacement_policy() const { return replacement_policy_.c_str(); }
+
   /**
    * @brief 获取指定的页面
    *
@@ -118,6 +196,20 @@ public:
    */
   Frame *alloc(int buffer_pool_id, PageNum page_num);
 
+  /**
+   * @brief 为预读分配一个页帧
+   * @details 新的页帧处于加载中的状态，其它线程可以找到这个页帧，但是要等预读完成才能访问。
+   * @param exists 页面已经在内存中时设置为true，并返回nullptr
+   * @return 没有空闲的页帧时返回nullptr
+   */
+  Frame *alloc_read_ahead(int buffer_pool_id, PageNum page_num, bool &exists);
+
+  /**
+   * @brief 预读的页面加载完成
+   * @details 加载失败时把页帧从分片中删除，等其它线程都不再使用之后释放
+   */
+  void finish_read_ahead(Frame *frame, bool success);
+
   /**
    * 尽管frame中已经包含了buffer_pool_id和page_num，但是依然要求
    * 传入，因为frame可能忘记初始化或者没有初始化
@@ -126,37 +218,107 @@ public:
 
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
-   * 尝试从pin count=0的页面中淘汰一些
+   * 尝试从pin count=0的页面中淘汰一些。优先淘汰不需要刷盘的干净页面
+   * @details 从上次淘汰结束的分片开始，依次在每个分片中淘汰，直到淘汰了足够多的页面
    * @param count 想要purge多少个页面
    * @param purger 需要在释放frame之前，对页面做些什么操作。当前是刷新脏数据到磁盘
    * @return 返回本次清理了多少个页面
    */
   int purge_frames(int count, std::function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  /**
+   * @brief 计算重启时至少要从哪个LSN开始恢复页面
+   * @details 遍历所有页面，取脏页的recovery lsn的最小值。正在修改的页面，可能日志已经写入但是还没有设置页面的
+   * LSN，由于修改页面时都持有页面的写锁，拿不到读锁的页面使用页面当前的LSN加1作为下界。
+   * @param lsn 没有脏页时返回这个值
+   */
+  LSN min_recovery_lsn(LSN lsn);
+
+  /**
+   * @brief 列出所有的脏页，按照recovery lsn从小到大排序
+   * @details 给后台刷脏页的线程使用，不包括文件头页面。文件头页面的修改由buffer pool的锁保护，
+   * 在检查点或者关闭文件时刷新。
+   */
+  void dirty_frames(std::vector<BPDirtyFrame> &frames);
+
+  /**
+   * @brief 列出每个分片中最先被淘汰的页面中，没有被使用的脏页
+   * @param depth 每个分片检查多少个页面
+   */
+  void lru_tail_dirty_frames(int depth, std::vector<FrameId> &frame_ids);
+
+  /**
+   * @brief 如果页面还在内存中并且是脏页，就pin住这个页面
+   * @details 不调整页面的淘汰顺序，避免后台刷页面影响页面淘汰的顺序
+   * @return 页面已经被淘汰或者不是脏页时返回nullptr
+   */
+  Frame *pin_dirty(const FrameId &frame_id);
+
+  size_t frame_num() const;
 
   /**
    * 测试使用。返回已经从内存申请的个数
    */
   size_t total_frame_num() const { return allocator_.get_size(); }
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
+  int shard_num() const { return shard_num_; }
+
+  /**
+   * @brief 每个分片的页帧个数和锁冲突次数
+   */
+  std::vector<BPFrameShardStat> shard_stats() const;
+
+  /**
+   * @brief 预读加载、命中和浪费的页面个数
+   */
+  void read_ahead_stat(BPReadAheadStat &stat) const;
+
+  /**
+   * @brief 记录一次获取页面的结果，用于统计命中率
+   */
+  void record_access(bool hit);
+  void hit_stat(BPHitStat &stat) const;
 
 private:
-  class BPFrameIdHasher
+  using FrameAllocator = common::MemPoolSimple<Frame>;
+
+  /**
+   * @brief 一个分片。按照缓存行对齐，避免不同分片的锁之间出现伪共享
+   */
+  struct alignas(64) Shard
   {
-  public:
-    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+    mutable std::mutex             lock;
+    std::unique_ptr<FrameReplacer> frames;
+    mutable std::atomic<uint64_t> lock_count{0};
+    mutable std::atomic<uint64_t> contention_count{0};
+
+    /**
+     * @brief 加锁并统计锁冲突
+     */
+    std::unique_lock<std::mutex> guard() const;
   };
 
-  using FrameLruCache  = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
-  using FrameAllocator = common::MemPoolSimple<Frame>;
+  Shard &shard_of(const FrameId &frame_id) { return shards_[frame_id.hash() % shard_num_]; }
 
-  std::mutex     lock_;
-  FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  Frame *get_internal(Shard &shard, const FrameId &frame_id);
+  RC     free_internal(Shard &shard, const FrameId &frame_id, Frame *frame, bool evicted);
+
+  /**
+   * @brief 在一个分片中淘汰页面，需要加着分片的锁
+   */
+  int purge_shard_frames(Shard &shard, int count, const std::function<RC(Frame *frame)> &purger);
+
+private:
+  std::unique_ptr<Shard[]> shards_;
+  int                      shard_num_ = 0;
+  std::atomic<int>         purge_cursor_{0};  ///< 下次从这个分片开始淘汰页面
+  std::atomic<uint64_t>    read_ahead_pages_{0};
+  std::atomic<uint64_t>    read_ahead_hits_{0};
+  std::atomic<uint64_t>    read_ahead_wastes_{0};
+  std::atomic<uint64_t>    access_count_{0};
+  std::atomic<uint64_t>    hit_count_{0};
+  std::string              replacement_policy_ = "lru";
+  FrameAllocator           allocator_;
 };
 
 /**
@@ -207,6 +369,19 @@ public:
    */
   RC get_this_page(PageNum page_num, Frame **frame);
 
+  /**
+   * @brief 提示后面会访问这些页面，由后台线程异步地预读
+   * @details 预读线程没有启动或者来不及处理时什么都不做
+   */
+  void hint_read_ahead(PageNum start_page, int page_count);
+
+  /**
+   * @brief 把 [start_page, start_page + page_count) 中已经分配并且不在内存中的页面读取到页帧中
+   * @details 一批页面作为一次请求提交给IO引擎。页帧不够时会淘汰一些页面，淘汰不出来就放弃剩下的页面。
+   * @param read_count 加载了多少个页面
+   */
+  RC read_ahead(PageNum start_page, int page_count, int &read_count);
+
   /**
    * @brief 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
    * @details 分配页面时，如果文件中有空闲页，就直接分配一个空闲页；
@@ -250,6 +425,13 @@ public:
    */
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 后台刷脏页的线程把页面刷新到double write buffer
+   * @details 调用者需要pin住页面并持有页面的读锁。不加buffer pool的锁，避免和分配、释放页面相互等待，
+   * 所以不能用来刷新文件头页面。
+   */
+  RC clean_page(Frame &frame);
+
   /**
    * 刷新所有页面到double write buffer，即使pin count不是0
    */
@@ -276,6 +458,17 @@ public:
 protected:
   RC allocate_frame(PageNum page_num, Frame **buf);
 
+  /**
+   * @brief 淘汰一些页面，给新的页面腾出页帧
+   */
+  void purge_frames_for_alloc(int count);
+
+  /**
+   * @brief 查找内存中的页面，页面正在预读时等待预读完成
+   * @return 页面不在内存中或者预读失败时返回nullptr
+   */
+  Frame *get_loaded_frame(PageNum page_num);
+
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
    */
@@ -308,7 +501,6 @@ private:
   std::string file_name_;  /// 文件名
 
   common::Mutex lock_;
-  common::Mutex wr_lock_;
 
 private:
   friend class BufferPoolIterator;
@@ -321,10 +513,17 @@ private:
 class BufferPoolManager final
 {
 public:
-  BufferPoolManager(int memory_size = 0);
+  /**
+   * @param memory_size     用于缓存页面的内存大小，小于等于0时使用默认值
+   * @param frame_shard_num 页帧管理器的分片个数，小于等于0时使用默认值
+   */
+  BufferPoolManager(int memory_size = 0, int frame_shard_num = 0);
   ~BufferPoolManager();
 
-  RC init(std::unique_ptr<DoubleWriteBuffer> dblwr_buffer);
+  /**
+   * @param io_engine 读写页面使用的IO引擎，为空时使用pread
+   */
+  RC init(std::unique_ptr<DoubleWriteBuffer> dblwr_buffer, std::unique_ptr<IoEngine> io_engine = nullptr);
 
   RC create_file(const char *file_name);
   RC open_file(LogHandler &log_handler, const char *file_name, DiskBufferPool *&bp);
@@ -332,8 +531,60 @@ public:
 
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 启动后台刷脏页的线程
+   * @details 需要在恢复完成之后启动，回放日志时不加buffer pool的锁
+   */
+  RC start_page_cleaner();
+  void stop_page_cleaner();
+
+  /**
+   * @brief 唤醒后台刷脏页的线程
+   * @details 没有空闲页帧需要淘汰页面时调用
+   */
+  void wake_up_page_cleaner();
+
+  /**
+   * @brief 启动后台预读的线程
+   */
+  RC   start_read_ahead();
+  void stop_read_ahead();
+
+  /**
+   * @brief 提交一个异步的预读请求，参考 DiskBufferPool::hint_read_ahead
+   */
+  void submit_read_ahead(int32_t buffer_pool_id, PageNum start_page, int page_count);
+
+  /**
+   * @brief 后台线程执行一个预读请求
+   * @details 与后台刷脏页一样，需要持有 clean_lock，防止文件被关闭
+   */
+  RC read_ahead(int32_t buffer_pool_id, PageNum start_page, int page_count, int &read_count);
+
+  BPReadAheadStat read_ahead_stat() const;
+  BPHitStat       hit_stat() const;
+
+  /**
+   * @brief 把命中率、分片锁和预读的统计信息打印到日志中
+   * @details 后台刷脏页的线程定期调用，关闭时也会打印一次
+   */
+  void log_stat() const;
+
+  /**
+   * @brief 后台线程刷新一个脏页
+   * @details 页面正在被修改或者已经不是脏页时跳过
+   * @param flushed 是否刷新了这个页面
+   */
+  RC clean_page(const FrameId &frame_id, bool &flushed);
+
+  /**
+   * @brief 关闭文件时需要持有的锁，防止后台刷脏页和预读的线程访问正在关闭的文件
+   */
+  std::recursive_mutex &clean_lock() { return clean_lock_; }
+
   BPFrameManager    &get_frame_manager() { return frame_manager_; }
   DoubleWriteBuffer *get_dblwr_buffer() { return dblwr_buffer_.get(); }
+  IoEngine          &io_engine() { return *io_engine_; }
 
   /**
    * @brief 根据ID获取对应的BufferPool对象
@@ -346,7 +597,11 @@ public:
 private:
   BPFrameManager frame_manager_{"BufPool"};
 
+  std::unique_ptr<IoEngine>          io_engine_;  ///< 需要在double write buffer之后析构
   std::unique_ptr<DoubleWriteBuffer> dblwr_buffer_;
+  std::unique_ptr<PageCleaner>       page_cleaner_;
+  std::unique_ptr<ReadAheadWorker>   read_ahead_worker_;
+  std::recursive_mutex               clean_lock_;  ///< 后台线程访问页面时不能关闭文件
 
   common::Mutex                                     lock_;
   std::unordered_map<std::string, DiskBufferPool *> buffer_pools_;
@@ -12,12 +12,15 @@ See the Mulan PSL v2 for more details. */
 // Created by Wenbin1002 on 2024/04/16
 //
 #include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <mutex>
 #include <algorithm>
 
 #include "storage/buffer/double_write_buffer.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/io_engine.h"
 #include "common/io/io.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
@@ -34,6 +37,7 @@ public:
 public:
   DoubleWritePageKey key;
   int32_t            page_index = -1; /// 页面在double write buffer文件中的页索引
+  int64_t            batch_id   = 0;  /// 页面最后一次写入double write buffer文件时的批次
   Page               page;
 
   static const int32_t SIZE;
@@ -81,22 +85,108 @@ RC DiskDoubleWriteBuffer::open_file(const char *filename)
 
 RC DiskDoubleWriteBuffer::flush_page()
 {
-  sync();
+  scoped_lock lock_guard(lock_);
+  return flush_page_internal();
+}
+
+RC DiskDoubleWriteBuffer::flush_page_internal()
+{
+  vector<pair<DiskBufferPool *, DoubleWritePage *>> pages;
+  pages.reserve(dblwr_pages_.size());
+  for (const auto &pair : dblwr_pages_) {
+    DoubleWritePage *dblwr_page  = pair.second;
+    DiskBufferPool  *disk_buffer = nullptr;
+    RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+    ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
+    pages.emplace_back(disk_buffer, dblwr_page);
+  }
+
+  RC rc = write_pages(pages);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
   for (const auto &pair : dblwr_pages_) {
-    RC rc = write_page(pair.second);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
     delete pair.second;
   }
 
   dblwr_pages_.clear();
-  header_.page_cnt = 0;
 
   return RC::SUCCESS;
 }
 
+RC DiskDoubleWriteBuffer::write_pages(const vector<pair<DiskBufferPool *, DoubleWritePage *>> &pages)
+{
+  if (pages.empty()) {
+    return RC::SUCCESS;
+  }
+
+  IoEngine &io_engine = bp_manager_.io_engine();
+
+  // 文件头和所有页面一次顺序写入共享文件
+  header_.page_cnt = static_cast<int32_t>(pages.size());
+  header_.batch_id = next_batch_id_++;
+
+  vector<char> buffer(DoubleWriteBufferHeader::SIZE + pages.size() * DoubleWritePage::SIZE);
+  memcpy(buffer.data(), &header_, DoubleWriteBufferHeader::SIZE);
+  for (size_t i = 0; i < pages.size(); i++) {
+    DoubleWritePage *dblwr_page = pages[i].second;
+    dblwr_page->page_index      = static_cast<int32_t>(i);
+    dblwr_page->batch_id        = header_.batch_id;
+    memcpy(buffer.data() + DoubleWriteBufferHeader::SIZE + i * DoubleWritePage::SIZE, dblwr_page, DoubleWritePage::SIZE);
+  }
+
+  RC rc = io_engine.write(file_desc_, 0, buffer.data(), static_cast<int64_t>(buffer.size()));
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write pages into double write buffer file. page count=%d, rc=%s",
+              header_.page_cnt, strrc(rc));
+    return rc;
+  }
+
+  if (fdatasync(file_desc_) != 0) {
+    LOG_ERROR("Failed to sync double write buffer file. page count=%d, error=%s", header_.page_cnt, strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+
+  // 共享文件中的页面已经持久化，再写入页面所在的文件
+  vector<IoRequest> requests;
+  vector<int>       fds;
+  requests.reserve(pages.size());
+  for (const auto &[disk_buffer, dblwr_page] : pages) {
+    LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
+              dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
+
+    IoRequest request;
+    request.type   = IoRequest::Type::WRITE;
+    request.fd     = disk_buffer->file_desc();
+    request.offset = static_cast<int64_t>(dblwr_page->key.page_num) * BP_PAGE_SIZE;
+    request.buf    = &dblwr_page->page;
+    request.size   = BP_PAGE_SIZE;
+    requests.push_back(request);
+    fds.push_back(request.fd);
+  }
+
+  rc = io_engine.submit(requests);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write pages in double write buffer. page count=%d, rc=%s",
+              static_cast<int>(requests.size()), strrc(rc));
+    return rc;
+  }
+
+  sort(fds.begin(), fds.end());
+  fds.erase(unique(fds.begin(), fds.end()), fds.end());
+  for (int fd : fds) {
+    if (fdatasync(fd) != 0) {
+      LOG_ERROR("Failed to sync data file. fd=%d, error=%s", fd, strerror(errno));
+      return RC::IOERR_SYNC;
+    }
+  }
+
+  LOG_TRACE("double write buffer write pages done. batch id=%ld, page count=%d, file count=%d",
+            header_.batch_id, header_.page_cnt, static_cast<int>(fds.size()));
+  return RC::SUCCESS;
+}
+
 RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &page)
 {
   scoped_lock lock_guard(lock_);
@@ -106,7 +196,7 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
     iter->second->page = page;
     LOG_TRACE("[cache hit]add page into double write buffer. buffer_pool_id:%d,page_num:%d,lsn=%d, dwb size=%d",
               bp->id(), page_num, page.lsn, static_cast<int>(dblwr_pages_.size()));
-    return write_page_internal(iter->second);
+    return RC::SUCCESS;
   }
 
   int64_t          page_cnt   = dblwr_pages_.size();
@@ -115,28 +205,8 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
   LOG_TRACE("insert page into double write buffer. buffer_pool_id:%d,page_num:%d,lsn=%d, dwb size:%d",
             bp->id(), page_num, page.lsn, static_cast<int>(dblwr_pages_.size()));
 
-  RC rc = write_page_internal(dblwr_page);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to write page into double write buffer. rc=%s buffer_pool_id:%d,page_num:%d,lsn=%d.",
-        strrc(rc), bp->id(), page_num, page.lsn);
-    return rc;
-  }
-
-  if (page_cnt + 1 > header_.page_cnt) {
-    header_.page_cnt = page_cnt + 1;
-    if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to add page header due to failed to seek %s.", strerror(errno));
-      return RC::IOERR_SEEK;
-    }
-
-    if (writen(file_desc_, &header_, sizeof(header_)) != 0) {
-      LOG_ERROR("Failed to add page header due to %s.", strerror(errno));
-      return RC::IOERR_WRITE;
-    }
-  }
-
   if (static_cast<int>(dblwr_pages_.size()) >= max_pages_) {
-    RC rc = flush_page();
+    RC rc = flush_page_internal();
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to flush pages in double write buffer");
       return rc;
@@ -146,35 +216,6 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
-{
-  int32_t page_index = page->page_index;
-  int64_t offset = page_index * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to add page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, page, DoubleWritePage::SIZE) != 0) {
-    LOG_ERROR("Failed to add page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
-  }
-
-  return RC::SUCCESS;
-}
-
-RC DiskDoubleWriteBuffer::write_page(DoubleWritePage *dblwr_page)
-{
-  DiskBufferPool *disk_buffer = nullptr;
-  RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
-  ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
-
-  LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
-            dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
-
-  return disk_buffer->write_page(dblwr_page->key.page_num, dblwr_page->page);
-}
-
 RC DiskDoubleWriteBuffer::read_page(DiskBufferPool *bp, PageNum page_num, Page &page)
 {
   scoped_lock lock_guard(lock_);
@@ -202,26 +243,22 @@ RC DiskDoubleWriteBuffer::clear_pages(DiskBufferPool *buffer_pool)
     return false;
   };
 
-  lock_.lock();
+  // 这些页面也要先写入共享文件，写入过程中不能有其它批次覆盖共享文件
+  scoped_lock lock_guard(lock_);
   erase_if(dblwr_pages_, remove_pred);
-  lock_.unlock();
 
   LOG_INFO("clear pages in double write buffer. file name=%s, page count=%d",
            buffer_pool->filename(), spec_pages.size());
 
-  // 页面从小到大排序，防止出现小页面还没有写入，而页面编号更大的seek失败的情况
-  sort(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *a, DoubleWritePage *b) {
-    return a->key.page_num < b->key.page_num;
-  });
-
-  RC rc = RC::SUCCESS;
+  vector<pair<DiskBufferPool *, DoubleWritePage *>> pages;
+  pages.reserve(spec_pages.size());
   for (DoubleWritePage *dbl_page : spec_pages) {
-    rc = buffer_pool->write_page(dbl_page->key.page_num, dbl_page->page);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("Failed to write page %s:%d to disk buffer pool. rc=%s",
-               buffer_pool->filename(), dbl_page->key.page_num, strrc(rc));
-      break;
-    }
+    pages.emplace_back(buffer_pool, dbl_page);
+  }
+
+  RC rc = write_pages(pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to write pages of %s in double write buffer. rc=%s", buffer_pool->filename(), strrc(rc));
   }
 
   for_each(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *dbl_page) { delete dbl_page; });
@@ -253,6 +290,8 @@ RC DiskDoubleWriteBuffer::load_pages()
     return RC::IOERR_READ;
   }
 
+  next_batch_id_ = header_.batch_id + 1;
+
   for (int page_num = 0; page_num < header_.page_cnt; page_num++) {
     int64_t offset = ((int64_t)page_num) * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
 
@@ -272,6 +311,12 @@ RC DiskDoubleWriteBuffer::load_pages()
       return RC::IOERR_READ;
     }
 
+    // 最后一个批次没有写完时，后面可能还有更早批次的页面
+    if (dblwr_page->batch_id != header_.batch_id) {
+      LOG_TRACE("got a page of an old batch. page batch id=%ld, batch id=%ld", dblwr_page->batch_id, header_.batch_id);
+      continue;
+    }
+
     const CheckSum check_sum = crc32(page.data, BP_PAGE_DATA_SIZE);
     if (check_sum == page.check_sum) {
       DoubleWritePageKey key = dblwr_page->key;
@@ -287,7 +332,36 @@ RC DiskDoubleWriteBuffer::load_pages()
 
 RC DiskDoubleWriteBuffer::recover()
 {
-  return flush_page();
+  scoped_lock lock_guard(lock_);
+
+  vector<pair<DiskBufferPool *, DoubleWritePage *>> pages;
+  pages.reserve(dblwr_pages_.size());
+  for (const auto &pair : dblwr_pages_) {
+    DoubleWritePage *dblwr_page  = pair.second;
+    DiskBufferPool  *disk_buffer = nullptr;
+    RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+    if (OB_FAIL(rc) || nullptr == disk_buffer) {
+      LOG_WARN("skip page in double write buffer, buffer pool is not opened. buffer_pool_id:%d,page_num:%d",
+               dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num);
+      continue;
+    }
+    pages.emplace_back(disk_buffer, dblwr_page);
+  }
+
+  RC rc = write_pages(pages);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to recover pages in double write buffer. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("double write buffer recover done. page count=%d, skipped=%d",
+           static_cast<int>(pages.size()), static_cast<int>(dblwr_pages_.size() - pages.size()));
+
+  for (const auto &pair : dblwr_pages_) {
+    delete pair.second;
+  }
+  dblwr_pages_.clear();
+  return RC::SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////
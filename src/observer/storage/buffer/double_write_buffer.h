@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "common/lang/mutex.h"
 #include "common/types.h"
@@ -32,7 +33,7 @@ public:
   virtual ~DoubleWriteBuffer() = default;
 
   /**
-   * 将页面加入buffer，并且写入磁盘中的共享表空间
+   * 将页面加入buffer，攒够一批后写入磁盘中的共享表空间，再写入页面所在的文件
    */
   virtual RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) = 0;
 
@@ -47,6 +48,7 @@ public:
 struct DoubleWriteBufferHeader
 {
   int32_t page_cnt = 0;
+  int64_t batch_id = 0;  ///< 最后一次写入的批次，只有属于这个批次的页面是有效的
 
   static const int32_t SIZE;
 };
@@ -81,7 +83,10 @@ struct DoubleWritePageKeyHash
  * 当我们从磁盘中读取页面时，会校验页面的checksum，如果校验失败，则说明页面写入不完整，这时候可以从
  * DoubleWriteBuffer中读取数据。
  *
- * @note 每次都要保证，不管在内存中还是在文件中，这里的数据都是最新的，都比Buffer pool中的数据要新
+ * 页面先保存在内存中，攒够一批后，连同文件头一起使用一次顺序写入共享文件并sync一次，然后把这批页面
+ * 一起写入各自的文件，每个文件sync一次。内存中还没有写入共享文件的页面，在页面所在文件中的旧数据是完整的，
+ * 丢失的修改由redo日志恢复，所以做检查点之前要调用 flush_page。
+ * 文件头和每个页面都记录了批次编号，启动时只加载最后一个批次中的页面，不会用旧的页面覆盖新数据。
  */
 class DiskDoubleWriteBuffer : public DoubleWriteBuffer
 {
@@ -107,7 +112,7 @@ public:
   RC flush_page();
 
   /**
-   * 将页面加入buffer，并且写入磁盘中的共享表空间
+   * 将页面加入buffer，buffer满了之后把所有页面作为一批写入磁盘
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
@@ -119,7 +124,8 @@ public:
   RC clear_pages(DiskBufferPool *bp) override;
 
   /**
-   * 将共享表空间的页读入buffer
+   * 将启动时从共享表空间加载的页面写入对应的文件
+   * @details 所在的buffer pool没有打开的页面会被丢弃，比如表已经删除了
    */
   RC recover();
 
@@ -127,14 +133,14 @@ private:
   /**
    * 将buffer中的页面写入对应的磁盘
    */
-  RC write_page(DoubleWritePage *page);
+  RC flush_page_internal();
 
   /**
-   * 将页面写到当前double write buffer文件中
-   * @details 每次页面更新都应该写入到磁盘中。保证double write buffer
-   * 内存和文件中的数据都是最新的。
+   * @brief 写入一批页面
+   * @details 先把这批页面顺序写入共享文件并sync，再把页面作为一批请求提交给IO引擎写入各自的文件，
+   * 使用io_uring时这些写操作可以并发完成，最后每个文件sync一次。
    */
-  RC write_page_internal(DoubleWritePage *page);
+  RC write_pages(const std::vector<std::pair<DiskBufferPool *, DoubleWritePage *>> &pages);
 
   /**
    * @brief 将磁盘文件中的内容加载到内存中。在启动时调用
@@ -147,6 +153,7 @@ private:
   common::Mutex           lock_;
   BufferPoolManager      &bp_manager_;
   DoubleWriteBufferHeader header_;
+  int64_t                 next_batch_id_ = 1;
 
   std::unordered_map<DoubleWritePageKey, DoubleWritePage *, DoubleWritePageKeyHash> dblwr_pages_;
 };
@@ -157,7 +164,7 @@ public:
   virtual ~VacuousDoubleWriteBuffer() = default;
 
   /**
-   * 将页面加入buffer，并且写入磁盘中的共享表空间
+   * 直接将页面写入对应的文件
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
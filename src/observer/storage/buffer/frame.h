@@ -105,7 +105,20 @@ public:
    * 序列号要小，那就可以从日志中读取这些更大序列号的日志，做重做操作，将页面恢复到最新状态，也就是redo。
    */
   LSN  lsn() const { return page_.lsn; }
-  void set_lsn(LSN lsn) { page_.lsn = lsn; }
+  void set_lsn(LSN lsn)
+  {
+    page_.lsn = lsn;
+    if (recovery_lsn_.load() == 0) {
+      recovery_lsn_.store(lsn);
+    }
+  }
+
+  /**
+   * @brief 页面上一次刷盘之后第一次修改的日志序列号
+   * @details 页面刷盘之前，从这个LSN开始的日志都不能删除，做检查点时根据所有脏页的这个值计算从哪里开始恢复。
+   * 页面刷盘后清零。
+   */
+  LSN recovery_lsn() const { return recovery_lsn_.load(); }
 
   /**
    * @brief 页面校验和
@@ -133,11 +146,47 @@ public:
    * @brief 重置“脏”标记
    * @details 如果页面已经被写入磁盘文件，则应调用此函数。
    */
-  void clear_dirty() { dirty_ = false; }
+  void clear_dirty()
+  {
+    dirty_ = false;
+    recovery_lsn_.store(0);
+  }
   bool dirty() const { return dirty_; }
 
   char *data() { return page_.data; }
 
+  /**
+   * @brief 预读的页面在数据加载完成之前就放进了页帧管理器
+   * @details 其它线程找到这个页帧之后，需要等待加载完成才能访问页面数据。
+   * 加载失败时页帧已经从页帧管理器中删除了，等待的线程需要重新加载页面。
+   */
+  void set_loading() { load_state_.store(LOADING); }
+  void set_loaded(bool success)
+  {
+    load_state_.store(success ? LOADED : LOAD_FAILED);
+    load_state_.notify_all();
+  }
+
+  /**
+   * @brief 等待预读的页面加载完成
+   * @return 页面是否加载成功
+   */
+  bool wait_loaded() const
+  {
+    int state = load_state_.load();
+    while (state == LOADING) {
+      load_state_.wait(LOADING);
+      state = load_state_.load();
+    }
+    return state == LOADED;
+  }
+
+  /**
+   * @brief 页面是预读加载的并且还没有被访问过，用来统计预读的命中和浪费
+   */
+  void set_read_ahead(bool read_ahead) { read_ahead_.store(read_ahead); }
+  bool clear_read_ahead() { return read_ahead_.exchange(false); }
+
   bool can_purge() { return pin_count_.load() == 0; }
 
   /**
@@ -173,8 +222,16 @@ private:
   friend class BufferPool;
 
   bool             dirty_ = false;
+  std::atomic<LSN> recovery_lsn_{0};
   std::atomic<int> pin_count_{0};
   unsigned long    acc_time_ = 0;    //访问时间，此字段暂时没有实际作用
+
+  static constexpr int LOADED      = 0;
+  static constexpr int LOADING     = 1;
+  static constexpr int LOAD_FAILED = 2;
+
+  std::atomic<int>  load_state_{LOADED};
+  std::atomic<bool> read_ahead_{false};
   FrameId          frame_id_;
   Page             page_;
 
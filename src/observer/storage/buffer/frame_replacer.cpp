@@ -0,0 +1,132 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+
+#include "storage/buffer/frame_replacer.h"
+
+using namespace std;
+
+unique_ptr<FrameReplacer> FrameReplacer::create(const char *name)
+{
+  if (0 == strcasecmp(name, "lru")) {
+    return make_unique<LruFrameReplacer>();
+  }
+  if (0 == strcasecmp(name, "2q")) {
+    return make_unique<TwoQueueFrameReplacer>();
+  }
+
+  LOG_WARN("unknown replacement policy: %s", name);
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool TwoQueueFrameReplacer::get(const FrameId &frame_id, Frame *&frame)
+{
+  auto iter = index_.find(frame_id);
+  if (iter == index_.end()) {
+    return false;
+  }
+
+  Entry &entry = iter->second;
+  frame        = entry.iter->second;
+  if (entry.in_main) {
+    main_.splice(main_.end(), main_, entry.iter);
+  }
+  return true;
+}
+
+bool TwoQueueFrameReplacer::peek(const FrameId &frame_id, Frame *&frame) const
+{
+  auto iter = index_.find(frame_id);
+  if (iter == index_.end()) {
+    return false;
+  }
+
+  frame = iter->second.iter->second;
+  return true;
+}
+
+void TwoQueueFrameReplacer::put(const FrameId &frame_id, Frame *frame)
+{
+  Entry entry;
+  auto  out_iter = out_index_.find(frame_id);
+  if (out_iter != out_index_.end()) {
+    out_.erase(out_iter->second);
+    out_index_.erase(out_iter);
+
+    entry.in_main = true;
+    entry.iter    = main_.emplace(main_.end(), frame_id, frame);
+  } else {
+    entry.in_main = false;
+    entry.iter    = in_.emplace(in_.end(), frame_id, frame);
+  }
+  index_.emplace(frame_id, entry);
+}
+
+void TwoQueueFrameReplacer::remove(const FrameId &frame_id, bool evicted)
+{
+  auto iter = index_.find(frame_id);
+  if (iter == index_.end()) {
+    return;
+  }
+
+  Entry &entry = iter->second;
+  if (entry.in_main) {
+    main_.erase(entry.iter);
+    index_.erase(iter);
+    return;
+  }
+
+  in_.erase(entry.iter);
+  index_.erase(iter);
+  if (!evicted) {
+    return;
+  }
+
+  out_index_.emplace(frame_id, out_.emplace(out_.end(), frame_id));
+  const size_t max_out_num = max(index_.size() * OUT_PERCENT / 100, MIN_OUT_NUM);
+  while (out_.size() > max_out_num) {
+    out_index_.erase(out_.front());
+    out_.pop_front();
+  }
+}
+
+void TwoQueueFrameReplacer::foreach (const Visitor &visitor)
+{
+  if (foreach_oldest(main_, visitor)) {
+    (void)foreach_oldest(in_, visitor);
+  }
+}
+
+void TwoQueueFrameReplacer::foreach_victim(const Visitor &visitor)
+{
+  if (in_.size() * 100 > index_.size() * IN_PERCENT) {
+    if (foreach_oldest(in_, visitor)) {
+      (void)foreach_oldest(main_, visitor);
+    }
+  } else {
+    if (foreach_oldest(main_, visitor)) {
+      (void)foreach_oldest(in_, visitor);
+    }
+  }
+}
+
+bool TwoQueueFrameReplacer::foreach_oldest(FrameList &frames, const Visitor &visitor)
+{
+  for (const auto &[frame_id, frame] : frames) {
+    if (!visitor(frame_id, frame)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,175 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "common/lang/lru_cache.h"
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 页帧的替换策略
+ * @ingroup BufferPool
+ * @details 记录一个分片中所有的页帧，并决定页帧的淘汰顺序。调用者负责加锁，这里不是线程安全的。
+ * 当前有两种实现：
+ * - lru：最近最少使用的页面先淘汰；
+ * - 2q：第一次访问的页面放在一个先进先出的队列中，被淘汰之后很快又被访问的页面才会放到LRU链表中。
+ *   全表扫描只会在先进先出队列中进进出出，不会把B+树的内部节点等经常访问的页面挤出去。
+ * 可以在配置文件的 [STORAGE] REPLACEMENT_POLICY 中选择。
+ */
+class FrameReplacer
+{
+public:
+  using Visitor = std::function<bool(const FrameId &, Frame *const)>;
+
+  FrameReplacer()          = default;
+  virtual ~FrameReplacer() = default;
+
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief 访问一个页帧，会调整页帧的淘汰顺序
+   */
+  virtual bool get(const FrameId &frame_id, Frame *&frame) = 0;
+
+  /**
+   * @brief 查找一个页帧，不影响淘汰顺序
+   */
+  virtual bool peek(const FrameId &frame_id, Frame *&frame) const = 0;
+
+  /**
+   * @brief 加入一个新的页帧，调用者保证页帧不存在
+   */
+  virtual void put(const FrameId &frame_id, Frame *frame) = 0;
+
+  /**
+   * @brief 删除一个页帧
+   * @param evicted 是否是作为淘汰的页面删除的，删除文件或者放弃加载页面时是false
+   */
+  virtual void   remove(const FrameId &frame_id, bool evicted) = 0;
+  virtual size_t count() const                                 = 0;
+
+  /**
+   * @brief 遍历所有页帧，visitor返回false时停止
+   */
+  virtual void foreach (const Visitor &visitor) = 0;
+
+  /**
+   * @brief 按照淘汰顺序遍历页帧，最先淘汰的页帧最先访问
+   */
+  virtual void foreach_victim(const Visitor &visitor) = 0;
+
+  /**
+   * @brief 根据名字创建替换策略
+   * @return 不认识的名字返回nullptr
+   */
+  static std::unique_ptr<FrameReplacer> create(const char *name);
+};
+
+/**
+ * @brief LRU替换策略
+ * @ingroup BufferPool
+ */
+class LruFrameReplacer final : public FrameReplacer
+{
+public:
+  LruFrameReplacer()          = default;
+  virtual ~LruFrameReplacer() = default;
+
+  const char *name() const override { return "lru"; }
+
+  bool   get(const FrameId &frame_id, Frame *&frame) override { return frames_.get(frame_id, frame); }
+  bool   peek(const FrameId &frame_id, Frame *&frame) const override { return frames_.peek(frame_id, frame); }
+  void   put(const FrameId &frame_id, Frame *frame) override { frames_.put(frame_id, frame); }
+  void   remove(const FrameId &frame_id, bool evicted) override { frames_.remove(frame_id); }
+  size_t count() const override { return frames_.count(); }
+
+  void foreach (const Visitor &visitor) override { frames_.foreach (visitor); }
+  void foreach_victim(const Visitor &visitor) override { frames_.foreach_reverse(visitor); }
+
+private:
+  class FrameIdHasher
+  {
+  public:
+    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+  };
+
+  common::LruCache<FrameId, Frame *, FrameIdHasher> frames_;
+};
+
+/**
+ * @brief 2Q替换策略
+ * @ingroup BufferPool
+ * @details 参考 Johnson and Shasha, 2Q: A Low Overhead High Performance Buffer Management Replacement Algorithm.
+ * 页帧分别放在两个队列中：
+ * - A1in：第一次进入内存的页面，先进先出。在这个队列中再次被访问也不调整顺序，因为短时间内的多次访问，
+ *   比如扫描时逐条读取同一个页面上的记录，不能说明这个页面是热点；
+ * - Am：LRU链表，被访问时移到头部。
+ * A1in中的页面被淘汰后，只在A1out中记下页面编号，其它原因删除的页面不记录。A1out中的页面再次进入内存时，说明它在被淘汰之后很快
+ * 又被访问了，直接放到Am中。
+ * A1in中的页面个数超过总数的 IN_PERCENT 时优先淘汰A1in中的页面，否则优先淘汰Am中的页面。
+ */
+class TwoQueueFrameReplacer final : public FrameReplacer
+{
+public:
+  static constexpr size_t IN_PERCENT = 25;  ///< A1in 占所有页帧的比例
+  static constexpr size_t OUT_PERCENT = 50; ///< A1out 最多记录多少页面，相对于所有页帧的比例
+  static constexpr size_t MIN_OUT_NUM = 16;
+
+  TwoQueueFrameReplacer()          = default;
+  virtual ~TwoQueueFrameReplacer() = default;
+
+  const char *name() const override { return "2q"; }
+
+  bool   get(const FrameId &frame_id, Frame *&frame) override;
+  bool   peek(const FrameId &frame_id, Frame *&frame) const override;
+  void   put(const FrameId &frame_id, Frame *frame) override;
+  void   remove(const FrameId &frame_id, bool evicted) override;
+  size_t count() const override { return index_.size(); }
+
+  void foreach (const Visitor &visitor) override;
+  void foreach_victim(const Visitor &visitor) override;
+
+  size_t in_count() const { return in_.size(); }
+  size_t main_count() const { return main_.size(); }
+  size_t out_count() const { return out_.size(); }
+
+private:
+  class FrameIdHasher
+  {
+  public:
+    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+  };
+
+  using FrameList = std::list<std::pair<FrameId, Frame *>>;
+
+  struct Entry
+  {
+    bool                in_main = false;  ///< 在Am中还是在A1in中
+    FrameList::iterator iter;
+  };
+
+  /**
+   * @brief 按照从旧到新的顺序遍历一个队列
+   */
+  static bool foreach_oldest(FrameList &frames, const Visitor &visitor);
+
+private:
+  FrameList in_;    ///< A1in，新页面放在尾部
+  FrameList main_;  ///< Am，最近访问的页面放在尾部
+  std::unordered_map<FrameId, Entry, FrameIdHasher> index_;
+
+  std::list<FrameId>                                                    out_;  ///< A1out，新记录放在尾部
+  std::unordered_map<FrameId, std::list<FrameId>::iterator, FrameIdHasher> out_index_;
+};
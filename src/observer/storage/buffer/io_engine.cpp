@@ -0,0 +1,404 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/buffer/io_engine.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+static RC io_error(const IoRequest &request)
+{
+  return request.type == IoRequest::Type::READ ? RC::IOERR_READ : RC::IOERR_WRITE;
+}
+
+RC IoEngine::read(int fd, int64_t offset, void *buf, int64_t size)
+{
+  IoRequest request{IoRequest::Type::READ, fd, offset, buf, size};
+  return submit(span<IoRequest>(&request, 1));
+}
+
+RC IoEngine::write(int fd, int64_t offset, const void *buf, int64_t size)
+{
+  IoRequest request{IoRequest::Type::WRITE, fd, offset, const_cast<void *>(buf), size};
+  return submit(span<IoRequest>(&request, 1));
+}
+
+unique_ptr<IoEngine> IoEngine::create(const char *name)
+{
+  if (0 == strcasecmp(name, "pread")) {
+    return make_unique<PreadIoEngine>();
+  }
+
+  if (0 == strcasecmp(name, "io_uring")) {
+    auto engine = make_unique<IoUringEngine>();
+    RC   rc     = engine->init();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init io_uring, use pread instead. rc=%s", strrc(rc));
+      return make_unique<PreadIoEngine>();
+    }
+    return engine;
+  }
+
+  LOG_WARN("unknown io engine: %s", name);
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC PreadIoEngine::submit(span<IoRequest> requests)
+{
+  RC rc = RC::SUCCESS;
+  for (IoRequest &request : requests) {
+    request.rc = execute(request);
+    if (OB_FAIL(request.rc) && OB_SUCC(rc)) {
+      rc = request.rc;
+    }
+  }
+  return rc;
+}
+
+RC PreadIoEngine::execute(IoRequest &request, int64_t done /* = 0 */)
+{
+  char *buf = static_cast<char *>(request.buf);
+  while (done < request.size) {
+    ssize_t ret = 0;
+    if (request.type == IoRequest::Type::READ) {
+      ret = ::pread(request.fd, buf + done, request.size - done, request.offset + done);
+    } else {
+      ret = ::pwrite(request.fd, buf + done, request.size - done, request.offset + done);
+    }
+
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      LOG_WARN("failed to %s file. fd=%d, offset=%ld, size=%ld, done=%ld, ret=%ld, error=%s",
+          request.type == IoRequest::Type::READ ? "read" : "write",
+          request.fd, request.offset, request.size, done, ret, ret < 0 ? strerror(errno) : "end of file");
+      return io_error(request);
+    }
+    done += ret;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 一个io_uring，包括提交队列和完成队列
+ * @details 使用时需要持有lock
+ */
+class IoUringEngine::Ring
+{
+public:
+  Ring() = default;
+  ~Ring();
+
+  RC init(unsigned entries);
+
+  /**
+   * @brief 提交不超过 entries() 个请求，等待全部完成
+   */
+  RC submit(span<IoRequest> requests);
+
+  unsigned entries() const { return sq_entries_; }
+
+  /**
+   * @brief 系统调用出错时，提交队列中可能还有没有被内核取走的请求，这个io_uring不能再使用了
+   */
+  bool broken() const { return broken_; }
+
+public:
+  mutex lock;
+
+private:
+  /**
+   * @brief 收割完成队列中已经完成的请求
+   * @param[in,out] done 每个请求是否已经完成
+   * @param[in,out] rc   第一个失败的请求的错误码
+   * @return 这次收割的请求个数
+   */
+  size_t reap(span<IoRequest> requests, vector<bool> &done, RC &rc);
+
+  /**
+   * @brief io_uring_enter 出错之后，等待已经被内核取走的请求全部完成
+   * @details 内核可能还在读写这些请求的内存，返回之前调用者就会释放或者重用它们
+   */
+  void wait_inflight(span<IoRequest> requests, vector<bool> &done, size_t inflight, RC &rc);
+
+private:
+  int  fd_     = -1;
+  bool broken_ = false;
+
+  void  *sq_ring_      = nullptr;
+  size_t sq_ring_size_ = 0;
+  void  *cq_ring_      = nullptr;
+  size_t cq_ring_size_ = 0;
+
+  io_uring_sqe *sqes_      = nullptr;
+  size_t        sqes_size_ = 0;
+
+  unsigned  sq_entries_ = 0;
+  unsigned *sq_head_    = nullptr;
+  unsigned *sq_tail_    = nullptr;
+  unsigned *sq_mask_    = nullptr;
+  unsigned *sq_array_   = nullptr;
+
+  unsigned     *cq_head_ = nullptr;
+  unsigned     *cq_tail_ = nullptr;
+  unsigned     *cq_mask_ = nullptr;
+  io_uring_cqe *cqes_    = nullptr;
+};
+
+IoUringEngine::Ring::~Ring()
+{
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+RC IoUringEngine::Ring::init(unsigned entries)
+{
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd_ < 0) {
+    LOG_WARN("failed to setup io_uring. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    LOG_WARN("failed to mmap io_uring submission queue. error=%s", strerror(errno));
+    return RC::NOMEM;
+  }
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      LOG_WARN("failed to mmap io_uring completion queue. error=%s", strerror(errno));
+      return RC::NOMEM;
+    }
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    LOG_WARN("failed to mmap io_uring submission entries. error=%s", strerror(errno));
+    return RC::NOMEM;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  char *sq_ring = static_cast<char *>(sq_ring_);
+  char *cq_ring = static_cast<char *>(cq_ring_);
+
+  sq_entries_ = params.sq_entries;
+  sq_head_    = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.head);
+  sq_tail_    = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.tail);
+  sq_mask_    = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.ring_mask);
+  sq_array_   = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.array);
+  cq_head_    = reinterpret_cast<unsigned *>(cq_ring + params.cq_off.head);
+  cq_tail_    = reinterpret_cast<unsigned *>(cq_ring + params.cq_off.tail);
+  cq_mask_    = reinterpret_cast<unsigned *>(cq_ring + params.cq_off.ring_mask);
+  cqes_       = reinterpret_cast<io_uring_cqe *>(cq_ring + params.cq_off.cqes);
+  return RC::SUCCESS;
+}
+
+RC IoUringEngine::Ring::submit(span<IoRequest> requests)
+{
+  // 只有持有锁的线程会修改提交队列的尾部和完成队列的头部。上一次提交的请求都已经被内核取走了
+  const unsigned sq_start = *sq_tail_;
+  unsigned       sq_tail  = sq_start;
+  for (size_t i = 0; i < requests.size(); i++) {
+    IoRequest &request = requests[i];
+
+    const unsigned index = sq_tail & *sq_mask_;
+    io_uring_sqe  *sqe   = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = request.type == IoRequest::Type::READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd        = request.fd;
+    sqe->off       = static_cast<uint64_t>(request.offset);
+    sqe->addr      = reinterpret_cast<uint64_t>(request.buf);
+    sqe->len       = static_cast<uint32_t>(request.size);
+    sqe->user_data = i;
+    sq_array_[index] = index;
+    sq_tail++;
+  }
+  __atomic_store_n(sq_tail_, sq_tail, __ATOMIC_RELEASE);
+
+  RC           rc        = RC::SUCCESS;
+  vector<bool> done(requests.size(), false);
+  size_t       to_submit = requests.size();
+  size_t       completed = 0;
+  while (completed < requests.size()) {
+    const size_t wait_num = requests.size() - completed;
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, fd_, to_submit, wait_num, IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG_ERROR("failed to enter io_uring. error=%s", strerror(errno));
+      broken_ = true;
+      break;
+    }
+    to_submit -= min(to_submit, static_cast<size_t>(ret));
+    completed += reap(requests, done, rc);
+  }
+
+  if (!broken_) {
+    return rc;
+  }
+
+  // 内核取走的请求要等它们完成，没有取走的请求永远不会再执行了，同步地完成它们
+  const size_t submitted = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) - sq_start;
+  wait_inflight(requests, done, submitted - completed, rc);
+  for (size_t i = 0; i < requests.size(); i++) {
+    if (!done[i]) {
+      requests[i].rc = PreadIoEngine::execute(requests[i]);
+      if (OB_FAIL(requests[i].rc) && OB_SUCC(rc)) {
+        rc = requests[i].rc;
+      }
+    }
+  }
+  return rc;
+}
+
+size_t IoUringEngine::Ring::reap(span<IoRequest> requests, vector<bool> &done, RC &rc)
+{
+  size_t         reaped  = 0;
+  unsigned       cq_head = *cq_head_;
+  const unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; cq_head != cq_tail; cq_head++) {
+    const io_uring_cqe *cqe     = &cqes_[cq_head & *cq_mask_];
+    IoRequest          &request = requests[cqe->user_data];
+    if (cqe->res < 0) {
+      LOG_WARN("io_uring request failed. fd=%d, offset=%ld, size=%ld, error=%s",
+          request.fd, request.offset, request.size, strerror(-cqe->res));
+      request.rc = io_error(request);
+    } else {
+      // 读写的字节数不够时同步补齐
+      request.rc = PreadIoEngine::execute(request, cqe->res);
+    }
+
+    if (OB_FAIL(request.rc) && OB_SUCC(rc)) {
+      rc = request.rc;
+    }
+    done[cqe->user_data] = true;
+    reaped++;
+  }
+  __atomic_store_n(cq_head_, cq_head, __ATOMIC_RELEASE);
+  return reaped;
+}
+
+void IoUringEngine::Ring::wait_inflight(span<IoRequest> requests, vector<bool> &done, size_t inflight, RC &rc)
+{
+  while (inflight > 0) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, fd_, 0, inflight, IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (ret < 0 && errno != EINTR) {
+      // 不能在内核中等待时轮询完成队列。有些完成事件要在当前线程从系统调用返回时才写入，所以用usleep让出CPU
+      usleep(1000);
+    }
+    inflight -= min(inflight, reap(requests, done, rc));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+IoUringEngine::~IoUringEngine() = default;
+
+RC IoUringEngine::init()
+{
+  for (int i = 0; i < RING_NUM; i++) {
+    auto ring = make_unique<Ring>();
+    RC   rc   = ring->init(RING_ENTRIES);
+    if (OB_FAIL(rc)) {
+      rings_.clear();
+      return rc;
+    }
+    rings_.push_back(std::move(ring));
+  }
+  LOG_INFO("io_uring engine initialized. ring num=%d, entries=%u", RING_NUM, rings_[0]->entries());
+  return RC::SUCCESS;
+}
+
+RC IoUringEngine::submit(span<IoRequest> requests)
+{
+  if (requests.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 优先使用空闲的io_uring，都在使用时轮流等待
+  const uint32_t     start = next_ring_.fetch_add(1, memory_order_relaxed);
+  Ring              *ring  = nullptr;
+  unique_lock<mutex> guard;
+  for (int i = 0; i < RING_NUM && ring == nullptr; i++) {
+    Ring *candidate = rings_[(start + i) % RING_NUM].get();
+    guard           = unique_lock<mutex>(candidate->lock, try_to_lock);
+    if (guard.owns_lock()) {
+      ring = candidate;
+    }
+  }
+  if (ring == nullptr) {
+    ring  = rings_[start % RING_NUM].get();
+    guard = unique_lock<mutex>(ring->lock);
+  }
+
+  if (ring->broken()) {
+    PreadIoEngine pread_engine;
+    return pread_engine.submit(requests);
+  }
+
+  RC rc = RC::SUCCESS;
+  for (size_t offset = 0; offset < requests.size(); offset += ring->entries()) {
+    const size_t count = min(static_cast<size_t>(ring->entries()), requests.size() - offset);
+    RC           ret   = RC::SUCCESS;
+    if (ring->broken()) {
+      // 前一批请求提交失败，剩下的请求同步完成
+      PreadIoEngine pread_engine;
+      ret = pread_engine.submit(requests.subspan(offset, count));
+    } else {
+      ret = ring->submit(requests.subspan(offset, count));
+    }
+    if (OB_FAIL(ret) && OB_SUCC(rc)) {
+      rc = ret;
+    }
+  }
+  return rc;
+}
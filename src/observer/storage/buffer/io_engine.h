@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "common/rc.h"
+
+/**
+ * @brief 一个读或写文件的请求
+ * @ingroup BufferPool
+ */
+struct IoRequest
+{
+  enum class Type
+  {
+    READ,
+    WRITE,
+  };
+
+  Type    type   = Type::READ;
+  int     fd     = -1;
+  int64_t offset = 0;        ///< 在文件中的位置
+  void   *buf    = nullptr;
+  int64_t size   = 0;
+  RC      rc     = RC::SUCCESS;  ///< 请求完成之后的结果
+};
+
+/**
+ * @brief 读写页面的IO引擎
+ * @ingroup BufferPool
+ * @details 所有的请求都指定了在文件中的位置，不依赖文件的当前偏移，所以多个线程可以同时读写同一个文件。
+ * 当前有两种实现：
+ * - pread：使用 pread/pwrite 同步地逐个完成请求；
+ * - io_uring：一批请求一次提交给内核，由内核并发地完成，再一起收割结果。
+ * 可以在配置文件的 [STORAGE] IO_ENGINE 中选择，系统不支持io_uring时使用pread。
+ */
+class IoEngine
+{
+public:
+  IoEngine()          = default;
+  virtual ~IoEngine() = default;
+
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief 提交一批请求并等待全部完成
+   * @details 每个请求的结果记录在请求的rc中
+   * @return 第一个失败的请求的错误码
+   */
+  virtual RC submit(std::span<IoRequest> requests) = 0;
+
+  RC read(int fd, int64_t offset, void *buf, int64_t size);
+  RC write(int fd, int64_t offset, const void *buf, int64_t size);
+
+  /**
+   * @brief 根据名字创建IO引擎
+   * @details io_uring 初始化失败时退化为 pread
+   * @return 不认识的名字返回nullptr
+   */
+  static std::unique_ptr<IoEngine> create(const char *name);
+};
+
+/**
+ * @brief 使用 pread/pwrite 的IO引擎
+ * @ingroup BufferPool
+ */
+class PreadIoEngine final : public IoEngine
+{
+public:
+  PreadIoEngine()          = default;
+  virtual ~PreadIoEngine() = default;
+
+  const char *name() const override { return "pread"; }
+
+  RC submit(std::span<IoRequest> requests) override;
+
+  /**
+   * @brief 同步地完成一个请求，也用来补齐io_uring没有读写完的部分
+   * @param done 已经读写完成的字节数
+   */
+  static RC execute(IoRequest &request, int64_t done = 0);
+};
+
+/**
+ * @brief 使用 io_uring 的IO引擎
+ * @ingroup BufferPool
+ * @details 没有依赖liburing，直接使用系统调用。一个io_uring的提交和收割不是线程安全的，
+ * 这里准备了几个io_uring，每次提交时使用一个空闲的，所以多个线程可以同时提交请求。
+ */
+class IoUringEngine final : public IoEngine
+{
+public:
+  static constexpr int      RING_NUM     = 4;
+  static constexpr unsigned RING_ENTRIES = 64;
+
+  IoUringEngine() = default;
+  virtual ~IoUringEngine();
+
+  RC init();
+
+  const char *name() const override { return "io_uring"; }
+
+  RC submit(std::span<IoRequest> requests) override;
+
+private:
+  class Ring;
+
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::atomic<uint32_t>              next_ring_{0};  ///< 所有io_uring都在使用时，轮流等待
+};
@@ -0,0 +1,148 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <vector>
+
+#include "storage/buffer/page_cleaner.h"
+#include "common/log/log.h"
+#include "common/thread/thread_util.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace common;
+
+PageCleaner::~PageCleaner() { stop(); }
+
+RC PageCleaner::start()
+{
+  lock_guard<mutex> guard(lock_);
+  if (thread_) {
+    LOG_WARN("page cleaner has been started");
+    return RC::INTERNAL;
+  }
+
+  running_ = true;
+  thread_  = make_unique<thread>(&PageCleaner::thread_func, this);
+  return RC::SUCCESS;
+}
+
+void PageCleaner::stop()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!thread_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+
+  thread_->join();
+  thread_.reset();
+  LOG_INFO("page cleaner stopped");
+}
+
+void PageCleaner::wake_up()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (waked_) {
+      return;
+    }
+    waked_ = true;
+  }
+  cond_.notify_all();
+}
+
+void PageCleaner::thread_func()
+{
+  thread_set_name("PageCleaner");
+  LOG_INFO("page cleaner started");
+
+  auto last_stat_time = chrono::steady_clock::now();
+
+  unique_lock<mutex> guard(lock_);
+  while (running_) {
+    guard.unlock();
+    const int flushed = clean_once();
+
+    const auto now = chrono::steady_clock::now();
+    if (now - last_stat_time >= STAT_INTERVAL) {
+      bpm_.log_stat();
+      last_stat_time = now;
+    }
+    guard.lock();
+
+    // 刷满一轮说明脏页还很多，前台等待空闲页帧时也不能停下来
+    const bool busy = flushed >= MAX_FLUSH_PAGES || (waked_ && flushed > 0);
+    waked_          = false;
+    if (!busy) {
+      cond_.wait_for(guard, CLEAN_INTERVAL, [this]() { return !running_ || waked_; });
+    }
+  }
+}
+
+int PageCleaner::clean_once()
+{
+  BPFrameManager &frame_manager = bpm_.get_frame_manager();
+  const size_t    capacity      = frame_manager.total_frame_num();
+  if (capacity == 0) {
+    return 0;
+  }
+
+  int flushed = 0;
+
+  // 先保证淘汰页面时有干净的页面可以用
+  const size_t used_num  = frame_manager.frame_num();
+  const size_t free_num  = capacity > used_num ? capacity - used_num : 0;
+  const size_t watermark = static_cast<size_t>(capacity * FREE_FRAME_RATIO);
+  if (free_num <= watermark) {
+    const int       depth = max(1, static_cast<int>(watermark) / frame_manager.shard_num());
+    vector<FrameId> frame_ids;
+    frame_manager.lru_tail_dirty_frames(depth, frame_ids);
+    for (const FrameId &frame_id : frame_ids) {
+      if (clean_page(frame_id)) {
+        flushed++;
+      }
+    }
+  }
+
+  // 再按照recovery lsn的顺序刷新最早修改的页面，控制脏页的比例
+  vector<BPDirtyFrame> dirty_frames;
+  frame_manager.dirty_frames(dirty_frames);
+  const double dirty_ratio = static_cast<double>(dirty_frames.size()) / capacity;
+  if (dirty_ratio > DIRTY_RATIO_LOW) {
+    const double pressure  = min(1.0, (dirty_ratio - DIRTY_RATIO_LOW) / (DIRTY_RATIO_HIGH - DIRTY_RATIO_LOW));
+    const size_t flush_num = min(dirty_frames.size(), static_cast<size_t>(max(1.0, MAX_FLUSH_PAGES * pressure)));
+    for (size_t i = 0; i < flush_num; i++) {
+      if (clean_page(dirty_frames[i].frame_id)) {
+        flushed++;
+      }
+    }
+  }
+
+  if (flushed > 0) {
+    LOG_DEBUG("page cleaner flushed %d pages. free frames=%ld, dirty frames=%ld, capacity=%ld",
+        flushed, free_num, dirty_frames.size(), capacity);
+  }
+  return flushed;
+}
+
+bool PageCleaner::clean_page(const FrameId &frame_id)
+{
+  bool flushed = false;
+  RC   rc      = bpm_.clean_page(frame_id, flushed);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to clean page. frame id=%s, rc=%s", frame_id.to_string().c_str(), strrc(rc));
+    return false;
+  }
+  return flushed;
+}
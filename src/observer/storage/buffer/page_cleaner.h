@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common/rc.h"
+
+class BufferPoolManager;
+class FrameId;
+
+/**
+ * @brief 后台刷脏页的线程
+ * @ingroup BufferPool
+ * @details 淘汰页面时如果遇到脏页，需要先等待日志落盘，再把页面写入double write buffer，
+ * 这些都发生在前台查询的线程中。后台线程提前把脏页刷新出去，让淘汰页面时几乎总是能找到干净的页面。
+ * 每一轮做两件事：
+ * 1. 空闲页帧少于 FREE_FRAME_RATIO 时，刷新每个分片LRU链表尾部最先被淘汰的脏页；
+ * 2. 脏页比例超过 DIRTY_RATIO_LOW 时，按照recovery lsn从小到大刷新脏页，这样检查点也可以向前推进。
+ *    脏页比例越高每轮刷得越多，超过 DIRTY_RATIO_HIGH 时每轮刷 MAX_FLUSH_PAGES 个页面。
+ * 每轮结束后等待 CLEAN_INTERVAL，压力仍然很大或者前台没有空闲页帧时立即开始下一轮。
+ * 另外每隔 STAT_INTERVAL 把buffer pool的统计信息打印到日志中。
+ */
+class PageCleaner
+{
+public:
+  static constexpr double                    FREE_FRAME_RATIO = 0.05;
+  static constexpr double                    DIRTY_RATIO_LOW  = 0.10;
+  static constexpr double                    DIRTY_RATIO_HIGH = 0.75;
+  static constexpr int                       MAX_FLUSH_PAGES  = 128;
+  static constexpr std::chrono::milliseconds CLEAN_INTERVAL{1000};
+  static constexpr std::chrono::seconds      STAT_INTERVAL{60};
+
+  explicit PageCleaner(BufferPoolManager &bpm) : bpm_(bpm) {}
+  ~PageCleaner();
+
+  RC   start();
+  void stop();
+
+  /**
+   * @brief 让后台线程立即开始下一轮
+   */
+  void wake_up();
+
+  /**
+   * @brief 执行一轮刷脏页
+   * @return 这一轮刷新的页面个数
+   */
+  int clean_once();
+
+private:
+  void thread_func();
+
+  /**
+   * @brief 刷新一轮中选出来的一个页面
+   * @return 是否刷新了这个页面
+   */
+  bool clean_page(const FrameId &frame_id);
+
+private:
+  BufferPoolManager &bpm_;
+
+  std::mutex                   lock_;
+  std::condition_variable      cond_;
+  bool                         running_ = false;
+  bool                         waked_   = false;
+  std::unique_ptr<std::thread> thread_;
+};
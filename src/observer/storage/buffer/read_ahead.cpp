@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "storage/buffer/read_ahead.h"
+#include "common/log/log.h"
+#include "common/thread/thread_util.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace common;
+
+ReadAheadWorker::~ReadAheadWorker() { stop(); }
+
+RC ReadAheadWorker::start()
+{
+  lock_guard<mutex> guard(lock_);
+  if (thread_) {
+    LOG_WARN("read ahead worker has been started");
+    return RC::INTERNAL;
+  }
+
+  running_ = true;
+  thread_  = make_unique<thread>(&ReadAheadWorker::thread_func, this);
+  return RC::SUCCESS;
+}
+
+void ReadAheadWorker::stop()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!thread_) {
+      return;
+    }
+    running_ = false;
+    requests_.clear();
+  }
+  cond_.notify_all();
+
+  thread_->join();
+  thread_.reset();
+  LOG_INFO("read ahead worker stopped. requests=%lu, dropped=%lu", request_count(), dropped_count());
+}
+
+bool ReadAheadWorker::submit(int32_t buffer_pool_id, PageNum start_page, int page_count)
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!running_) {
+      return false;
+    }
+
+    request_count_.fetch_add(1, memory_order_relaxed);
+    if (requests_.size() >= MAX_PENDING_REQUESTS) {
+      dropped_count_.fetch_add(1, memory_order_relaxed);
+      return false;
+    }
+    requests_.push_back(Request{buffer_pool_id, start_page, page_count});
+  }
+  cond_.notify_one();
+  return true;
+}
+
+void ReadAheadWorker::thread_func()
+{
+  thread_set_name("ReadAhead");
+  LOG_INFO("read ahead worker started");
+
+  unique_lock<mutex> guard(lock_);
+  while (running_) {
+    if (requests_.empty()) {
+      cond_.wait(guard, [this]() { return !running_ || !requests_.empty(); });
+      continue;
+    }
+
+    Request request = requests_.front();
+    requests_.pop_front();
+    guard.unlock();
+
+    int read_count = 0;
+    RC  rc         = bpm_.read_ahead(request.buffer_pool_id, request.start_page, request.page_count, read_count);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to read ahead. buffer pool id=%d, start page=%d, page count=%d, rc=%s",
+          request.buffer_pool_id, request.start_page, request.page_count, strrc(rc));
+    }
+
+    guard.lock();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ReadAheadTracker::reset(DiskBufferPool *buffer_pool)
+{
+  buffer_pool_      = buffer_pool;
+  last_page_num_    = BP_INVALID_PAGE_NUM;
+  sequential_count_ = 0;
+  read_ahead_end_   = BP_INVALID_PAGE_NUM;
+}
+
+void ReadAheadTracker::access(PageNum page_num, PageNum next_page_num /* = BP_INVALID_PAGE_NUM */)
+{
+  if (nullptr == buffer_pool_) {
+    return;
+  }
+
+  // BufferPoolIterator 会跳过没有分配的页面，所以编号有小的间隔也当做顺序访问
+  if (last_page_num_ != BP_INVALID_PAGE_NUM && page_num > last_page_num_ &&
+      page_num - last_page_num_ <= READ_AHEAD_PAGES) {
+    sequential_count_++;
+  } else {
+    sequential_count_ = 1;
+    read_ahead_end_   = page_num + 1;
+  }
+  last_page_num_ = page_num;
+
+  if (sequential_count_ >= SEQUENTIAL_THRESHOLD && read_ahead_end_ - page_num <= READ_AHEAD_PAGES / 2) {
+    const PageNum start_page = max(read_ahead_end_, page_num + 1);
+    read_ahead_end_          = page_num + 1 + READ_AHEAD_PAGES;
+    buffer_pool_->hint_read_ahead(start_page, read_ahead_end_ - start_page);
+  }
+
+  if (next_page_num != BP_INVALID_PAGE_NUM && (next_page_num <= page_num || next_page_num >= read_ahead_end_)) {
+    buffer_pool_->hint_read_ahead(next_page_num, 1);
+  }
+}
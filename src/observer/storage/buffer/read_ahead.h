@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+class BufferPoolManager;
+class DiskBufferPool;
+
+/**
+ * @brief 后台预读页面的线程
+ * @ingroup BufferPool
+ * @details 扫描表或者索引时，每个没有缓存的页面都要同步地读一次磁盘。扫描器发现自己在顺序访问页面时，
+ * 把后面要访问的页面提交给这个线程，由它一次读取一批页面放到页帧中，扫描器访问到的时候就不需要再读磁盘了。
+ * 预读只是一个优化，队列满了就丢弃新的请求。
+ */
+class ReadAheadWorker
+{
+public:
+  static constexpr size_t MAX_PENDING_REQUESTS = 64;
+
+  explicit ReadAheadWorker(BufferPoolManager &bpm) : bpm_(bpm) {}
+  ~ReadAheadWorker();
+
+  RC   start();
+  void stop();
+
+  /**
+   * @brief 提交一个预读请求
+   * @return 线程没有启动或者队列已满时返回false
+   */
+  bool submit(int32_t buffer_pool_id, PageNum start_page, int page_count);
+
+  uint64_t request_count() const { return request_count_.load(std::memory_order_relaxed); }
+  uint64_t dropped_count() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+private:
+  void thread_func();
+
+private:
+  struct Request
+  {
+    int32_t buffer_pool_id = -1;
+    PageNum start_page     = BP_INVALID_PAGE_NUM;
+    int     page_count     = 0;
+  };
+
+  BufferPoolManager &bpm_;
+
+  std::mutex                   lock_;
+  std::condition_variable      cond_;
+  bool                         running_ = false;
+  std::deque<Request>          requests_;
+  std::unique_ptr<std::thread> thread_;
+
+  std::atomic<uint64_t> request_count_{0};
+  std::atomic<uint64_t> dropped_count_{0};
+};
+
+/**
+ * @brief 识别一个扫描是否在顺序访问页面，并提前预读后面的页面
+ * @ingroup BufferPool
+ * @details 每个扫描器有一个自己的 ReadAheadTracker。连续 SEQUENTIAL_THRESHOLD 个页面的编号都在递增，
+ * 就认为是顺序访问，预读后面的 READ_AHEAD_PAGES 个页面。预读的页面用掉一半之后，再预读下一批。
+ * 访问页面时也可以告诉它下一个要访问的页面，比如B+树叶子节点的兄弟节点，不在预读范围内时单独预读这个页面。
+ */
+class ReadAheadTracker
+{
+public:
+  static constexpr int SEQUENTIAL_THRESHOLD = 2;
+  static constexpr int READ_AHEAD_PAGES     = 32;
+
+  /**
+   * @brief 开始一次新的扫描
+   * @param buffer_pool 为空时不做预读
+   */
+  void reset(DiskBufferPool *buffer_pool);
+
+  /**
+   * @brief 扫描访问了一个页面
+   * @param next_page_num 确定下一个要访问的页面时传入
+   */
+  void access(PageNum page_num, PageNum next_page_num = BP_INVALID_PAGE_NUM);
+
+private:
+  DiskBufferPool *buffer_pool_      = nullptr;
+  PageNum         last_page_num_    = BP_INVALID_PAGE_NUM;
+  int             sequential_count_ = 0;
+  PageNum         read_ahead_end_   = BP_INVALID_PAGE_NUM;  ///< 已经预读到的位置，不包含这个页面
+};
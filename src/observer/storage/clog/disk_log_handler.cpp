@@ -26,7 +26,13 @@ using namespace common;
 RC DiskLogHandler::init(const char *path)
 {
   const int max_entry_number_per_file = 1000;
-  return file_manager_.init(path, max_entry_number_per_file);
+  RC        rc                        = file_manager_.init(path, max_entry_number_per_file);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 没有回放日志时从0开始，回放之后会使用日志中最大的LSN重新初始化
+  return entry_buffer_.init(0);
 }
 
 RC DiskLogHandler::start()
@@ -50,6 +56,11 @@ RC DiskLogHandler::stop()
   }
 
   running_.store(false);
+  {
+    // 加锁保证等待的线程要么已经在等待，要么能看到running_的变化
+    lock_guard<mutex> guard(flushed_mutex_);
+  }
+  flushed_cond_.notify_all();
 
   LOG_INFO("log handler stopped");
   return RC::SUCCESS;
@@ -75,7 +86,8 @@ RC DiskLogHandler::await_termination()
 
 RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
 {
-  LSN max_lsn = 0;
+  // 检查点之后可能没有日志，之前的日志文件也可能已经删除了，LSN至少要从检查点继续
+  LSN max_lsn = start_lsn > 0 ? start_lsn - 1 : 0;
   auto replay_callback = [&replayer, &max_lsn](LogEntry &entry) -> RC {
     if (entry.lsn() > max_lsn) {
       max_lsn = entry.lsn();
@@ -94,6 +106,7 @@ RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
     LOG_WARN("failed to init log entry buffer. rc=%s", strrc(rc));
     return rc;
   }
+  flushed_lsn_.store(max_lsn);
 
   LOG_INFO("replay clog files done. start lsn=%ld, max_lsn=%ld", start_lsn, max_lsn);
   return rc;
@@ -149,9 +162,9 @@ RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
 
 RC DiskLogHandler::wait_lsn(LSN lsn)
 {
-  // 直接强制等待。在生产系统中，我们可能会使用条件变量来等待。
-  while (running_.load() && current_flushed_lsn() < lsn) {
-    this_thread::sleep_for(chrono::milliseconds(100));
+  if (current_flushed_lsn() < lsn) {
+    unique_lock<mutex> guard(flushed_mutex_);
+    flushed_cond_.wait(guard, [this, lsn]() { return !running_.load() || current_flushed_lsn() >= lsn; });
   }
 
   if (current_flushed_lsn() >= lsn) {
@@ -161,12 +174,22 @@ RC DiskLogHandler::wait_lsn(LSN lsn)
   }
 }
 
+void DiskLogHandler::set_flushed_lsn(LSN lsn)
+{
+  {
+    lock_guard<mutex> guard(flushed_mutex_);
+    flushed_lsn_.store(lsn);
+  }
+  flushed_cond_.notify_all();
+}
+
 void DiskLogHandler::thread_func()
 {
   /*
-  这个线程一直不停的循环，检查日志缓冲区中是否有日志在内存中，如果在内存中就刷新到磁盘。
-  这种做法很粗暴简单，与生产数据库的做法不同。生产数据库通常会在内存达到一定量，或者一定时间
-  之后，会刷新一下磁盘。这样做的好处是减少磁盘的IO次数，提高性能。
+  这个线程一直不停的循环，把日志缓冲区中的日志刷新到磁盘。
+  缓冲区中没有日志时，在缓冲区的条件变量上等待，有新的日志追加进来会立即被唤醒。
+  每一轮把缓冲区中所有的日志写入文件后只做一次sync，等待的线程越多，每次sync能持久化的日志就越多，
+  这就是组提交（group commit）。
   */
   thread_set_name("LogHandler");
   LOG_INFO("log handler thread started");
@@ -198,11 +221,25 @@ void DiskLogHandler::thread_func()
       LOG_WARN("failed to flush log entry buffer. rc=%s", strrc(rc));
     }
 
+    // 写入当前文件的日志必须在切换到下一个文件之前sync
+    const LSN written_lsn = entry_buffer_.flushed_lsn();
+    if (written_lsn > current_flushed_lsn()) {
+      RC sync_rc = file_writer.sync();
+      if (OB_FAIL(sync_rc)) {
+        LOG_WARN("failed to sync log file. file=%s, rc=%s", file_writer.to_string().c_str(), strrc(sync_rc));
+        // 不能切换文件，下一轮继续sync当前文件
+        rc = sync_rc;
+        this_thread::sleep_for(chrono::milliseconds(100));
+        continue;
+      }
+      set_flushed_lsn(written_lsn);
+    }
+
     if (flush_count == 0 && rc == RC::SUCCESS) {
-      this_thread::sleep_for(chrono::milliseconds(100));
-      continue;
+      // 追加日志时会唤醒，超时只是为了能够及时检查running_
+      entry_buffer_.wait_entries(chrono::milliseconds(100));
     }
   }
 
   LOG_INFO("log handler thread stopped");
-}
\ No newline at end of file
+}
@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <deque>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 
 #include "common/types.h"
 #include "common/rc.h"
@@ -33,6 +35,9 @@ class LogReplayer;
  * @ingroup CLog
  * @details 该模块负责日志的写入、读取、回放等功能。
  * 会在后台开启一个线程，一直尝试刷新内存中的日志到磁盘。
+ * 刷日志使用组提交的方式：后台线程在有日志追加时被唤醒，每次把缓冲区中所有的日志写入文件，
+ * 然后只做一次sync，再唤醒所有等待的LSN不超过刷盘位置的线程。
+ * 后台线程做sync的时候，新的日志会继续在缓冲区中累积，下一次一起刷盘。
  * 所有的CLog日志文件都存放在指定的目录下，每个日志文件按照日志条数来划分。
  * 调用的顺序应该是：
  * @code {.cpp}
@@ -93,15 +98,24 @@ public:
 
   /**
    * @brief 等待指定的日志刷盘
-   *
+   * @details 在条件变量上等待，后台线程刷盘之后会立即唤醒
    * @param lsn 想要等待的日志
    */
   RC wait_lsn(LSN lsn) override;
 
   /// @brief 当前的LSN
   LSN current_lsn() const override { return entry_buffer_.current_lsn(); }
-  /// @brief 当前刷新到哪个日志
-  LSN current_flushed_lsn() const { return entry_buffer_.flushed_lsn(); }
+  /// @brief 当前刷新到哪个日志，这个位置之前的日志都已经持久化了
+  LSN current_flushed_lsn() const { return flushed_lsn_.load(); }
+
+  /**
+   * @brief 删除所有日志都小于lsn的日志文件
+   * @details 正在写入的最后一个日志文件不会删除
+   */
+  RC truncate(LSN lsn) override { return file_manager_.remove_files(lsn); }
+
+  /// @brief 当前日志文件的个数
+  size_t log_file_num() const { return file_manager_.file_num(); }
 
 private:
   /**
@@ -119,6 +133,11 @@ private:
    */
   void thread_func();
 
+  /**
+   * @brief 记录最新的刷盘位置并唤醒等待的线程
+   */
+  void set_flushed_lsn(LSN lsn);
+
 private:
   std::unique_ptr<std::thread> thread_;          /// 刷新日志的线程
   std::atomic_bool             running_{false};  /// 是否还要继续运行
@@ -126,5 +145,9 @@ private:
   LogFileManager file_manager_;  /// 管理所有的日志文件
   LogEntryBuffer entry_buffer_;  /// 缓存日志
 
+  std::atomic<LSN>        flushed_lsn_{0};  /// 已经sync到磁盘的最大LSN
+  std::mutex              flushed_mutex_;   /// 与flushed_cond_配合使用
+  std::condition_variable flushed_cond_;    /// 等待日志刷盘的线程在这里等待
+
   std::string path_;  /// 日志文件存放的目录
 };
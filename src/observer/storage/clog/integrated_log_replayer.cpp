@@ -12,10 +12,14 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/02/04
 //
 
+#include <cstring>
+
 #include "storage/clog/integrated_log_replayer.h"
-#include "storage/clog/log_entry.h"
+#include "common/thread/thread_util.h"
+#include "storage/buffer/page.h"
 
 using namespace std;
+using namespace common;
 
 IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm)
     : buffer_pool_log_replayer_(bpm),
@@ -31,7 +35,154 @@ IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<
       trx_log_replayer_(std::move(trx_log_replayer))
 {}
 
+IntegratedLogReplayer::~IntegratedLogReplayer() { stop_workers(); }
+
+RC IntegratedLogReplayer::start_workers(int worker_num)
+{
+  if (!workers_.empty()) {
+    LOG_WARN("log replay workers have been started. worker num=%d", static_cast<int>(workers_.size()));
+    return RC::INTERNAL;
+  }
+
+  if (worker_num <= 1) {
+    return RC::SUCCESS;
+  }
+
+  for (int i = 0; i < worker_num; i++) {
+    workers_.push_back(make_unique<Worker>());
+  }
+  for (unique_ptr<Worker> &worker : workers_) {
+    worker->thread = thread(&IntegratedLogReplayer::worker_func, this, std::ref(*worker));
+  }
+  LOG_INFO("start parallel log replay. worker num=%d", worker_num);
+  return RC::SUCCESS;
+}
+
 RC IntegratedLogReplayer::replay(const LogEntry &entry)
+{
+  if (workers_.empty()) {
+    return replay_entry(entry);
+  }
+
+  RC rc = worker_rc_.load();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int index = worker_index(entry);
+  if (index < 0) {
+    return replay_entry(entry);
+  }
+
+  LogEntry copied_entry;
+  rc = copied_entry.init(entry.lsn(), entry.module(), vector<char>(entry.data(), entry.data() + entry.payload_size()));
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  Worker &worker = *workers_[index];
+  {
+    unique_lock<mutex> guard(worker.lock);
+    worker.cond.wait(guard, [&worker]() { return worker.entries.size() < MAX_WORKER_ENTRIES; });
+    worker.entries.push_back(std::move(copied_entry));
+  }
+  worker.cond.notify_all();
+  return RC::SUCCESS;
+}
+
+int IntegratedLogReplayer::worker_index(const LogEntry &entry) const
+{
+  int32_t buffer_pool_id = 0;
+  PageNum page_num       = BP_HEADER_PAGE;
+  switch (entry.module().id()) {
+    case LogModule::Id::BUFFER_POOL: {
+      // 只修改文件头页面
+      if (entry.payload_size() < static_cast<int32_t>(sizeof(BufferPoolLogEntry))) {
+        return -1;
+      }
+      buffer_pool_id = reinterpret_cast<const BufferPoolLogEntry *>(entry.data())->buffer_pool_id;
+    } break;
+    case LogModule::Id::RECORD_MANAGER: {
+      if (entry.payload_size() < RecordLogHeader::SIZE) {
+        return -1;
+      }
+      auto log_header = reinterpret_cast<const RecordLogHeader *>(entry.data());
+      buffer_pool_id  = log_header->buffer_pool_id;
+      page_num        = log_header->page_num;
+    } break;
+    case LogModule::Id::BPLUS_TREE: {
+      // 一条日志可能修改同一个索引文件的多个页面，所以同一个索引文件的日志都由一个线程回放，
+      // 与这个文件分配页面的日志也在同一个线程上
+      if (entry.payload_size() < static_cast<int32_t>(sizeof(buffer_pool_id))) {
+        return -1;
+      }
+      memcpy(&buffer_pool_id, entry.data(), sizeof(buffer_pool_id));
+    } break;
+    default: {
+      // 事务日志和无法识别的日志都在调用线程上回放
+      return -1;
+    }
+  }
+
+  const uint64_t key =
+      static_cast<uint64_t>(static_cast<uint32_t>(buffer_pool_id)) * 31 + static_cast<uint32_t>(page_num);
+  return static_cast<int>(key % workers_.size());
+}
+
+void IntegratedLogReplayer::worker_func(Worker &worker)
+{
+  thread_set_name("LogReplayer");
+
+  deque<LogEntry> entries;
+  while (true) {
+    {
+      unique_lock<mutex> guard(worker.lock);
+      worker.cond.wait(guard, [&worker]() { return worker.stopped || !worker.entries.empty(); });
+      if (worker.entries.empty()) {
+        break;
+      }
+      entries.swap(worker.entries);
+    }
+    worker.cond.notify_all();
+
+    for (const LogEntry &entry : entries) {
+      // 出错后仍然要取走队列中的日志，防止分发线程一直等待
+      if (OB_FAIL(worker_rc_.load())) {
+        break;
+      }
+
+      RC rc = replay_entry(entry);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to replay log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+        RC expected = RC::SUCCESS;
+        worker_rc_.compare_exchange_strong(expected, rc);
+      }
+    }
+    entries.clear();
+  }
+}
+
+RC IntegratedLogReplayer::stop_workers()
+{
+  for (unique_ptr<Worker> &worker : workers_) {
+    {
+      lock_guard<mutex> guard(worker->lock);
+      worker->stopped = true;
+    }
+    worker->cond.notify_all();
+  }
+
+  for (unique_ptr<Worker> &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  workers_.clear();
+  return worker_rc_.load();
+}
+
+RC IntegratedLogReplayer::replay_entry(const LogEntry &entry)
 {
   switch (entry.module().id()) {
     case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.replay(entry);
@@ -44,7 +195,14 @@ RC IntegratedLogReplayer::replay(const LogEntry &entry)
 
 RC IntegratedLogReplayer::on_done()
 {
-  RC rc = buffer_pool_log_replayer_.on_done();
+  // 回滚未完成的事务之前，所有页面的日志都要回放完
+  RC rc = stop_workers();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to replay page logs in parallel. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_log_replayer_.on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do buffer pool log replay. rc=%s", strrc(rc));
     return rc;
@@ -61,10 +219,12 @@ RC IntegratedLogReplayer::on_done()
     return rc;
   }
 
-  rc = trx_log_replayer_->on_done();
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
-    return rc;
+  if (trx_log_replayer_) {
+    rc = trx_log_replayer_->on_done();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
+      return rc;
+    }
   }
 
   return RC::SUCCESS;
@@ -14,6 +14,15 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "storage/clog/log_entry.h"
 #include "storage/clog/log_replayer.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/record/record_log.h"
@@ -25,7 +34,11 @@ class BufferPoolManager;
 /**
  * @brief 整体日志回放类
  * @ingroup Clog
- * @details 负责回放所有日志，是其它各模块日志回放的分发器
+ * @details 负责回放所有日志，是其它各模块日志回放的分发器。
+ * 默认在调用replay的线程上按顺序回放。调用 start_workers 之后并行回放：
+ * 修改页面的日志按照 (buffer pool, page) 分发到固定的工作线程，同一个页面的日志仍然按照LSN顺序回放。
+ * 事务日志只记录逻辑操作，不读写页面，依然在调用线程上按顺序回放。
+ * 所有页面日志在 on_done 中回放完成之后，才会回滚未完成的事务。
  */
 class IntegratedLogReplayer : public LogReplayer
 {
@@ -44,7 +57,13 @@ public:
    * 区别于另一个构造函数，这个构造函数可以指定不同的事务日志回放器。比如进程启动时可以指定选择使用VacuousTrx还是MvccTrx。
    */
   IntegratedLogReplayer(BufferPoolManager &bpm, std::unique_ptr<LogReplayer> trx_log_replayer);
-  virtual ~IntegratedLogReplayer() = default;
+  virtual ~IntegratedLogReplayer();
+
+  /**
+   * @brief 启动并行回放的工作线程
+   * @details 需要在回放第一条日志之前调用。worker_num 不大于1时仍然按顺序回放。
+   */
+  RC start_workers(int worker_num);
 
   //! @copydoc LogReplayer::replay
   RC replay(const LogEntry &entry) override;
@@ -52,9 +71,46 @@ public:
   //! @copydoc LogReplayer::on_done
   RC on_done() override;
 
+private:
+  /**
+   * @brief 并行回放的一个工作线程，按照收到的顺序回放队列中的日志
+   */
+  struct Worker
+  {
+    std::mutex              lock;
+    std::condition_variable cond;  ///< 队列不再为空、不再满或者需要停止时通知
+    std::deque<LogEntry>    entries;
+    bool                    stopped = false;
+    std::thread             thread;
+  };
+
+  /// 每个工作线程的队列中最多缓存的日志条数，避免读日志比回放快太多时占用过多内存
+  static constexpr size_t MAX_WORKER_ENTRIES = 4096;
+
+  /**
+   * @brief 按照日志所属的模块回放一条日志
+   */
+  RC replay_entry(const LogEntry &entry);
+
+  /**
+   * @brief 计算页面日志应该分发到哪个工作线程
+   * @return 不修改页面的日志返回 -1
+   */
+  int worker_index(const LogEntry &entry) const;
+
+  void worker_func(Worker &worker);
+
+  /**
+   * @brief 等待所有工作线程回放完队列中的日志后退出
+   */
+  RC stop_workers();
+
 private:
   BufferPoolLogReplayer        buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
   RecordLogReplayer            record_log_replayer_;       ///< record manager 日志回放器
   BplusTreeLogReplayer         bplus_tree_log_replayer_;   ///< bplus tree 日志回放器
   std::unique_ptr<LogReplayer> trx_log_replayer_;          ///< trx 日志回放器
+
+  std::vector<std::unique_ptr<Worker>> workers_;                     ///< 并行回放的工作线程，为空时按顺序回放
+  std::atomic<RC>                      worker_rc_{RC::SUCCESS};      ///< 工作线程第一次回放失败的错误码
 };
\ No newline at end of file
@@ -13,6 +13,9 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <mutex>
+#include <string.h>
+#include <sys/uio.h>
+
 #include "storage/clog/log_buffer.h"
 #include "storage/clog/log_file.h"
 
@@ -21,15 +24,47 @@ using namespace common;
 
 RC LogEntryBuffer::init(LSN lsn, int32_t max_bytes /*= 0*/)
 {
-  current_lsn_.store(lsn);
-  flushed_lsn_.store(lsn);
-
   if (max_bytes > 0) {
     max_bytes_ = max_bytes;
   }
+
+  // 环形内存的大小是2的幂，计算位置时可以直接使用位运算。至少要能容纳一条最大的日志
+  int64_t capacity = 1;
+  while (capacity < max_bytes_ || capacity < LogEntry::max_size()) {
+    capacity <<= 1;
+  }
+  if (capacity > MAX_CAPACITY) {
+    LOG_WARN("log buffer is too large. max_bytes=%d, max_capacity=%ld", max_bytes_, MAX_CAPACITY);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (capacity != capacity_) {
+    capacity_  = capacity;
+    data_      = make_unique<char[]>(capacity_);
+    // 每条日志至少有一个日志头，所以缓冲区中的日志条数不会超过这个值
+    ready_num_ = capacity_ / LogHeader::SIZE;
+    ready_     = make_unique<atomic<LSN>[]>(ready_num_);
+  }
+  for (int64_t i = 0; i < ready_num_; i++) {
+    ready_[i].store(0, memory_order_relaxed);
+  }
+
+  flushed_lsn_.store(lsn);
+  released_pos_.store(0);
+  reserved_.store(pack(lsn, 0));
   return RC::SUCCESS;
 }
 
+LSN LogEntryBuffer::unpack_lsn(uint64_t reserved, LSN base_lsn) const
+{
+  return base_lsn + static_cast<LSN>(((reserved >> POS_BITS) - static_cast<uint64_t>(base_lsn)) & LSN_MASK);
+}
+
+uint64_t LogEntryBuffer::unpack_pos(uint64_t reserved, uint64_t base_pos) const
+{
+  return base_pos + ((reserved - base_pos) & POS_MASK);
+}
+
 RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, vector<char> &&data)
 {
   return append(lsn, LogModule(module_id), std::move(data));
@@ -37,71 +72,174 @@ RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, vector<char> &&data
 
 RC LogEntryBuffer::append(LSN &lsn, LogModule module, vector<char> &&data)
 {
-  /// 控制当前buffer使用的内存
-  /// 简单粗暴，强制原地等待
-  /// 但是如果当前想要新插入的日志比较大，不会做控制。所以理论上容纳的最大buffer内存是2*max_bytes_
-  while (bytes_.load() >= max_bytes_) {
-    this_thread::sleep_for(chrono::milliseconds(10));
+  if (!data_) {
+    LOG_WARN("log buffer is not initialized");
+    return RC::INTERNAL;
   }
 
-  LogEntry entry;
-  RC rc = entry.init(lsn, module, std::move(data));
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to init log entry. rc=%s", strrc(rc));
-    return rc;
+  if (static_cast<int32_t>(data.size()) > LogEntry::max_payload_size()) {
+    LOG_DEBUG("log entry size is too large. size=%d, max_payload_size=%d", data.size(), LogEntry::max_payload_size());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  /// 预留LSN和内存。内存不足时等待刷日志的线程释放
+  const int64_t entry_size = LogHeader::SIZE + static_cast<int64_t>(data.size());
+  uint64_t      reserved   = 0;
+  uint64_t      start_pos  = 0;
+  while (true) {
+    // 先读released_pos再读reserved_。released_pos只会增长，不会超过之后才读到的预留位置
+    const uint64_t released_pos = released_pos_.load();
+    reserved                    = reserved_.load();
+    start_pos                   = unpack_pos(reserved, released_pos);
+    if (start_pos + entry_size - released_pos > static_cast<uint64_t>(capacity_)) {
+      wait_space(entry_size);
+      continue;
+    }
+
+    const uint64_t new_reserved = pack((reserved >> POS_BITS) + 1, start_pos + entry_size);
+    if (reserved_.compare_exchange_weak(reserved, new_reserved)) {
+      reserved = new_reserved;
+      break;
+    }
   }
+  // 自己的日志还没有写入文件，所以flushed_lsn一定比它小
+  lsn = unpack_lsn(reserved, flushed_lsn_.load());
 
-  lock_guard guard(mutex_);
-  lsn = ++current_lsn_;
-  entry.set_lsn(lsn);
+  /// 复制日志，这里不需要加锁
+  LogHeader header;
+  memset(&header, 0, sizeof(header));
+  header.lsn       = lsn;
+  header.size      = static_cast<int32_t>(data.size());
+  header.module_id = module.index();
+  copy_in(start_pos, &header, LogHeader::SIZE);
+  copy_in(start_pos + LogHeader::SIZE, data.data(), data.size());
 
-  entries_.push_back(std::move(entry));
-  bytes_ += entry.total_size();
+  /// 标记复制完成，如果刷日志的线程在等待就唤醒它
+  ready_[lsn % ready_num_].store(lsn);
+  if (flusher_waiting_.load()) {
+    lock_guard guard(mutex_);
+    entry_cond_.notify_one();
+  }
   return RC::SUCCESS;
 }
 
+bool LogEntryBuffer::has_space(int64_t entry_size) const
+{
+  const uint64_t released_pos = released_pos_.load();
+  const uint64_t start_pos    = unpack_pos(reserved_.load(), released_pos);
+  return start_pos + entry_size - released_pos <= static_cast<uint64_t>(capacity_);
+}
+
+void LogEntryBuffer::wait_space(int64_t entry_size)
+{
+  // 先增加等待计数再检查空间，刷日志的线程释放内存后要么能看到计数，要么这里能看到释放的内存
+  unique_lock guard(mutex_);
+  space_waiters_++;
+  space_cond_.wait_for(guard, chrono::milliseconds(10), [this, entry_size]() { return has_space(entry_size); });
+  space_waiters_--;
+}
+
+void LogEntryBuffer::copy_in(uint64_t pos, const void *data, int64_t size)
+{
+  const int64_t offset = static_cast<int64_t>(pos & (capacity_ - 1));
+  const int64_t first  = min(size, capacity_ - offset);
+  memcpy(data_.get() + offset, data, first);
+  memcpy(data_.get(), static_cast<const char *>(data) + first, size - first);
+}
+
+void LogEntryBuffer::copy_out(uint64_t pos, void *data, int64_t size) const
+{
+  const int64_t offset = static_cast<int64_t>(pos & (capacity_ - 1));
+  const int64_t first  = min(size, capacity_ - offset);
+  memcpy(data, data_.get() + offset, first);
+  memcpy(static_cast<char *>(data) + first, data_.get(), size - first);
+}
+
+bool LogEntryBuffer::entry_ready(LSN lsn) const { return ready_ && ready_[lsn % ready_num_].load() == lsn; }
+
 RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
 {
   count = 0;
 
-  while (entry_number() > 0) {
-    LogEntry entry;
-    {
-      lock_guard guard(mutex_);
-      if (entries_.empty()) {
-        break;
-      }
-
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      entry = std::move(entries_.front());
-      ASSERT(entry.payload_size() > 0 && entry.lsn() > 0, "invalid log entry");
-      entries_.pop_front();
-      bytes_ -= entry.total_size();
-    }
-    
-    RC rc = writer.write(entry);
-    if (OB_FAIL(rc)) {
-      lock_guard guard(mutex_);
-      entries_.emplace_front(std::move(entry));
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      return rc;
-    } else {
-      ++count;
-      flushed_lsn_ = entry.lsn();
+  // 只有当前线程会修改这两个值
+  const LSN      flushed_lsn  = flushed_lsn_.load();
+  const uint64_t released_pos = released_pos_.load();
+
+  RC       rc       = RC::SUCCESS;
+  LSN      last_lsn = flushed_lsn;
+  uint64_t end_pos  = released_pos;
+  while (entry_ready(last_lsn + 1)) {
+    // 一个日志文件写的日志条数是有限制的
+    if (last_lsn + 1 > writer.end_lsn()) {
+      rc = RC::LOG_FILE_FULL;
+      break;
     }
+
+    LogHeader header;
+    copy_out(end_pos, &header, LogHeader::SIZE);
+    ASSERT(header.lsn == last_lsn + 1 && header.size >= 0, "invalid log entry. header=%s", header.to_string().c_str());
+    end_pos += LogHeader::SIZE + header.size;
+    last_lsn++;
   }
-  
-  return RC::SUCCESS;
+
+  if (last_lsn == flushed_lsn) {
+    return rc;
+  }
+
+  // 连续的一段内存，回绕时分成两段
+  struct iovec  iov[2];
+  int           iovcnt = 0;
+  const int64_t offset = static_cast<int64_t>(released_pos & (capacity_ - 1));
+  const int64_t size   = static_cast<int64_t>(end_pos - released_pos);
+  const int64_t first  = min(size, capacity_ - offset);
+  iov[iovcnt].iov_base = data_.get() + offset;
+  iov[iovcnt].iov_len  = first;
+  iovcnt++;
+  if (size > first) {
+    iov[iovcnt].iov_base = data_.get();
+    iov[iovcnt].iov_len  = size - first;
+    iovcnt++;
+  }
+
+  RC write_rc = writer.write(iov, iovcnt, flushed_lsn + 1, last_lsn);
+  if (OB_FAIL(write_rc)) {
+    LOG_WARN("failed to write log entries. first_lsn=%ld, last_lsn=%ld, rc=%s", 
+             flushed_lsn + 1, last_lsn, strrc(write_rc));
+    return write_rc;
+  }
+
+  count = static_cast<int>(last_lsn - flushed_lsn);
+
+  // 先更新flushed_lsn，再释放内存，保证追加日志时计算的LSN是正确的
+  flushed_lsn_.store(last_lsn);
+  released_pos_.store(end_pos);
+  if (space_waiters_.load() > 0) {
+    lock_guard guard(mutex_);
+    space_cond_.notify_all();
+  }
+  return rc;
+}
+
+bool LogEntryBuffer::wait_entries(chrono::milliseconds timeout)
+{
+  unique_lock guard(mutex_);
+  // 先设置等待标识再检查，追加日志的线程要么能看到标识，要么这里能看到新的日志
+  flusher_waiting_.store(true);
+  bool ready = entry_cond_.wait_for(guard, timeout, [this]() { return entry_ready(flushed_lsn_.load() + 1); });
+  flusher_waiting_.store(false);
+  return ready;
 }
 
 int64_t LogEntryBuffer::bytes() const
 {
-  return bytes_.load();
+  const uint64_t released_pos = released_pos_.load();
+  return static_cast<int64_t>(unpack_pos(reserved_.load(), released_pos) - released_pos);
 }
 
 int32_t LogEntryBuffer::entry_number() const
 {
-  return entries_.size();
-}
\ No newline at end of file
+  const LSN flushed_lsn = flushed_lsn_.load();
+  return static_cast<int32_t>(unpack_lsn(reserved_.load(), flushed_lsn) - flushed_lsn);
+}
+
+LSN LogEntryBuffer::current_lsn() const { return unpack_lsn(reserved_.load(), flushed_lsn_.load()); }
@@ -15,8 +15,9 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <memory>
-#include <deque>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 
 #include "common/rc.h"
 #include "common/types.h"
@@ -30,8 +31,13 @@ class LogFileWriter;
  * @brief 日志数据缓冲区
  * @ingroup CLog
  * @details 缓存一部分日志在内存中而不是直接写入磁盘。
- * 这里的缓存没有考虑高性能操作，比如使用预分配内存、环形缓冲池等。
- * 在生产数据库中，通常会使用预分配内存形式的缓存来提高性能，并且可以减少内存碎片。
+ * 缓冲区是预先分配好的一块环形内存，日志按照写入文件的格式（日志头加上日志数据）依次存放在里面。
+ * 追加日志时不加锁：
+ * 1. 使用CAS在一个64位整数上同时预留LSN和一段内存，LSN与内存的顺序总是一致的；
+ * 2. 把日志复制到预留的内存中，多个线程可以同时复制；
+ * 3. 在LSN对应的槽位上标记这条日志已经复制完成。
+ * 刷日志的线程从上次刷新的位置开始，找到连续的已经复制完成的日志，一次写入文件，然后释放这段内存。
+ * 内存不足时，追加日志的线程需要等待刷日志的线程释放内存。
  */
 class LogEntryBuffer
 {
@@ -39,6 +45,11 @@ public:
   LogEntryBuffer()  = default;
   ~LogEntryBuffer() = default;
 
+  /**
+   * @brief 初始化缓冲区，需要在追加日志之前调用
+   * @param lsn 当前最大的LSN，下一条日志的LSN是lsn+1
+   * @param max_bytes 缓冲区的大小，会向上取整到2的幂，并且至少能容纳一条最大的日志
+   */
   RC init(LSN lsn, int32_t max_bytes = 0);
 
   /**
@@ -49,32 +60,82 @@ public:
 
   /**
    * @brief 刷新缓冲区中的日志到磁盘
-   *
+   * @details 把从上次刷新的位置开始、连续的已经复制完成的日志一次写入文件。
+   * 超过当前文件end_lsn的日志不会写入，返回LOG_FILE_FULL，切换文件后再写。
+   * 只能有一个线程调用。
    * @param file_handle 使用它来写文件
    * @param count 刷了多少条日志
    */
   RC flush(LogFileWriter &file_writer, int &count);
 
+  /**
+   * @brief 等待缓冲区中有可以刷新的日志
+   * @details 追加日志时会唤醒等待的线程，所以刷日志的线程不需要轮询
+   * @param timeout 最多等待多久
+   * @return 缓冲区中是否有可以刷新的日志
+   */
+  bool wait_entries(std::chrono::milliseconds timeout);
+
   /**
    * @brief 当前缓冲区中有多少字节的日志
    */
   int64_t bytes() const;
 
   /**
-   * @brief 当前缓冲区中有多少条日志
+   * @brief 当前缓冲区中有多少条日志，包括还没有复制完成的
    */
   int32_t entry_number() const;
 
-  LSN current_lsn() const { return current_lsn_.load(); }
+  LSN current_lsn() const;
+  /// @brief 已经写入文件的最大LSN，不一定已经刷新到磁盘
   LSN flushed_lsn() const { return flushed_lsn_.load(); }
 
+  int64_t capacity() const { return capacity_; }
+
+private:
+  /**
+   * 预留位置使用的64位整数，高LSN_BITS位是最后一条日志LSN的低位，低POS_BITS位是预留内存结束位置的低位。
+   * 完整的LSN和位置可以根据已经刷新的LSN和位置计算出来，因为缓冲区中的日志条数和字节数都远小于这两个范围。
+   */
+  static constexpr int      POS_BITS = 36;
+  static constexpr int      LSN_BITS = 64 - POS_BITS;
+  static constexpr uint64_t POS_MASK = (uint64_t(1) << POS_BITS) - 1;
+  static constexpr uint64_t LSN_MASK = (uint64_t(1) << LSN_BITS) - 1;
+  /// 缓冲区的最大值，保证缓冲区中的日志条数和字节数不会超过上面字段范围的一半
+  static constexpr int64_t MAX_CAPACITY = int64_t(1) << 28;
+
+  static uint64_t pack(LSN lsn, uint64_t pos) { return ((lsn & LSN_MASK) << POS_BITS) | (pos & POS_MASK); }
+  LSN             unpack_lsn(uint64_t reserved, LSN base_lsn) const;
+  uint64_t        unpack_pos(uint64_t reserved, uint64_t base_pos) const;
+
+  /// @brief 在环形内存中复制数据，处理回绕
+  void copy_in(uint64_t pos, const void *data, int64_t size);
+  void copy_out(uint64_t pos, void *data, int64_t size) const;
+
+  /// @brief 这条日志是否已经复制完成
+  bool entry_ready(LSN lsn) const;
+
+  /// @brief 当前是否有足够的内存预留一条日志
+  bool has_space(int64_t entry_size) const;
+
+  /// @brief 等待刷日志的线程释放内存，超时后调用者重新检查
+  void wait_space(int64_t entry_size);
+
 private:
-  std::mutex           mutex_;  /// 当前数据结构一定会在多线程中访问，所以强制使用有效的锁，而不是有条件生效的common::Mutex
-  std::deque<LogEntry> entries_;  /// 日志缓冲区
-  std::atomic<int64_t> bytes_;    /// 当前缓冲区中的日志数据大小
+  std::unique_ptr<char[]>             data_;      /// 环形内存
+  int64_t                             capacity_ = 0;
+  std::unique_ptr<std::atomic<LSN>[]> ready_;     /// 按照LSN取模，记录复制完成的日志LSN
+  int64_t                             ready_num_ = 0;
+
+  std::atomic<uint64_t> reserved_{0};      /// 预留的LSN和内存位置，参考pack
+  std::atomic<uint64_t> released_pos_{0};  /// 已经写入文件、可以重复使用的内存位置，单调递增
+  std::atomic<LSN>      flushed_lsn_{0};
 
-  std::atomic<LSN> current_lsn_{0};
-  std::atomic<LSN> flushed_lsn_{0};
+  std::mutex              mutex_;                 /// 只用于等待，追加日志不需要加锁
+  std::condition_variable entry_cond_;            /// 有新的日志时通知刷日志的线程
+  std::condition_variable space_cond_;            /// 释放内存后通知追加日志的线程
+  std::atomic<bool>       flusher_waiting_{false};
+  std::atomic<int>        space_waiters_{0};
 
   int32_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
 };
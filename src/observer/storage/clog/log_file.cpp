@@ -154,7 +154,8 @@ RC LogFileWriter::open(const char *filename, int end_lsn)
   filename_ = filename;
   end_lsn_ = end_lsn;
 
-  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT | O_SYNC, 0644);
+  // 不使用O_SYNC，每批日志写入后由调用者sync一次
+  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT, 0644);
   if (fd_ < 0) {
     LOG_WARN("open file failed. filename=%s, error=%s", filename, strerror(errno));
     return RC::FILE_OPEN;
@@ -213,6 +214,69 @@ RC LogFileWriter::write(LogEntry &entry)
   return RC::SUCCESS;
 }
 
+RC LogFileWriter::write(const struct iovec *iov, int iovcnt, LSN first_lsn, LSN last_lsn)
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (last_lsn > end_lsn_) {
+    return RC::LOG_FILE_FULL;
+  }
+
+  if (first_lsn <= last_lsn_ || first_lsn > last_lsn) {
+    LOG_WARN("write log entries failed. invalid lsn. filename=%s, file last_lsn=%ld, first_lsn=%ld, last_lsn=%ld", 
+             filename_.c_str(), last_lsn_, first_lsn, last_lsn);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  /// WARNING 这里需要处理日志写一半的情况
+  /// 日志只写成功一部分到文件中非常难处理
+  vector<struct iovec> iovs(iov, iov + iovcnt);
+  int                  index = 0;
+  size_t               size  = 0;
+  while (index < iovcnt) {
+    ssize_t ret = ::writev(fd_, iovs.data() + index, iovcnt - index);
+    if (ret < 0) {
+      if (EINTR == errno || EAGAIN == errno) {
+        continue;
+      }
+      LOG_WARN("write log entries failed. filename=%s, error=%s, first_lsn=%ld, last_lsn=%ld", 
+               filename_.c_str(), strerror(errno), first_lsn, last_lsn);
+      return RC::IOERR_WRITE;
+    }
+
+    // 跳过已经写完的部分
+    size += ret;
+    while (index < iovcnt && static_cast<size_t>(ret) >= iovs[index].iov_len) {
+      ret -= iovs[index].iov_len;
+      index++;
+    }
+    if (index < iovcnt) {
+      iovs[index].iov_base = static_cast<char *>(iovs[index].iov_base) + ret;
+      iovs[index].iov_len -= ret;
+    }
+  }
+
+  last_lsn_ = last_lsn;
+  LOG_TRACE("write log entries success. filename=%s, first_lsn=%ld, last_lsn=%ld, size=%ld", 
+            filename_.c_str(), first_lsn, last_lsn, size);
+  return RC::SUCCESS;
+}
+
+RC LogFileWriter::sync()
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (0 != fsync(fd_)) {
+    LOG_WARN("sync log file failed. filename=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
 bool LogFileWriter::valid() const
 {
   return fd_ >= 0;
@@ -299,6 +363,7 @@ RC LogFileManager::list_files(std::vector<std::string> &files, LSN start_lsn)
 {
   files.clear();
 
+  lock_guard<mutex> guard(lock_);
   // 这里的代码是AI自动生成的
   // 其实写的不好，我们只需要找到比start_lsn相等或者小的第一个日志文件就可以了
   for (auto &file : log_files_) {
@@ -312,7 +377,9 @@ RC LogFileManager::list_files(std::vector<std::string> &files, LSN start_lsn)
 
 RC LogFileManager::last_file(LogFileWriter &file_writer)
 {
+  unique_lock<mutex> guard(lock_);
   if (log_files_.empty()) {
+    guard.unlock();
     return next_file(file_writer);
   }
 
@@ -327,6 +394,7 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 {
   file_writer.close();
 
+  lock_guard<mutex> guard(lock_);
   LSN lsn = 0;
   if (!log_files_.empty()) {
     lsn = log_files_.rbegin()->first + max_entry_number_per_file_;
@@ -338,3 +406,31 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 
   return file_writer.open(file_path.c_str(), lsn + max_entry_number_per_file_ - 1);
 }
+
+RC LogFileManager::remove_files(LSN lsn)
+{
+  lock_guard<mutex> guard(lock_);
+  while (log_files_.size() > 1) {
+    auto iter = log_files_.begin();
+    if (iter->first + max_entry_number_per_file_ - 1 >= lsn) {
+      break;
+    }
+
+    error_code ec;
+    filesystem::remove(iter->second, ec);
+    if (ec) {
+      LOG_WARN("failed to remove log file. file=%s, error=%s", iter->second.c_str(), ec.message().c_str());
+      return RC::FILE_REMOVE;
+    }
+
+    LOG_INFO("log file removed. file=%s, lsn=%ld", iter->second.c_str(), lsn);
+    log_files_.erase(iter);
+  }
+  return RC::SUCCESS;
+}
+
+size_t LogFileManager::file_num() const
+{
+  lock_guard<mutex> guard(lock_);
+  return log_files_.size();
+}
@@ -19,6 +19,9 @@ See the Mulan PSL v2 for more details. */
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <vector>
+#include <sys/uio.h>
 
 #include "common/rc.h"
 #include "common/types.h"
@@ -77,6 +80,20 @@ public:
   /// @brief 写入一条日志
   RC write(LogEntry &entry);
 
+  /**
+   * @brief 写入已经按照文件格式序列化好的连续多条日志
+   * @details 数据可以分成多段，使用一次writev写入
+   * @param first_lsn 第一条日志的LSN
+   * @param last_lsn  最后一条日志的LSN，不能超过end_lsn
+   */
+  RC write(const struct iovec *iov, int iovcnt, LSN first_lsn, LSN last_lsn);
+
+  /**
+   * @brief 把已经写入的日志刷新到磁盘
+   * @details write只是把日志写到操作系统的缓存中，调用sync之后日志才是持久化的
+   */
+  RC sync();
+
   /**
    * @brief 当前文件是否已经打开
    */
@@ -91,11 +108,14 @@ public:
 
   const char *filename() const { return filename_.c_str(); }
 
+  /// @brief 当前文件允许写入的最大LSN
+  LSN end_lsn() const { return end_lsn_; }
+
 private:
   std::string filename_;       /// 日志文件名
   int         fd_       = -1;  /// 日志文件描述符
-  int         last_lsn_ = 0;   /// 写入的最后一条日志LSN
-  int         end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
+  LSN         last_lsn_ = 0;   /// 写入的最后一条日志LSN
+  LSN         end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
 };
 
 /**
@@ -138,6 +158,16 @@ public:
    */
   RC next_file(LogFileWriter &file_writer);
 
+  /**
+   * @brief 删除所有日志都小于lsn的日志文件
+   * @details 最后一个日志文件正在写入，不会删除
+   * @param lsn 检查点LSN，重启时从这里开始回放日志
+   */
+  RC remove_files(LSN lsn);
+
+  /// @brief 当前日志文件的个数
+  size_t file_num() const;
+
 private:
   /**
    * @brief 从文件名称中获取LSN
@@ -152,5 +182,7 @@ private:
   std::filesystem::path directory_;                  /// 日志文件存放的目录
   int                   max_entry_number_per_file_;  /// 一个文件最大允许存放多少条日志
 
+  /// 日志线程会创建新文件，做检查点的线程会删除旧文件
+  mutable std::mutex                   lock_;
   std::map<LSN, std::filesystem::path> log_files_;  /// 日志文件名和第一个LSN的映射
 };
@@ -96,6 +96,13 @@ public:
 
   virtual LSN current_lsn() const = 0;
 
+  /**
+   * @brief 删除不再需要的日志
+   * @details 做完检查点之后调用，重启时从检查点开始回放，更早的日志就不再需要了
+   * @param lsn 检查点LSN，不会删除大于等于这个LSN的日志
+   */
+  virtual RC truncate(LSN lsn) = 0;
+
   static RC create(const char *name, LogHandler *&handler);
 
 private:
@@ -14,8 +14,10 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/db/db.h"
 
+#include <algorithm>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 #include <filesystem>
 
@@ -23,6 +25,9 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "common/os/path.h"
 #include "common/global_context.h"
+#include "common/thread/thread_util.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
 #include "storage/common/meta_util.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
@@ -33,8 +38,26 @@ See the Mulan PSL v2 for more details. */
 using namespace std;
 using namespace common;
 
+Db::Db() = default;
+
 Db::~Db()
 {
+  // 检查点、后台刷脏页和预读都用到了buffer pool和日志，需要最先停止
+  stop_checkpoint_thread();
+  if (buffer_pool_manager_) {
+    buffer_pool_manager_->stop_read_ahead();
+    buffer_pool_manager_->stop_page_cleaner();
+  }
+
+  // 后台回收删除的记录时会访问表
+  if (trx_kit_) {
+    trx_kit_->stop_purge();
+  }
+
+  // 缓存的执行计划引用了表，先于表释放
+  plan_cache_.reset();
+  query_cache_.reset();
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -48,7 +71,8 @@ Db::~Db()
   LOG_INFO("Db has been closed: %s", name_.c_str());
 }
 
-RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, const char *log_handler_name)
+RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, const char *log_handler_name,
+    const char *io_engine_name, const char *replacement_policy, int frame_shard_num)
 {
   RC rc = RC::SUCCESS;
 
@@ -69,9 +93,17 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
   }
 
   trx_kit_.reset(trx_kit);
+  plan_cache_  = make_unique<PlanCache>();
+  query_cache_ = make_unique<QueryCache>();
+
+  buffer_pool_manager_ = make_unique<BufferPoolManager>(0 /*memory_size*/, frame_shard_num);
+  rc                   = buffer_pool_manager_->get_frame_manager().set_replacement_policy(replacement_policy);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to set replacement policy: %s, rc=%s", replacement_policy, strrc(rc));
+    return rc;
+  }
 
-  buffer_pool_manager_ = make_unique<BufferPoolManager>();
-  auto dblwr_buffer    = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
+  auto dblwr_buffer = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
 
   const char      *double_write_buffer_filename  = "dblwr.db";
   filesystem::path double_write_buffer_file_path = filesystem::path(dbpath) / double_write_buffer_filename;
@@ -82,7 +114,13 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
-  rc = buffer_pool_manager_->init(std::move(dblwr_buffer));
+  unique_ptr<IoEngine> io_engine = IoEngine::create(io_engine_name);
+  if (!io_engine) {
+    LOG_ERROR("Failed to create io engine: %s", io_engine_name);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  rc = buffer_pool_manager_->init(std::move(dblwr_buffer), std::move(io_engine));
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to init buffer pool manager. dbpath=%s, rc=%s", dbpath, strrc(rc));
     return rc;
@@ -134,6 +172,28 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  // 回放日志时不加buffer pool的锁，恢复完成之后才能在后台刷脏页
+  rc = buffer_pool_manager_->start_page_cleaner();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start page cleaner. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_manager_->start_read_ahead();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start read ahead worker. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  // 恢复时回滚了没有提交的事务，之后留在表中的删除记录才能回收
+  rc = trx_kit_->start_purge(*this);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start purge. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  checkpoint_thread_running_ = true;
+  checkpoint_thread_         = make_unique<thread>(&Db::checkpoint_thread_func, this);
   return rc;
 }
 
@@ -158,6 +218,7 @@ RC Db::create_table(const char *table_name, span<const AttrInfoSqlNode> attribut
   }
 
   opened_tables_[table_name] = table;
+  plan_cache_->invalidate();
   LOG_INFO("Create table success. table name=%s, table_id:%d", table_name, table_id);
   return RC::SUCCESS;
 }
@@ -169,12 +230,16 @@ RC Db::drop_table(const char *table_name) {
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
+  trx_kit_->drop_table(table);
+
   RC rc = table->drop();
   if (rc != RC::SUCCESS) {
     LOG_WARN("drop table failed. db=%s, table_name=%s, due to %s", name(), table_name, strrc(rc));
     return rc;
   }
 
+  // 缓存的执行计划可能引用了这个表
+  plan_cache_->invalidate();
   opened_tables_.erase(table_name);
   delete table;
   LOG_INFO("drop table success. db=%s, table_name=%s", name(), table_name);
@@ -261,29 +326,115 @@ RC Db::sync()
     LOG_INFO("Successfully sync table db:%s, table:%s.", name_.c_str(), table->name());
   }
 
-  auto dblwr_buffer = static_cast<DiskDoubleWriteBuffer *>(buffer_pool_manager_->get_dblwr_buffer());
-  rc                = dblwr_buffer->flush_page();
-  LOG_INFO("double write buffer flush pages ret=%s", strrc(rc));
+  rc = checkpoint();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to checkpoint. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("Successfully sync db. db=%s", name_.c_str());
+  return rc;
+}
+
+RC Db::checkpoint()
+{
+  lock_guard<mutex> guard(checkpoint_lock_);
 
   /*
-  在sync期间，不允许有未完成的事务，也不允许开启新的事物。
-  这个约束不是从程序层面处理的，而是认为的约束。
+  先获取当前的LSN，之后才开始修改数据的页面和事务，它们的日志一定比这个LSN大。
+  已经在修改的页面和事务，会记录一个不大于它们日志LSN的下界，检查点不会越过这些下界。
   */
-  LSN current_lsn = log_handler_->current_lsn();
-  rc              = log_handler_->wait_lsn(current_lsn);
+  const LSN current_lsn = log_handler_->current_lsn();
+  LSN       lsn         = trx_kit_->min_recovery_lsn(current_lsn + 1);
+  lsn                   = buffer_pool_manager_->get_frame_manager().min_recovery_lsn(lsn);
+
+  // 之后分配的事务号，都会出现在检查点之后的日志中，重启回放日志时能够找回来
+  const int32_t trx_id = trx_kit_->current_trx_id();
+
+  if (lsn <= check_point_lsn_ && trx_id == check_point_trx_id_) {
+    LOG_TRACE("checkpoint lsn does not advance. db=%s, checkpoint lsn=%ld, lsn=%ld", name_.c_str(), check_point_lsn_, lsn);
+    return RC::SUCCESS;
+  }
+  // 没有日志时事务号也可能变化，检查点LSN不能后退
+  lsn = max(lsn, check_point_lsn_);
+
+  // 已经刷出的脏页可能还在double write buffer中，需要真正写到数据文件中。写入之后会逐个同步数据文件
+  auto dblwr_buffer = static_cast<DiskDoubleWriteBuffer *>(buffer_pool_manager_->get_dblwr_buffer());
+  RC   rc           = dblwr_buffer->flush_page();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush double write buffer. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  // 检查点之前的日志都要落盘
+  rc = log_handler_->wait_lsn(lsn - 1);
   if (OB_FAIL(rc)) {
-    LOG_ERROR("Failed to wait lsn. lsn=%ld, rc=%d:%s", current_lsn, rc, strrc(rc));
+    LOG_WARN("failed to wait lsn. lsn=%ld, rc=%s", lsn - 1, strrc(rc));
     return rc;
   }
 
-  check_point_lsn_ = current_lsn;
-  rc               = flush_meta();
+  const LSN     old_check_point_lsn    = check_point_lsn_;
+  const int32_t old_check_point_trx_id = check_point_trx_id_;
+  check_point_lsn_                     = lsn;
+  check_point_trx_id_                  = trx_id;
+  rc                                   = flush_meta();
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
+    check_point_lsn_    = old_check_point_lsn;
+    check_point_trx_id_ = old_check_point_trx_id;
     return rc;
   }
-  LOG_INFO("Successfully sync db. db=%s", name_.c_str());
-  return rc;
+
+  rc = log_handler_->truncate(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to truncate log. db=%s, lsn=%ld, rc=%s", name_.c_str(), lsn, strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("checkpoint done. db=%s, checkpoint lsn=%ld, current lsn=%ld", name_.c_str(), lsn, current_lsn);
+  return RC::SUCCESS;
+}
+
+void Db::checkpoint_thread_func()
+{
+  thread_set_name("Checkpoint");
+  LOG_INFO("checkpoint thread started. db=%s", name_.c_str());
+
+  unique_lock<mutex> lock(checkpoint_thread_mutex_);
+  while (checkpoint_thread_running_) {
+    checkpoint_thread_cond_.wait_for(lock, CHECKPOINT_INTERVAL, [this]() { return !checkpoint_thread_running_; });
+    if (!checkpoint_thread_running_) {
+      break;
+    }
+
+    lock.unlock();
+    RC rc = checkpoint();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+    lock.lock();
+  }
+  LOG_INFO("checkpoint thread stopped. db=%s", name_.c_str());
+}
+
+void Db::stop_checkpoint_thread()
+{
+  if (!checkpoint_thread_) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> guard(checkpoint_thread_mutex_);
+    checkpoint_thread_running_ = false;
+  }
+  checkpoint_thread_cond_.notify_all();
+  checkpoint_thread_->join();
+  checkpoint_thread_.reset();
+}
+
+int Db::recover_worker_num()
+{
+  const int cpu_num = static_cast<int>(thread::hardware_concurrency());
+  return min(cpu_num, MAX_RECOVER_WORKER_NUM);
 }
 
 RC Db::recover()
@@ -297,7 +448,13 @@ RC Db::recover()
   }
 
   IntegratedLogReplayer log_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer));
-  RC                    rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
+  RC                    rc = log_replayer.start_workers(recover_worker_num());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start log replay workers. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to replay log. rc=%s", strrc(rc));
     return rc;
@@ -349,10 +506,14 @@ RC Db::init_meta()
       return RC::IOERR_TOO_LONG;
     }
 
-    buffer[n]        = '\0';
-    check_point_lsn_ = atoll(buffer);  // 当前元数据就这一个数字
-    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld", 
-             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_);
+    // 元数据是检查点LSN和检查点时已经分配的最大事务号，旧的元数据文件中只有检查点LSN
+    buffer[n]          = '\0';
+    char   *end        = nullptr;
+    check_point_lsn_   = strtoll(buffer, &end, 10);
+    int32_t max_trx_id = static_cast<int32_t>(strtol(end, nullptr, 10));
+    trx_kit_->advance_trx_id(max_trx_id);
+    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld, max trx id=%d", 
+             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_, max_trx_id);
   }
   close(fd);
 
@@ -377,7 +538,7 @@ RC Db::flush_meta()
     return RC::IOERR_WRITE;
   }
 
-  string buffer = to_string(check_point_lsn_);
+  string buffer = to_string(check_point_lsn_) + " " + to_string(check_point_trx_id_);
   int    n      = write(fd, buffer.c_str(), buffer.size());
   if (n < 0) {
     LOG_ERROR("Failed to write db meta file. db=%s, file=%s, errno=%s", 
@@ -387,6 +548,10 @@ RC Db::flush_meta()
     LOG_ERROR("Failed to write db meta file. db=%s, file=%s, buffer size=%ld, write size=%d", 
               name_.c_str(), temp_meta_file_path.c_str(), buffer.size(), n);
     rc = RC::IOERR_WRITE;
+  } else if (fsync(fd) != 0) {
+    LOG_ERROR("Failed to sync db meta file. db=%s, file=%s, errno=%s", 
+              name_.c_str(), temp_meta_file_path.c_str(), strerror(errno));
+    rc = RC::IOERR_SYNC;
   } else {
     error_code ec;
     filesystem::rename(temp_meta_file_path, meta_file_path, ec);
@@ -400,6 +565,7 @@ RC Db::flush_meta()
                name_.c_str(), temp_meta_file_path.c_str(), check_point_lsn_);
     }
   }
+  close(fd);
 
   return rc;
 }
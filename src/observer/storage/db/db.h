@@ -14,12 +14,17 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <vector>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <span>
 
+#include "common/ini_setting.h"
 #include "common/rc.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -30,6 +35,8 @@ class Table;
 class LogHandler;
 class BufferPoolManager;
 class TrxKit;
+class PlanCache;
+class QueryCache;
 
 /**
  * @brief 一个DB实例负责管理一批表
@@ -45,7 +52,7 @@ class TrxKit;
 class Db
 {
 public:
-  Db() = default;
+  Db();
   ~Db();
 
   /**
@@ -54,9 +61,14 @@ public:
    * @param name   数据库名称
    * @param dbpath 当前数据库放在哪个目录下
    * @param trx_kit_name 使用哪种类型的事务模型
+   * @param io_engine_name 读写页面使用哪种IO引擎，参考 IoEngine::create
+   * @param replacement_policy 页帧使用哪种替换策略，参考 FrameReplacer::create
+   * @param frame_shard_num 页帧管理器的分片个数，参考 BPFrameManager::init
    * @note 数据库不是放在dbpath/name下，是直接使用dbpath目录
    */
-  RC init(const char *name, const char *dbpath, const char *trx_kit_name, const char *log_handler_name);
+  RC init(const char *name, const char *dbpath, const char *trx_kit_name, const char *log_handler_name,
+      const char *io_engine_name = IO_ENGINE_DEFAULT, const char *replacement_policy = REPLACEMENT_POLICY_DEFAULT,
+      int frame_shard_num = FRAME_SHARD_NUM_DEFAULT);
 
   /**
    * @brief 创建一个表
@@ -79,15 +91,30 @@ public:
   /// @brief 当前数据库的名称
   const char *name() const;
 
+  /// @brief 数据库文件存放的目录
+  const char *path() const { return path_.c_str(); }
+
   /// @brief 列出所有的表
   void all_tables(std::vector<std::string> &table_names) const;
 
   /**
    * @brief 将所有内存中的数据，刷新到磁盘中。
    * @details 注意，这里也没有并发控制，需要由上层来保证当前没有正在进行的事务。
+   * 刷新完成后做一次检查点。
    */
   RC sync();
 
+  /**
+   * @brief 做一次模糊检查点
+   * @details 不需要停止事务，也不主动刷脏页。检查点LSN取脏页的recovery lsn、活跃事务的第一条日志
+   * 和当前LSN的最小值，重启时从这里开始回放日志。检查点落盘后删除不再需要的日志文件。
+   * 后台线程会定期调用。
+   */
+  RC checkpoint();
+
+  /// @brief 当前的检查点LSN
+  LSN check_point_lsn() const { return check_point_lsn_; }
+
   /// @brief 获取当前数据库的日志处理器
   LogHandler &log_handler();
 
@@ -97,11 +124,19 @@ public:
   /// @brief 获取当前数据库的事务管理器
   TrxKit &trx_kit();
 
+  /// @brief 当前数据库的执行计划缓存
+  PlanCache &plan_cache() { return *plan_cache_; }
+
+  /// @brief 当前数据库的查询结果缓存
+  QueryCache &query_cache() { return *query_cache_; }
+
 private:
   /// @brief 打开所有的表。在数据库初始化的时候会执行
   RC open_all_tables();
   /// @brief 恢复数据。在数据库初始化的时候运行。
   RC recover();
+  /// @brief 并行回放日志的线程数，与CPU数量相同但不超过 MAX_RECOVER_WORKER_NUM，不大于1时按顺序回放
+  static int recover_worker_num();
 
   /// @brief 初始化元数据。在数据库初始化的时候，加载元数据
   RC init_meta();
@@ -111,6 +146,10 @@ private:
   /// @brief 初始化数据库的double buffer pool
   RC init_dblwr_buffer();
 
+  /// @brief 定期做检查点的线程
+  void checkpoint_thread_func();
+  void stop_checkpoint_thread();
+
 private:
   std::string                              name_;                 ///< 数据库名称
   std::string                              path_;                 ///< 数据库文件存放的目录
@@ -118,9 +157,24 @@ private:
   std::unique_ptr<BufferPoolManager>       buffer_pool_manager_;  ///< 当前数据库的buffer pool管理器
   std::unique_ptr<LogHandler>              log_handler_;          ///< 当前数据库的日志处理器
   std::unique_ptr<TrxKit>                  trx_kit_;              ///< 当前数据库的事务管理器
+  std::unique_ptr<PlanCache>               plan_cache_;           ///< 当前数据库的执行计划缓存
+  std::unique_ptr<QueryCache>              query_cache_;          ///< 当前数据库的查询结果缓存
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
 
-  LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  LSN     check_point_lsn_    = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  int32_t check_point_trx_id_ = 0;  ///< 检查点时已经分配的最大事务号。会记录到磁盘中。
+
+  /// 恢复时并行回放日志的最大线程数
+  static constexpr int MAX_RECOVER_WORKER_NUM = 8;
+
+  /// 后台线程做检查点的间隔
+  static constexpr std::chrono::seconds CHECKPOINT_INTERVAL{30};
+
+  std::mutex                   checkpoint_lock_;  ///< 后台线程和sync不能同时做检查点
+  std::mutex                   checkpoint_thread_mutex_;
+  std::condition_variable      checkpoint_thread_cond_;
+  bool                         checkpoint_thread_running_ = false;
+  std::unique_ptr<std::thread> checkpoint_thread_;
 };
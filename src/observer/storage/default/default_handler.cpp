@@ -33,7 +33,9 @@ DefaultHandler::DefaultHandler() {}
 
 DefaultHandler::~DefaultHandler() noexcept { destroy(); }
 
-RC DefaultHandler::init(const char *base_dir, const char *trx_kit_name, const char *log_handler_name)
+RC DefaultHandler::init(
+    const char *base_dir, const char *trx_kit_name, const char *log_handler_name, const char *io_engine_name,
+    const char *replacement_policy, int frame_shard_num)
 {
   // 检查目录是否存在，或者创建
   filesystem::path db_dir(base_dir);
@@ -48,6 +50,9 @@ RC DefaultHandler::init(const char *base_dir, const char *trx_kit_name, const ch
   db_dir_   = db_dir;
   trx_kit_name_ = trx_kit_name;
   log_handler_name_ = log_handler_name;
+  io_engine_name_ = io_engine_name;
+  replacement_policy_ = replacement_policy;
+  frame_shard_num_ = frame_shard_num;
 
   const char *sys_db = "sys";
 
@@ -123,7 +128,8 @@ RC DefaultHandler::open_db(const char *dbname)
   // open db
   Db *db  = new Db();
   RC  ret = RC::SUCCESS;
-  if ((ret = db->init(dbname, dbpath.c_str(), trx_kit_name_.c_str(), log_handler_name_.c_str())) != RC::SUCCESS) {
+  if ((ret = db->init(dbname, dbpath.c_str(), trx_kit_name_.c_str(), log_handler_name_.c_str(), io_engine_name_.c_str(),
+           replacement_policy_.c_str(), frame_shard_num_)) != RC::SUCCESS) {
     LOG_ERROR("Failed to open db: %s. error=%s", dbname, strrc(ret));
     delete db;
   } else {
@@ -39,8 +39,13 @@ public:
    * @param base_dir 存储引擎的根目录。所有的数据库相关数据文件都放在这个目录下
    * @param trx_kit_name 使用哪种类型的事务模型
    * @param log_handler_name 使用哪种类型的日志处理器
+   * @param io_engine_name 读写页面使用哪种IO引擎
+   * @param replacement_policy 页帧使用哪种替换策略
+   * @param frame_shard_num 页帧管理器的分片个数
    */
-  RC   init(const char *base_dir, const char *trx_kit_name, const char *log_handler_name);
+  RC   init(const char *base_dir, const char *trx_kit_name, const char *log_handler_name,
+        const char *io_engine_name = IO_ENGINE_DEFAULT, const char *replacement_policy = REPLACEMENT_POLICY_DEFAULT,
+        int frame_shard_num = FRAME_SHARD_NUM_DEFAULT);
   void destroy();
 
   /**
@@ -96,5 +101,8 @@ private:
   std::filesystem::path       db_dir_;            ///< 数据库文件的根目录
   std::string                 trx_kit_name_;      ///< 事务模型的名称
   std::string                 log_handler_name_;  ///< 日志处理器的名称
+  std::string                 io_engine_name_;    ///< IO引擎的名称
+  std::string                 replacement_policy_;  ///< 页帧替换策略的名称
+  int                         frame_shard_num_ = FRAME_SHARD_NUM_DEFAULT;  ///< 页帧管理器的分片个数
   std::map<std::string, Db *> opened_dbs_;        ///< 打开的数据库
 };
@@ -1839,6 +1839,7 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   inited_        = true;
   first_emitted_ = false;
+  read_ahead_.reset(tree_handler_.disk_buffer_pool_);
 
   LatchMemo &latch_memo = mtr_.latch_memo();
 
@@ -1961,6 +1962,9 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   if (touch_end()) {
     current_frame_ = nullptr;
+  } else {
+    LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+    read_ahead_.access(current_frame_->page_num(), node.next_page());
   }
 
   return RC::SUCCESS;
@@ -2036,6 +2040,9 @@ RC BplusTreeScanner::next_entry(RID &rid)
 
   latch_memo.release_to(memo_point);
   iter_index_ = -1;  // `next` will add 1
+
+  LeafIndexNodeHandler next_node(mtr_, tree_handler_.file_header_, current_frame_);
+  read_ahead_.access(next_page_num, next_node.next_page());
   return next_entry(rid);
 }
 
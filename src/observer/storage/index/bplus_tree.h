@@ -28,6 +28,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse_defs.h"
 #include "sql/parser/value.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/read_ahead.h"
 #include "storage/record/record_manager.h"
 #include "storage/index/latch_memo.h"
 #include "storage/index/bplus_tree_log.h"
@@ -736,4 +737,6 @@ private:
   common::MemPoolItem::unique_ptr right_key_;
   int                             iter_index_    = -1;
   bool                            first_emitted_ = false;
+
+  ReadAheadTracker read_ahead_;  ///< 预读后面的叶子节点
 };
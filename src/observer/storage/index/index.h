@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <stddef.h>
+#include <string.h>
 #include <vector>
 
 #include "common/rc.h"
@@ -41,6 +42,16 @@ public:
   virtual ~Index() = default;
 
   const IndexMeta &index_meta() const { return index_meta_; }
+  const FieldMeta &field_meta() const { return field_meta_; }
+
+  /**
+   * @brief 两条记录在这个索引上的键值是否相同
+   * @details 键值相同时更新记录不需要修改索引
+   */
+  bool same_key(const char *record1, const char *record2) const
+  {
+    return 0 == memcmp(record1 + field_meta_.offset(), record2 + field_meta_.offset(), field_meta_.len());
+  }
 
   /**
    * @brief 插入一条数据
@@ -40,6 +40,7 @@ public:
 public:
   const char *name() const;
   const char *field() const;
+  bool        unique() const { return unique_; }
 
   void desc(std::ostream &os) const;
 
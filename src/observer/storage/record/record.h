@@ -137,6 +137,7 @@ public:
     }
 
     memcpy(data_, other.data_, other.len_);
+    rid_ = other.rid_;
     return *this;
   }
 
@@ -39,6 +39,7 @@ string RecordOperation::to_string() const
     case Type::INSERT: return ret + "INSERT";
     case Type::DELETE: return ret + "DELETE";
     case Type::UPDATE: return ret + "UPDATE";
+    case Type::UPDATE_RANGE: return ret + "UPDATE_RANGE";
     default: return ret + "UNKNOWN";
   }
 }
@@ -48,6 +49,8 @@ string RecordOperation::to_string() const
 
 const int32_t RecordLogHeader::SIZE = sizeof(RecordLogHeader);
 
+const int32_t RecordUpdateRange::SIZE = sizeof(RecordUpdateRange);
+
 string RecordLogHeader::to_string() const
 {
   stringstream ss;
@@ -63,6 +66,10 @@ string RecordLogHeader::to_string() const
     case RecordOperation::Type::UPDATE: {
       ss << ", slot_num:" << slot_num;
     } break;
+    case RecordOperation::Type::UPDATE_RANGE: {
+      auto range = reinterpret_cast<const RecordUpdateRange *>(data);
+      ss << ", slot_num:" << slot_num << ", offset:" << range->offset << ", length:" << range->length;
+    } break;
     default: {
       ss << ", unknown operation type";
     } break;
@@ -140,6 +147,33 @@ RC RecordLogHandler::update_record(Frame *frame, const RID &rid, const char *rec
   return rc;
 }
 
+RC RecordLogHandler::update_record_range(
+    Frame *frame, const RID &rid, int32_t offset, int32_t length, const char *old_data, const char *new_data)
+{
+  const int    log_payload_size = RecordLogHeader::SIZE + RecordUpdateRange::SIZE + length * 2;
+  vector<char> log_payload(log_payload_size);
+  RecordLogHeader *header = reinterpret_cast<RecordLogHeader *>(log_payload.data());
+  header->buffer_pool_id  = buffer_pool_id_;
+  header->operation_type  = RecordOperation(RecordOperation::Type::UPDATE_RANGE).type_id();
+  header->page_num        = rid.page_num;
+  header->slot_num        = rid.slot_num;
+
+  RecordUpdateRange *range = reinterpret_cast<RecordUpdateRange *>(log_payload.data() + RecordLogHeader::SIZE);
+  range->offset            = offset;
+  range->length            = length;
+
+  char *range_data = log_payload.data() + RecordLogHeader::SIZE + RecordUpdateRange::SIZE;
+  memcpy(range_data, old_data, length);
+  memcpy(range_data + length, new_data, length);
+
+  LSN lsn = 0;
+  RC rc = log_handler_->append(lsn, LogModule::Id::RECORD_MANAGER, std::move(log_payload));
+  if (OB_SUCC(rc) && lsn > 0) {
+    frame->set_lsn(lsn);
+  }
+  return rc;
+}
+
 RC RecordLogHandler::delete_record(Frame *frame, const RID &rid)
 {
   RecordLogHeader header;
@@ -215,6 +249,9 @@ RC RecordLogReplayer::replay(const LogEntry &entry)
     case RecordOperation::Type::UPDATE: {
       rc = replay_update(*buffer_pool, *log_header);
     } break;
+    case RecordOperation::Type::UPDATE_RANGE: {
+      rc = replay_update_range(*buffer_pool, *log_header);
+    } break;
     default: {
       LOG_WARN("unknown record operation type: %d", log_header->operation_type);
       return RC::INVALID_ARGUMENT;
@@ -310,4 +347,29 @@ RC RecordLogReplayer::replay_update(DiskBufferPool &buffer_pool, const RecordLog
   }
 
   return rc;
-}
\ No newline at end of file
+}
+
+RC RecordLogReplayer::replay_update_range(DiskBufferPool &buffer_pool, const RecordLogHeader &header)
+{
+  VacuousLogHandler vacuous_log_handler;
+  RecordPageHandler record_page_handler;
+
+  RC rc = record_page_handler.init(buffer_pool, vacuous_log_handler, header.page_num, ReadWriteMode::READ_WRITE);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to init record page handler. page num=%d, rc=%s", header.page_num, strrc(rc));
+    return rc;
+  }
+
+  auto        range    = reinterpret_cast<const RecordUpdateRange *>(header.data);
+  const char *new_data = header.data + RecordUpdateRange::SIZE + range->length;
+
+  RID rid(header.page_num, header.slot_num);
+  rc = record_page_handler.update_record_range(rid, range->offset, range->length, new_data);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("fail to recover update record range. page num=%d, slot num=%d, offset=%d, length=%d, rc=%s", 
+             header.page_num, header.slot_num, range->offset, range->length, strrc(rc));
+    return rc;
+  }
+
+  return rc;
+}
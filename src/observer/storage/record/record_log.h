@@ -38,7 +38,8 @@ public:
     INIT_PAGE,  /// 初始化空页面
     INSERT,     /// 插入一条记录
     DELETE,     /// 删除一条记录
-    UPDATE      /// 更新一条记录
+    UPDATE,       /// 更新一条记录
+    UPDATE_RANGE  /// 更新一条记录中的一段连续数据
   };
 
 public:
@@ -73,6 +74,19 @@ struct RecordLogHeader
   static const int32_t SIZE;
 };
 
+/**
+ * @brief 部分更新记录的日志内容
+ * @details 日志格式是 RecordLogHeader | RecordUpdateRange | 修改前的数据 | 修改后的数据，两段数据的长度都是length。
+ * 重放时只需要修改后的数据，修改前的数据方便排查问题。
+ */
+struct RecordUpdateRange
+{
+  int32_t offset;  ///< 修改的数据在记录中的偏移
+  int32_t length;  ///< 修改的数据长度
+
+  static const int32_t SIZE;
+};
+
 class RecordLogHandler final
 {
 public:
@@ -119,6 +133,19 @@ public:
    */
   RC update_record(Frame *frame, const RID &rid, const char *record);
 
+  /**
+   * @brief 更新记录中的一段连续数据
+   * @details 通常一次更新只修改少数几个字段，只记录被修改的这一段数据，日志比记录整条数据小很多
+   * @param frame 页帧
+   * @param rid 记录的位置
+   * @param offset 修改的数据在记录中的偏移
+   * @param length 修改的数据长度
+   * @param old_data 修改前的数据
+   * @param new_data 修改后的数据
+   */
+  RC update_record_range(
+      Frame *frame, const RID &rid, int32_t offset, int32_t length, const char *old_data, const char *new_data);
+
 private:
   LogHandler *log_handler_    = nullptr;
   int32_t     buffer_pool_id_ = -1;
@@ -142,6 +169,7 @@ private:
   RC replay_insert(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_delete(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_update(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
+  RC replay_update_range(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
 
 private:
   BufferPoolManager &bpm_;
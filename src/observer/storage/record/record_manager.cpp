@@ -304,28 +304,74 @@ RC RecordPageHandler::update_record(const RID &rid, const char *data)
   }
 
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  if (bitmap.get_bit(rid.slot_num)) {
-    frame_->mark_dirty();
-
-    char *record_data = get_record_data(rid.slot_num);
-    if (record_data == data) {
-      // nothing to do
-    } else {
-      memcpy(record_data, data, page_header_->record_real_size);
-    }
+  if (!bitmap.get_bit(rid.slot_num)) {
+    LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
+    return RC::RECORD_NOT_EXIST;
+  }
 
+  char *record_data = get_record_data(rid.slot_num);
+  if (record_data == data) {
+    // 调用者已经直接修改了页面上的数据，不知道改了哪些，只能记录整条数据
+    frame_->mark_dirty();
     RC rc = log_handler_.update_record(frame_, rid, data);
     if (OB_FAIL(rc)) {
       LOG_ERROR("Failed to update record. page_num %d:%d. rc=%s", 
                 disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
       // return rc; // ignore errors
     }
+    return RC::SUCCESS;
+  }
 
+  // 找到第一个和最后一个不同的字节，只更新中间这一段
+  int begin = 0;
+  int end   = page_header_->record_real_size;
+  while (begin < end && record_data[begin] == data[begin]) {
+    begin++;
+  }
+  if (begin == end) {
     return RC::SUCCESS;
-  } else {
+  }
+  while (record_data[end - 1] == data[end - 1]) {
+    end--;
+  }
+
+  return update_record_range(rid, begin, end - begin, data + begin);
+}
+
+RC RecordPageHandler::update_record_range(const RID &rid, int offset, int length, const char *data)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, "cannot update record from page while the page is readonly");
+
+  if (rid.slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, frame=%s, page_header=%s",
+              rid.slot_num, frame_->to_string().c_str(), page_header_->to_string().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (offset < 0 || length <= 0 || offset + length > page_header_->record_real_size) {
+    LOG_ERROR("Invalid update range. offset=%d, length=%d, record size=%d",
+              offset, length, page_header_->record_real_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!bitmap.get_bit(rid.slot_num)) {
     LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
     return RC::RECORD_NOT_EXIST;
   }
+
+  frame_->mark_dirty();
+
+  char *record_data = get_record_data(rid.slot_num) + offset;
+  RC    rc          = log_handler_.update_record_range(frame_, rid, offset, length, record_data, data);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to update record. page_num %d:%d. rc=%s", 
+              disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
+    // return rc; // ignore errors
+  }
+
+  memcpy(record_data, data, length);
+  return RC::SUCCESS;
 }
 
 RC RecordPageHandler::get_record(const RID &rid, Record &record)
@@ -589,6 +635,7 @@ RC RecordFileScanner::open_scan(
   disk_buffer_pool_ = &buffer_pool;
   log_handler_      = &log_handler;
   rw_mode_          = mode;
+  read_ahead_.reset(&buffer_pool);
 
   RC rc = bp_iterator_.init(buffer_pool, 1);
   if (rc != RC::SUCCESS) {
@@ -623,6 +670,7 @@ RC RecordFileScanner::fetch_next_record()
   // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
   while (bp_iterator_.has_next()) {
     PageNum page_num = bp_iterator_.next();
+    read_ahead_.access(page_num);
     record_page_handler_.cleanup();
     rc = record_page_handler_.init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_);
     if (OB_FAIL(rc)) {
@@ -688,6 +736,8 @@ RC RecordFileScanner::close_scan()
   }
 
   record_page_handler_.cleanup();
+  // 扫描可能没有结束就关闭了，重新打开时要从头开始
+  record_page_iterator_ = RecordPageIterator();
 
   return RC::SUCCESS;
 }
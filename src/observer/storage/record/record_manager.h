@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/bitmap.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/read_ahead.h"
 #include "storage/record/record.h"
 #include "storage/record/record_log.h"
 #include "common/types.h"
@@ -188,11 +189,23 @@ public:
   RC delete_record(const RID *rid);
 
   /**
-   * @brief
-   *
+   * @brief 原地更新一条记录
+   * @details 只会修改与原来的数据不同的部分，日志中也只记录这一段数据
+   * @param rid  要更新的记录标识
+   * @param data 更新后的记录内容
    */
   RC update_record(const RID &rid, const char *data);
 
+  /**
+   * @brief 更新记录中的一段连续数据
+   *
+   * @param rid    要更新的记录标识
+   * @param offset 修改的数据在记录中的偏移
+   * @param length 修改的数据长度
+   * @param data   修改后的数据，长度是length
+   */
+  RC update_record_range(const RID &rid, int offset, int length, const char *data);
+
   /**
    * @brief 获取指定位置的记录数据
    *
@@ -370,6 +383,7 @@ private:
   ReadWriteMode   rw_mode_ = ReadWriteMode::READ_WRITE;  ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                 ///< 遍历buffer pool的所有页面
+  ReadAheadTracker   read_ahead_;                  ///< 顺序访问页面时预读后面的页面
   ConditionFilter   *condition_filter_ = nullptr;  ///< 过滤record
   RecordPageHandler  record_page_handler_;         ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;        ///< 遍历某个页面上的所有record
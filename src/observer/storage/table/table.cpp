@@ -238,6 +238,7 @@ RC Table::insert_record(Record &record)
                 name(), rc2, strrc(rc2));
     }
   }
+  bump_version();
   return rc;
 }
 
@@ -319,8 +320,9 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   }
 
   // 复制所有字段的值
+  // 没有用到的字节清零，原地更新时才能只比较出真正修改过的数据
   int   record_size = table_meta_.record_size();
-  char *record_data = (char *)malloc(record_size);
+  char *record_data = (char *)calloc(1, record_size);
 
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field    = table_meta_.field(i + normal_field_start_index);
@@ -513,9 +515,76 @@ RC Table::delete_record(const Record &record)
            name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
   rc = record_handler_->delete_record(&record.rid());
+  bump_version();
   return rc;
 }
 
+RC Table::update_record(const Record &old_record, Record &new_record)
+{
+  const RID &rid = old_record.rid();
+  new_record.set_rid(rid);
+
+  std::vector<Index *> changed_indexes;
+  for (Index *index : indexes_) {
+    if (!index->same_key(old_record.data(), new_record.data())) {
+      changed_indexes.push_back(index);
+    }
+  }
+
+  // 先插入新的键值，这样唯一索引冲突时只需要删除已经插入的键值
+  RC rc = RC::SUCCESS;
+  size_t inserted_num = 0;
+  for (; inserted_num < changed_indexes.size(); inserted_num++) {
+    rc = changed_indexes[inserted_num]->insert_entry(new_record.data(), &rid);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert entry into index while updating record. table=%s, index=%s, rid=%s, rc=%s",
+               name(), changed_indexes[inserted_num]->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+      break;
+    }
+  }
+
+  if (OB_SUCC(rc)) {
+    rc = record_handler_->visit_record(rid, [&new_record](Record &record) -> bool {
+      memcpy(record.data(), new_record.data(), record.len());
+      return true;
+    });
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to update record. table=%s, rid=%s, rc=%s", name(), rid.to_string().c_str(), strrc(rc));
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    for (size_t i = 0; i < inserted_num; i++) {
+      RC rc2 = changed_indexes[i]->delete_entry(new_record.data(), &rid);
+      if (OB_FAIL(rc2)) {
+        LOG_ERROR("Failed to rollback index data when update record failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+    return rc;
+  }
+
+  for (Index *index : changed_indexes) {
+    rc = index->delete_entry(old_record.data(), &rid);
+    ASSERT(RC::SUCCESS == rc, 
+           "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
+           name(), index->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+  }
+
+  bump_version();
+  return rc;
+}
+
+bool Table::index_key_changed(const Record &old_record, const Record &new_record) const
+{
+  for (Index *index : indexes_) {
+    if (!index->same_key(old_record.data(), new_record.data())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
 {
   RC rc = RC::SUCCESS;
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <span>
 
@@ -78,6 +79,20 @@ public:
    */
   RC insert_record(Record &record);
   RC delete_record(const Record &record);
+
+  /**
+   * @brief 原地更新一条记录
+   * @details 新的数据直接覆盖原来的位置，RID不变。只修改键值发生变化的索引，没有修改到的索引不需要动。
+   * 与insert_record一样不关心事务相关操作。
+   * @param old_record 更新前的记录，索引中的旧键值从这里取
+   * @param new_record 更新后的记录，成功后RID与old_record相同
+   */
+  RC update_record(const Record &old_record, Record &new_record);
+
+  /**
+   * @brief 两条记录是否在某个索引上的键值不同
+   */
+  bool index_key_changed(const Record &old_record, const Record &new_record) const;
   RC delete_record(const RID &rid);
   RC get_record(const RID &rid, Record &record);
 
@@ -105,6 +120,13 @@ public:
 
   Db *db() const { return db_; }
 
+  /**
+   * @brief 表数据的版本，数据的修改对其它事务可见之后增加
+   * @details 查询结果缓存根据版本判断缓存的结果是否过期。插入、删除记录和事务提交时都会增加版本
+   */
+  uint64_t version() const { return version_.load(); }
+  void     bump_version() { version_++; }
+
   const TableMeta &table_meta() const;
 
   RC sync();
@@ -127,4 +149,6 @@ private:
   DiskBufferPool      *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
   RecordFileHandler   *record_handler_   = nullptr;  /// 记录操作
   std::vector<Index *> indexes_;
+
+  std::atomic<uint64_t> version_{0};
 };
@@ -0,0 +1,285 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <sstream>
+
+#include "storage/trx/mvcc_purger.h"
+#include "common/log/log.h"
+#include "common/thread/thread_util.h"
+#include "storage/db/db.h"
+#include "storage/field/field.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+using namespace common;
+
+string MvccPurgeStat::to_string() const
+{
+  stringstream ss;
+  ss << "queued:" << queued_count << ", purged records:" << purged_records << ", purged versions:" << purged_versions
+     << ", skipped:" << skipped_count << ", backlog:" << backlog << ", undo versions:" << undo_versions
+     << ", oldest trx id:" << oldest_trx_id;
+  return ss.str();
+}
+
+/**
+ * @brief 记录上表示删除这个版本的事务的字段
+ */
+static Field end_xid_field(Table *table)
+{
+  span<const FieldMeta> trx_fields = table->table_meta().trx_fields();
+  ASSERT(trx_fields.size() >= 2, "invalid trx fields number. %d", trx_fields.size());
+  return Field(table, &trx_fields[1]);
+}
+
+MvccPurger::~MvccPurger() { stop(); }
+
+RC MvccPurger::start(Db &db)
+{
+  vector<string> table_names;
+  db.all_tables(table_names);
+
+  lock_guard<mutex> guard(lock_);
+  if (thread_) {
+    LOG_WARN("mvcc purger has been started");
+    return RC::INTERNAL;
+  }
+
+  for (const string &table_name : table_names) {
+    sweep_tables_.push_back(db.find_table(table_name.c_str()));
+  }
+
+  running_ = true;
+  thread_  = make_unique<thread>(&MvccPurger::thread_func, this);
+  return RC::SUCCESS;
+}
+
+void MvccPurger::stop()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!thread_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+
+  thread_->join();
+  thread_.reset();
+  LOG_INFO("mvcc purger stopped. %s", stat().to_string().c_str());
+}
+
+void MvccPurger::add_deleted(Table *table, const RID &rid, int32_t end_xid)
+{
+  add(PurgeEntry{table, rid, end_xid, true /*deleted*/});
+}
+
+void MvccPurger::add_updated(Table *table, const RID &rid, int32_t end_xid)
+{
+  add(PurgeEntry{table, rid, end_xid, false /*deleted*/});
+}
+
+void MvccPurger::add(const PurgeEntry &entry)
+{
+  lock_guard<mutex> guard(lock_);
+  queue_.push_back(entry);
+  stat_.queued_count++;
+}
+
+void MvccPurger::remove_table(Table *table)
+{
+  lock_guard<mutex> purge_guard(purge_lock_);
+  lock_guard<mutex> guard(lock_);
+
+  const size_t old_size = queue_.size();
+  erase_if(queue_, [table](const PurgeEntry &entry) { return entry.table == table; });
+  stat_.skipped_count += old_size - queue_.size();
+  erase(sweep_tables_, table);
+}
+
+void MvccPurger::thread_func()
+{
+  thread_set_name("MvccPurger");
+  LOG_INFO("mvcc purger started");
+
+  sweep();
+
+  auto     last_stat_time = chrono::steady_clock::now();
+  uint64_t last_backlog   = 0;
+
+  unique_lock<mutex> guard(lock_);
+  while (running_) {
+    const uint64_t backlog = queue_.size();
+    guard.unlock();
+    const int purged = purge_once();
+
+    // 定期打印统计信息，积压增长很快时不用等到下一个周期
+    const auto now = chrono::steady_clock::now();
+    if (now - last_stat_time >= STAT_INTERVAL ||
+        (backlog >= static_cast<uint64_t>(BATCH_SIZE) && backlog >= last_backlog * 2)) {
+      LOG_INFO("mvcc purger stat. %s", stat().to_string().c_str());
+      LOG_INFO("row lock stat. %s", trx_kit_.lock_manager().stat().to_string().c_str());
+      last_stat_time = now;
+      last_backlog   = backlog;
+    }
+    guard.lock();
+
+    // 处理了一整批说明还有很多积压，立即开始下一轮
+    if (purged < BATCH_SIZE) {
+      cond_.wait_for(guard, PURGE_INTERVAL, [this]() { return !running_; });
+    }
+  }
+}
+
+int MvccPurger::purge_once()
+{
+  lock_guard<mutex> purge_guard(purge_lock_);
+
+  // 队列中的记录结束得比最早的活跃事务还早，就不会再有事务访问它
+  const int32_t      oldest_trx_id = trx_kit_.oldest_active_trx_id();
+  vector<PurgeEntry> entries;
+  {
+    lock_guard<mutex> guard(lock_);
+    while (!queue_.empty() && static_cast<int>(entries.size()) < BATCH_SIZE &&
+           queue_.front().end_xid < oldest_trx_id) {
+      entries.push_back(queue_.front());
+      queue_.pop_front();
+    }
+  }
+
+  for (const PurgeEntry &entry : entries) {
+    purge_entry(entry, oldest_trx_id);
+  }
+
+  if (!entries.empty()) {
+    LOG_DEBUG("mvcc purger purged %d entries. oldest trx id=%d", static_cast<int>(entries.size()), oldest_trx_id);
+  }
+  return static_cast<int>(entries.size());
+}
+
+void MvccPurger::purge_entry(const PurgeEntry &entry, int32_t oldest_trx_id)
+{
+  if (entry.deleted) {
+    purge_record(entry.table, entry.rid, entry.end_xid);
+    return;
+  }
+
+  Field end_field = end_xid_field(entry.table);
+  auto  removable = [&end_field, oldest_trx_id](const Record &version) {
+    const int32_t end_xid = end_field.get_int(version);
+    return end_xid > 0 && end_xid < oldest_trx_id;
+  };
+  const size_t removed = trx_kit_.undo_segment().trim(entry.table->table_id(), entry.rid, removable);
+
+  lock_guard<mutex> guard(lock_);
+  stat_.purged_versions += removed;
+}
+
+void MvccPurger::purge_record(Table *table, const RID &rid, int32_t end_xid)
+{
+  Record record;
+  RC     rc = table->get_record(rid, record);
+  if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+    LOG_WARN("failed to get record to purge. table=%s, rid=%s, rc=%s", table->name(), rid.to_string().c_str(), strrc(rc));
+  }
+
+  // 已经提交删除的记录不会再被修改，不一致说明这个位置已经不是原来的记录了
+  if (OB_FAIL(rc) || end_xid_field(table).get_int(record) != end_xid) {
+    lock_guard<mutex> guard(lock_);
+    stat_.skipped_count++;
+    return;
+  }
+
+  // 先删除旧版本，这个位置之后可能会插入新的记录
+  const size_t removed = trx_kit_.undo_segment().trim(table->table_id(), rid, [](const Record &) { return true; });
+
+  rc = table->delete_record(record);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to purge record. table=%s, rid=%s, rc=%s", table->name(), rid.to_string().c_str(), strrc(rc));
+  }
+
+  lock_guard<mutex> guard(lock_);
+  stat_.purged_versions += removed;
+  if (OB_SUCC(rc)) {
+    stat_.purged_records++;
+  } else {
+    stat_.skipped_count++;
+  }
+}
+
+void MvccPurger::sweep()
+{
+  while (true) {
+    lock_guard<mutex> purge_guard(purge_lock_);
+
+    Table *table = nullptr;
+    {
+      lock_guard<mutex> guard(lock_);
+      if (!running_ || sweep_tables_.empty()) {
+        return;
+      }
+      table = sweep_tables_.back();
+      sweep_tables_.pop_back();
+    }
+
+    sweep_table(table);
+  }
+}
+
+void MvccPurger::sweep_table(Table *table)
+{
+  const int32_t oldest_trx_id = trx_kit_.oldest_active_trx_id();
+  const int32_t max_trx_id    = trx_kit_.max_trx_id();
+  Field         end_field     = end_xid_field(table);
+
+  // 扫描时持有页面的锁，先找出所有要回收的记录，扫描结束后再删除
+  vector<pair<RID, int32_t>> dead_records;
+  RecordFileScanner          scanner;
+  RC                         rc = table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create scanner to sweep table. table=%s, rc=%s", table->name(), strrc(rc));
+    return;
+  }
+
+  Record record;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    const int32_t end_xid = end_field.get_int(record);
+    if (end_xid > 0 && end_xid != max_trx_id && end_xid < oldest_trx_id) {
+      dead_records.emplace_back(record.rid(), end_xid);
+    }
+  }
+  scanner.close_scan();
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to sweep table. table=%s, rc=%s", table->name(), strrc(rc));
+  }
+
+  for (const auto &[rid, end_xid] : dead_records) {
+    purge_record(table, rid, end_xid);
+  }
+  LOG_INFO("mvcc purger swept table. table=%s, dead records=%d", table->name(), static_cast<int>(dead_records.size()));
+}
+
+MvccPurgeStat MvccPurger::stat() const
+{
+  MvccPurgeStat stat;
+  {
+    lock_guard<mutex> guard(lock_);
+    stat         = stat_;
+    stat.backlog = queue_.size();
+  }
+  stat.undo_versions = trx_kit_.undo_segment().version_count();
+  stat.oldest_trx_id = trx_kit_.oldest_active_trx_id();
+  return stat;
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/record/record.h"
+
+class Db;
+class Table;
+class MvccTrxKit;
+
+/**
+ * @brief 垃圾回收的统计信息
+ * @ingroup Transaction
+ */
+struct MvccPurgeStat
+{
+  uint64_t queued_count    = 0;  ///< 进入回收队列的记录个数
+  uint64_t purged_records  = 0;  ///< 从表中物理删除的记录个数，包括启动时扫描出来的
+  uint64_t purged_versions = 0;  ///< 从版本链上删除的旧版本个数
+  uint64_t skipped_count   = 0;  ///< 记录已经不存在，或者不再是删除时的版本，不需要回收的个数
+  uint64_t backlog         = 0;  ///< 队列中还在等待回收的记录个数
+  uint64_t undo_versions   = 0;  ///< 版本链上还保存着的旧版本个数
+  int32_t  oldest_trx_id   = 0;  ///< 最早的活跃事务，在它之前结束的版本都可以回收
+
+  std::string to_string() const;
+};
+
+/**
+ * @brief 多版本事务的垃圾回收
+ * @ingroup Transaction
+ * @details 事务删除记录只是设置了记录的end xid，提交之后这条记录仍然留在表和索引中，
+ * 扫描时每次都要读出来再跳过。原地更新留下的旧版本，如果提交时还有读事务在使用，也会一直留在版本链上。
+ * 事务提交时把这些记录放到回收队列中，后台线程在所有活跃事务都看不到它们之后：
+ * 1. 删除的记录，从索引和表中物理删除，空出来的位置可以给新插入的记录使用；
+ * 2. 更新过的记录，删除版本链上不再需要的旧版本。
+ * 队列只在内存中，重启时后台线程先扫描一遍所有的表，回收重启前已经删除的记录。
+ * 物理删除记录与回滚插入的记录一样，通过表和索引自己的日志保证重启后的一致性。
+ * 后台线程每隔 STAT_INTERVAL 把统计信息打印到日志中，积压的记录比上次打印时翻倍的话立即打印，
+ * 用来判断回收是否跟得上。行锁的统计信息也一起打印。
+ */
+class MvccPurger
+{
+public:
+  static constexpr int                       BATCH_SIZE = 256;
+  static constexpr std::chrono::milliseconds PURGE_INTERVAL{1000};
+  static constexpr std::chrono::seconds      STAT_INTERVAL{60};
+
+  explicit MvccPurger(MvccTrxKit &trx_kit) : trx_kit_(trx_kit) {}
+  ~MvccPurger();
+
+  /**
+   * @brief 启动后台线程
+   * @details 在数据库恢复完成之后调用，此时打开的表都需要扫描一遍
+   */
+  RC   start(Db &db);
+  void stop();
+
+  /**
+   * @brief 事务提交之后，把删除的记录放到回收队列中
+   * @param end_xid 删除这条记录的事务的提交事务号
+   */
+  void add_deleted(Table *table, const RID &rid, int32_t end_xid);
+
+  /**
+   * @brief 事务提交时版本链上还有旧版本被其它事务使用，等它们结束后再删除
+   */
+  void add_updated(Table *table, const RID &rid, int32_t end_xid);
+
+  /**
+   * @brief 删除表之前调用，丢弃这个表上还没有回收的记录
+   * @details 会等待正在进行的回收完成，之后不会再访问这个表
+   */
+  void remove_table(Table *table);
+
+  /**
+   * @brief 回收一批已经没有事务能看到的记录和旧版本
+   * @details 队列大致按照提交的顺序排列，遇到还有事务可能看到的记录就停止
+   * @return 这一批处理的队列中的记录个数
+   */
+  int purge_once();
+
+  /**
+   * @brief 扫描启动时打开的表，后台线程开始回收队列之前先执行
+   */
+  void sweep();
+
+  MvccPurgeStat stat() const;
+
+private:
+  struct PurgeEntry
+  {
+    Table  *table   = nullptr;
+    RID     rid;
+    int32_t end_xid = 0;      ///< 删除或者更新这条记录的事务的提交事务号
+    bool    deleted = false;  ///< 删除的记录，否则是更新过的记录
+  };
+
+  void add(const PurgeEntry &entry);
+  void thread_func();
+
+  /**
+   * @brief 扫描表中所有的记录，回收已经删除并且没有事务能看到的记录
+   */
+  void sweep_table(Table *table);
+
+  /**
+   * @brief 回收一条记录。调用者持有 purge_lock_
+   */
+  void purge_entry(const PurgeEntry &entry, int32_t oldest_trx_id);
+  void purge_record(Table *table, const RID &rid, int32_t end_xid);
+
+private:
+  MvccTrxKit &trx_kit_;
+
+  std::mutex purge_lock_;  ///< 正在回收时持有，删除表时需要等待回收完成
+
+  mutable std::mutex           lock_;  ///< 保护下面的成员
+  std::deque<PurgeEntry>       queue_;
+  std::vector<Table *>         sweep_tables_;  ///< 启动时还没有扫描的表
+  MvccPurgeStat                stat_;
+  std::condition_variable      cond_;
+  bool                         running_ = false;
+  std::unique_ptr<std::thread> thread_;
+};
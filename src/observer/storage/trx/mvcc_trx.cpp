@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/04/24.
 //
 
+#include <algorithm>
 #include <limits>
 #include <ranges>
 
@@ -24,6 +25,8 @@ using namespace std;
 
 MvccTrxKit::~MvccTrxKit()
 {
+  LOG_INFO("row lock stat. %s", lock_manager_.stat().to_string().c_str());
+
   vector<Trx *> tmp_trxes;
   tmp_trxes.swap(trxes_);
 
@@ -47,6 +50,59 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const { return &fields_; }
 
 int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
+int32_t MvccTrxKit::begin_trx(MvccReadView &read_view)
+{
+  // 分配事务号和记为活跃事务要在同一个锁里面，否则别的事务创建读视图或者计算最早的活跃事务时可能漏掉它
+  lock_.lock();
+  int32_t trx_id = next_trx_id();
+
+  read_view.high_limit = trx_id + 1;
+  read_view.low_limit  = active_xids_.empty() ? read_view.high_limit : active_xids_.begin()->first;
+  read_view.active_xids.clear();
+  read_view.active_xids.reserve(active_xids_.size());
+  for (const auto &[xid, low_limit] : active_xids_) {
+    read_view.active_xids.push_back(xid);
+  }
+
+  active_xids_.emplace(trx_id, read_view.low_limit);
+  lock_.unlock();
+  return trx_id;
+}
+
+int32_t MvccTrxKit::begin_commit()
+{
+  lock_.lock();
+  int32_t commit_xid = next_trx_id();
+  active_xids_.emplace(commit_xid, commit_xid);
+  lock_.unlock();
+  return commit_xid;
+}
+
+void MvccTrxKit::end_trx(int32_t xid)
+{
+  lock_.lock();
+  active_xids_.erase(xid);
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::oldest_active_trx_id()
+{
+  lock_.lock();
+  int32_t xid = current_trx_id_.load() + 1;
+  for (const auto &[active_xid, low_limit] : active_xids_) {
+    xid = min(xid, low_limit);
+  }
+  lock_.unlock();
+  return xid;
+}
+
+void MvccTrxKit::advance_trx_id(int32_t trx_id)
+{
+  int32_t current = current_trx_id_.load();
+  while (current < trx_id && !current_trx_id_.compare_exchange_weak(current, trx_id)) {
+  }
+}
+
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
 Trx *MvccTrxKit::create_trx(LogHandler &log_handler)
@@ -66,17 +122,19 @@ Trx *MvccTrxKit::create_trx(LogHandler &log_handler, int32_t trx_id)
   if (trx != nullptr) {
     lock_.lock();
     trxes_.push_back(trx);
-    if (current_trx_id_ < trx_id) {
-      current_trx_id_ = trx_id;
-    }
     lock_.unlock();
+    advance_trx_id(trx_id);
   }
   return trx;
 }
 
 void MvccTrxKit::destroy_trx(Trx *trx)
 {
+  // 正常情况下事务结束时已经释放了行锁
+  lock_manager_.unlock_all(trx->id());
+
   lock_.lock();
+  active_xids_.erase(trx->id());
   for (auto iter = trxes_.begin(), itend = trxes_.end(); iter != itend; ++iter) {
     if (*iter == trx) {
       trxes_.erase(iter);
@@ -114,6 +172,38 @@ LogReplayer *MvccTrxKit::create_log_replayer(Db &db, LogHandler &log_handler)
   return new MvccTrxLogReplayer(db, *this, log_handler);
 }
 
+LSN MvccTrxKit::min_recovery_lsn(LSN lsn)
+{
+  lock_.lock();
+  for (Trx *trx : trxes_) {
+    LSN recovery_lsn = static_cast<MvccTrx *>(trx)->recovery_lsn();
+    if (recovery_lsn > 0 && recovery_lsn < lsn) {
+      lsn = recovery_lsn;
+    }
+  }
+  lock_.unlock();
+  return lsn;
+}
+
+RC MvccTrxKit::start_purge(Db &db) { return purger_.start(db); }
+
+void MvccTrxKit::stop_purge() { purger_.stop(); }
+
+void MvccTrxKit::drop_table(Table *table) { purger_.remove_table(table); }
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MvccReadView::visible(int32_t commit_xid) const
+{
+  if (commit_xid < low_limit) {
+    return true;
+  }
+  if (commit_xid >= high_limit) {
+    return false;
+  }
+  return !binary_search(active_xids.begin(), active_xids.end(), commit_xid);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler) : trx_kit_(kit), log_handler_(log_handler)
@@ -137,6 +227,8 @@ RC MvccTrx::insert_record(Table *table, Record &record)
   begin_field.set_int(record, -trx_id_);
   end_field.set_int(record, trx_kit_.max_trx_id());
 
+  set_recovery_lsn_if_need();
+
   RC rc = table->insert_record(record);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to insert record into table. rc=%s", strrc(rc));
@@ -157,12 +249,20 @@ RC MvccTrx::delete_record(Table *table, Record &record)
   Field end_field;
   trx_fields(table, begin_field, end_field);
 
+  RC rc = lock_record(table, record.rid());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
   RC delete_result = RC::SUCCESS;
 
-  RC rc = table->visit_record(record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
-    RC rc = this->visit_record(table, inplace_record, ReadWriteMode::READ_WRITE);
+  set_recovery_lsn_if_need();
+
+  rc = table->visit_record(record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
+    // 已经持有行锁，不会再有别的事务正在修改这条记录
+    RC rc = this->visit_version(table, inplace_record, ReadWriteMode::READ_WRITE);
     if (OB_FAIL(rc)) {
-      delete_result = rc;
+      delete_result = (rc == RC::LOCKED_NEED_WAIT) ? RC::LOCKED_CONCURRENCY_CONFLICT : rc;
       return false;
     }
 
@@ -177,6 +277,9 @@ RC MvccTrx::delete_record(Table *table, Record &record)
 
   if (OB_FAIL(delete_result)) {
     LOG_TRACE("record is not visible. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(delete_result));
+    if (delete_result == RC::LOCKED_CONCURRENCY_CONFLICT) {
+      trx_kit_.lock_manager().add_conflict();
+    }
     return delete_result;
   }
 
@@ -189,7 +292,135 @@ RC MvccTrx::delete_record(Table *table, Record &record)
   return RC::SUCCESS;
 }
 
+RC MvccTrx::update_record(Table *table, Record &old_record, Record &new_record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const RID &rid = old_record.rid();
+  if (!table->index_key_changed(old_record, new_record)) {
+    return update_record_in_place(table, rid, new_record);
+  }
+
+  if (begin_field.get_int(old_record) == -trx_id_) {
+    // 当前事务插入的记录，其它事务看不到，可以直接修改索引。回滚时会直接删除这条记录，所以不需要额外记录事务日志
+    bool updated_by_self = false;
+    trx_kit_.undo_segment().visit(table->table_id(), rid, [this, &end_field, &updated_by_self](Record &version) {
+      updated_by_self = end_field.get_int(version) == -trx_id_;
+      return false;
+    });
+
+    if (!updated_by_self) {
+      begin_field.set_int(new_record, -trx_id_);
+      end_field.set_int(new_record, end_field.get_int(old_record));
+      return table->update_record(old_record, new_record);
+    }
+  }
+
+  RC rc = delete_record(table, old_record);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to delete old record while updating. rid=%s, rc=%s", 
+              old_record.rid().to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  return insert_record(table, new_record);
+}
+
+RC MvccTrx::update_record_in_place(Table *table, const RID &rid, Record &new_record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  RC rc = lock_record(table, rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  RC   update_result = RC::SUCCESS;
+  bool new_version   = false;
+
+  set_recovery_lsn_if_need();
+
+  auto record_updater = [&](Record &inplace_record) -> bool {
+    update_result = this->visit_version(table, inplace_record, ReadWriteMode::READ_WRITE);
+    if (update_result == RC::LOCKED_NEED_WAIT) {
+      update_result = RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+    if (OB_FAIL(update_result)) {
+      return false;
+    }
+
+    if (begin_field.get_int(inplace_record) != -trx_id_) {
+      // 当前事务第一次修改这条记录，把现在的版本放到版本链上
+      update_result = log_handler_.update_record(trx_id_, table, rid, inplace_record.data(), inplace_record.len());
+      if (OB_FAIL(update_result)) {
+        LOG_WARN("failed to append update record log. trx id=%d, rid=%s, rc=%s",
+                 trx_id_, rid.to_string().c_str(), strrc(update_result));
+        return false;
+      }
+
+      end_field.set_int(inplace_record, -trx_id_);
+      trx_kit_.undo_segment().push(table->table_id(), rid, trx_id_, inplace_record.data(), inplace_record.len());
+      new_version = true;
+    }
+
+    begin_field.set_int(new_record, -trx_id_);
+    end_field.set_int(new_record, trx_kit_.max_trx_id());
+    memcpy(inplace_record.data(), new_record.data(), inplace_record.len());
+    return true;
+  };
+
+  rc = table->visit_record(rid, record_updater);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to visit record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  if (OB_FAIL(update_result)) {
+    LOG_TRACE("failed to update record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(update_result));
+    if (update_result == RC::LOCKED_CONCURRENCY_CONFLICT) {
+      trx_kit_.lock_manager().add_conflict();
+    }
+    return update_result;
+  }
+
+  if (new_version) {
+    operations_.push_back(Operation(Operation::Type::UPDATE, table, rid));
+  }
+
+  new_record.set_rid(rid);
+  table->bump_version();
+  return RC::SUCCESS;
+}
+
+RC MvccTrx::lock_record(Table *table, const RID &rid)
+{
+  if (recovering_) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = trx_kit_.lock_manager().lock(trx_id_, table->table_id(), rid);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to lock record. trx id=%d, table=%s, rid=%s, rc=%s",
+              trx_id_, table->name(), rid.to_string().c_str(), strrc(rc));
+  }
+  return rc;
+}
+
 RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
+{
+  // 扫描时不等待，修改这条记录时再加锁等待
+  RC rc = visit_version(table, record, mode);
+  if (rc == RC::LOCKED_NEED_WAIT) {
+    rc = RC::SUCCESS;
+  }
+  return rc;
+}
+
+RC MvccTrx::visit_version(Table *table, Record &record, ReadWriteMode mode)
 {
   Field begin_field;
   Field end_field;
@@ -198,50 +429,99 @@ RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
   int32_t begin_xid = begin_field.get_int(record);
   int32_t end_xid   = end_field.get_int(record);
 
-  RC rc = RC::SUCCESS;
-  if (begin_xid > 0 && end_xid > 0) {
-    if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
-      rc = RC::SUCCESS;
-    } else {
-      LOG_TRACE("record invisible. trx id=%d, begin xid=%d, end xid=%d", trx_id_, begin_xid, end_xid);
-      rc = RC::RECORD_INVISIBLE;
+  RC rc = check_visibility(begin_xid, end_xid, mode);
+  if (rc != RC::RECORD_INVISIBLE || !newer_than_snapshot(begin_xid)) {
+    return rc;
+  }
+
+  // 最新的版本是当前事务开始之后其它事务修改的，沿着版本链找当前事务能看到的旧版本
+  bool found = false;
+  auto version_visitor = [&](Record &version) -> bool {
+    RC rc = check_visibility(begin_field.get_int(version), end_field.get_int(version), ReadWriteMode::READ_ONLY);
+    if (OB_FAIL(rc)) {
+      return true;
     }
-  } else if (begin_xid < 0) {
-    // begin xid 小于0说明是刚插入而且没有提交的数据
-    if (-begin_xid == trx_id_) {
-      rc = RC::SUCCESS;
-    } else {
-      LOG_TRACE("record invisible. someone is updating this record right now. trx id=%d, begin xid=%d, end xid=%d",
+
+    found = true;
+    record.copy_data(version.data(), version.len());
+    return false;
+  };
+  trx_kit_.undo_segment().visit(table->table_id(), record.rid(), version_visitor);
+
+  if (!found) {
+    return RC::RECORD_INVISIBLE;
+  }
+
+  if (mode == ReadWriteMode::READ_WRITE && begin_xid < 0) {
+    // 修改这条记录的事务还没有结束，它回滚的话当前事务看到的仍然是最新的版本
+    LOG_TRACE("need wait. someone is updating this record right now. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  if (mode == ReadWriteMode::READ_WRITE) {
+    // 当前事务能看到的不是最新的版本，说明别的事务已经修改了这条记录
+    LOG_TRACE("concurrency conflict. record has been updated by others. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  return RC::SUCCESS;
+}
+
+RC MvccTrx::check_visibility(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const
+{
+  // begin xid 小于0说明是刚插入或者刚更新而且没有提交的数据
+  if (begin_xid < 0 && -begin_xid != trx_id_) {
+    LOG_TRACE("record invisible. someone is updating this record right now. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::RECORD_INVISIBLE;
+  }
+
+  if (begin_xid > 0 && !read_view_.visible(begin_xid)) {
+    LOG_TRACE("record invisible. committed after read view. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::RECORD_INVISIBLE;
+  }
+
+  if (end_xid == trx_kit_.max_trx_id()) {
+    return RC::SUCCESS;
+  }
+
+  if (end_xid < 0) {
+    // end xid 小于0 说明是正在删除但是还没有提交的数据
+    if (-end_xid == trx_id_) {
+      LOG_TRACE("record invisible. self has deleted this record. trx id=%d, begin xid=%d, end xid=%d",
                 trx_id_, begin_xid, end_xid);
-      rc = RC::RECORD_INVISIBLE;
+      return RC::RECORD_INVISIBLE;
     }
-  } else if (end_xid < 0) {
-    // end xid 小于0 说明是正在删除但是还没有提交的数据
-    if (mode == ReadWriteMode::READ_ONLY) {
-      // 如果 -end_xid 就是当前事务的事务号，说明是当前事务删除的
-      if (-end_xid != trx_id_) {
-        rc = RC::SUCCESS;
-      } else {
-        LOG_TRACE("record invisible. self has deleted this record. trx id=%d, begin xid=%d, end xid=%d",
-                  trx_id_, begin_xid, end_xid);
-        rc = RC::RECORD_INVISIBLE;
-      }
-    } else {
-      // 如果当前想要修改此条数据，并且不是当前事务删除的，简单的报错
-      // 这是事务并发处理的一种方式，非常简单粗暴。其它的并发处理方法，可以等待，或者让客户端重试
-      // 或者等事务结束后，再检测修改的数据是否有冲突
-      if (-end_xid != trx_id_) {
-        LOG_TRACE("concurrency conflit. someone is deleting this record right now. trx id=%d, begin xid=%d, end xid=%d",
-                  trx_id_, begin_xid, end_xid);
-        rc = RC::LOCKED_CONCURRENCY_CONFLICT;
-      } else {
-        LOG_TRACE("record invisible. self has deleted this record. trx id=%d, begin xid=%d, end xid=%d",
-                  trx_id_, begin_xid, end_xid);
-        rc = RC::RECORD_INVISIBLE;
-      }
+
+    if (mode == ReadWriteMode::READ_WRITE) {
+      // 别的事务正在删除这条记录，要等它结束才知道能不能修改。它持有这条记录的行锁，修改时在锁上等待
+      LOG_TRACE("need wait. someone is deleting this record right now. trx id=%d, begin xid=%d, end xid=%d",
+                trx_id_, begin_xid, end_xid);
+      return RC::LOCKED_NEED_WAIT;
     }
+    return RC::SUCCESS;
   }
-  return rc;
+
+  if (read_view_.visible(end_xid)) {
+    LOG_TRACE("record invisible. deleted before read view. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::RECORD_INVISIBLE;
+  }
+
+  if (mode == ReadWriteMode::READ_WRITE) {
+    // 读视图创建之后，别的事务删除了这条记录并且已经提交
+    LOG_TRACE("concurrency conflit. record has been deleted. trx id=%d, begin xid=%d, end xid=%d",
+              trx_id_, begin_xid, end_xid);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  return RC::SUCCESS;
+}
+
+bool MvccTrx::newer_than_snapshot(int32_t begin_xid) const
+{
+  return (begin_xid < 0 && -begin_xid != trx_id_) || (begin_xid > 0 && !read_view_.visible(begin_xid));
 }
 
 /**
@@ -263,11 +543,22 @@ void MvccTrx::trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_fi
   end_xid_field.set_field(&trx_fields[1]);
 }
 
+/**
+ * @brief 在第一次修改数据之前记录当前的LSN
+ * @details 之后写入的日志LSN都比它大。检查点不能越过这个位置，否则重启时就找不到这个事务的全部日志来回滚了
+ */
+void MvccTrx::set_recovery_lsn_if_need()
+{
+  if (recovery_lsn_.load() == 0) {
+    recovery_lsn_.store(log_handler_.current_lsn() + 1);
+  }
+}
+
 RC MvccTrx::start_if_need()
 {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
+    trx_id_ = trx_kit_.begin_trx(read_view_);
     LOG_DEBUG("current thread change to new trx with %d", trx_id_);
     started_ = true;
   }
@@ -276,15 +567,18 @@ RC MvccTrx::start_if_need()
 
 RC MvccTrx::commit()
 {
-  int32_t commit_id = trx_kit_.next_trx_id();
+  int32_t commit_id = trx_kit_.begin_commit();
   return commit_with_trx_id(commit_id);
 }
 
 RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
 {
-  // TODO 原子性提交BUG：这里存在一个很大的问题，不能让其他事务一次性看到当前事务更新到的数据或同时看不到
+  // 提交事务号在修改完所有的记录之前都是活跃的，其它事务要么看到全部的修改，要么都看不到
   RC rc    = RC::SUCCESS;
   started_ = false;
+  if (!recovering_) {
+    trx_kit_.end_trx(trx_id_);
+  }
 
   for (const Operation &operation : operations_) {
     switch (operation.type()) {
@@ -310,6 +604,35 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
                rid.to_string().c_str(), strrc(rc));
       } break;
 
+      case Operation::Type::UPDATE: {
+        RID    rid(operation.page_num(), operation.slot_num());
+        Table *table = operation.table();
+        Field  begin_xid_field, end_xid_field;
+        trx_fields(table, begin_xid_field, end_xid_field);
+
+        // 先修改最新的版本，再修改旧版本的结束时间，否则中间会有事务两个版本都看不到
+        auto record_updater = [this, &begin_xid_field, commit_xid](Record &record) -> bool {
+          ASSERT(begin_xid_field.get_int(record) == -this->trx_id_, 
+                 "got an invalid record while committing. begin xid=%d, this trx id=%d", 
+                 begin_xid_field.get_int(record), trx_id_);
+
+          begin_xid_field.set_int(record, commit_xid);
+          return true;
+        };
+
+        rc = table->visit_record(rid, record_updater);
+        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
+               rid.to_string().c_str(), strrc(rc));
+
+        auto version_updater = [this, &end_xid_field, commit_xid](Record &version) -> bool {
+          if (end_xid_field.get_int(version) == -trx_id_) {
+            end_xid_field.set_int(version, commit_xid);
+          }
+          return false;
+        };
+        trx_kit_.undo_segment().visit(table->table_id(), rid, version_updater);
+      } break;
+
       case Operation::Type::DELETE: {
         Table *table = operation.table();
         RID    rid(operation.page_num(), operation.slot_num());
@@ -338,20 +661,71 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
     }
   }
 
+  // 修改对其它事务可见了
+  if (!recovering_) {
+    trx_kit_.end_trx(commit_xid);
+  }
+  for (const Operation &operation : operations_) {
+    operation.table()->bump_version();
+  }
+
+  if (!recovering_) {
+    for (const Operation &operation : operations_) {
+      if (operation.type() == Operation::Type::DELETE) {
+        trx_kit_.purger().add_deleted(
+            operation.table(), RID(operation.page_num(), operation.slot_num()), commit_xid);
+      }
+    }
+  }
+
+  trim_undo_versions(commit_xid);
+
   if (!recovering_) {
     rc = log_handler_.commit(trx_id_, commit_xid);
   }
 
   operations_.clear();
+  recovery_lsn_.store(0);
+  trx_kit_.lock_manager().unlock_all(trx_id_);
 
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
   return rc;
 }
 
+void MvccTrx::trim_undo_versions(int32_t commit_xid)
+{
+  const int32_t oldest_trx_id = trx_kit_.oldest_active_trx_id();
+  for (const Operation &operation : operations_) {
+    if (operation.type() != Operation::Type::UPDATE) {
+      continue;
+    }
+
+    Table *table = operation.table();
+    RID    rid(operation.page_num(), operation.slot_num());
+    Field  begin_xid_field, end_xid_field;
+    trx_fields(table, begin_xid_field, end_xid_field);
+
+    // 在最早的活跃事务开始之前就结束的版本，不会再有事务访问
+    auto removable = [&end_xid_field, oldest_trx_id](const Record &version) {
+      const int32_t end_xid = end_xid_field.get_int(version);
+      return end_xid > 0 && end_xid < oldest_trx_id;
+    };
+    trx_kit_.undo_segment().trim(table->table_id(), rid, removable);
+
+    // 提交之前开始的事务还可能读取刚刚结束的旧版本，等它们结束之后再回收
+    if (!recovering_ && oldest_trx_id < commit_xid) {
+      trx_kit_.purger().add_updated(table, rid, commit_xid);
+    }
+  }
+}
+
 RC MvccTrx::rollback()
 {
   RC rc    = RC::SUCCESS;
   started_ = false;
+  if (!recovering_) {
+    trx_kit_.end_trx(trx_id_);
+  }
 
   for (auto iter = operations_.rbegin(), itend = operations_.rend(); iter != itend; ++iter) {
     const Operation &operation = *iter;
@@ -411,6 +785,41 @@ RC MvccTrx::rollback()
                rid.to_string().c_str(), strrc(rc));
       } break;
 
+      case Operation::Type::UPDATE: {
+        Table *table = operation.table();
+        RID    rid(operation.page_num(), operation.slot_num());
+
+        Record old_version;
+        rc = trx_kit_.undo_segment().pop(table->table_id(), rid, trx_id_, old_version);
+        if (OB_FAIL(rc)) {
+          ASSERT(recovering_ && rc == RC::RECORD_NOT_EXIST, "failed to get old version while rollback. rid=%s, rc=%s",
+                 rid.to_string().c_str(), strrc(rc));
+          rc = RC::SUCCESS;
+          continue;
+        }
+
+        Field begin_xid_field, end_xid_field;
+        trx_fields(table, begin_xid_field, end_xid_field);
+        end_xid_field.set_int(old_version, trx_kit_.max_trx_id());
+
+        auto record_updater = [this, &begin_xid_field, &old_version](Record &record) -> bool {
+          if (recovering_ && begin_xid_field.get_int(record) != -trx_id_) {
+            return false;
+          }
+
+          ASSERT(begin_xid_field.get_int(record) == -trx_id_, 
+                "got an invalid record while rollback. begin xid=%d, this trx id=%d", 
+                begin_xid_field.get_int(record), trx_id_);
+
+          memcpy(record.data(), old_version.data(), record.len());
+          return true;
+        };
+
+        rc = table->visit_record(rid, record_updater);
+        ASSERT(rc == RC::SUCCESS, "failed to get record while rollback. rid=%s, rc=%s",
+               rid.to_string().c_str(), strrc(rc));
+      } break;
+
       default: {
         ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
       }
@@ -422,16 +831,32 @@ RC MvccTrx::rollback()
   if (!recovering_) {
     rc = log_handler_.rollback(trx_id_);
   }
+  recovery_lsn_.store(0);
+  trx_kit_.lock_manager().unlock_all(trx_id_);
   LOG_TRACE("append trx rollback log. trx id=%d, rc=%s", trx_id_, strrc(rc));
   return rc;
 }
 
+/**
+ * @brief 重启时不会有事务读取旧版本，事务结束后就删除回放日志时生成的旧版本
+ */
+void MvccTrx::discard_undo_versions()
+{
+  for (const Operation &operation : operations_) {
+    if (operation.type() == Operation::Type::UPDATE) {
+      trx_kit_.undo_segment().remove(
+          operation.table_id(), RID(operation.page_num(), operation.slot_num()), trx_id_);
+    }
+  }
+}
+
 RC find_table(Db *db, const LogEntry &log_entry, Table *&table)
 {
   auto *trx_log_header = reinterpret_cast<const MvccTrxLogHeader *>(log_entry.data());
   switch (MvccTrxLogOperation(trx_log_header->operation_type).type()) {
     case MvccTrxLogOperation::Type::INSERT_RECORD:
-    case MvccTrxLogOperation::Type::DELETE_RECORD: {
+    case MvccTrxLogOperation::Type::DELETE_RECORD:
+    case MvccTrxLogOperation::Type::UPDATE_RECORD: {
       auto *trx_log_record = reinterpret_cast<const MvccTrxRecordLogEntry *>(log_entry.data());
       table                = db->find_table(trx_log_record->table_id);
       if (nullptr == table) {
@@ -466,15 +891,24 @@ RC MvccTrx::redo(Db *db, const LogEntry &log_entry)
       operations_.push_back(Operation(Operation::Type::DELETE, table, trx_log_record->rid));
     } break;
 
+    case MvccTrxLogOperation::Type::UPDATE_RECORD: {
+      // 重新生成旧版本，如果事务最后没有提交，回滚时要用它恢复数据
+      auto *trx_log_record = reinterpret_cast<const MvccTrxUpdateLogEntry *>(log_entry.data());
+      trx_kit_.undo_segment().push(
+          table->table_id(), trx_log_record->record.rid, trx_id_, trx_log_record->data, trx_log_record->data_len);
+      operations_.push_back(Operation(Operation::Type::UPDATE, table, trx_log_record->record.rid));
+    } break;
+
     case MvccTrxLogOperation::Type::COMMIT: {
-      // auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
-      // commit_with_trx_id(trx_log_record->commit_trx_id);
       // 遇到了提交日志，说明前面的记录都已经提交成功了
+      auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
+      trx_kit_.advance_trx_id(trx_log_record->commit_trx_id);
+      discard_undo_versions();
     } break;
 
     case MvccTrxLogOperation::Type::ROLLBACK: {
-      // do nothing
       // 遇到了回滚日志，前面的回滚操作也都执行完成了
+      discard_undo_versions();
     } break;
 
     default: {
@@ -14,15 +14,35 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "storage/trx/trx.h"
+#include "storage/trx/mvcc_purger.h"
 #include "storage/trx/mvcc_trx_log.h"
+#include "storage/trx/row_lock_manager.h"
+#include "storage/trx/undo_segment.h"
 
 class CLogManager;
 class LogHandler;
 class MvccTrxLogHandler;
 
+/**
+ * @brief 多版本事务的读视图
+ * @ingroup Transaction
+ * @details 事务开始时记录下当时还没有结束的事务号，包括还在运行的事务和正在提交的事务的提交事务号。
+ * 一个提交事务号对读视图可见，要求它比 high_limit 小并且不在 active_xids 中，比 low_limit 小的一定可见。
+ * 正在提交的事务要逐条修改记录上的事务号，把它的提交事务号当作没有结束，读事务就不会看到提交了一半的数据。
+ */
+struct MvccReadView
+{
+  int32_t              low_limit  = 0;  ///< 比它小的提交事务号都可见
+  int32_t              high_limit = 0;  ///< 不小于它的提交事务号都不可见，是读视图创建之后才分配的
+  std::vector<int32_t> active_xids;     ///< 读视图创建时还没有结束的事务号，从小到大排列
+
+  bool visible(int32_t commit_xid) const;
+};
+
 class MvccTrxKit : public TrxKit
 {
 public:
@@ -45,9 +65,45 @@ public:
 
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 
+  LSN min_recovery_lsn(LSN lsn) override;
+
+  int32_t current_trx_id() const override { return current_trx_id_.load(); }
+  void    advance_trx_id(int32_t trx_id) override;
+
+  RC   start_purge(Db &db) override;
+  void stop_purge() override;
+  void drop_table(Table *table) override;
+
 public:
   int32_t next_trx_id();
 
+  /**
+   * @brief 分配一个新的事务号，记为活跃的事务，并创建它的读视图
+   */
+  int32_t begin_trx(MvccReadView &read_view);
+
+  /**
+   * @brief 分配一个提交事务号
+   * @details 在修改完所有记录上的事务号之前，它和活跃的事务一样对新的读视图不可见
+   */
+  int32_t begin_commit();
+
+  /**
+   * @brief 事务或者提交结束，不再是活跃的
+   */
+  void end_trx(int32_t xid);
+
+  /**
+   * @brief 所有活跃的事务都能看到的提交事务号的上界
+   * @details 取所有读视图的 low_limit 和正在提交的事务号的最小值，没有活跃事务时返回下一个事务号。
+   * 比它更早结束的旧版本，已经没有事务能看到了
+   */
+  int32_t oldest_active_trx_id();
+
+  UndoSegment    &undo_segment() { return undo_segment_; }
+  MvccPurger     &purger() { return purger_; }
+  RowLockManager &lock_manager() { return lock_manager_; }
+
 public:
   int32_t max_trx_id() const;
 
@@ -58,12 +114,24 @@ private:
 
   common::Mutex      lock_;
   std::vector<Trx *> trxes_;
+  /// 正在运行的事务和正在提交的提交事务号，值是它能看到的提交事务号的下界，受lock_保护
+  std::map<int32_t, int32_t> active_xids_;
+
+  UndoSegment    undo_segment_;   ///< 原地更新的记录的旧版本
+  MvccPurger     purger_{*this};  ///< 回收删除的记录和不再需要的旧版本
+  RowLockManager lock_manager_;   ///< 修改记录时加的行锁
 };
 
 /**
  * @brief 多版本并发事务
  * @ingroup Transaction
- * TODO 没有垃圾回收
+ * @details 每条记录上都有begin xid和end xid两个字段，表示这个版本对哪些事务可见。
+ * 事务开始时创建读视图，begin xid对读视图可见而end xid不可见的版本，就是当前事务能看到的版本。
+ * 没有修改索引键值的更新直接在原来的位置写入新的版本，旧的版本放到 UndoSegment 的版本链上，
+ * 读取时最新的版本不可见，就沿着版本链找到自己能看到的旧版本。
+ * 提交删除的记录和还有事务在使用的旧版本，交给 MvccPurger 在后台回收。
+ * 删除和更新记录之前先加行锁，事务结束时释放。别的事务正在修改这条记录时排队等待，
+ * 它回滚之后当前事务可以继续修改，它提交之后当前事务的快照已经过时，仍然返回冲突。
  */
 class MvccTrx : public Trx
 {
@@ -80,13 +148,22 @@ public:
   RC insert_record(Table *table, Record &record) override;
   RC delete_record(Table *table, Record &record) override;
 
+  /**
+   * @brief 更新一条记录
+   * @details 没有修改索引键值时原地更新，第一次修改这条记录时把旧的版本放到版本链上。
+   * 修改了索引键值时，其它事务还要通过旧的键值找到旧版本，仍然删除旧记录再插入一条新的记录，
+   * 当前事务自己插入的记录除外。
+   */
+  RC update_record(Table *table, Record &old_record, Record &new_record) override;
+
   /**
    * @brief 当访问到某条数据时，使用此函数来判断是否可见，或者是否有访问冲突
    *
    * @param table    要访问的数据属于哪张表
    * @param record   要访问哪条数据
    * @param mode     是否只读访问
-   * @return RC      - SUCCESS 成功
+   * @return RC      - SUCCESS 成功。最新的版本不可见时，record会换成当前事务可见的旧版本的数据。
+   *                   别的事务正在修改这条记录时也返回成功，修改时再等待它结束
    *                 - RECORD_INVISIBLE 此数据对当前事务不可见，应该跳过
    *                 - LOCKED_CONCURRENCY_CONFLICT 与其它事务有冲突
    */
@@ -100,9 +177,44 @@ public:
 
   int32_t id() const override { return trx_id_; }
 
+  /**
+   * @brief 当前事务第一条日志的LSN的下界
+   * @details 在第一次修改数据之前设置，事务结束时清零。没有修改过数据的事务返回0
+   */
+  LSN recovery_lsn() const { return recovery_lsn_.load(); }
+
 private:
   RC   commit_with_trx_id(int32_t commit_id);
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
+  void set_recovery_lsn_if_need();
+
+  /**
+   * @brief 同 visit_record，别的事务正在修改这条记录时返回 LOCKED_NEED_WAIT
+   */
+  RC visit_version(Table *table, Record &record, ReadWriteMode mode);
+
+  /**
+   * @brief 修改记录之前加上行锁，恢复时不需要加锁
+   */
+  RC lock_record(Table *table, const RID &rid);
+
+  /**
+   * @brief 根据一个版本的begin xid和end xid判断是否可见
+   */
+  RC check_visibility(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const;
+
+  /**
+   * @brief 最新的版本是否是读视图之外的事务修改的，这时版本链上可能有当前事务能看到的旧版本
+   */
+  bool newer_than_snapshot(int32_t begin_xid) const;
+
+  RC update_record_in_place(Table *table, const RID &rid, Record &new_record);
+
+  /**
+   * @brief 提交时删除更新过的记录上不再需要的旧版本，还有事务在使用的交给后台回收
+   */
+  void trim_undo_versions(int32_t commit_xid);
+  void discard_undo_versions();
 
 private:
   static const int32_t MAX_TRX_ID = std::numeric_limits<int32_t>::max();
@@ -114,7 +226,9 @@ private:
   MvccTrxKit       &trx_kit_;
   MvccTrxLogHandler log_handler_;
   int32_t           trx_id_     = -1;
+  MvccReadView      read_view_;
   bool              started_    = false;
   bool              recovering_ = false;
   OperationSet      operations_;
+  std::atomic<LSN>  recovery_lsn_{0};
 };
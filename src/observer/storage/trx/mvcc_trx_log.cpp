@@ -32,6 +32,7 @@ string MvccTrxLogOperation::to_string() const
     case Type::DELETE_RECORD: return ret + "DELETE_RECORD";
     case Type::COMMIT: return ret + "COMMIT";
     case Type::ROLLBACK: return ret + "ROLLBACK";
+    case Type::UPDATE_RECORD: return ret + "UPDATE_RECORD";
     default: return ret + "UNKNOWN";
   }
 }
@@ -54,6 +55,15 @@ string MvccTrxRecordLogEntry::to_string() const
   return ss.str();
 }
 
+const int32_t MvccTrxUpdateLogEntry::SIZE = sizeof(MvccTrxUpdateLogEntry);
+
+string MvccTrxUpdateLogEntry::to_string() const
+{
+  stringstream ss;
+  ss << record.to_string() << ", data_len: " << data_len;
+  return ss.str();
+}
+
 const int32_t MvccTrxCommitLogEntry::SIZE = sizeof(MvccTrxCommitLogEntry);
 
 string MvccTrxCommitLogEntry::to_string() const
@@ -99,6 +109,23 @@ RC MvccTrxLogHandler::delete_record(int32_t trx_id, Table *table, const RID &rid
       lsn, LogModule::Id::TRANSACTION, span<const char>(reinterpret_cast<const char *>(&log_entry), sizeof(log_entry)));
 }
 
+RC MvccTrxLogHandler::update_record(int32_t trx_id, Table *table, const RID &rid, const char *old_data, int len)
+{
+  ASSERT(trx_id > 0, "invalid trx_id:%d", trx_id);
+
+  vector<char> log_payload(MvccTrxUpdateLogEntry::SIZE + len);
+  auto *log_entry = reinterpret_cast<MvccTrxUpdateLogEntry *>(log_payload.data());
+  log_entry->record.header.operation_type = MvccTrxLogOperation(MvccTrxLogOperation::Type::UPDATE_RECORD).index();
+  log_entry->record.header.trx_id         = trx_id;
+  log_entry->record.table_id              = table->table_id();
+  log_entry->record.rid                   = rid;
+  log_entry->data_len                     = len;
+  memcpy(log_entry->data, old_data, len);
+
+  LSN lsn = 0;
+  return log_handler_.append(lsn, LogModule::Id::TRANSACTION, std::move(log_payload));
+}
+
 RC MvccTrxLogHandler::commit(int32_t trx_id, int32_t commit_trx_id)
 {
   ASSERT(trx_id > 0 && commit_trx_id > trx_id, "invalid trx_id:%d, commit_trx_id:%d", trx_id, commit_trx_id);
@@ -133,6 +160,8 @@ RC MvccTrxLogHandler::rollback(int32_t trx_id)
       lsn, LogModule::Id::TRANSACTION, span<const char>(reinterpret_cast<const char *>(&log_entry), sizeof(log_entry)));
 }
 
+LSN MvccTrxLogHandler::current_lsn() const { return log_handler_.current_lsn(); }
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 MvccTrxLogReplayer::MvccTrxLogReplayer(Db &db, MvccTrxKit &trx_kit, LogHandler &log_handler)
   : db_(db), trx_kit_(trx_kit), log_handler_(log_handler)
@@ -142,8 +171,6 @@ RC MvccTrxLogReplayer::replay(const LogEntry &entry)
 {
   RC rc = RC::SUCCESS;
 
-  // 由于当前没有check point，所以所有的事务都重做。
-
   ASSERT(entry.module().id() == LogModule::Id::TRANSACTION, "invalid log module id: %d", entry.module().id());
 
   if (entry.payload_size() < MvccTrxLogHeader::SIZE) {
@@ -156,7 +183,7 @@ RC MvccTrxLogReplayer::replay(const LogEntry &entry)
   auto trx_iter = trx_map_.find(header->trx_id);
   if (trx_iter == trx_map_.end()) {
     trx = static_cast<MvccTrx *>(trx_kit_.create_trx(log_handler_, header->trx_id));
-    // trx = new MvccTrx(trx_kit_, log_handler_, header->trx_id);
+    trx_map_.emplace(header->trx_id, trx);
   } else {
     trx = trx_iter->second;
   }
@@ -181,7 +208,7 @@ RC MvccTrxLogReplayer::on_done()
   for (auto &pair : trx_map_) {
     MvccTrx *trx = pair.second;
     trx->rollback(); // 恢复时的rollback，可能遇到之前已经回滚一半的事务又再次调用回滚的情况
-    delete pair.second;
+    trx_kit_.destroy_trx(trx);
   }
   trx_map_.clear();
 
@@ -41,7 +41,8 @@ public:
     INSERT_RECORD,  ///< 插入一条记录
     DELETE_RECORD,  ///< 删除一条记录
     COMMIT,         ///< 提交事务
-    ROLLBACK        ///< 回滚事务
+    ROLLBACK,       ///< 回滚事务
+    UPDATE_RECORD   ///< 原地更新一条记录
   };
 
 public:
@@ -88,6 +89,23 @@ struct MvccTrxRecordLogEntry
   std::string to_string() const;
 };
 
+/**
+ * @brief 原地更新一条记录的日志
+ * @ingroup CLog
+ * @details 记录更新前的完整数据，重启时回滚没有提交的事务要用它恢复旧的版本。
+ * 更新后的数据由记录管理器的日志负责重做。
+ */
+struct MvccTrxUpdateLogEntry
+{
+  MvccTrxRecordLogEntry record;    ///< 更新的是哪条记录
+  int32_t               data_len;  ///< 更新前的数据长度
+  char                  data[0];   ///< 更新前的数据
+
+  static const int32_t SIZE;  ///< 不包含数据的日志大小
+
+  std::string to_string() const;
+};
+
 /**
  * @brief 事务提交的日志
  * @ingroup CLog
@@ -123,6 +141,13 @@ public:
    */
   RC delete_record(int32_t trx_id, Table *table, const RID &rid);
 
+  /**
+   * @brief 记录原地更新一条记录的日志
+   * @param old_data 更新前的数据
+   * @param len      数据长度
+   */
+  RC update_record(int32_t trx_id, Table *table, const RID &rid, const char *old_data, int len);
+
   /**
    * @brief 记录提交事务的日志
    * @details 会等待日志落地
@@ -135,6 +160,8 @@ public:
    */
   RC rollback(int32_t trx_id);
 
+  LSN current_lsn() const;
+
 private:
   LogHandler &log_handler_;
 };
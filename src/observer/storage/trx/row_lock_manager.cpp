@@ -0,0 +1,189 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "storage/trx/row_lock_manager.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+
+string RowLockStat::to_string() const
+{
+  stringstream ss;
+  ss << "locks:" << lock_count << ", waits:" << wait_count << ", wait time(us):" << wait_time_us
+     << ", max wait(us):" << max_wait_us << ", deadlocks:" << deadlock_count << ", timeouts:" << timeout_count
+     << ", conflicts:" << conflict_count;
+  return ss.str();
+}
+
+RC RowLockManager::lock(int32_t trx_id, int32_t table_id, const RID &rid)
+{
+  const RowKey key{table_id, rid};
+
+  unique_lock<mutex> guard(lock_);
+
+  unique_ptr<RowLock> &row_lock_ptr = row_locks_[key];
+  if (!row_lock_ptr) {
+    row_lock_ptr = make_unique<RowLock>();
+  }
+
+  RowLock &row_lock = *row_lock_ptr;
+  if (row_lock.owner == trx_id) {
+    return RC::SUCCESS;
+  }
+
+  if (row_lock.owner == 0) {
+    row_lock.owner = trx_id;
+    owned_keys_[trx_id].push_back(key);
+    stat_.lock_count++;
+    return RC::SUCCESS;
+  }
+
+  if (would_deadlock(trx_id, row_lock)) {
+    stat_.deadlock_count++;
+    LOG_INFO("deadlock detected. trx id=%d, table id=%d, rid=%s, owner=%d",
+             trx_id, table_id, rid.to_string().c_str(), row_lock.owner);
+    return RC::LOCKED_DEADLOCK;
+  }
+
+  LOG_TRACE("wait for row lock. trx id=%d, table id=%d, rid=%s, owner=%d",
+            trx_id, table_id, rid.to_string().c_str(), row_lock.owner);
+  row_lock.waiters.push_back(trx_id);
+  waiting_keys_.emplace(trx_id, key);
+  stat_.wait_count++;
+
+  const auto start   = chrono::steady_clock::now();
+  const bool granted = row_lock.cond.wait_until(
+      guard, start + wait_timeout_, [&row_lock, trx_id]() { return row_lock.owner == trx_id; });
+
+  const uint64_t wait_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  stat_.wait_time_us += wait_us;
+  stat_.max_wait_us = max(stat_.max_wait_us, wait_us);
+
+  if (!granted) {
+    cancel_wait(trx_id, row_lock);
+    stat_.timeout_count++;
+    LOG_INFO("wait for row lock timeout. trx id=%d, table id=%d, rid=%s, owner=%d",
+             trx_id, table_id, rid.to_string().c_str(), row_lock.owner);
+    return RC::LOCKED_WAIT_TIMEOUT;
+  }
+
+  // 释放锁的事务已经把这个锁记到当前事务名下了
+  stat_.lock_count++;
+  return RC::SUCCESS;
+}
+
+void RowLockManager::unlock_all(int32_t trx_id)
+{
+  lock_guard<mutex> guard(lock_);
+
+  auto owned_iter = owned_keys_.find(trx_id);
+  if (owned_iter == owned_keys_.end()) {
+    return;
+  }
+
+  vector<RowKey> keys;
+  keys.swap(owned_iter->second);
+  owned_keys_.erase(owned_iter);
+
+  for (const RowKey &key : keys) {
+    auto iter = row_locks_.find(key);
+    ASSERT(iter != row_locks_.end() && iter->second->owner == trx_id,
+           "invalid row lock owner. trx id=%d, rid=%s", trx_id, key.rid.to_string().c_str());
+
+    RowLock &row_lock = *iter->second;
+    if (row_lock.waiters.empty()) {
+      row_locks_.erase(iter);
+      continue;
+    }
+
+    // 直接交给排在最前面的事务，后来的事务不能插队
+    const int32_t next_owner = row_lock.waiters.front();
+    row_lock.waiters.pop_front();
+    row_lock.owner = next_owner;
+    owned_keys_[next_owner].push_back(key);
+    waiting_keys_.erase(next_owner);
+    row_lock.cond.notify_all();
+  }
+}
+
+void RowLockManager::cancel_wait(int32_t trx_id, RowLock &row_lock)
+{
+  erase(row_lock.waiters, trx_id);
+  waiting_keys_.erase(trx_id);
+}
+
+bool RowLockManager::would_deadlock(int32_t trx_id, const RowLock &row_lock) const
+{
+  // 从当前事务要等待的事务出发，沿着等待关系能回到当前事务就是死锁
+  vector<int32_t>         pending(row_lock.waiters.begin(), row_lock.waiters.end());
+  unordered_set<int32_t> visited;
+  pending.push_back(row_lock.owner);
+
+  while (!pending.empty()) {
+    const int32_t waiting_trx = pending.back();
+    pending.pop_back();
+    if (waiting_trx == trx_id) {
+      return true;
+    }
+    if (!visited.insert(waiting_trx).second) {
+      continue;
+    }
+
+    auto key_iter = waiting_keys_.find(waiting_trx);
+    if (key_iter == waiting_keys_.end()) {
+      continue;
+    }
+
+    const RowLock &waited_lock = *row_locks_.at(key_iter->second);
+    pending.push_back(waited_lock.owner);
+    for (int32_t waiter : waited_lock.waiters) {
+      if (waiter == waiting_trx) {
+        break;
+      }
+      pending.push_back(waiter);
+    }
+  }
+  return false;
+}
+
+void RowLockManager::add_conflict()
+{
+  lock_guard<mutex> guard(lock_);
+  stat_.conflict_count++;
+}
+
+void RowLockManager::set_wait_timeout(chrono::milliseconds timeout)
+{
+  lock_guard<mutex> guard(lock_);
+  wait_timeout_ = timeout;
+}
+
+chrono::milliseconds RowLockManager::wait_timeout() const
+{
+  lock_guard<mutex> guard(lock_);
+  return wait_timeout_;
+}
+
+size_t RowLockManager::lock_num() const
+{
+  lock_guard<mutex> guard(lock_);
+  return row_locks_.size();
+}
+
+RowLockStat RowLockManager::stat() const
+{
+  lock_guard<mutex> guard(lock_);
+  return stat_;
+}
@@ -0,0 +1,131 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 行锁的统计信息
+ * @ingroup Transaction
+ */
+struct RowLockStat
+{
+  uint64_t lock_count     = 0;  ///< 加锁的次数，不包括已经持有的锁
+  uint64_t wait_count     = 0;  ///< 需要等待的次数
+  uint64_t wait_time_us   = 0;  ///< 等待的总时间
+  uint64_t max_wait_us    = 0;  ///< 最长的一次等待时间
+  uint64_t deadlock_count = 0;  ///< 检测到死锁而放弃加锁的次数
+  uint64_t timeout_count  = 0;  ///< 等待超时的次数
+  uint64_t conflict_count = 0;  ///< 拿到锁之后发现记录已经被别的事务修改，只能重试事务的次数
+
+  std::string to_string() const;
+};
+
+/**
+ * @brief 行锁管理器
+ * @ingroup Transaction
+ * @details 多版本事务修改记录之前先加上这条记录的排他锁，事务结束时释放。
+ * 别的事务持有锁时，在这条记录的等待队列中排队，锁释放时直接交给队列中的第一个事务。
+ * 加锁前沿着等待关系检查是否会形成环，形成环的话当前事务放弃加锁，返回 LOCKED_DEADLOCK；
+ * 等待超过 wait_timeout 返回 LOCKED_WAIT_TIMEOUT。
+ * 等待时不能持有页面的锁，否则持有行锁的事务提交时无法修改记录。
+ */
+class RowLockManager
+{
+public:
+  static constexpr std::chrono::milliseconds DEFAULT_WAIT_TIMEOUT{10000};
+
+  RowLockManager()  = default;
+  ~RowLockManager() = default;
+
+  /**
+   * @brief 给一条记录加排他锁，已经持有的话直接返回
+   * @return RC SUCCESS 加锁成功
+   *            LOCKED_DEADLOCK 等待会造成死锁
+   *            LOCKED_WAIT_TIMEOUT 等待超时
+   */
+  RC lock(int32_t trx_id, int32_t table_id, const RID &rid);
+
+  /**
+   * @brief 释放一个事务持有的所有锁，唤醒等待的事务
+   */
+  void unlock_all(int32_t trx_id);
+
+  /**
+   * @brief 记录拿到锁之后仍然冲突的次数
+   */
+  void add_conflict();
+
+  void                      set_wait_timeout(std::chrono::milliseconds timeout);
+  std::chrono::milliseconds wait_timeout() const;
+
+  /**
+   * @brief 当前持有锁的记录个数
+   */
+  size_t lock_num() const;
+
+  RowLockStat stat() const;
+
+private:
+  struct RowKey
+  {
+    int32_t table_id;
+    RID     rid;
+
+    bool operator==(const RowKey &other) const { return table_id == other.table_id && rid == other.rid; }
+  };
+
+  struct RowKeyHasher
+  {
+    size_t operator()(const RowKey &key) const noexcept
+    {
+      return std::hash<int32_t>()(key.table_id) ^ (RIDHash()(key.rid) << 1);
+    }
+  };
+
+  struct RowLock
+  {
+    int32_t                 owner = 0;  ///< 持有锁的事务，锁释放时直接设置为等待队列中的第一个事务
+    std::deque<int32_t>     waiters;    ///< 按照等待的先后顺序排列
+    std::condition_variable cond;
+  };
+
+  /**
+   * @brief trx_id 等待 row_lock 是否会形成环
+   * @details 一个事务等待锁的持有者，以及排在它前面的事务
+   */
+  bool would_deadlock(int32_t trx_id, const RowLock &row_lock) const;
+
+  /**
+   * @brief 把等待队列中的 trx_id 删掉，调用者持有 lock_
+   */
+  void cancel_wait(int32_t trx_id, RowLock &row_lock);
+
+private:
+  mutable std::mutex lock_;
+
+  std::unordered_map<RowKey, std::unique_ptr<RowLock>, RowKeyHasher> row_locks_;
+  std::unordered_map<int32_t, std::vector<RowKey>>                   owned_keys_;    ///< 每个事务持有的锁
+  std::unordered_map<int32_t, RowKey>                                waiting_keys_;  ///< 每个事务正在等待的锁
+
+  std::chrono::milliseconds wait_timeout_ = DEFAULT_WAIT_TIMEOUT;
+  RowLockStat               stat_;
+};
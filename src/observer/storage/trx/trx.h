@@ -130,6 +130,31 @@ public:
 
   virtual LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) = 0;
 
+  /**
+   * @brief 计算重启时至少要从哪个LSN开始回放事务日志
+   * @details 没有结束的事务，重启时要回放它所有的日志才能回滚
+   * @param lsn 没有活跃的事务时返回这个值
+   */
+  virtual LSN min_recovery_lsn(LSN lsn) { return lsn; }
+
+  /**
+   * @brief 已经分配出去的最大事务号
+   * @details 检查点时记录到数据库的元数据中，重启后从这里继续分配，新的事务号总是比数据中的大
+   */
+  virtual int32_t current_trx_id() const { return 0; }
+  virtual void    advance_trx_id(int32_t trx_id) {}
+
+  /**
+   * @brief 数据库恢复完成之后调用，启动回收删除的记录等后台任务
+   */
+  virtual RC   start_purge(Db &db) { return RC::SUCCESS; }
+  virtual void stop_purge() {}
+
+  /**
+   * @brief 删除表之前调用，之后后台任务不会再访问这个表
+   */
+  virtual void drop_table(Table *table) {}
+
 public:
   static TrxKit *create(const char *name);
 };
@@ -148,6 +173,14 @@ public:
   virtual RC delete_record(Table *table, Record &record)                    = 0;
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
 
+  /**
+   * @brief 更新一条记录
+   * @details 事务允许的话在原来的位置更新，否则删除旧记录再插入新记录，这时new_record的RID会变化
+   * @param old_record 更新前的记录
+   * @param new_record 更新后的记录，返回时包含更新后的RID
+   */
+  virtual RC update_record(Table *table, Record &old_record, Record &new_record) = 0;
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
@@ -0,0 +1,112 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/trx/undo_segment.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+void UndoSegment::push(int32_t table_id, const RID &rid, int32_t trx_id, const char *data, int len)
+{
+  UndoVersion version;
+  version.trx_id = trx_id;
+  version.data.assign(data, data + len);
+
+  lock_guard<mutex> guard(lock_);
+  chains_[UndoKey{table_id, rid}].push_front(std::move(version));
+  version_count_.fetch_add(1, memory_order_relaxed);
+}
+
+RC UndoSegment::pop(int32_t table_id, const RID &rid, int32_t trx_id, Record &record)
+{
+  lock_guard<mutex> guard(lock_);
+  auto iter = chains_.find(UndoKey{table_id, rid});
+  if (iter == chains_.end() || iter->second.front().trx_id != trx_id) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  VersionChain &chain = iter->second;
+  RC rc = record.copy_data(chain.front().data.data(), static_cast<int>(chain.front().data.size()));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  record.set_rid(rid);
+
+  chain.pop_front();
+  version_count_.fetch_sub(1, memory_order_relaxed);
+  if (chain.empty()) {
+    chains_.erase(iter);
+  }
+  return RC::SUCCESS;
+}
+
+void UndoSegment::visit(int32_t table_id, const RID &rid, const Visitor &visitor)
+{
+  lock_guard<mutex> guard(lock_);
+  auto iter = chains_.find(UndoKey{table_id, rid});
+  if (iter == chains_.end()) {
+    return;
+  }
+
+  Record record;
+  record.set_rid(rid);
+  for (UndoVersion &version : iter->second) {
+    record.set_data(version.data.data(), static_cast<int>(version.data.size()));
+    if (!visitor(record)) {
+      break;
+    }
+  }
+}
+
+size_t UndoSegment::trim(int32_t table_id, const RID &rid, const function<bool(const Record &)> &removable)
+{
+  lock_guard<mutex> guard(lock_);
+  auto iter = chains_.find(UndoKey{table_id, rid});
+  if (iter == chains_.end()) {
+    return 0;
+  }
+
+  VersionChain &chain = iter->second;
+  Record        record;
+  record.set_rid(rid);
+  size_t keep_num = 0;
+  for (; keep_num < chain.size(); keep_num++) {
+    UndoVersion &version = chain[keep_num];
+    record.set_data(version.data.data(), static_cast<int>(version.data.size()));
+    if (removable(record)) {
+      break;
+    }
+  }
+
+  const size_t removed_num = chain.size() - keep_num;
+  chain.resize(keep_num);
+  version_count_.fetch_sub(removed_num, memory_order_relaxed);
+  if (chain.empty()) {
+    chains_.erase(iter);
+  }
+  return removed_num;
+}
+
+void UndoSegment::remove(int32_t table_id, const RID &rid, int32_t trx_id)
+{
+  lock_guard<mutex> guard(lock_);
+  auto iter = chains_.find(UndoKey{table_id, rid});
+  if (iter == chains_.end()) {
+    return;
+  }
+
+  VersionChain &chain    = iter->second;
+  const size_t  old_size = chain.size();
+  erase_if(chain, [trx_id](const UndoVersion &version) { return version.trx_id == trx_id; });
+  version_count_.fetch_sub(old_size - chain.size(), memory_order_relaxed);
+  if (chain.empty()) {
+    chains_.erase(iter);
+  }
+}
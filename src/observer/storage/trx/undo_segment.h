@@ -0,0 +1,111 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 保存记录的旧版本
+ * @ingroup Transaction
+ * @details 多版本事务原地更新记录时，表文件中只保存最新的版本，旧的版本放到这里。
+ * 每条记录的旧版本按照从新到旧的顺序组成一个版本链，通过表ID和RID找到。
+ * 旧版本只给还在运行的事务读取，不需要持久化，重启后就不存在了。
+ * 重启时回滚没有提交的事务需要的旧数据，记录在事务日志中。
+ * 版本链上的数据与表中的记录格式相同，包含事务字段，可见性的判断由事务模块负责。
+ */
+class UndoSegment
+{
+public:
+  /**
+   * @brief 访问一个旧版本，返回false时停止
+   */
+  using Visitor = std::function<bool(Record &)>;
+
+  UndoSegment()  = default;
+  ~UndoSegment() = default;
+
+  /**
+   * @brief 把一个旧版本放到版本链的头部
+   * @param trx_id 修改记录、生成这个旧版本的事务
+   * @param data   旧版本的数据
+   * @param len    数据长度
+   */
+  void push(int32_t table_id, const RID &rid, int32_t trx_id, const char *data, int len);
+
+  /**
+   * @brief 取出版本链上最新的旧版本，回滚时使用
+   * @details 最新的旧版本不是trx_id生成的，返回RECORD_NOT_EXIST
+   * @param[out] record 返回旧版本的数据
+   */
+  RC pop(int32_t table_id, const RID &rid, int32_t trx_id, Record &record);
+
+  /**
+   * @brief 按照从新到旧的顺序访问一条记录的旧版本
+   * @details 访问时持有锁，visitor可以修改版本的数据，比如事务提交时设置结束的事务号
+   */
+  void visit(int32_t table_id, const RID &rid, const Visitor &visitor);
+
+  /**
+   * @brief 删除一条记录上没有事务会再访问的旧版本
+   * @details 越旧的版本结束得越早，从新到旧找到第一个可以删除的版本，把它和比它旧的版本都删掉
+   * @param removable 判断一个旧版本是否可以删除
+   * @return 删除的版本个数
+   */
+  size_t trim(int32_t table_id, const RID &rid, const std::function<bool(const Record &)> &removable);
+
+  /**
+   * @brief 删除一条记录上某个事务生成的所有旧版本
+   * @details 重启回放日志时，已经结束的事务不需要旧版本
+   */
+  void remove(int32_t table_id, const RID &rid, int32_t trx_id);
+
+  /**
+   * @brief 当前保存的旧版本个数
+   */
+  size_t version_count() const { return version_count_.load(std::memory_order_relaxed); }
+
+private:
+  struct UndoVersion
+  {
+    int32_t           trx_id = -1;  ///< 生成这个旧版本的事务
+    std::vector<char> data;
+  };
+
+  using VersionChain = std::deque<UndoVersion>;  ///< 头部是最新的版本
+
+  struct UndoKey
+  {
+    int32_t table_id;
+    RID     rid;
+
+    bool operator==(const UndoKey &other) const { return table_id == other.table_id && rid == other.rid; }
+  };
+
+  struct UndoKeyHasher
+  {
+    size_t operator()(const UndoKey &key) const noexcept
+    {
+      return std::hash<int32_t>()(key.table_id) ^ (RIDHash()(key.rid) << 1);
+    }
+  };
+
+  std::mutex                                               lock_;
+  std::unordered_map<UndoKey, VersionChain, UndoKeyHasher> chains_;
+  std::atomic<size_t>                                      version_count_{0};
+};
@@ -0,0 +1,77 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string>
+
+#include "sql/operator/aggregate_hash_table.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(GroupKeyEncoder, encode)
+{
+  Value null_value;
+  null_value.set_null();
+
+  string key1;
+  string key2;
+  GroupKeyEncoder::append(null_value, key1);
+  GroupKeyEncoder::append(null_value, key2);
+  ASSERT_EQ(key1, key2);
+
+  key1.clear();
+  key2.clear();
+  GroupKeyEncoder::append(Value(0), key1);
+  GroupKeyEncoder::append(null_value, key2);
+  ASSERT_NE(key1, key2);
+
+  key1.clear();
+  key2.clear();
+  GroupKeyEncoder::append(Value((float)0.0), key1);
+  GroupKeyEncoder::append(Value((float)-0.0), key2);
+  ASSERT_EQ(key1, key2);
+
+  key1.clear();
+  key2.clear();
+  GroupKeyEncoder::append(Value("ab"), key1);
+  GroupKeyEncoder::append(Value("c"), key1);
+  GroupKeyEncoder::append(Value("a"), key2);
+  GroupKeyEncoder::append(Value("bc"), key2);
+  ASSERT_NE(key1, key2);
+}
+
+TEST(AggregateHashTable, find_or_insert)
+{
+  AggregateHashTable hash_table;
+
+  const int group_num = 10000;
+  string    key;
+  bool      inserted = false;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < group_num; i++) {
+      key.clear();
+      GroupKeyEncoder::append(Value(i), key);
+      ASSERT_EQ(hash_table.find_or_insert(key, inserted), i);
+      ASSERT_EQ(inserted, round == 0);
+    }
+  }
+  ASSERT_EQ(hash_table.size(), group_num);
+
+  hash_table.clear();
+  ASSERT_EQ(hash_table.size(), 0);
+  ASSERT_EQ(hash_table.find_or_insert(key, inserted), 0);
+  ASSERT_TRUE(inserted);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
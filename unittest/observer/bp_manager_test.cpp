@@ -125,6 +125,60 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_frame_manager, test_frame_manager_shard)
+{
+  for (int shard_num : {1, 3, 16}) {
+    BPFrameManager frame_manager("Test");
+    frame_manager.init(1, shard_num);
+    ASSERT_EQ(frame_manager.shard_num(), shard_num);
+
+    test_get(frame_manager);
+
+    // 页帧在所有分片之间共享，分配满之后淘汰页面可以从任意分片中腾出空间
+    const int           buffer_pool_id = 0;
+    std::vector<Frame *> frames;
+    for (PageNum page_num = 0; true; page_num++) {
+      Frame *frame = frame_manager.alloc(buffer_pool_id, page_num);
+      if (frame == nullptr) {
+        break;
+      }
+      frames.push_back(frame);
+    }
+    ASSERT_EQ(frames.size(), frame_manager.total_frame_num());
+    ASSERT_EQ(frames.size(), frame_manager.frame_num());
+
+    frames[0]->unpin();
+    frames[1]->unpin();
+    int purged = 0;
+    ASSERT_EQ(frame_manager.purge_frames(2,
+                  [&purged](Frame *) {
+                    purged++;
+                    return RC::SUCCESS;
+                  }),
+        2);
+    ASSERT_EQ(purged, 2);
+    ASSERT_EQ(frame_manager.frame_num(), frames.size() - 2);
+
+    // 正在使用的页面不会被淘汰
+    ASSERT_EQ(frame_manager.purge_frames(1, [](Frame *) { return RC::SUCCESS; }), 0);
+
+    std::vector<BPFrameShardStat> stats = frame_manager.shard_stats();
+    ASSERT_EQ(static_cast<int>(stats.size()), shard_num);
+    size_t frame_num = 0;
+    for (const BPFrameShardStat &stat : stats) {
+      frame_num += stat.frame_num;
+      ASSERT_GT(stat.lock_count, 0);
+      ASSERT_EQ(stat.contention_count, 0);
+    }
+    ASSERT_EQ(frame_num, frame_manager.frame_num());
+
+    for (size_t i = 2; i < frames.size(); i++) {
+      ASSERT_EQ(frame_manager.free(buffer_pool_id, frames[i]->page_num(), frames[i]), RC::SUCCESS);
+    }
+    ASSERT_EQ(frame_manager.cleanup(), RC::SUCCESS);
+  }
+}
+
 int main(int argc, char **argv)
 {
 
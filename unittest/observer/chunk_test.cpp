@@ -0,0 +1,158 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/expr/chunk.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 列i、j是整数，f是浮点数，s是字符串，都包含NULL
+ */
+static void make_chunk(Chunk &chunk, int rows)
+{
+  auto i_column = make_shared<Column>(INTS, 4);
+  auto j_column = make_shared<Column>(INTS, 4);
+  auto f_column = make_shared<Column>(FLOATS, 4);
+  auto s_column = make_shared<Column>(CHARS, 4);
+
+  Value null_value;
+  null_value.set_null();
+  const char *strings[] = {"", "a", "ab", "b", "abcd"};
+  for (int row = 0; row < rows; row++) {
+    i_column->append_value(row % 11 == 0 ? null_value : Value(row % 7 - 3));
+    j_column->append_value(row % 13 == 0 ? null_value : Value(row % 5 - 2));
+    f_column->append_value(row % 17 == 0 ? null_value : Value(static_cast<float>(row % 9) / 2 - 2));
+    s_column->append_value(row % 19 == 0 ? null_value : Value(strings[row % 5]));
+  }
+
+  chunk.reset();
+  chunk.add_column(TupleCellSpec("i"), i_column);
+  chunk.add_column(TupleCellSpec("j"), j_column);
+  chunk.add_column(TupleCellSpec("f"), f_column);
+  chunk.add_column(TupleCellSpec("s"), s_column);
+  chunk.set_rows(rows);
+}
+
+static unique_ptr<Expression> cell(const char *name, AttrType type)
+{
+  return make_unique<TupleCellExpr>(TupleCellSpec(name), type);
+}
+
+static unique_ptr<Expression> value(const Value &v) { return make_unique<ValueExpr>(v); }
+
+/**
+ * @brief 按列计算的结果与逐行计算的结果一致
+ */
+static void check_expression(const Expression &expr, const Chunk &chunk)
+{
+  shared_ptr<Column> column;
+  ASSERT_EQ(expr.get_column(chunk, column), RC::SUCCESS);
+
+  ChunkTuple tuple;
+  tuple.set_chunk(&chunk);
+  Value expected;
+  Value actual;
+  for (int row = 0; row < chunk.rows(); row++) {
+    tuple.set_row(row);
+    ASSERT_EQ(expr.get_value(tuple, expected), RC::SUCCESS);
+    column->get_value(row, actual);
+    ASSERT_EQ(expected.attr_type(), actual.attr_type()) << "row=" << row;
+    if (expected.attr_type() != NULLS) {
+      ASSERT_EQ(expected.compare(actual), 0) << "row=" << row;
+    }
+  }
+}
+
+TEST(Chunk, comparison)
+{
+  Chunk chunk;
+  make_chunk(chunk, 1000);
+
+  const CompOp ops[] = {EQUAL_TO, LESS_EQUAL, NOT_EQUAL, LESS_THAN, GREAT_EQUAL, GREAT_THAN};
+  for (CompOp op : ops) {
+    check_expression(ComparisonExpr(op, cell("i", INTS), cell("j", INTS)), chunk);
+    check_expression(ComparisonExpr(op, cell("i", INTS), cell("f", FLOATS)), chunk);
+    check_expression(ComparisonExpr(op, cell("f", FLOATS), value(Value(0.5f))), chunk);
+    check_expression(ComparisonExpr(op, value(Value(1)), cell("j", INTS)), chunk);
+    check_expression(ComparisonExpr(op, cell("s", CHARS), value(Value("ab"))), chunk);
+  }
+}
+
+TEST(Chunk, arithmetic)
+{
+  Chunk chunk;
+  make_chunk(chunk, 1000);
+
+  const ArithmeticType types[] = {
+      ArithmeticType::ADD, ArithmeticType::SUB, ArithmeticType::MUL, ArithmeticType::DIV};
+  for (ArithmeticType type : types) {
+    check_expression(ArithmeticExpr(type, cell("i", INTS), cell("j", INTS)), chunk);
+    check_expression(ArithmeticExpr(type, cell("i", INTS), cell("f", FLOATS)), chunk);
+    check_expression(ArithmeticExpr(type, cell("f", FLOATS), value(Value(2))), chunk);
+    check_expression(ArithmeticExpr(type, cell("s", CHARS), cell("j", INTS)), chunk);
+  }
+}
+
+TEST(Chunk, conjunction)
+{
+  Chunk chunk;
+  make_chunk(chunk, 1000);
+
+  for (ConjunctionType type : {ConjunctionType::AND, ConjunctionType::OR}) {
+    vector<unique_ptr<Expression>> children;
+    children.push_back(make_unique<ComparisonExpr>(LESS_THAN, cell("i", INTS), cell("j", INTS)));
+    children.push_back(make_unique<ComparisonExpr>(GREAT_THAN, cell("f", FLOATS), value(Value(0.0f))));
+    children.push_back(cell("j", INTS));
+    check_expression(ConjunctionExpr(type, children), chunk);
+  }
+}
+
+TEST(Chunk, select)
+{
+  Chunk chunk;
+  make_chunk(chunk, 100);
+
+  shared_ptr<Column> filter;
+  ComparisonExpr     expr(GREAT_EQUAL, cell("i", INTS), value(Value(0)));
+  ASSERT_EQ(expr.get_column(chunk, filter), RC::SUCCESS);
+
+  vector<int> selection;
+  filter->collect_true(chunk.rows(), selection);
+
+  vector<Value> expected;
+  Value         v;
+  for (int row : selection) {
+    chunk.column(2)->get_value(row, v);
+    expected.push_back(v);
+  }
+
+  chunk.select(selection);
+  ASSERT_EQ(chunk.rows(), static_cast<int>(selection.size()));
+  for (int row = 0; row < chunk.rows(); row++) {
+    ASSERT_FALSE(chunk.column(0)->is_null(row));
+    chunk.column(0)->get_value(row, v);
+    ASSERT_GE(v.get_int(), 0);
+    chunk.column(2)->get_value(row, v);
+    ASSERT_EQ(v.attr_type(), expected[row].attr_type());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,11 +12,15 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/02/01
 //
 
+#include <chrono>
 #include <filesystem>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "common/log/log.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/read_ahead.h"
 #include "storage/clog/vacuous_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
 
@@ -132,6 +136,184 @@ TEST(BufferPool, create)
   ASSERT_EQ(buffer_pool->id(), buffer_pool2->id());
 }
 
+TEST(DiskBufferPool, page_cleaner)
+{
+  /*
+  1. 修改一些页面，脏页按照recovery lsn排序
+  2. 刷一轮脏页，正在修改的页面不会被刷新
+  3. 页面不够用时优先淘汰干净的页面
+  */
+  filesystem::path directory("buffer_pool");
+  filesystem::remove_all(directory);
+  filesystem::create_directories(directory);
+  filesystem::path bp_file = directory / "page_cleaner.bp";
+
+  // 只有一个内存池
+  BufferPoolManager bpm(BP_PAGE_SIZE * DEFAULT_ITEM_NUM_PER_POOL);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+  const int       page_num      = 100;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+
+  // 1. 页面号越大越早修改
+  for (PageNum page = 1; page <= page_num; page++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page, &frame));
+    frame->write_latch();
+    frame->set_lsn(page_num + 1 - page);
+    frame->mark_dirty();
+    frame->write_unlatch();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+
+  vector<BPDirtyFrame> dirty_frames;
+  frame_manager.dirty_frames(dirty_frames);
+  ASSERT_EQ(dirty_frames.size(), static_cast<size_t>(page_num));
+  for (int i = 0; i < page_num; i++) {
+    ASSERT_EQ(dirty_frames[i].recovery_lsn, i + 1);
+    ASSERT_EQ(dirty_frames[i].frame_id.page_num(), page_num - i);
+  }
+
+  // 2. 脏页比例很高，一轮可以全部刷完，除了加着写锁的页面
+  Frame *latched_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page_num, &latched_frame));
+  latched_frame->write_latch();
+
+  PageCleaner cleaner(bpm);
+  ASSERT_EQ(cleaner.clean_once(), page_num - 1);
+  frame_manager.dirty_frames(dirty_frames);
+  ASSERT_EQ(dirty_frames.size(), 1);
+  ASSERT_EQ(dirty_frames[0].frame_id.page_num(), page_num);
+
+  latched_frame->write_unlatch();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(latched_frame));
+
+  // 3. 用完所有页帧，最早访问的脏页仍然在内存中
+  Frame *dirty_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(1, &dirty_frame));
+  dirty_frame->mark_dirty();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(dirty_frame));
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(i % 50 + 2, &frame));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+  Frame *frame = frame_manager.get(buffer_pool->id(), 1);
+  ASSERT_EQ(frame, dirty_frame);
+  frame->unpin();
+
+  // 后台线程可以正常启动和停止
+  ASSERT_EQ(RC::SUCCESS, bpm.start_page_cleaner());
+  bpm.wake_up_page_cleaner();
+  bpm.stop_page_cleaner();
+
+  ASSERT_EQ(bpm.close_file(bp_file.c_str()), RC::SUCCESS);
+}
+
+TEST(DiskBufferPool, read_ahead)
+{
+  filesystem::path directory("buffer_pool");
+  filesystem::remove_all(directory);
+  filesystem::create_directories(directory);
+  filesystem::path bp_file = directory / "read_ahead.bp";
+
+  BufferPoolManager bpm(BP_PAGE_SIZE * DEFAULT_ITEM_NUM_PER_POOL);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+
+  // 每个页面的开头记录自己的页面编号
+  const int page_num = 40;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    PageNum this_page = frame->page_num();
+    memcpy(frame->data(), &this_page, sizeof(this_page));
+    frame->mark_dirty();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->dispose_page(5));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->purge_all_pages());
+
+  auto check_page = [buffer_pool](PageNum page) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page, &frame));
+    PageNum page_in_data = BP_INVALID_PAGE_NUM;
+    memcpy(&page_in_data, frame->data(), sizeof(page_in_data));
+    ASSERT_EQ(page, page_in_data);
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  };
+
+  // 同步预读，跳过没有分配的页面和已经在内存中的页面
+  int read_count = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->read_ahead(1, 10, read_count));
+  ASSERT_EQ(9, read_count);
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->read_ahead(1, 10, read_count));
+  ASSERT_EQ(0, read_count);
+
+  for (PageNum page = 1; page <= 4; page++) {
+    check_page(page);
+  }
+  BPReadAheadStat stat = bpm.read_ahead_stat();
+  ASSERT_EQ(9UL, stat.read_pages);
+  ASSERT_EQ(4UL, stat.hit_pages);
+
+  // 没有访问过就被淘汰的页面是浪费的
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->purge_all_pages());
+  stat = bpm.read_ahead_stat();
+  ASSERT_EQ(5UL, stat.wasted_pages);
+
+  // 后台线程没有启动时，预读的提示什么都不做
+  buffer_pool->hint_read_ahead(11, 10);
+  ASSERT_EQ(0UL, bpm.read_ahead_stat().request_count);
+
+  // 异步预读
+  ASSERT_EQ(RC::SUCCESS, bpm.start_read_ahead());
+  buffer_pool->hint_read_ahead(11, page_num);
+  for (int i = 0; i < 1000 && bpm.read_ahead_stat().read_pages < 9UL + page_num - 10; i++) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  stat = bpm.read_ahead_stat();
+  ASSERT_EQ(1UL, stat.request_count);
+  ASSERT_EQ(9UL + page_num - 10, stat.read_pages);
+  for (PageNum page = 11; page <= page_num; page++) {
+    check_page(page);
+  }
+  ASSERT_EQ(4UL + page_num - 10, bpm.read_ahead_stat().hit_pages);
+
+  // 顺序扫描时自动预读，页面内容不受影响
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->purge_all_pages());
+  ReadAheadTracker tracker;
+  tracker.reset(buffer_pool);
+  for (PageNum page = 1; page <= page_num; page++) {
+    if (page == 5) {
+      continue;
+    }
+    tracker.access(page);
+    check_page(page);
+  }
+  ASSERT_GT(bpm.read_ahead_stat().request_count, 1UL);
+  bpm.stop_read_ahead();
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/31
 //
 
+#include <chrono>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #define private public
@@ -180,6 +183,47 @@ TEST(DiskLogHandler, multi_thread)
   ASSERT_EQ(RC::SUCCESS, handler.await_termination());
 }
 
+TEST(DiskLogHandler, group_commit)
+{
+  const char *directory = "test_log_handler_group_commit";
+  filesystem::remove_all(directory);
+
+  DiskLogHandler  handler;
+  TestLogReplayer replayer;
+  ASSERT_EQ(RC::SUCCESS, handler.init(directory));
+  ASSERT_EQ(RC::SUCCESS, handler.replay(replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, handler.start());
+
+  // 每次提交都等待日志刷盘。刷盘之后会立即唤醒等待的线程，而不是轮询
+  const int     thread_num = 8;
+  const int     times      = 100;
+  vector<thread> threads;
+  auto           begin = chrono::steady_clock::now();
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back([&handler]() {
+      for (int j = 0; j < times; j++) {
+        LSN          lsn = 0;
+        vector<char> data(10);
+        ASSERT_EQ(handler.append(lsn, LogModule::Id::TRANSACTION, std::move(data)), RC::SUCCESS);
+        ASSERT_EQ(RC::SUCCESS, handler.wait_lsn(lsn));
+        ASSERT_GE(handler.current_flushed_lsn(), lsn);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin);
+  LOG_INFO("group commit done. elapsed=%ld ms", elapsed.count());
+  ASSERT_LT(elapsed.count(), times * 100);
+
+  ASSERT_EQ(handler.current_flushed_lsn(), thread_num * times);
+  ASSERT_EQ(RC::SUCCESS, handler.stop());
+  ASSERT_EQ(RC::SUCCESS, handler.await_termination());
+
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
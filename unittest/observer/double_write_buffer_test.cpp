@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <filesystem>
+#include <string.h>
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 
@@ -21,6 +23,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/clog/vacuous_log_handler.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/clog/integrated_log_replayer.h"
+#include "common/math/crc.h"
 
 using namespace std;
 using namespace common;
@@ -201,6 +204,102 @@ TEST(DoubleWriteBuffer, single_file_exception)
   bpm  = nullptr;
 }
 
+TEST(DoubleWriteBuffer, batch_write)
+{
+  /*
+  页面先保存在内存中，攒够一批或者主动刷新时才写入共享文件和页面所在的文件，
+  重新打开共享文件时只加载最后一批页面
+  */
+  filesystem::path directory("double_write_buffer_test_batch_write_dir");
+  filesystem::remove_all(directory);
+  filesystem::create_directories(directory);
+
+  filesystem::path buffer_pool_filename         = directory / "buffer_pool.bp";
+  filesystem::path double_write_buffer_filename = directory / "double_write_buffer.dwb";
+
+  const int         max_pages = 4;
+  auto              bpm       = make_unique<BufferPoolManager>();
+  VacuousLogHandler log_handler;
+  auto              double_write_buffer = make_unique<DiskDoubleWriteBuffer>(*bpm, max_pages);
+  ASSERT_EQ(RC::SUCCESS, double_write_buffer->open_file(double_write_buffer_filename.c_str()));
+  DiskDoubleWriteBuffer *dblwr_buffer = double_write_buffer.get();
+  ASSERT_EQ(bpm->init(std::move(double_write_buffer)), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(buffer_pool_filename.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, buffer_pool_filename.c_str(), buffer_pool));
+  ASSERT_NE(buffer_pool, nullptr);
+
+  vector<PageNum> page_nums;
+  for (int i = 0; i < max_pages; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    page_nums.push_back(frame->page_num());
+    frame->unpin();
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->flush_all_pages());
+  ASSERT_EQ(RC::SUCCESS, dblwr_buffer->flush_page());
+
+  auto make_page = [](char c, LSN lsn) {
+    Page page;
+    memset(page.data, c, BP_PAGE_DATA_SIZE);
+    page.lsn       = lsn;
+    page.check_sum = crc32(page.data, BP_PAGE_DATA_SIZE);
+    return page;
+  };
+  auto read_file_page = [buffer_pool](PageNum page_num, Page &page) {
+    return pread(buffer_pool->file_desc(), &page, BP_PAGE_SIZE, static_cast<off_t>(page_num) * BP_PAGE_SIZE);
+  };
+
+  // 没有攒够一批时只在内存中
+  const uintmax_t file_size = filesystem::file_size(double_write_buffer_filename);
+  for (int i = 0; i < max_pages - 1; i++) {
+    Page page = make_page('a' + i, 100 + i);
+    ASSERT_EQ(RC::SUCCESS, dblwr_buffer->add_page(buffer_pool, page_nums[i], page));
+  }
+  ASSERT_EQ(file_size, filesystem::file_size(double_write_buffer_filename));
+
+  Page page;
+  ASSERT_EQ(RC::SUCCESS, dblwr_buffer->read_page(buffer_pool, page_nums[0], page));
+  ASSERT_EQ('a', page.data[0]);
+  ASSERT_EQ(static_cast<ssize_t>(BP_PAGE_SIZE), read_file_page(page_nums[0], page));
+  ASSERT_NE('a', page.data[0]);
+
+  // 攒够一批后写入页面所在的文件
+  page = make_page('z', 200);
+  ASSERT_EQ(RC::SUCCESS, dblwr_buffer->add_page(buffer_pool, page_nums[max_pages - 1], page));
+  for (int i = 0; i < max_pages; i++) {
+    ASSERT_EQ(RC::BUFFERPOOL_INVALID_PAGE_NUM, dblwr_buffer->read_page(buffer_pool, page_nums[i], page));
+    ASSERT_EQ(static_cast<ssize_t>(BP_PAGE_SIZE), read_file_page(page_nums[i], page));
+    ASSERT_EQ(i == max_pages - 1 ? 'z' : 'a' + i, page.data[BP_PAGE_DATA_SIZE - 1]);
+  }
+
+  // 重新打开共享文件，可以读到最后一批页面
+  {
+    DiskDoubleWriteBuffer reopened(*bpm, max_pages);
+    ASSERT_EQ(RC::SUCCESS, reopened.open_file(double_write_buffer_filename.c_str()));
+    for (int i = 0; i < max_pages; i++) {
+      ASSERT_EQ(RC::SUCCESS, reopened.read_page(buffer_pool, page_nums[i], page));
+      ASSERT_EQ(i == max_pages - 1 ? 'z' : 'a' + i, page.data[0]);
+    }
+  }
+
+  // 新的一批只有一个页面，上一批剩下的页面不会再被加载
+  page = make_page('y', 300);
+  ASSERT_EQ(RC::SUCCESS, dblwr_buffer->add_page(buffer_pool, page_nums[1], page));
+  ASSERT_EQ(RC::SUCCESS, dblwr_buffer->flush_page());
+  {
+    DiskDoubleWriteBuffer reopened(*bpm, max_pages);
+    ASSERT_EQ(RC::SUCCESS, reopened.open_file(double_write_buffer_filename.c_str()));
+    ASSERT_EQ(RC::SUCCESS, reopened.read_page(buffer_pool, page_nums[1], page));
+    ASSERT_EQ('y', page.data[0]);
+    ASSERT_EQ(RC::BUFFERPOOL_INVALID_PAGE_NUM, reopened.read_page(buffer_pool, page_nums[0], page));
+    ASSERT_EQ(RC::BUFFERPOOL_INVALID_PAGE_NUM, reopened.read_page(buffer_pool, page_nums[2], page));
+  }
+
+  bpm = nullptr;
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
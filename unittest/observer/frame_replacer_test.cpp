@@ -0,0 +1,200 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/frame_replacer.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 模拟一个只能存放capacity个页面的缓存，返回命中率
+ * @details 热点页面被反复访问，中间穿插着少量其它页面的访问，每一轮最后做一次全表扫描
+ */
+double simulate(FrameReplacer &replacer, int capacity)
+{
+  const int hot_num        = capacity / 4;
+  const int scan_num       = capacity * 4;
+  const int round_num      = 20;
+  const int buffer_pool_id = 1;
+
+  unique_ptr<Frame[]> frames = make_unique<Frame[]>(capacity);
+  vector<Frame *>     free_frames;
+  for (int i = 0; i < capacity; i++) {
+    free_frames.push_back(&frames[i]);
+  }
+
+  int  access_count = 0;
+  int  hit_count    = 0;
+  auto access       = [&](PageNum page_num) {
+    access_count++;
+    FrameId frame_id(buffer_pool_id, page_num);
+    Frame  *frame = nullptr;
+    if (replacer.get(frame_id, frame)) {
+      hit_count++;
+      return;
+    }
+
+    if (free_frames.empty()) {
+      FrameId victim;
+      replacer.foreach_victim([&victim, &free_frames](const FrameId &id, Frame *const victim_frame) {
+        victim = id;
+        free_frames.push_back(victim_frame);
+        return false;
+      });
+      replacer.remove(victim, true /*evicted*/);
+    }
+
+    frame = free_frames.back();
+    free_frames.pop_back();
+    replacer.put(frame_id, frame);
+  };
+
+  PageNum cold_page = hot_num;
+  for (int round = 0; round < round_num; round++) {
+    for (int i = 0; i < 4; i++) {
+      for (PageNum page_num = 0; page_num < hot_num; page_num++) {
+        access(page_num);
+      }
+      for (int j = 0; j < capacity / 2; j++) {
+        access(cold_page++);
+      }
+    }
+
+    for (int i = 0; i < scan_num; i++) {
+      access(cold_page++);
+    }
+  }
+
+  EXPECT_EQ(static_cast<size_t>(capacity), replacer.count());
+  return static_cast<double>(hit_count) / access_count;
+}
+
+TEST(FrameReplacer, create)
+{
+  unique_ptr<FrameReplacer> replacer = FrameReplacer::create("lru");
+  ASSERT_NE(nullptr, replacer);
+  ASSERT_STREQ("lru", replacer->name());
+
+  replacer = FrameReplacer::create("2q");
+  ASSERT_NE(nullptr, replacer);
+  ASSERT_STREQ("2q", replacer->name());
+
+  ASSERT_EQ(nullptr, FrameReplacer::create("unknown"));
+}
+
+TEST(FrameReplacer, two_queue)
+{
+  TwoQueueFrameReplacer replacer;
+  Frame                 frames[3];
+  FrameId               frame_ids[3] = {FrameId(1, 1), FrameId(1, 2), FrameId(1, 3)};
+
+  // 新页面放在A1in中，再次访问也不会移动
+  for (int i = 0; i < 3; i++) {
+    replacer.put(frame_ids[i], &frames[i]);
+  }
+  Frame *frame = nullptr;
+  ASSERT_TRUE(replacer.get(frame_ids[0], frame));
+  ASSERT_EQ(&frames[0], frame);
+  ASSERT_EQ(3UL, replacer.in_count());
+
+  vector<FrameId> victims;
+  auto            collector = [&victims](const FrameId &frame_id, Frame *const) {
+    victims.push_back(frame_id);
+    return true;
+  };
+  replacer.foreach_victim(collector);
+  ASSERT_EQ(vector<FrameId>(frame_ids, frame_ids + 3), victims);
+
+  // 不是淘汰的页面，比如删除的页面，不记录到A1out中
+  replacer.remove(frame_ids[1], false /*evicted*/);
+  ASSERT_EQ(0UL, replacer.out_count());
+  replacer.put(frame_ids[1], &frames[1]);
+  ASSERT_EQ(0UL, replacer.main_count());
+
+  // 从A1in中淘汰的页面再次进入内存时放到Am中
+  replacer.remove(frame_ids[0], true /*evicted*/);
+  ASSERT_EQ(1UL, replacer.out_count());
+  ASSERT_FALSE(replacer.peek(frame_ids[0], frame));
+  replacer.put(frame_ids[0], &frames[0]);
+  ASSERT_EQ(0UL, replacer.out_count());
+  ASSERT_EQ(1UL, replacer.main_count());
+  ASSERT_EQ(2UL, replacer.in_count());
+
+  // A1in 超过比例时先淘汰A1in中的页面
+  victims.clear();
+  replacer.foreach_victim(collector);
+  ASSERT_EQ(vector<FrameId>({frame_ids[2], frame_ids[1], frame_ids[0]}), victims);
+
+  // 从Am中删除不会记录到A1out中
+  replacer.remove(frame_ids[0], true /*evicted*/);
+  ASSERT_EQ(0UL, replacer.out_count());
+  ASSERT_EQ(2UL, replacer.count());
+}
+
+TEST(FrameReplacer, scan_resistant)
+{
+  const int capacity = 64;
+
+  LruFrameReplacer lru;
+  const double     lru_hit_ratio = simulate(lru, capacity);
+
+  TwoQueueFrameReplacer two_queue;
+  const double          two_queue_hit_ratio = simulate(two_queue, capacity);
+
+  LOG_INFO("hit ratio. lru=%f, 2q=%f", lru_hit_ratio, two_queue_hit_ratio);
+  ASSERT_GT(two_queue_hit_ratio, lru_hit_ratio);
+
+  // 扫描结束之后热点页面还在内存中
+  for (PageNum page_num = 0; page_num < capacity / 4; page_num++) {
+    Frame *frame = nullptr;
+    ASSERT_TRUE(two_queue.peek(FrameId(1, page_num), frame));
+  }
+}
+
+TEST(FrameReplacer, frame_manager)
+{
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::SUCCESS, frame_manager.init(2, 4));
+  ASSERT_STREQ("lru", frame_manager.replacement_policy());
+
+  ASSERT_EQ(RC::INVALID_ARGUMENT, frame_manager.set_replacement_policy("unknown"));
+  ASSERT_EQ(RC::SUCCESS, frame_manager.set_replacement_policy("2q"));
+  ASSERT_STREQ("2q", frame_manager.replacement_policy());
+
+  Frame *frame = frame_manager.alloc(1, 1);
+  ASSERT_NE(nullptr, frame);
+  ASSERT_EQ(RC::INTERNAL, frame_manager.set_replacement_policy("lru"));
+  frame_manager.record_access(false);
+  frame_manager.record_access(true);
+  frame_manager.record_access(true);
+
+  BPHitStat stat;
+  frame_manager.hit_stat(stat);
+  ASSERT_EQ("2q", stat.replacement_policy);
+  ASSERT_EQ(3UL, stat.access_count);
+  ASSERT_EQ(2UL, stat.hit_count);
+
+  ASSERT_EQ(RC::SUCCESS, frame_manager.free(1, 1, frame));
+  ASSERT_EQ(RC::SUCCESS, frame_manager.cleanup());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_TRACE);
+  return RUN_ALL_TESTS();
+}
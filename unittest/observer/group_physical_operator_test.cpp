@@ -0,0 +1,120 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <climits>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "common/log/log.h"
+#include "sql/operator/group_physical_operator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 输出固定行数的算子，作为聚合算子的输入
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  explicit RowsPhysicalOperator(int row_num) : row_num_(row_num) {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *) override
+  {
+    position_ = -1;
+    return RC::SUCCESS;
+  }
+
+  RC next() override
+  {
+    if (position_ + 1 >= row_num_) {
+      return RC::RECORD_EOF;
+    }
+    position_++;
+    return RC::SUCCESS;
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  int            row_num_  = 0;
+  int            position_ = -1;
+  ValueListTuple tuple_;
+};
+
+/**
+ * @brief 对row_num行数据求和，每一行的值都是value，返回唯一的一行结果
+ */
+static RC sum_of(const Value &value, int row_num, Value &result)
+{
+  vector<unique_ptr<AggregateDesc>> descs;
+  descs.push_back(make_unique<AggregateDesc>(AggregateType::SUM, make_unique<ValueExpr>(value), TupleCellSpec("sum")));
+
+  GroupPhysicalOperator oper(std::move(descs), vector<unique_ptr<Expression>>());
+  oper.add_child(make_unique<RowsPhysicalOperator>(row_num));
+
+  RC rc = oper.open(nullptr);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = oper.next();
+  if (OB_SUCC(rc)) {
+    rc = oper.current_tuple()->cell_at(0, result);
+  }
+  EXPECT_EQ(RC::SUCCESS, oper.close());
+  return rc;
+}
+
+TEST(GroupPhysicalOperator, sum_type)
+{
+  Value result;
+  ASSERT_EQ(RC::SUCCESS, sum_of(Value(3), 4, result));
+  ASSERT_EQ(AttrType::INTS, result.attr_type());
+  ASSERT_EQ(12, result.get_int());
+
+  ASSERT_EQ(RC::SUCCESS, sum_of(Value(1.5f), 4, result));
+  ASSERT_EQ(AttrType::FLOATS, result.attr_type());
+  ASSERT_FLOAT_EQ(6.0f, result.get_float());
+
+  // 浮点数的和即使是整数值也按照浮点数返回
+  ASSERT_EQ(RC::SUCCESS, sum_of(Value(2.0f), 2, result));
+  ASSERT_EQ(AttrType::FLOATS, result.attr_type());
+
+  ASSERT_EQ(RC::SUCCESS, sum_of(Value(INT_MAX), 1, result));
+  ASSERT_EQ(AttrType::INTS, result.attr_type());
+  ASSERT_EQ(INT_MAX, result.get_int());
+}
+
+TEST(GroupPhysicalOperator, sum_overflow)
+{
+  // 整数的和超出int的范围时报错，而不是换成精度更低的浮点数
+  Value result;
+  ASSERT_EQ(RC::NUMERIC_OVERFLOW, sum_of(Value(INT_MAX), 2, result));
+  ASSERT_EQ(RC::NUMERIC_OVERFLOW, sum_of(Value(INT_MIN), 2, result));
+
+  ASSERT_EQ(RC::SUCCESS, sum_of(Value(INT_MIN / 2), 2, result));
+  ASSERT_EQ(AttrType::INTS, result.attr_type());
+  ASSERT_EQ(INT_MIN, result.get_int());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <fcntl.h>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "storage/buffer/io_engine.h"
+
+using namespace std;
+using namespace common;
+
+static const int64_t BLOCK_SIZE = 4096;
+
+void test_io_engine(IoEngine &engine)
+{
+  filesystem::path file = filesystem::path(string("io_engine_test_") + engine.name() + ".dat");
+  filesystem::remove(file);
+  int fd = open(file.c_str(), O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+
+  // 单个请求
+  vector<char> block(BLOCK_SIZE, 'a');
+  vector<char> read_block(BLOCK_SIZE, 0);
+  ASSERT_EQ(RC::SUCCESS, engine.write(fd, 0, block.data(), BLOCK_SIZE));
+  ASSERT_EQ(RC::SUCCESS, engine.read(fd, 0, read_block.data(), BLOCK_SIZE));
+  ASSERT_EQ(block, read_block);
+
+  // 一批请求，超过一个io_uring的容量，顺序是乱的
+  const int            block_num = IoUringEngine::RING_ENTRIES * 2 + 3;
+  vector<vector<char>> blocks(block_num);
+  vector<IoRequest>    requests(block_num);
+  for (int i = 0; i < block_num; i++) {
+    const int index = (i * 7) % block_num;
+    blocks[i].assign(BLOCK_SIZE, static_cast<char>('0' + index % 64));
+    requests[i].type   = IoRequest::Type::WRITE;
+    requests[i].fd     = fd;
+    requests[i].offset = index * BLOCK_SIZE;
+    requests[i].buf    = blocks[i].data();
+    requests[i].size   = BLOCK_SIZE;
+  }
+  ASSERT_EQ(RC::SUCCESS, engine.submit(requests));
+
+  vector<vector<char>> read_blocks(block_num, vector<char>(BLOCK_SIZE, 0));
+  for (int i = 0; i < block_num; i++) {
+    requests[i].type = IoRequest::Type::READ;
+    requests[i].buf  = read_blocks[i].data();
+    requests[i].rc   = RC::INTERNAL;
+  }
+  ASSERT_EQ(RC::SUCCESS, engine.submit(requests));
+  for (int i = 0; i < block_num; i++) {
+    ASSERT_EQ(RC::SUCCESS, requests[i].rc);
+    ASSERT_EQ(blocks[i], read_blocks[i]);
+  }
+
+  // 读超过文件末尾的位置会失败，不影响同一批中的其它请求
+  requests.resize(2);
+  requests[1].offset = block_num * BLOCK_SIZE + BLOCK_SIZE / 2;
+  ASSERT_NE(RC::SUCCESS, engine.submit(requests));
+  ASSERT_EQ(RC::SUCCESS, requests[0].rc);
+  ASSERT_EQ(RC::IOERR_READ, requests[1].rc);
+
+  // 多个线程同时提交
+  vector<thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&engine, fd, t]() {
+      vector<char> data(BLOCK_SIZE, static_cast<char>('A' + t));
+      vector<char> result(BLOCK_SIZE, 0);
+      for (int i = 0; i < 100; i++) {
+        const int64_t offset = (t * 100 + i) * BLOCK_SIZE;
+        ASSERT_EQ(RC::SUCCESS, engine.write(fd, offset, data.data(), BLOCK_SIZE));
+        ASSERT_EQ(RC::SUCCESS, engine.read(fd, offset, result.data(), BLOCK_SIZE));
+        ASSERT_EQ(data, result);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  close(fd);
+  filesystem::remove(file);
+}
+
+TEST(IoEngine, pread)
+{
+  unique_ptr<IoEngine> engine = IoEngine::create("pread");
+  ASSERT_NE(nullptr, engine);
+  ASSERT_STREQ("pread", engine->name());
+  test_io_engine(*engine);
+}
+
+TEST(IoEngine, io_uring)
+{
+  // 系统不支持io_uring时会退化为pread
+  unique_ptr<IoEngine> engine = IoEngine::create("io_uring");
+  ASSERT_NE(nullptr, engine);
+  test_io_engine(*engine);
+}
+
+TEST(IoEngine, unknown)
+{
+  ASSERT_EQ(nullptr, IoEngine::create("unknown"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_TRACE);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string>
+#include <vector>
+
+#include "sql/expr/row_codec.h"
+#include "sql/operator/join_hash_table.h"
+#include "sql/operator/spill_file.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(RowCodec, encode_decode)
+{
+  Value null_value;
+  null_value.set_null();
+
+  vector<Value> cells = {Value(1), Value((float)2.5), Value("abc"), Value(""), null_value, Value(true)};
+
+  vector<char> buf(RowCodec::encoded_size(cells));
+  RowCodec::encode(cells, buf.data());
+  ASSERT_EQ(RowCodec::cell_num(buf.data()), static_cast<int>(cells.size()));
+  ASSERT_EQ(RowCodec::row_size(buf.data()), static_cast<int>(buf.size()));
+
+  Value cell;
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 0, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), INTS);
+  ASSERT_EQ(cell.get_int(), 1);
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 1, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), FLOATS);
+  ASSERT_FLOAT_EQ(cell.get_float(), 2.5);
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 2, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), CHARS);
+  ASSERT_EQ(cell.get_string(), "abc");
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 3, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), CHARS);
+  ASSERT_EQ(cell.get_string(), "");
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 4, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), NULLS);
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 5, cell), RC::SUCCESS);
+  ASSERT_EQ(cell.attr_type(), BOOLEANS);
+  ASSERT_TRUE(cell.get_boolean());
+
+  ASSERT_EQ(RowCodec::decode_cell(buf.data(), 6, cell), RC::NOTFOUND);
+}
+
+TEST(JoinKeyEncoder, mixed_types)
+{
+  ASSERT_EQ(join_key_type(INTS, INTS), JoinKeyType::INTEGER);
+  ASSERT_EQ(join_key_type(INTS, FLOATS), JoinKeyType::DOUBLE);
+  ASSERT_EQ(join_key_type(CHARS, CHARS), JoinKeyType::STRING);
+  ASSERT_EQ(join_key_type(DATES, CHARS), JoinKeyType::DATE);
+
+  JoinKeyEncoder int_encoder({JoinKeyType::DOUBLE});
+  JoinKeyEncoder float_encoder({JoinKeyType::DOUBLE});
+
+  string int_key;
+  string float_key;
+  ASSERT_TRUE(int_encoder.encode_values({Value(3)}, int_key));
+  ASSERT_TRUE(float_encoder.encode_values({Value((float)3.0)}, float_key));
+  ASSERT_EQ(int_key, float_key);
+
+  ASSERT_TRUE(float_encoder.encode_values({Value((float)3.5)}, float_key));
+  ASSERT_NE(int_key, float_key);
+
+  Value null_value;
+  null_value.set_null();
+  ASSERT_FALSE(int_encoder.encode_values({null_value}, int_key));
+
+  // 多列的键不能因为拼接产生歧义
+  JoinKeyEncoder string_encoder({JoinKeyType::STRING, JoinKeyType::STRING});
+  string         key1;
+  string         key2;
+  ASSERT_TRUE(string_encoder.encode_values({Value("ab"), Value("c")}, key1));
+  ASSERT_TRUE(string_encoder.encode_values({Value("a"), Value("bc")}, key2));
+  ASSERT_NE(key1, key2);
+}
+
+TEST(JoinHashTable, find)
+{
+  JoinKeyEncoder encoder({JoinKeyType::INTEGER});
+  JoinHashTable  hash_table;
+
+  string key;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(encoder.encode_values({Value(i % 100)}, key));
+    hash_table.insert(key, {Value(i % 100), Value(i)});
+  }
+  hash_table.build();
+  ASSERT_EQ(hash_table.size(), 1000UL);
+
+  for (int k = 0; k < 100; k++) {
+    ASSERT_TRUE(encoder.encode_values({Value(k)}, key));
+    const size_t hash = JoinHashTable::hash(key);
+
+    int   count    = 0;
+    int   previous = -1;
+    Value cell;
+    for (int entry = hash_table.find_first(key, hash); entry >= 0; entry = hash_table.find_next(entry, key, hash)) {
+      ASSERT_EQ(RowCodec::decode_cell(hash_table.row(entry), 0, cell), RC::SUCCESS);
+      ASSERT_EQ(cell.get_int(), k);
+      // 相同的键按照插入的顺序返回
+      ASSERT_EQ(RowCodec::decode_cell(hash_table.row(entry), 1, cell), RC::SUCCESS);
+      ASSERT_GT(cell.get_int(), previous);
+      previous = cell.get_int();
+      count++;
+    }
+    ASSERT_EQ(count, 10);
+  }
+
+  ASSERT_TRUE(encoder.encode_values({Value(1000)}, key));
+  ASSERT_LT(hash_table.find_first(key, JoinHashTable::hash(key)), 0);
+
+  hash_table.clear();
+  ASSERT_TRUE(hash_table.empty());
+}
+
+TEST(SpillFile, write_read)
+{
+  SpillFile file;
+  ASSERT_EQ(file.open("."), RC::SUCCESS);
+
+  // 超过一个缓存大小，覆盖读写时缓存的切换
+  const int record_num = 10000;
+  for (int i = 0; i < record_num; i++) {
+    string row(i % 50, static_cast<char>('a' + i % 26));
+    ASSERT_EQ(file.append(to_string(i), row), RC::SUCCESS);
+  }
+  ASSERT_EQ(file.finish(), RC::SUCCESS);
+  ASSERT_EQ(file.record_count(), record_num);
+
+  string key;
+  string row;
+  for (int i = 0; i < record_num; i++) {
+    ASSERT_EQ(file.read(key, row), RC::SUCCESS);
+    ASSERT_EQ(key, to_string(i));
+    ASSERT_EQ(row, string(i % 50, static_cast<char>('a' + i % 26)));
+  }
+  ASSERT_EQ(file.read(key, row), RC::RECORD_EOF);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/31
 //
 
+#include <atomic>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #define private public
@@ -62,10 +65,96 @@ TEST(LogEntryBuffer, test_append)
 
   ASSERT_NE(RC::SUCCESS, buffer.flush(writer, count));
 
+  // 文件写满时没有写入的日志留在缓冲区中，切换文件后继续写
+  ASSERT_EQ(count, 0);
+  ASSERT_EQ(buffer.entry_number(), 1);
+  ASSERT_GT(buffer.bytes(), 0);
+  writer.close();
+  filesystem::remove("test_log_entry_buffer.log");
+
+  ASSERT_EQ(RC::SUCCESS, writer.open("test_log_entry_buffer.log", end_lsn + 1000));
+  ASSERT_EQ(RC::SUCCESS, buffer.flush(writer, count));
+  ASSERT_EQ(count, 1);
+  ASSERT_EQ(buffer.entry_number(), 0);
+  ASSERT_EQ(buffer.bytes(), 0);
+  ASSERT_EQ(buffer.flushed_lsn(), lsn);
+
   writer.close();
   filesystem::remove("test_log_entry_buffer.log");
 }
 
+TEST(LogEntryBuffer, test_concurrent_append)
+{
+  // 多个线程同时追加日志，数据量是缓冲区大小的几倍，环形内存会回绕多次
+  const char *filename = "test_log_entry_buffer_concurrent.log";
+  filesystem::remove(filename);
+
+  LogEntryBuffer buffer;
+  ASSERT_EQ(RC::SUCCESS, buffer.init(0));
+
+  const int     thread_num = 8;
+  const int     times      = 20000;
+  const LSN     total      = thread_num * times;
+  atomic<bool>  done{false};
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, writer.open(filename, total));
+
+  thread flusher([&]() {
+    while (!done.load() || buffer.entry_number() > 0) {
+      int count = 0;
+      ASSERT_EQ(RC::SUCCESS, buffer.flush(writer, count));
+      if (count == 0) {
+        buffer.wait_entries(chrono::milliseconds(10));
+      }
+    }
+  });
+
+  vector<thread> threads;
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back([&buffer, i]() {
+      for (int j = 0; j < times; j++) {
+        // 日志数据是线程编号和序号，长度各不相同
+        vector<char> data(sizeof(int) * 2 + (j % 200));
+        memcpy(data.data(), &i, sizeof(i));
+        memcpy(data.data() + sizeof(i), &j, sizeof(j));
+        LSN lsn = 0;
+        ASSERT_EQ(RC::SUCCESS, buffer.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  done.store(true);
+  flusher.join();
+  writer.close();
+
+  ASSERT_EQ(buffer.current_lsn(), total);
+  ASSERT_EQ(buffer.flushed_lsn(), total);
+  ASSERT_EQ(buffer.bytes(), 0);
+
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, reader.open(filename));
+  LSN         last_lsn = 0;
+  vector<int> next_seq(thread_num, 0);
+  auto        checker  = [&](LogEntry &entry) -> RC {
+    EXPECT_EQ(entry.lsn(), last_lsn + 1);
+    last_lsn = entry.lsn();
+
+    int thread_index = 0, seq = 0;
+    memcpy(&thread_index, entry.data(), sizeof(thread_index));
+    memcpy(&seq, entry.data() + sizeof(thread_index), sizeof(seq));
+    EXPECT_EQ(seq, next_seq[thread_index]++);
+    EXPECT_EQ(entry.payload_size(), static_cast<int>(sizeof(int) * 2 + (seq % 200)));
+    return RC::SUCCESS;
+  };
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(checker));
+  ASSERT_EQ(last_lsn, total);
+  reader.close();
+
+  filesystem::remove(filename);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -178,6 +178,61 @@ TEST(LogFileReadWrite, test_read_write)
   // filesystem::remove(log_file);
 }
 
+TEST(LogFileReadWrite, test_batch_write)
+{
+  const char *log_file = "test_log_file_batch_write.log";
+
+  filesystem::remove(log_file);
+
+  LogFileWriter writer;
+  LSN           end_lsn = 100;
+  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, end_lsn));
+
+  // 按照文件格式序列化日志，记录每条日志结束的位置
+  vector<char>   buffer;
+  vector<size_t> entry_ends(1, 0);
+  for (LSN lsn = 1; lsn <= 150; ++lsn) {
+    LogEntry     entry;
+    vector<char> data(lsn);
+    ASSERT_EQ(RC::SUCCESS, entry.init(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+    const char *header = reinterpret_cast<const char *>(&entry.header());
+    buffer.insert(buffer.end(), header, header + LogHeader::SIZE);
+    buffer.insert(buffer.end(), entry.data(), entry.data() + entry.payload_size());
+    entry_ends.push_back(buffer.size());
+  }
+
+  // 超过end_lsn的日志不会写入
+  struct iovec iov[2];
+  iov[0].iov_base = buffer.data();
+  iov[0].iov_len  = entry_ends[150];
+  ASSERT_EQ(RC::LOG_FILE_FULL, writer.write(iov, 1, 1, 150));
+
+  // 分成两段写入，中间切开一条日志
+  iov[0].iov_len  = entry_ends[50] + 3;
+  iov[1].iov_base = buffer.data() + iov[0].iov_len;
+  iov[1].iov_len  = entry_ends[end_lsn] - iov[0].iov_len;
+  ASSERT_EQ(RC::SUCCESS, writer.write(iov, 2, 1, end_lsn));
+  ASSERT_TRUE(writer.full());
+  ASSERT_EQ(RC::INVALID_ARGUMENT, writer.write(iov, 2, 1, end_lsn));
+  writer.close();
+
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, reader.open(log_file));
+
+  LSN  last_lsn = 0;
+  auto callback = [&last_lsn](LogEntry &entry) -> RC {
+    EXPECT_EQ(last_lsn + 1, entry.lsn());
+    EXPECT_EQ(entry.lsn(), entry.payload_size());
+    last_lsn = entry.lsn();
+    return RC::SUCCESS;
+  };
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback));
+  ASSERT_EQ(end_lsn, last_lsn);
+  reader.close();
+
+  filesystem::remove(log_file);
+}
+
 TEST(LogFileManager, get_lsn_from_filename)
 {
   const char *file_prefix = LogFileManager::file_prefix_;
@@ -390,6 +445,50 @@ TEST(LogFileManager, next_file)
   filesystem::remove_all(directory);
 }
 
+TEST(LogFileManager, remove_files)
+{
+  const char *directory                 = "remove_files";
+  int         max_entry_number_per_file = 1000;
+
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directory(directory));
+
+  LSN lsns[] = {1000, 2000, 3000};
+  for (LSN lsn : lsns) {
+    string filename = string(directory) + "/" + LogFileManager::file_prefix_ + to_string(lsn) + LogFileManager::file_suffix_;
+    ofstream ofs(filename);
+    ofs.close();
+  }
+
+  LogFileManager manager;
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(3, manager.file_num());
+
+  // 第一个文件中还有没有到检查点的日志
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files(1999));
+  ASSERT_EQ(3, manager.file_num());
+
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files(2000));
+  ASSERT_EQ(2, manager.file_num());
+  ASSERT_FALSE(filesystem::exists(string(directory) + "/" + LogFileManager::file_prefix_ + "1000" + LogFileManager::file_suffix_));
+
+  // 最后一个文件总是保留
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files(10000));
+  ASSERT_EQ(1, manager.file_num());
+
+  vector<string> files;
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(string(LogFileManager::file_prefix_) + "3000" + LogFileManager::file_suffix_, filesystem::path(files[0]).filename());
+
+  // 新的文件接着最后一个文件
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, manager.next_file(writer));
+  ASSERT_EQ(string(LogFileManager::file_prefix_) + "4000" + LogFileManager::file_suffix_, filesystem::path(writer.filename()).filename());
+
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
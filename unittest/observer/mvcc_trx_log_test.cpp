@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "gtest/gtest.h"
 #include "storage/db/db.h"
+#include "storage/field/field.h"
 #include "storage/table/table.h"
 #include "storage/record/record.h"
 #include "storage/trx/mvcc_trx.h"
@@ -713,6 +714,251 @@ TEST(MvccTrxLog, wal_rollback_abnormal)
   db.reset();
 }
 
+TEST(MvccTrxLog, checkpoint)
+{
+  /*
+  插入一些数据，其中一个事务一直不提交。做检查点时不能越过这个事务的日志，复制出来的数据库恢复时要把它回滚掉。
+  这个事务结束后再做检查点，旧的日志文件会被删除，重启后数据依然完整，LSN也能接着增长。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  const char      *dbname3          = "test_db3";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  filesystem::path db_path3         = test_directory / dbname3;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  const char             *table_name = "table_0";
+  const int               field_num  = 4;
+  vector<AttrInfoSqlNode> attr_infos;
+  for (int i = 0; i < field_num; i++) {
+    AttrInfoSqlNode attr_info;
+    attr_info.name   = string("field_") + to_string(i);
+    attr_info.type   = AttrType::INTS;
+    attr_info.length = 4;
+    attr_infos.push_back(attr_info);
+  }
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  auto insert_records = [&](Db &db, Trx *trx, int num) {
+    Table *table = db.find_table(table_name);
+    ASSERT_NE(table, nullptr);
+    for (int i = 0; i < num; i++) {
+      vector<Value> values(field_num);
+      for (Value &value : values) {
+        value.set_int(i);
+      }
+
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table->make_record(values.size(), values.data(), record));
+      ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+    }
+  };
+
+  auto count_records = [table_name](Db &db) {
+    Table            *table = db.find_table(table_name);
+    RecordFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    int    count = 0;
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      count++;
+    }
+    return count;
+  };
+
+  TrxKit   &trx_kit       = db->trx_kit();
+  const int committed_num = 1000;
+  const int active_num    = 100;
+
+  Trx *trx = trx_kit.create_trx(db->log_handler());
+  trx->start_if_need();
+  insert_records(*db, trx, committed_num);
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  Trx *active_trx = trx_kit.create_trx(db->log_handler());
+  active_trx->start_if_need();
+  insert_records(*db, active_trx, active_num);
+  const LSN active_trx_lsn = static_cast<MvccTrx *>(active_trx)->recovery_lsn();
+  ASSERT_GT(active_trx_lsn, 0);
+
+  trx = trx_kit.create_trx(db->log_handler());
+  trx->start_if_need();
+  insert_records(*db, trx, committed_num);
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  DiskLogHandler &log_handler = static_cast<DiskLogHandler &>(db->log_handler());
+  ASSERT_GT(log_handler.log_file_num(), 1);
+
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint());
+  ASSERT_GT(db->check_point_lsn(), 0);
+  ASSERT_LE(db->check_point_lsn(), active_trx_lsn);
+
+  ASSERT_EQ(RC::SUCCESS, log_handler.wait_lsn(log_handler.current_lsn()));
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+  ASSERT_EQ(committed_num * 2, count_records(*db2));
+  db2.reset();
+
+  ASSERT_EQ(RC::SUCCESS, active_trx->commit());
+  trx_kit.destroy_trx(active_trx);
+
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+  const LSN current_lsn = log_handler.current_lsn();
+  ASSERT_EQ(current_lsn + 1, db->check_point_lsn());
+  ASSERT_EQ(1, log_handler.log_file_num());
+
+  filesystem::copy(db_path, db_path3, filesystem::copy_options::recursive);
+
+  auto db3 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db3->init(dbname3, db_path3.c_str(), trx_kit_name, log_handler_name));
+  ASSERT_EQ(committed_num * 2 + active_num, count_records(*db3));
+  ASSERT_EQ(current_lsn, db3->log_handler().current_lsn());
+
+  trx = db3->trx_kit().create_trx(db3->log_handler());
+  trx->start_if_need();
+  insert_records(*db3, trx, 1);
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  db3->trx_kit().destroy_trx(trx);
+  ASSERT_GT(db3->log_handler().current_lsn(), current_lsn);
+
+  db3.reset();
+  db.reset();
+}
+
+TEST(MvccTrxLog, wal_update)
+{
+  /*
+  原地更新记录，一个事务提交，另一个事务没有提交。
+  日志落地后复制文件，重启后提交的修改可见，没有提交的修改使用日志中的旧版本回滚。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  vector<AttrInfoSqlNode> attr_infos;
+  for (const char *name : {"id", "value"}) {
+    AttrInfoSqlNode attr_info;
+    attr_info.name   = name;
+    attr_info.type   = AttrType::INTS;
+    attr_info.length = 4;
+    attr_infos.push_back(attr_info);
+  }
+  const char *table_name = "table_update";
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+  Table *table = db->find_table(table_name);
+  ASSERT_NE(table, nullptr);
+
+  const int record_num = 100;
+  auto      make_record = [](Table *table, int id, int value, Record &record) {
+    Value values[2];
+    values[0].set_int(id);
+    values[1].set_int(value);
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+  };
+
+  TrxKit &trx_kit = db->trx_kit();
+  Trx    *trx     = trx_kit.create_trx(db->log_handler());
+  trx->start_if_need();
+  vector<RID> rids;
+  for (int i = 0; i < record_num; i++) {
+    Record record;
+    make_record(table, i, i, record);
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+    rids.push_back(record.rid());
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  auto update_all = [&](Trx *trx, int delta) {
+    for (int i = 0; i < record_num; i++) {
+      Record old_record;
+      ASSERT_EQ(RC::SUCCESS, table->get_record(rids[i], old_record));
+      Record new_record;
+      make_record(table, i, i + delta, new_record);
+      ASSERT_EQ(RC::SUCCESS, trx->update_record(table, old_record, new_record));
+      ASSERT_EQ(rids[i], new_record.rid());
+    }
+  };
+
+  Trx *committed_trx = trx_kit.create_trx(db->log_handler());
+  committed_trx->start_if_need();
+  update_all(committed_trx, 1000);
+  ASSERT_EQ(RC::SUCCESS, committed_trx->commit());
+  trx_kit.destroy_trx(committed_trx);
+
+  Trx *active_trx = trx_kit.create_trx(db->log_handler());
+  active_trx->start_if_need();
+  update_all(active_trx, 2000);
+
+  DiskLogHandler &log_handler = static_cast<DiskLogHandler &>(db->log_handler());
+  LSN             current_lsn = log_handler.current_lsn();
+  ASSERT_EQ(RC::SUCCESS, log_handler.wait_lsn(current_lsn));
+
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+  ASSERT_EQ(0UL, static_cast<MvccTrxKit &>(db2->trx_kit()).undo_segment().version_count());
+
+  Table *table2 = db2->find_table(table_name);
+  ASSERT_NE(table2, nullptr);
+  Field id_field(table2, table2->table_meta().field("id"));
+  Field value_field(table2, table2->table_meta().field("value"));
+
+  trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table2->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+  int    record_count  = 0;
+  int    visible_count = 0;
+  Record record;
+  while (OB_SUCC(scanner.next(record))) {
+    record_count++;
+    if (OB_SUCC(trx->visit_record(table2, record, ReadWriteMode::READ_ONLY))) {
+      visible_count++;
+      ASSERT_EQ(id_field.get_int(record) + 1000, value_field.get_int(record));
+    }
+  }
+  ASSERT_EQ(record_num, record_count);
+  ASSERT_EQ(record_num, visible_count);
+  db2->trx_kit().destroy_trx(trx);
+
+  db2.reset();
+  ASSERT_EQ(RC::SUCCESS, active_trx->rollback());
+  trx_kit.destroy_trx(active_trx);
+  db.reset();
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,445 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/field/field.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+using namespace common;
+
+class MvccTrxTest : public testing::Test
+{
+protected:
+  static constexpr int RECORD_NUM = 10;
+
+  void SetUp() override
+  {
+    test_directory_ = filesystem::path("mvcc_trx_test") / testing::UnitTest::GetInstance()->current_test_info()->name();
+    filesystem::remove_all(test_directory_);
+    filesystem::create_directories(test_directory_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", test_directory_.c_str(), "mvcc", "vacuous"));
+
+    vector<AttrInfoSqlNode> attr_infos;
+    for (const char *name : {"id", "value"}) {
+      AttrInfoSqlNode attr_info;
+      attr_info.name   = name;
+      attr_info.type   = AttrType::INTS;
+      attr_info.length = 4;
+      attr_infos.push_back(attr_info);
+    }
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+
+    Trx *trx = create_trx();
+    for (int i = 0; i < RECORD_NUM; i++) {
+      Record record;
+      make_record(i, 0, record);
+      ASSERT_EQ(RC::SUCCESS, trx->insert_record(table_, record));
+    }
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    destroy_trx(trx);
+  }
+
+  void TearDown() override
+  {
+    db_.reset();
+    filesystem::remove_all(test_directory_);
+  }
+
+  Trx *create_trx()
+  {
+    Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+    trx->start_if_need();
+    return trx;
+  }
+
+  void destroy_trx(Trx *trx) { db_->trx_kit().destroy_trx(trx); }
+
+  MvccTrxKit &trx_kit() { return static_cast<MvccTrxKit &>(db_->trx_kit()); }
+
+  void make_record(int id, int value, Record &record)
+  {
+    Value values[2];
+    values[0].set_int(id);
+    values[1].set_int(value);
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+  }
+
+  int field_value(const Record &record, const char *field_name)
+  {
+    Field field(table_, table_->table_meta().field(field_name));
+    return field.get_int(record);
+  }
+
+  /**
+   * @brief 当前事务能看到的所有记录的value字段之和，以及表文件中所有记录的个数
+   */
+  void scan(Trx *trx, int &visible_num, int &value_sum, int &physical_num)
+  {
+    visible_num  = 0;
+    value_sum    = 0;
+    physical_num = 0;
+
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      physical_num++;
+      if (OB_SUCC(trx->visit_record(table_, record, ReadWriteMode::READ_ONLY))) {
+        visible_num++;
+        value_sum += field_value(record, "value");
+      }
+    }
+  }
+
+  /**
+   * @brief 把当前事务能看到的所有记录的value字段都改成value
+   */
+  RC update_all(Trx *trx, int value)
+  {
+    vector<Record> old_records;
+    {
+      RecordFileScanner scanner;
+      RC rc = table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_WRITE);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      Record record;
+      while (OB_SUCC(rc = scanner.next(record))) {
+        Record old_record;
+        old_record.copy_data(record.data(), record.len());
+        old_record.set_rid(record.rid());
+        old_records.push_back(std::move(old_record));
+      }
+    }
+
+    for (Record &old_record : old_records) {
+      Record new_record;
+      make_record(field_value(old_record, "id"), value, new_record);
+      RC rc = trx->update_record(table_, old_record, new_record);
+      if (rc == RC::RECORD_INVISIBLE) {
+        continue;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      if (new_record.rid() != old_record.rid()) {
+        return RC::INTERNAL;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+protected:
+  filesystem::path test_directory_;
+  unique_ptr<Db>   db_;
+  Table           *table_ = nullptr;
+};
+
+TEST_F(MvccTrxTest, version_chain)
+{
+  int visible_num  = 0;
+  int value_sum    = 0;
+  int physical_num = 0;
+
+  Trx *reader = create_trx();
+  Trx *writer = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(writer, 1));
+  ASSERT_EQ(static_cast<size_t>(RECORD_NUM), trx_kit().undo_segment().version_count());
+
+  // 写事务看到新的版本，其它事务看到旧的版本，表文件中只有一个版本
+  scan(writer, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(RECORD_NUM, value_sum);
+  ASSERT_EQ(RECORD_NUM, physical_num);
+
+  scan(reader, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(0, value_sum);
+  ASSERT_EQ(RECORD_NUM, physical_num);
+
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  destroy_trx(writer);
+
+  // 提交之前开始的事务仍然看到旧的版本，所以旧版本不能删除
+  scan(reader, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(0, value_sum);
+  ASSERT_EQ(static_cast<size_t>(RECORD_NUM), trx_kit().undo_segment().version_count());
+
+  Trx *reader2 = create_trx();
+  scan(reader2, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(RECORD_NUM, value_sum);
+
+  // 读事务开始之后的修改已经提交了，不能再修改
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, update_all(reader, 3));
+  ASSERT_EQ(RC::SUCCESS, reader->rollback());
+  destroy_trx(reader);
+
+  // 没有事务需要旧版本了，再次更新提交时删除
+  ASSERT_EQ(RC::SUCCESS, update_all(reader2, 2));
+  ASSERT_EQ(RC::SUCCESS, reader2->commit());
+  destroy_trx(reader2);
+  ASSERT_EQ(0UL, trx_kit().undo_segment().version_count());
+
+  Trx *reader3 = create_trx();
+  scan(reader3, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(RECORD_NUM * 2, value_sum);
+  ASSERT_EQ(RECORD_NUM, physical_num);
+  ASSERT_EQ(RC::SUCCESS, reader3->commit());
+  destroy_trx(reader3);
+}
+
+TEST_F(MvccTrxTest, rollback)
+{
+  int visible_num  = 0;
+  int value_sum    = 0;
+  int physical_num = 0;
+
+  Trx *writer = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(writer, 1));
+  ASSERT_EQ(RC::SUCCESS, update_all(writer, 2));
+  // 同一个事务多次修改只保留修改之前的版本
+  ASSERT_EQ(static_cast<size_t>(RECORD_NUM), trx_kit().undo_segment().version_count());
+
+  // 别的事务修改同一条记录时等待行锁
+  trx_kit().lock_manager().set_wait_timeout(chrono::milliseconds(50));
+  Trx *other = create_trx();
+  ASSERT_EQ(RC::LOCKED_WAIT_TIMEOUT, update_all(other, 3));
+
+  ASSERT_EQ(RC::SUCCESS, writer->rollback());
+  destroy_trx(writer);
+  ASSERT_EQ(0UL, trx_kit().undo_segment().version_count());
+
+  scan(other, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(0, value_sum);
+  ASSERT_EQ(RECORD_NUM, physical_num);
+  ASSERT_EQ(RC::SUCCESS, other->rollback());
+  destroy_trx(other);
+}
+
+TEST_F(MvccTrxTest, purge)
+{
+  const int delete_num   = RECORD_NUM / 2;
+  int       visible_num  = 0;
+  int       value_sum    = 0;
+  int       physical_num = 0;
+
+  MvccPurger &purger = trx_kit().purger();
+
+  Trx *trx = create_trx();
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, table_->table_meta().field("id"), "i_id", true /*unique*/));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  destroy_trx(trx);
+
+  Trx *reader = create_trx();
+
+  // 删除一半的记录，再更新所有的记录
+  Trx *writer = create_trx();
+  {
+    vector<Record> records;
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, writer, ReadWriteMode::READ_WRITE));
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      if (field_value(record, "id") < delete_num) {
+        records.emplace_back();
+        records.back().copy_data(record.data(), record.len());
+        records.back().set_rid(record.rid());
+      }
+    }
+    scanner.close_scan();
+
+    for (Record &record : records) {
+      ASSERT_EQ(RC::SUCCESS, writer->delete_record(table_, record));
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  destroy_trx(writer);
+
+  writer = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(writer, 1));
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  destroy_trx(writer);
+
+  // 读事务还能看到删除的记录和旧版本，不能回收
+  ASSERT_EQ(0, purger.purge_once());
+  MvccPurgeStat stat = purger.stat();
+  ASSERT_EQ(static_cast<uint64_t>(RECORD_NUM), stat.backlog);
+  ASSERT_EQ(static_cast<uint64_t>(RECORD_NUM - delete_num), stat.undo_versions);
+
+  scan(reader, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(0, value_sum);
+  ASSERT_EQ(RECORD_NUM, physical_num);
+
+  ASSERT_EQ(RC::SUCCESS, reader->rollback());
+  destroy_trx(reader);
+
+  // 后台线程可能已经回收过了
+  purger.purge_once();
+  stat = purger.stat();
+  ASSERT_EQ(0UL, stat.backlog);
+  ASSERT_EQ(0UL, stat.undo_versions);
+  ASSERT_EQ(static_cast<uint64_t>(delete_num), stat.purged_records);
+
+  trx = create_trx();
+  scan(trx, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM - delete_num, visible_num);
+  ASSERT_EQ(RECORD_NUM - delete_num, value_sum);
+  ASSERT_EQ(RECORD_NUM - delete_num, physical_num);
+
+  // 唯一索引上删除的键值也已经回收，可以再次插入
+  for (int i = 0; i < delete_num; i++) {
+    Record record;
+    make_record(i, 0, record);
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table_, record));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  destroy_trx(trx);
+}
+
+TEST_F(MvccTrxTest, read_view)
+{
+  MvccTrxKit &kit = trx_kit();
+
+  MvccReadView view1;
+  const int32_t trx_id1 = kit.begin_trx(view1);
+  ASSERT_EQ(trx_id1 + 1, view1.high_limit);
+  ASSERT_TRUE(view1.visible(trx_id1 - 1));
+
+  // 正在提交的事务号对新的读视图不可见，提交完成之后才可见
+  const int32_t commit_xid = kit.begin_commit();
+  MvccReadView  view2;
+  const int32_t trx_id2 = kit.begin_trx(view2);
+  ASSERT_EQ(vector<int32_t>({trx_id1, commit_xid}), view2.active_xids);
+  ASSERT_EQ(trx_id1, view2.low_limit);
+  ASSERT_FALSE(view1.visible(commit_xid));
+  ASSERT_FALSE(view2.visible(commit_xid));
+  ASSERT_EQ(trx_id1, kit.oldest_active_trx_id());
+
+  kit.end_trx(commit_xid);
+  MvccReadView view3;
+  const int32_t trx_id3 = kit.begin_trx(view3);
+  ASSERT_TRUE(view3.visible(commit_xid));
+  ASSERT_FALSE(view3.visible(trx_id3 + 1));
+
+  // 读视图还在使用时，它之后提交的版本不能回收
+  kit.end_trx(trx_id1);
+  ASSERT_EQ(trx_id1, kit.oldest_active_trx_id());
+  kit.end_trx(trx_id2);
+  ASSERT_EQ(view3.low_limit, kit.oldest_active_trx_id());
+  kit.end_trx(trx_id3);
+  ASSERT_EQ(kit.current_trx_id() + 1, kit.oldest_active_trx_id());
+}
+
+TEST_F(MvccTrxTest, restart)
+{
+  Trx *writer = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(writer, 1));
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  destroy_trx(writer);
+
+  // 重启后事务号继续增长，新的事务能看到重启前提交的数据
+  const int32_t trx_id = db_->trx_kit().current_trx_id();
+  ASSERT_EQ(RC::SUCCESS, db_->sync());
+  db_ = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db_->init("test_db", test_directory_.c_str(), "mvcc", "vacuous"));
+  table_ = db_->find_table("t");
+  ASSERT_NE(nullptr, table_);
+  ASSERT_EQ(trx_id, db_->trx_kit().current_trx_id());
+
+  int  visible_num  = 0;
+  int  value_sum    = 0;
+  int  physical_num = 0;
+  Trx *reader       = create_trx();
+  ASSERT_GT(reader->id(), trx_id);
+  scan(reader, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(RECORD_NUM, value_sum);
+  ASSERT_EQ(RC::SUCCESS, reader->commit());
+  destroy_trx(reader);
+}
+
+TEST_F(MvccTrxTest, lock_wait)
+{
+  RowLockManager &lock_manager = trx_kit().lock_manager();
+  lock_manager.set_wait_timeout(chrono::milliseconds(10000));
+
+  // 持有锁的事务回滚之后，等待的事务可以继续修改
+  Trx *holder = create_trx();
+  Trx *waiter = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(holder, 1));
+
+  future<RC> wait_result = async(launch::async, [this, waiter]() { return update_all(waiter, 2); });
+  ASSERT_EQ(future_status::timeout, wait_result.wait_for(chrono::milliseconds(200)));
+  ASSERT_EQ(RC::SUCCESS, holder->rollback());
+  destroy_trx(holder);
+  ASSERT_EQ(RC::SUCCESS, wait_result.get());
+  ASSERT_EQ(RC::SUCCESS, waiter->commit());
+  destroy_trx(waiter);
+  ASSERT_EQ(0, lock_manager.lock_num());
+
+  // 持有锁的事务提交之后，等待的事务的快照已经过时了
+  holder = create_trx();
+  waiter = create_trx();
+  ASSERT_EQ(RC::SUCCESS, update_all(holder, 3));
+
+  wait_result = async(launch::async, [this, waiter]() { return update_all(waiter, 4); });
+  ASSERT_EQ(future_status::timeout, wait_result.wait_for(chrono::milliseconds(200)));
+  ASSERT_EQ(RC::SUCCESS, holder->commit());
+  destroy_trx(holder);
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, wait_result.get());
+  ASSERT_EQ(RC::SUCCESS, waiter->rollback());
+  destroy_trx(waiter);
+
+  int  visible_num  = 0;
+  int  value_sum    = 0;
+  int  physical_num = 0;
+  Trx *reader       = create_trx();
+  scan(reader, visible_num, value_sum, physical_num);
+  ASSERT_EQ(RECORD_NUM, visible_num);
+  ASSERT_EQ(RECORD_NUM * 3, value_sum);
+  ASSERT_EQ(RC::SUCCESS, reader->commit());
+  destroy_trx(reader);
+
+  const RowLockStat stat = lock_manager.stat();
+  ASSERT_EQ(2, stat.wait_count);
+  ASSERT_EQ(1, stat.conflict_count);
+  ASSERT_EQ(0, stat.timeout_count);
+  ASSERT_EQ(0, lock_manager.lock_num());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
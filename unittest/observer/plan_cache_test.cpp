@@ -0,0 +1,223 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/expr/expression.h"
+#include "sql/operator/predicate_physical_operator.h"
+#include "sql/parser/parse.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/stmt/stmt.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 输出固定行数的算子
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  RowsPhysicalOperator(int rows) : rows_(rows) { tuple_.set_cells({Value(1)}); }
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *) override
+  {
+    position_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC next() override { return position_++ < rows_ ? RC::SUCCESS : RC::RECORD_EOF; }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  int            rows_     = 0;
+  int            position_ = 0;
+  ValueListTuple tuple_;
+};
+
+/**
+ * @brief 生成"where 左边常量 < 右边常量"的执行计划
+ * @param right_bindable 右边的常量是否来自SQL
+ */
+static unique_ptr<CachedPlan> make_plan(const string &sql, bool right_bindable)
+{
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql(sql.c_str(), key, literals);
+  EXPECT_EQ(literals.size(), 2);
+
+  auto left = make_unique<ValueExpr>(literals[0].value);
+  left->set_position(literals[0].position);
+  auto right = make_unique<ValueExpr>(literals[1].value);
+  if (right_bindable) {
+    right->set_position(literals[1].position);
+  }
+
+  auto predicate = make_unique<PredicatePhysicalOperator>(
+      make_unique<ComparisonExpr>(LESS_THAN, std::move(left), std::move(right)));
+  predicate->add_child(make_unique<RowsPhysicalOperator>(3));
+
+  auto plan = make_unique<CachedPlan>(std::move(key), std::move(literals), nullptr, std::move(predicate));
+  EXPECT_TRUE(plan->init());
+  return plan;
+}
+
+static int run(PhysicalOperator &oper)
+{
+  int count = 0;
+  EXPECT_EQ(oper.open(nullptr), RC::SUCCESS);
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = oper.next())) {
+    count++;
+  }
+  EXPECT_EQ(rc, RC::RECORD_EOF);
+  EXPECT_EQ(oper.close(), RC::SUCCESS);
+  return count;
+}
+
+TEST(PlanCache, parameterize_sql)
+{
+  const string       sql = "select id, 'a' from t where a > 10 and b = 'x y' and c < 1.5;";
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql(sql.c_str(), key, literals);
+
+  ASSERT_EQ(key, "select id, '?' from t where a > ? and b = '?' and c < ?.?;");
+  ASSERT_EQ(literals.size(), 4);
+  ASSERT_EQ(literals[0].text, "'a'");
+  ASSERT_EQ(literals[0].value.get_string(), "a");
+  ASSERT_EQ(literals[1].text, "10");
+  ASSERT_EQ(literals[1].position, static_cast<int>(sql.find("10")));
+  ASSERT_EQ(literals[1].value.get_int(), 10);
+  ASSERT_EQ(literals[2].text, "'x y'");
+  ASSERT_EQ(literals[2].value.get_string(), "x y");
+  ASSERT_EQ(literals[3].text, "1.5");
+  ASSERT_EQ(literals[3].value.attr_type(), AttrType::FLOATS);
+
+  // 空字符串和没有常量的SQL
+  parameterize_sql("select * from t where b = ''", key, literals);
+  ASSERT_EQ(key, "select * from t where b = '?'");
+  ASSERT_EQ(literals.size(), 1);
+  ASSERT_EQ(literals[0].value.get_string(), "");
+
+  parameterize_sql("select * from t", key, literals);
+  ASSERT_EQ(key, "select * from t");
+  ASSERT_TRUE(literals.empty());
+}
+
+TEST(PlanCache, acquire_and_bind)
+{
+  PlanCache plan_cache;
+  plan_cache.release(make_plan("select * from t where 1 < 2", true));
+  ASSERT_EQ(plan_cache.size(), 1);
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql("select * from t where 5 < 2", key, literals);
+  unique_ptr<CachedPlan> plan = plan_cache.acquire(key, literals);
+  ASSERT_NE(plan, nullptr);
+  ASSERT_EQ(plan_cache.size(), 0);
+
+  // 计划正在使用，相同的SQL不能命中
+  ASSERT_EQ(plan_cache.acquire(key, literals), nullptr);
+
+  {
+    CachedPlanPhysicalOperator oper(&plan_cache, std::move(plan));
+    ASSERT_EQ(run(oper), 0);
+  }
+  ASSERT_EQ(plan_cache.size(), 1);
+
+  parameterize_sql("select * from t where 1 < 7", key, literals);
+  plan = plan_cache.acquire(key, literals);
+  ASSERT_NE(plan, nullptr);
+  {
+    CachedPlanPhysicalOperator oper(&plan_cache, std::move(plan));
+    ASSERT_EQ(run(oper), 3);
+  }
+
+  // 常量类型不同，参数化之后的SQL也不同
+  parameterize_sql("select * from t where 1 < 7.0", key, literals);
+  ASSERT_EQ(plan_cache.acquire(key, literals), nullptr);
+
+  ASSERT_EQ(plan_cache.hits(), 2);
+  ASSERT_EQ(plan_cache.misses(), 2);
+}
+
+TEST(PlanCache, unbindable_literal)
+{
+  PlanCache plan_cache;
+  plan_cache.release(make_plan("select * from t where 1 < 2", false));
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql("select * from t where 1 < 3", key, literals);
+  ASSERT_EQ(plan_cache.acquire(key, literals), nullptr);
+
+  parameterize_sql("select * from t where 9 < 2", key, literals);
+  unique_ptr<CachedPlan> plan = plan_cache.acquire(key, literals);
+  ASSERT_NE(plan, nullptr);
+  CachedPlanPhysicalOperator oper(&plan_cache, std::move(plan));
+  ASSERT_EQ(run(oper), 0);
+}
+
+TEST(PlanCache, invalidate)
+{
+  PlanCache plan_cache;
+  plan_cache.release(make_plan("select * from t where 1 < 2", true));
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql("select * from t where 1 < 2", key, literals);
+  unique_ptr<CachedPlan> plan = plan_cache.acquire(key, literals);
+  ASSERT_NE(plan, nullptr);
+
+  plan_cache.release(make_plan("select * from t where 1 < 2", true));
+  plan_cache.invalidate();
+  ASSERT_EQ(plan_cache.size(), 0);
+  ASSERT_EQ(plan_cache.invalidations(), 1);
+
+  // 失效之前取出的计划不再放回
+  plan_cache.release(std::move(plan));
+  ASSERT_EQ(plan_cache.size(), 0);
+
+  plan = make_plan("select * from t where 1 < 2", true);
+  plan->set_version(plan_cache.version());
+  plan_cache.release(std::move(plan));
+  ASSERT_EQ(plan_cache.size(), 1);
+}
+
+TEST(PlanCache, evict)
+{
+  PlanCache plan_cache(2);
+  plan_cache.release(make_plan("select * from a where 1 < 2", true));
+  plan_cache.release(make_plan("select * from b where 1 < 2", true));
+  plan_cache.release(make_plan("select * from c where 1 < 2", true));
+  ASSERT_EQ(plan_cache.size(), 2);
+
+  string             key;
+  vector<SqlLiteral> literals;
+  parameterize_sql("select * from a where 1 < 2", key, literals);
+  ASSERT_EQ(plan_cache.acquire(key, literals), nullptr);
+  parameterize_sql("select * from c where 1 < 2", key, literals);
+  ASSERT_NE(plan_cache.acquire(key, literals), nullptr);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
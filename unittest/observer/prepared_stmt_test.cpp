@@ -0,0 +1,101 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/parser/parse.h"
+#include "sql/prepared_stmt/prepared_stmt.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(PreparedStmt, find_sql_params)
+{
+  const string sql = "select * from t where a > ? and b = '?' and c in (?, ?)";
+  vector<int>  positions;
+  find_sql_params(sql.c_str(), positions);
+  ASSERT_EQ(positions.size(), 3);
+  ASSERT_EQ(positions[0], static_cast<int>(sql.find("? and")));
+  ASSERT_EQ(positions[1], static_cast<int>(sql.find("?, ?")));
+  ASSERT_EQ(positions[2], static_cast<int>(sql.rfind('?')));
+
+  find_sql_params("select * from t", positions);
+  ASSERT_TRUE(positions.empty());
+}
+
+TEST(PreparedStmt, bind_sql)
+{
+  PreparedStmt stmt(1, "select * from t where a > ? and b = ? and c = ? and d = ? and e = '?'");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  ASSERT_EQ(stmt.param_count(), 4);
+
+  Value null_value;
+  null_value.set_null();
+  vector<Value> params = {Value(-5), Value(2.0f), Value("it's"), null_value};
+
+  string                    sql;
+  unique_ptr<ParsedSqlNode> sql_node;
+  ASSERT_EQ(stmt.bind(params, sql, sql_node), RC::SUCCESS);
+  ASSERT_EQ(sql_node, nullptr);
+  ASSERT_EQ(sql, "select * from t where a > -5 and b = 2.0 and c = \"it's\" and d = null and e = '?'");
+
+  // 同时包含两种引号的字符串不能转换成SQL常量
+  params[2] = Value("'\"");
+  ASSERT_NE(stmt.bind(params, sql, sql_node), RC::SUCCESS);
+
+  params.pop_back();
+  ASSERT_NE(stmt.bind(params, sql, sql_node), RC::SUCCESS);
+}
+
+TEST(PreparedStmt, bind_insert)
+{
+  PreparedStmt stmt(1, "insert into t values(1, ?, 'a', ?)");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  ASSERT_EQ(stmt.param_count(), 2);
+
+  string                    sql;
+  unique_ptr<ParsedSqlNode> sql_node;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(stmt.bind({Value(i), Value("x")}, sql, sql_node), RC::SUCCESS);
+    ASSERT_NE(sql_node, nullptr);
+    ASSERT_EQ(sql_node->flag, SCF_INSERT);
+    ASSERT_EQ(sql_node->insertion.relation_name, "t");
+
+    const vector<Value> &values = sql_node->insertion.values;
+    ASSERT_EQ(values.size(), 4);
+    ASSERT_EQ(values[0].get_int(), 1);
+    ASSERT_EQ(values[1].get_int(), i);
+    ASSERT_EQ(values[2].get_string(), "a");
+    ASSERT_EQ(values[3].get_string(), "x");
+  }
+}
+
+TEST(PreparedStmt, long_data)
+{
+  PreparedStmt stmt(1, "insert into t values(?)");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  ASSERT_EQ(stmt.long_data(0), nullptr);
+
+  stmt.append_long_data(0, "abc", 3);
+  stmt.append_long_data(0, "def", 3);
+  ASSERT_NE(stmt.long_data(0), nullptr);
+  ASSERT_EQ(*stmt.long_data(0), "abcdef");
+
+  stmt.clear_long_data();
+  ASSERT_EQ(stmt.long_data(0), nullptr);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
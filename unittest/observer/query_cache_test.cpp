@@ -0,0 +1,174 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/executor/sql_result.h"
+#include "sql/query_cache/query_cache.h"
+#include "storage/db/db.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 输出固定行数的算子，第i行是(i, "row i")
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  RowsPhysicalOperator(int rows) : rows_(rows) {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *) override
+  {
+    position_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC next() override
+  {
+    if (position_ >= rows_) {
+      return RC::RECORD_EOF;
+    }
+    tuple_.set_cells({Value(position_), Value(("row " + to_string(position_)).c_str())});
+    position_++;
+    return RC::SUCCESS;
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  int            rows_     = 0;
+  int            position_ = 0;
+  ValueListTuple tuple_;
+};
+
+static shared_ptr<QueryResult> make_result(int rows)
+{
+  auto result = make_shared<QueryResult>();
+  for (int i = 0; i < rows; i++) {
+    result->append_row({Value(i), Value(("row " + to_string(i)).c_str())});
+  }
+  return result;
+}
+
+TEST(QueryCache, lookup)
+{
+  Db         db;
+  QueryCache query_cache;
+  ASSERT_EQ(query_cache.lookup("select * from t", db), nullptr);
+
+  query_cache.insert("select * from t", make_result(3));
+  ASSERT_EQ(query_cache.size(), 1);
+
+  shared_ptr<const QueryResult> result = query_cache.lookup("select * from t", db);
+  ASSERT_NE(result, nullptr);
+  ASSERT_EQ(result->row_count(), 3);
+
+  // SQL原文不同就不能命中
+  ASSERT_EQ(query_cache.lookup("select * from  t", db), nullptr);
+
+  // 相同的SQL替换原来的结果
+  query_cache.insert("select * from t", make_result(5));
+  ASSERT_EQ(query_cache.size(), 1);
+  ASSERT_EQ(query_cache.lookup("select * from t", db)->row_count(), 5);
+
+  ASSERT_EQ(query_cache.hits(), 2);
+  ASSERT_EQ(query_cache.misses(), 2);
+
+  query_cache.clear();
+  ASSERT_EQ(query_cache.size(), 0);
+  ASSERT_EQ(query_cache.memory_size(), 0);
+}
+
+TEST(QueryCache, evict)
+{
+  const size_t result_size = make_result(100)->memory_size();
+  QueryCache   query_cache(result_size * 4 + 1024);
+
+  for (int i = 0; i < 8; i++) {
+    query_cache.insert("select " + to_string(i), make_result(100));
+    ASSERT_LE(query_cache.memory_size(), result_size * 4 + 1024);
+  }
+  ASSERT_LT(query_cache.size(), 8);
+
+  Db db;
+  ASSERT_EQ(query_cache.lookup("select 0", db), nullptr);
+  ASSERT_NE(query_cache.lookup("select 7", db), nullptr);
+
+  // 超过单个结果上限的不缓存
+  query_cache.insert("select big", make_result(1000));
+  ASSERT_EQ(query_cache.lookup("select big", db), nullptr);
+}
+
+TEST(QueryCache, record_and_replay)
+{
+  Db         db;
+  QueryCache query_cache;
+  SqlResult  sql_result(nullptr);
+
+  TupleSchema schema;
+  schema.append_cell("id");
+  schema.append_cell("name");
+  sql_result.set_tuple_schema(schema);
+
+  QueryResultRecordPhysicalOperator recorder(query_cache, "select * from t", make_shared<QueryResult>(), &sql_result);
+  recorder.add_child(make_unique<RowsPhysicalOperator>(10));
+
+  // 没有读完的结果不缓存
+  ASSERT_EQ(recorder.open(nullptr), RC::SUCCESS);
+  ASSERT_EQ(recorder.next(), RC::SUCCESS);
+  ASSERT_EQ(recorder.close(), RC::SUCCESS);
+  ASSERT_EQ(query_cache.size(), 0);
+
+  ASSERT_EQ(recorder.open(nullptr), RC::SUCCESS);
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = recorder.next())) {
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+  ASSERT_EQ(recorder.close(), RC::SUCCESS);
+  ASSERT_EQ(query_cache.size(), 1);
+
+  shared_ptr<const QueryResult> result = query_cache.lookup("select * from t", db);
+  ASSERT_NE(result, nullptr);
+  ASSERT_EQ(result->row_count(), 10);
+  ASSERT_EQ(result->schema().cell_num(), 2);
+
+  QueryResultPhysicalOperator replay(result);
+  for (int round = 0; round < 2; round++) {
+    ASSERT_EQ(replay.open(nullptr), RC::SUCCESS);
+    int count = 0;
+    while (RC::SUCCESS == (rc = replay.next())) {
+      Tuple *tuple = replay.current_tuple();
+      ASSERT_EQ(tuple->cell_num(), 2);
+
+      Value value;
+      ASSERT_EQ(tuple->cell_at(0, value), RC::SUCCESS);
+      ASSERT_EQ(value.get_int(), count);
+      ASSERT_EQ(tuple->cell_at(1, value), RC::SUCCESS);
+      ASSERT_EQ(value.get_string(), "row " + to_string(count));
+      count++;
+    }
+    ASSERT_EQ(rc, RC::RECORD_EOF);
+    ASSERT_EQ(count, 10);
+    ASSERT_EQ(replay.close(), RC::SUCCESS);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -121,6 +121,50 @@ TEST(RecordPageHandler, test_record_page_handler)
   delete bpm;
 }
 
+TEST(RecordPageHandler, update_record)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager_update.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, record_manager_file, bp));
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+
+  const int         record_size = 8;
+  RecordPageHandler record_page_handle;
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.init_empty_page(*bp, log_handler, frame->page_num(), record_size));
+
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.insert_record("aaaaaaa", &rid));
+
+  Record record;
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.update_record(rid, "aabbaaa"));
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.get_record(rid, record));
+  ASSERT_EQ(0, memcmp(record.data(), "aabbaaa", record_size));
+
+  // 数据没有变化
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.update_record(rid, "aabbaaa"));
+
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.update_record_range(rid, 6, 1, "c"));
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.get_record(rid, record));
+  ASSERT_EQ(0, memcmp(record.data(), "aabbaac", record_size));
+
+  ASSERT_EQ(RC::INVALID_ARGUMENT, record_page_handle.update_record_range(rid, 6, 3, "ccc"));
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.delete_record(&rid));
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, record_page_handle.update_record(rid, "aaaaaaa"));
+
+  record_page_handle.cleanup();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
 TEST(RecordFileScanner, test_record_file_iterator)
 {
   VacuousLogHandler log_handler;
@@ -331,30 +375,37 @@ TEST(RecordManager, durability)
   ASSERT_EQ(log_handler.await_termination(), RC::SUCCESS);
 
   // 重新创建资源并尝试从日志中恢复数据，然后校验数据
-  DiskLogHandler    log_handler2;
-  BufferPoolManager bpm2;
-  ASSERT_EQ(RC::SUCCESS, bpm2.init(make_unique<VacuousDoubleWriteBuffer>()));
-  DiskBufferPool *buffer_pool2 = nullptr;
-  filesystem::copy(record_manager_file_copy, record_manager_file);
-  ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
-  ASSERT_NE(buffer_pool2, nullptr);
-
-  IntegratedLogReplayer log_replayer2(bpm2);
-  ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
-  ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
-  ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
-
-  RecordFileHandler record_file_handler2;
-  ASSERT_EQ(record_file_handler2.init(*buffer_pool2, log_handler2), RC::SUCCESS);
-  for (const auto &[rid, record] : record_map) {
-    Record record_data;
-    ASSERT_EQ(record_file_handler2.get_record(rid, record_data), RC::SUCCESS);
-    ASSERT_EQ(memcmp(record_data.data(), record.c_str(), record.size()), 0);
+  // 分别使用顺序回放和并行回放
+  for (int worker_num : {0, 4}) {
+    DiskLogHandler    log_handler2;
+    BufferPoolManager bpm2;
+    ASSERT_EQ(RC::SUCCESS, bpm2.init(make_unique<VacuousDoubleWriteBuffer>()));
+    DiskBufferPool *buffer_pool2 = nullptr;
+    filesystem::remove(record_manager_file);
+    filesystem::copy(record_manager_file_copy, record_manager_file);
+    ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
+    ASSERT_NE(buffer_pool2, nullptr);
+
+    IntegratedLogReplayer log_replayer2(bpm2);
+    ASSERT_EQ(log_replayer2.start_workers(worker_num), RC::SUCCESS);
+    ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
+    ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
+    ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
+    ASSERT_EQ(log_replayer2.on_done(), RC::SUCCESS);
+
+    RecordFileHandler record_file_handler2;
+    ASSERT_EQ(record_file_handler2.init(*buffer_pool2, log_handler2), RC::SUCCESS);
+    for (const auto &[rid, record] : record_map) {
+      Record record_data;
+      ASSERT_EQ(record_file_handler2.get_record(rid, record_data), RC::SUCCESS);
+      ASSERT_EQ(memcmp(record_data.data(), record.c_str(), record.size()), 0);
+    }
+
+    record_file_handler2.close();
+    ASSERT_EQ(log_handler2.stop(), RC::SUCCESS);
+    ASSERT_EQ(log_handler2.await_termination(), RC::SUCCESS);
+    bpm2.close_file(record_manager_file.c_str());
   }
-
-  ASSERT_EQ(log_handler2.stop(), RC::SUCCESS);
-  ASSERT_EQ(log_handler2.await_termination(), RC::SUCCESS);
-  bpm2.close_file(record_manager_file.c_str());
 }
 
 int main(int argc, char **argv)
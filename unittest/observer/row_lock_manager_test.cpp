@@ -0,0 +1,129 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "storage/trx/row_lock_manager.h"
+
+using namespace std;
+using namespace common;
+
+static const RID rid1(1, 1);
+static const RID rid2(1, 2);
+
+TEST(RowLockManager, lock_unlock)
+{
+  RowLockManager lock_manager;
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, 1, rid1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, 1, rid1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, 1, rid2));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, 2, rid1));
+  ASSERT_EQ(3, lock_manager.lock_num());
+
+  lock_manager.unlock_all(1);
+  ASSERT_EQ(2, lock_manager.lock_num());
+  lock_manager.unlock_all(2);
+  ASSERT_EQ(0, lock_manager.lock_num());
+
+  const RowLockStat stat = lock_manager.stat();
+  ASSERT_EQ(3, stat.lock_count);
+  ASSERT_EQ(0, stat.wait_count);
+}
+
+TEST(RowLockManager, wait_queue)
+{
+  RowLockManager lock_manager;
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, 1, rid1));
+
+  // 锁按照等待的先后顺序交给等待的事务
+  future<RC> waiter2 = async(launch::async, [&lock_manager]() { return lock_manager.lock(2, 1, rid1); });
+  ASSERT_EQ(future_status::timeout, waiter2.wait_for(chrono::milliseconds(100)));
+  future<RC> waiter3 = async(launch::async, [&lock_manager]() { return lock_manager.lock(3, 1, rid1); });
+  ASSERT_EQ(future_status::timeout, waiter3.wait_for(chrono::milliseconds(100)));
+
+  lock_manager.unlock_all(1);
+  ASSERT_EQ(RC::SUCCESS, waiter2.get());
+  ASSERT_EQ(future_status::timeout, waiter3.wait_for(chrono::milliseconds(100)));
+
+  // 新来的事务不能插队
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(4, 1, rid2));
+  lock_manager.unlock_all(2);
+  ASSERT_EQ(RC::SUCCESS, waiter3.get());
+  lock_manager.unlock_all(3);
+  lock_manager.unlock_all(4);
+  ASSERT_EQ(0, lock_manager.lock_num());
+
+  const RowLockStat stat = lock_manager.stat();
+  ASSERT_EQ(4, stat.lock_count);
+  ASSERT_EQ(2, stat.wait_count);
+  ASSERT_GT(stat.wait_time_us, 0);
+  ASSERT_GE(stat.wait_time_us, stat.max_wait_us);
+}
+
+TEST(RowLockManager, timeout)
+{
+  RowLockManager lock_manager;
+  lock_manager.set_wait_timeout(chrono::milliseconds(50));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, 1, rid1));
+  ASSERT_EQ(RC::LOCKED_WAIT_TIMEOUT, lock_manager.lock(2, 1, rid1));
+
+  // 超时的事务不在等待队列中，锁释放之后直接删除
+  lock_manager.unlock_all(1);
+  ASSERT_EQ(0, lock_manager.lock_num());
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, 1, rid1));
+  lock_manager.unlock_all(2);
+
+  const RowLockStat stat = lock_manager.stat();
+  ASSERT_EQ(1, stat.timeout_count);
+  ASSERT_GE(stat.max_wait_us, 50 * 1000);
+}
+
+TEST(RowLockManager, deadlock)
+{
+  RowLockManager lock_manager;
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, 1, rid1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, 1, rid2));
+
+  future<RC> waiter1 = async(launch::async, [&lock_manager]() { return lock_manager.lock(1, 1, rid2); });
+  ASSERT_EQ(future_status::timeout, waiter1.wait_for(chrono::milliseconds(100)));
+
+  // 事务2等待事务1会形成环，直接失败
+  ASSERT_EQ(RC::LOCKED_DEADLOCK, lock_manager.lock(2, 1, rid1));
+
+  // 事务3持有另一条记录并等待 rid2，事务2再等待事务3也会形成环
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(3, 2, rid1));
+  future<RC> waiter3 = async(launch::async, [&lock_manager]() { return lock_manager.lock(3, 1, rid2); });
+  ASSERT_EQ(future_status::timeout, waiter3.wait_for(chrono::milliseconds(100)));
+  ASSERT_EQ(RC::LOCKED_DEADLOCK, lock_manager.lock(2, 2, rid1));
+
+  lock_manager.unlock_all(2);
+  ASSERT_EQ(RC::SUCCESS, waiter1.get());
+  lock_manager.unlock_all(1);
+  ASSERT_EQ(RC::SUCCESS, waiter3.get());
+  lock_manager.unlock_all(3);
+  ASSERT_EQ(0, lock_manager.lock_num());
+
+  const RowLockStat stat = lock_manager.stat();
+  ASSERT_EQ(2, stat.deadlock_count);
+  ASSERT_EQ(0, stat.timeout_count);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
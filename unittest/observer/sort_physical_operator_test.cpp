@@ -0,0 +1,163 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "session/session.h"
+#include "sql/operator/sort_physical_operator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 输出固定数据的算子，作为排序算子的输入
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  RowsPhysicalOperator(vector<vector<Value>> rows) : rows_(std::move(rows)) {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *) override
+  {
+    position_ = -1;
+    return RC::SUCCESS;
+  }
+
+  RC next() override
+  {
+    if (position_ + 1 >= static_cast<int>(rows_.size())) {
+      return RC::RECORD_EOF;
+    }
+    tuple_.set_cells(rows_[++position_]);
+    return RC::SUCCESS;
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  vector<vector<Value>> rows_;
+  int                   position_ = -1;
+  ValueListTuple        tuple_;
+};
+
+static string sort_key(const Value &value, bool is_asc)
+{
+  string key;
+  SortKeyEncoder::append(value, is_asc, key);
+  return key;
+}
+
+TEST(SortKeyEncoder, order)
+{
+  Value null_value;
+  null_value.set_null();
+
+  vector<Value> values = {null_value, Value(-100), Value(-1.5f), Value(0), Value((float)-0.0), Value(0.5f), Value(1),
+      Value(100), Value(1000000.0f)};
+  for (size_t i = 0; i + 1 < values.size(); i++) {
+    const int expected = values[i].attr_type() == AttrType::NULLS ? -1 : values[i].compare(values[i + 1]);
+    ASSERT_EQ(expected < 0, sort_key(values[i], true) < sort_key(values[i + 1], true)) << i;
+    ASSERT_EQ(expected < 0, sort_key(values[i], false) > sort_key(values[i + 1], false)) << i;
+  }
+  ASSERT_EQ(sort_key(Value(0), true), sort_key(Value((float)-0.0), true));
+
+  vector<Value> strings = {Value(""), Value("a"), Value("ab"), Value("abc"), Value("b")};
+  for (size_t i = 0; i + 1 < strings.size(); i++) {
+    ASSERT_LT(sort_key(strings[i], true), sort_key(strings[i + 1], true));
+    ASSERT_GT(sort_key(strings[i], false), sort_key(strings[i + 1], false));
+  }
+
+  // 多个字段拼接后，前一个字段的长度不影响比较结果
+  string key1 = sort_key(Value("a"), true) + sort_key(Value("z"), true);
+  string key2 = sort_key(Value("ab"), true) + sort_key(Value("a"), true);
+  ASSERT_LT(key1, key2);
+}
+
+/**
+ * @brief 使用排序算子排序，第0列是输出，第1、2列是排序字段(第1列升序，第2列降序)
+ */
+static void check_sort(size_t memory_limit, int limit, bool expect_spill)
+{
+  const int             row_num = 3000;
+  vector<vector<Value>> rows;
+  for (int i = 0; i < row_num; i++) {
+    rows.push_back({Value(i), Value((i * 7919) % 101), Value(static_cast<float>(i % 13))});
+  }
+
+  vector<vector<Value>> expected = rows;
+  stable_sort(expected.begin(), expected.end(), [](const vector<Value> &a, const vector<Value> &b) {
+    int cmp = a[1].compare(b[1]);
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+    return a[2].compare(b[2]) > 0;
+  });
+  if (limit >= 0 && limit < row_num) {
+    expected.resize(limit);
+  }
+
+  Session session;
+  session.set_sort_memory_limit(memory_limit);
+  Session::set_current_session(&session);
+
+  SortPhysicalOperator sort_oper({{1, true, "c1"}, {2, false, "c2"}}, {TupleCellSpec("c0")}, limit);
+  sort_oper.add_child(make_unique<RowsPhysicalOperator>(rows));
+
+  ASSERT_EQ(sort_oper.open(nullptr), RC::SUCCESS);
+  size_t count = 0;
+  RC     rc    = RC::SUCCESS;
+  while ((rc = sort_oper.next()) == RC::SUCCESS) {
+    Tuple *tuple = sort_oper.current_tuple();
+    ASSERT_EQ(tuple->cell_num(), 1);
+
+    Value value;
+    ASSERT_EQ(tuple->cell_at(0, value), RC::SUCCESS);
+    ASSERT_LT(count, expected.size());
+    ASSERT_EQ(value.get_int(), expected[count][0].get_int()) << count;
+    count++;
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+  ASSERT_EQ(count, expected.size());
+  ASSERT_EQ(sort_oper.param().find("spill_rows") != string::npos, expect_spill);
+  ASSERT_EQ(sort_oper.close(), RC::SUCCESS);
+
+  Session::set_current_session(nullptr);
+}
+
+TEST(SortPhysicalOperator, in_memory) { check_sort(SortPhysicalOperator::DEFAULT_MEMORY_LIMIT, -1, false); }
+
+TEST(SortPhysicalOperator, external)
+{
+  // 每一行都会生成一个run，需要多轮归并
+  check_sort(1, -1, true);
+}
+
+TEST(SortPhysicalOperator, top_n)
+{
+  check_sort(SortPhysicalOperator::DEFAULT_MEMORY_LIMIT, 10, false);
+  check_sort(SortPhysicalOperator::DEFAULT_MEMORY_LIMIT, 0, false);
+  check_sort(SortPhysicalOperator::DEFAULT_MEMORY_LIMIT, 5000, false);
+
+  // top-N的堆超过内存限制时，转换成外部排序
+  check_sort(1024, 2000, true);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <cstdint>
+#include <vector>
+
+#include "sql/expr/vector_kernels.h"
+#include "sql/parser/value.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static const CompOp COMP_OPS[] = {EQUAL_TO, LESS_EQUAL, NOT_EQUAL, LESS_THAN, GREAT_EQUAL, GREAT_THAN};
+
+/**
+ * @brief 依次使用CPU支持的每一种实现
+ */
+static vector<SimdLevel> levels()
+{
+  vector<SimdLevel> result;
+  const SimdLevel   supported = VectorKernels::detect();
+  for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2}) {
+    if (static_cast<int>(level) <= static_cast<int>(supported)) {
+      result.push_back(level);
+    }
+  }
+  return result;
+}
+
+static bool expected_result(CompOp comp, const Value &left, const Value &right)
+{
+  const int cmp = left.compare(right);
+  switch (comp) {
+    case EQUAL_TO: return cmp == 0;
+    case LESS_EQUAL: return cmp <= 0;
+    case NOT_EQUAL: return cmp != 0;
+    case LESS_THAN: return cmp < 0;
+    case GREAT_EQUAL: return cmp >= 0;
+    case GREAT_THAN: return cmp > 0;
+    default: return false;
+  }
+}
+
+class VectorKernelsTest : public testing::Test
+{
+protected:
+  void TearDown() override { VectorKernels::set_level(VectorKernels::detect()); }
+};
+
+TEST_F(VectorKernelsTest, compare_int32)
+{
+  // 长度不是向量宽度的整数倍，覆盖剩余部分的处理
+  const int       count = 1027;
+  vector<int32_t> left(count);
+  vector<int32_t> right(count);
+  for (int i = 0; i < count; i++) {
+    left[i]  = i % 7 - 3;
+    right[i] = i % 5 - 2;
+  }
+  left[0]  = INT32_MIN;
+  right[1] = INT32_MAX;
+
+  vector<uint8_t> result(count);
+  for (SimdLevel level : levels()) {
+    VectorKernels::set_level(level);
+    for (CompOp comp : COMP_OPS) {
+      for (int n : {0, 1, 3, 7, 9, 17, 33, count}) {
+        ASSERT_TRUE(VectorKernels::compare_int32(comp, left.data(), right.data(), n, result.data()));
+        for (int i = 0; i < n; i++) {
+          ASSERT_EQ(result[i], expected_result(comp, Value(left[i]), Value(right[i])) ? 1 : 0)
+              << "level=" << simd_level_name(level) << ", comp=" << comp << ", i=" << i;
+        }
+      }
+    }
+  }
+
+  ASSERT_FALSE(VectorKernels::compare_int32(NO_OP, left.data(), right.data(), count, result.data()));
+}
+
+TEST_F(VectorKernelsTest, compare_float)
+{
+  const int     count = 1029;
+  vector<float> left(count);
+  vector<float> right(count);
+  for (int i = 0; i < count; i++) {
+    left[i]  = static_cast<float>(i % 9) / 4 - 1;
+    // 一部分值的差在EPSILON以内，应当认为相等
+    right[i] = i % 3 == 0 ? left[i] + 1e-7f : static_cast<float>(i % 5) / 2 - 1;
+  }
+
+  vector<double>  left_doubles(left.begin(), left.end());
+  vector<double>  right_doubles(right.begin(), right.end());
+  vector<uint8_t> result(count);
+  vector<uint8_t> double_result(count);
+  for (SimdLevel level : levels()) {
+    VectorKernels::set_level(level);
+    for (CompOp comp : COMP_OPS) {
+      ASSERT_TRUE(VectorKernels::compare_float(comp, left.data(), right.data(), count, result.data()));
+      ASSERT_TRUE(
+          VectorKernels::compare_double(comp, left_doubles.data(), right_doubles.data(), count, double_result.data()));
+      for (int i = 0; i < count; i++) {
+        const uint8_t expected = expected_result(comp, Value(left[i]), Value(right[i])) ? 1 : 0;
+        ASSERT_EQ(result[i], expected) << "level=" << simd_level_name(level) << ", comp=" << comp << ", i=" << i;
+        ASSERT_EQ(double_result[i], expected) << "level=" << simd_level_name(level) << ", comp=" << comp << ", i=" << i;
+      }
+    }
+  }
+}
+
+TEST_F(VectorKernelsTest, arithmetic)
+{
+  const int       count = 1031;
+  vector<int32_t> left(count);
+  vector<int32_t> right(count);
+  vector<float>   left_floats(count);
+  vector<float>   right_floats(count);
+  for (int i = 0; i < count; i++) {
+    left[i]         = i * 7919 - 3000;
+    right[i]        = i % 13 - 6;
+    left_floats[i]  = static_cast<float>(left[i]) / 8;
+    right_floats[i] = static_cast<float>(right[i]) / 4 + 0.5f;
+  }
+  left[2] = INT32_MAX;
+  left[3] = INT32_MIN;
+
+  vector<int32_t> int_result(count);
+  vector<float>   float_result(count);
+  for (SimdLevel level : levels()) {
+    VectorKernels::set_level(level);
+    for (ArithmeticType type : {ArithmeticType::ADD, ArithmeticType::SUB, ArithmeticType::MUL}) {
+      ASSERT_TRUE(VectorKernels::arithmetic_int32(type, left.data(), right.data(), count, int_result.data()));
+      for (int i = 0; i < count; i++) {
+        const uint32_t l = static_cast<uint32_t>(left[i]);
+        const uint32_t r = static_cast<uint32_t>(right[i]);
+        const uint32_t expected = type == ArithmeticType::ADD ? l + r : (type == ArithmeticType::SUB ? l - r : l * r);
+        ASSERT_EQ(int_result[i], static_cast<int32_t>(expected)) << "level=" << simd_level_name(level) << ", i=" << i;
+      }
+    }
+
+    for (ArithmeticType type :
+        {ArithmeticType::ADD, ArithmeticType::SUB, ArithmeticType::MUL, ArithmeticType::DIV}) {
+      ASSERT_TRUE(VectorKernels::arithmetic_float(
+          type, left_floats.data(), right_floats.data(), count, float_result.data()));
+      for (int i = 0; i < count; i++) {
+        const float l = left_floats[i];
+        const float r = right_floats[i];
+        float       expected = 0;
+        switch (type) {
+          case ArithmeticType::ADD: expected = l + r; break;
+          case ArithmeticType::SUB: expected = l - r; break;
+          case ArithmeticType::MUL: expected = l * r; break;
+          default: expected = l / r; break;
+        }
+        ASSERT_EQ(float_result[i], expected) << "level=" << simd_level_name(level) << ", i=" << i;
+      }
+    }
+
+    ASSERT_FALSE(
+        VectorKernels::arithmetic_int32(ArithmeticType::DIV, left.data(), right.data(), count, int_result.data()));
+  }
+}
+
+TEST_F(VectorKernelsTest, select)
+{
+  const int       count = 1000;
+  vector<uint8_t> values(count);
+  vector<uint8_t> nulls(count);
+  for (int i = 0; i < count; i++) {
+    values[i] = i % 3 == 0 || i % 7 == 0 ? 1 : 0;
+    nulls[i]  = i % 5 == 0 ? 1 : 0;
+  }
+
+  vector<int> selection(count);
+  for (SimdLevel level : levels()) {
+    VectorKernels::set_level(level);
+    for (bool with_nulls : {false, true}) {
+      const uint8_t *null_data = with_nulls ? nulls.data() : nullptr;
+      const int      selected  = VectorKernels::select(values.data(), null_data, count, selection.data());
+
+      vector<int> expected;
+      for (int i = 0; i < count; i++) {
+        if (values[i] != 0 && (!with_nulls || nulls[i] == 0)) {
+          expected.push_back(i);
+        }
+      }
+      ASSERT_EQ(selected, static_cast<int>(expected.size())) << "level=" << simd_level_name(level);
+      for (int i = 0; i < selected; i++) {
+        ASSERT_EQ(selection[i], expected[i]) << "level=" << simd_level_name(level);
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}